@@ -62,7 +62,7 @@ struct
 };
 
 //! Set number of low-rank engines and default one
-#define LRENGINE_NUM 5
+#define LRENGINE_NUM 8
 #define LRENGINE_DEFAULT STARSH_LRENGINE_RSVD
 //! Array of low-rank engines, presented by string and enum value
 struct
@@ -76,17 +76,35 @@ struct
     {"RRQR", STARSH_LRENGINE_RRQR},
     {"RSVD", STARSH_LRENGINE_RSVD},
     {"CROSS", STARSH_LRENGINE_CROSS},
+    {"ID", STARSH_LRENGINE_ID},
+    {"CHEB", STARSH_LRENGINE_CHEB},
+    {"AUTO", STARSH_LRENGINE_AUTO},
+};
+
+//! Set number of error tolerance modes and default one
+#define TOLMODE_NUM 2
+#define TOLMODE_DEFAULT STARSH_TOLMODE_TILE
+//! Array of error tolerance modes, presented by string and enum value
+struct
+{
+    const char *string;
+    enum STARSH_TOLMODE tolmode;
+} const tolmode[TOLMODE_NUM] =
+{
+    {"TILE", STARSH_TOLMODE_TILE},
+    {"GLOBAL", STARSH_TOLMODE_GLOBAL},
 };
 
 //! Parameters of STARS-H
 struct starsh_params starsh_params =
 {
-    STARSH_BACKEND_NOTSELECTED, STARSH_LRENGINE_NOTSELECTED, -1
+    STARSH_BACKEND_NOTSELECTED, STARSH_LRENGINE_NOTSELECTED, -1,
+    STARSH_TOLMODE_NOTSELECTED
 };
 
 const static struct starsh_params starsh_params_default =
 {
-    BACKEND_DEFAULT, LRENGINE_DEFAULT, 10
+    BACKEND_DEFAULT, LRENGINE_DEFAULT, 10, TOLMODE_DEFAULT
 };
 
 //! Array of approximation functions for NOTSUPPORTED backend
@@ -96,7 +114,8 @@ static STARSH_blrm_approximate *(dlr_none[LRENGINE_NUM]) = {};
 static STARSH_blrm_approximate *(dlr_seq[LRENGINE_NUM]) =
 {
     starsh_blrm__dsdd, starsh_blrm__dsdd, starsh_blrm__dqp3,
-    starsh_blrm__drsdd, starsh_blrm__drsdd
+    starsh_blrm__drsdd, starsh_blrm__drsdd, starsh_blrm__did,
+    starsh_blrm__dcheb, starsh_blrm__dauto
 };
 
 //! Array of approximation functions for OPENMP backend
@@ -104,7 +123,8 @@ static STARSH_blrm_approximate *(dlr_omp[LRENGINE_NUM]) =
 {
     #ifdef OPENMP
     starsh_blrm__dsdd_omp, starsh_blrm__dsdd_omp, starsh_blrm__dqp3_omp,
-    starsh_blrm__drsdd_omp, starsh_blrm__drsdd_omp
+    starsh_blrm__drsdd_omp, starsh_blrm__drsdd_omp, starsh_blrm__did_omp,
+    starsh_blrm__dcheb_omp, starsh_blrm__dauto_omp
     #endif
 };
 
@@ -113,7 +133,10 @@ static STARSH_blrm_approximate *(dlr_mpi[LRENGINE_NUM]) =
 {
     #ifdef MPI
     starsh_blrm__dsdd_mpi, starsh_blrm__dsdd_mpi, starsh_blrm__dqp3_mpi,
-    starsh_blrm__drsdd_mpi, starsh_blrm__drsdd_mpi
+    starsh_blrm__drsdd_mpi, starsh_blrm__drsdd_mpi,
+    // Skeleton storage, interpolation and per-tile choice of engine are not
+    // supported by distributed routines yet
+    starsh_blrm__drsdd_mpi, starsh_blrm__drsdd_mpi, starsh_blrm__drsdd_mpi
     #endif
 };
 
@@ -123,7 +146,8 @@ static STARSH_blrm_approximate *(dlr_starpu[LRENGINE_NUM]) =
     #ifdef STARPU
     starsh_blrm__dsdd_starpu, starsh_blrm__dsdd_starpu,
     starsh_blrm__dqp3_starpu, starsh_blrm__drsdd_starpu,
-    starsh_blrm__drsdd_starpu
+    starsh_blrm__drsdd_starpu, starsh_blrm__drsdd_starpu,
+    starsh_blrm__drsdd_starpu, starsh_blrm__drsdd_starpu
     #endif
 };
 
@@ -133,7 +157,8 @@ static STARSH_blrm_approximate *(dlr_starpu_mpi[LRENGINE_NUM]) =
     #if defined(STARPU) && defined(MPI)
     starsh_blrm__dsdd_mpi_starpu, starsh_blrm__dsdd_mpi_starpu,
     starsh_blrm__dqp3_mpi_starpu, starsh_blrm__drsdd_mpi_starpu,
-    starsh_blrm__drsdd_mpi_starpu
+    starsh_blrm__drsdd_mpi_starpu, starsh_blrm__drsdd_mpi_starpu,
+    starsh_blrm__drsdd_mpi_starpu, starsh_blrm__drsdd_mpi_starpu
     #endif
 };
 
@@ -143,3 +168,41 @@ static STARSH_blrm_approximate *(*dlr[BACKEND_NUM]) =
     dlr_seq, dlr_omp, dlr_mpi, dlr_mpi, dlr_starpu, dlr_starpu_mpi
 };
 
+//! Array of approximation functions of complex problems for SEQUENTIAL
+//! backend. Only randomized SVD supports complex problems, so it is used
+//! with any low-rank engine.
+static STARSH_blrm_approximate *(zlr_seq[LRENGINE_NUM]) =
+{
+    starsh_blrm__zrsdd, starsh_blrm__zrsdd, starsh_blrm__zrsdd,
+    starsh_blrm__zrsdd, starsh_blrm__zrsdd, starsh_blrm__zrsdd,
+    starsh_blrm__zrsdd, starsh_blrm__zrsdd
+};
+
+//! Array of approximation functions of complex problems for OPENMP backend
+static STARSH_blrm_approximate *(zlr_omp[LRENGINE_NUM]) =
+{
+    #ifdef OPENMP
+    starsh_blrm__zrsdd_omp, starsh_blrm__zrsdd_omp, starsh_blrm__zrsdd_omp,
+    starsh_blrm__zrsdd_omp, starsh_blrm__zrsdd_omp, starsh_blrm__zrsdd_omp,
+    starsh_blrm__zrsdd_omp, starsh_blrm__zrsdd_omp
+    #endif
+};
+
+//! Array of approximation functions of complex problems for MPI and
+//! MPI_OPENMP backends
+static STARSH_blrm_approximate *(zlr_mpi[LRENGINE_NUM]) =
+{
+    #ifdef MPI
+    starsh_blrm__zrsdd_mpi, starsh_blrm__zrsdd_mpi, starsh_blrm__zrsdd_mpi,
+    starsh_blrm__zrsdd_mpi, starsh_blrm__zrsdd_mpi, starsh_blrm__zrsdd_mpi,
+    starsh_blrm__zrsdd_mpi, starsh_blrm__zrsdd_mpi
+    #endif
+};
+
+//! Array of approximation functions of complex problems, depending on
+//! backend. StarPU backends do not support complex problems.
+static STARSH_blrm_approximate *(*zlr[BACKEND_NUM]) =
+{
+    zlr_seq, zlr_omp, zlr_mpi, zlr_mpi, dlr_none, dlr_none
+};
+
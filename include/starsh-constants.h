@@ -55,6 +55,23 @@ enum STARSH_LRENGINE
     //!< Randomized SVD
     STARSH_LRENGINE_CROSS = 4,
     //!< Cross approximation
+    STARSH_LRENGINE_ID = 5,
+    //!< Interpolative decomposition, storing skeleton rows
+    STARSH_LRENGINE_CHEB = 6,
+    //!< Polynomial interpolation of kernel (needs geometry of clusters)
+    STARSH_LRENGINE_AUTO = 7,
+    //!< Choice of DCSVD, RSVD or CROSS for each tile separately
+};
+
+//! Enum for the way error tolerance is applied
+enum STARSH_TOLMODE
+{
+    STARSH_TOLMODE_NOTSELECTED = -1,
+    //!< Mode has not been yet selected
+    STARSH_TOLMODE_TILE = 0,
+    //!< Relative error of each tile
+    STARSH_TOLMODE_GLOBAL = 1
+    //!< Relative error of the whole matrix, distributed among tiles
 };
 
 //! Enum for error codes
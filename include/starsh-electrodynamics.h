@@ -56,7 +56,9 @@ enum STARSH_ELECTRODYNAMICS_KERNEL
  * starsh_eddata_block_sin_kernel_nd(),
  * starsh_eddata_block_cos_kernel_nd(),
  * starsh_eddata_block_sin_kernel_nd_simd(),
- * starsh_eddata_block_cos_kernel_nd_simd().
+ * starsh_eddata_block_cos_kernel_nd_simd(),
+ * starsh_eddata_block_exp_kernel_nd(),
+ * starsh_eddata_block_exp_kernel_nd_simd().
  *
  * @ingroup app-electrodynamics
  * */
@@ -69,6 +71,10 @@ enum STARSH_ELECTRODYNAMICS_KERNEL
     /*!< Helmholtz cos kernel.
      * @sa starsh_eddata_block_cos_kernel_nd().
      * */
+    STARSH_ELECTRODYNAMICS_EXP = 3,
+    /*!< Complex Helmholtz kernel.
+     * @sa starsh_eddata_block_exp_kernel_nd().
+     * */
     STARSH_ELECTRODYNAMICS_SIN_SIMD = 11,
     /*!< Helmholtz sin SIMD kernel.
      * @sa starsh_eddata_block_sin_kernel_nd_simd().
@@ -77,6 +83,10 @@ enum STARSH_ELECTRODYNAMICS_KERNEL
     /*!< Helmholtz cos SIMD kernel.
      * @sa starsh_eddata_block_cos_kernel_nd_simd().
      * */
+    STARSH_ELECTRODYNAMICS_EXP_SIMD = 13,
+    /*!< Complex Helmholtz SIMD kernel.
+     * @sa starsh_eddata_block_exp_kernel_nd_simd().
+     * */
 };
 
 enum STARSH_ELECTRODYNAMICS_PARAM
@@ -179,6 +189,54 @@ void starsh_eddata_block_cos_kernel_nd_simd(int nrows, int ncols,
         STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
         void *result, int ld);
 
+void starsh_eddata_block_exp_kernel_1d(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld);
+void starsh_eddata_block_exp_kernel_2d(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld);
+void starsh_eddata_block_exp_kernel_3d(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld);
+void starsh_eddata_block_exp_kernel_4d(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld);
+void starsh_eddata_block_exp_kernel_nd(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld);
+
+void starsh_eddata_block_exp_kernel_1d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_exp_kernel_2d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_exp_kernel_3d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_exp_kernel_4d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_exp_kernel_nd_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+
+void starsh_eddata_block_sincos_kernel_1d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_sincos_kernel_2d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_sincos_kernel_3d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_sincos_kernel_4d_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+void starsh_eddata_block_sincos_kernel_nd_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
+
 #ifdef __cplusplus
 }
 #endif
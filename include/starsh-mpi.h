@@ -79,6 +79,8 @@ int starsh_blrm__dqp3_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
         int maxrank, double tol, int onfly);
 int starsh_blrm__dna_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
         int maxrank, double tol, int onfly);
+int starsh_blrm__zrsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly);
 
 //! @}
 // End of group
@@ -95,8 +97,15 @@ int starsh_blrm__dna_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
 
 int starsh_blrm__dmml_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
         double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__dmml_plan_mpi(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb);
 int starsh_blrm__dmml_mpi_tlr(STARSH_blrm *matrix, int nrhs, double alpha,
         double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__dmml_trans_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__zmml_mpi(STARSH_blrm *matrix, int nrhs,
+        double _Complex alpha, double _Complex *A, int lda,
+        double _Complex beta, double _Complex *B, int ldb);
 
 //! @}
 // End of group
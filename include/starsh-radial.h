@@ -0,0 +1,87 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file include/starsh-radial.h
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifndef __STARSH_RADIAL_H__
+#define __STARSH_RADIAL_H__
+
+/*! @defgroup app-radial Radial kernels
+ * @ingroup applications
+ * @brief Generic kernels, defined by a user-provided radial function.
+ *
+ * @ref STARSH_raddata holds all the necessary data. User provides only a
+ * function \f$ \phi(r) \f$ of a distance, and starsh_raddata_block_kernel()
+ * takes care of gathering coordinates, computing distances and adding a
+ * nugget to diagonal elements.
+ * */
+
+// Add definitions for size_t, va_list, STARSH_kernel and STARSH_particles
+#include "starsh.h"
+#include "starsh-particles.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Scalar radial function \f$ \phi(r) \f$ with parameters `param`.
+//! @ingroup app-radial
+typedef double STARSH_radial_func(double r, void *param);
+
+//! Radial function, applied inplace to `count` distances at once.
+/*! Such a function can be written with vectorized loop, which is not
+ * possible with calls to a scalar @ref STARSH_radial_func.
+ * @ingroup app-radial
+ * */
+typedef void STARSH_radial_batch(int count, double *r, void *param);
+
+typedef struct starsh_raddata
+//! Structure for problems with radial kernels.
+/*! @ingroup app-radial
+ * */
+{
+    STARSH_particles particles;
+    //!< Particles.
+    STARSH_radial_func *phi;
+    //!< Scalar radial function.
+    STARSH_radial_batch *phi_batch;
+    //!< Batched radial function. Used instead of `phi` if not NULL.
+    void *param;
+    //!< Parameters of radial function.
+    double nugget;
+    //!< Value to add to diagonal elements.
+    int gemm_ndim;
+    //!< Minimal dimensionality to compute distances with GEMM.
+    /*!< Distances are computed by formula \f$ \|x\|^2+\|y\|^2-2x^Ty \f$,
+     * where points are shifted by the mean of rows of a block and all the
+     * dot products of a block are computed by a single GEMM.
+     * Default value is @ref STARSH_RADIAL_GEMM_NDIM.
+     * */
+} STARSH_raddata;
+
+//! Default minimal dimensionality to compute distances with GEMM.
+//! @ingroup app-radial
+#define STARSH_RADIAL_GEMM_NDIM 8
+
+int starsh_raddata_init(STARSH_raddata **data, STARSH_int count, int ndim,
+        double *point, STARSH_radial_func *phi, STARSH_radial_batch *phi_batch,
+        void *param, double nugget);
+void starsh_raddata_free(STARSH_raddata *data);
+
+// KERNELS
+
+void starsh_raddata_block_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __STARSH_RADIAL_H__
@@ -46,6 +46,10 @@ typedef struct starsh_mddata
     double denst;
     int mesh_points;
     int mordering;
+    double *point_soa;
+    //!< Coordinates of mesh points, stored dimension by dimension.
+    double scale;
+    //!< Scaling factor of RBF, computed from `rad`, `numobj` and `denst`.
 } STARSH_mddata;
 
 void starsh_generate_3d_virus(int nrows, int ncols,
@@ -56,10 +60,14 @@ void starsh_generate_3d_cube(int nrows, int ncols,
         STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
         void *result, int lda);
 void starsh_generate_3d_virus_rhs(STARSH_int mesh_points, double *A);
+void starsh_generate_3d_rbf_block(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, STARSH_mddata *data, double *A, int lda);
 int starsh_generate_3d_rbf_mesh_coordinates_virus(STARSH_mddata **data, char *file_name, STARSH_int mesh_points, int ndim,
 	int kernel, int numobj, int isreg, double reg, double rad, double denst, int mordering);
 int starsh_generate_3d_rbf_mesh_coordinates_cube(STARSH_mddata **data, STARSH_int mesh_points, int ndim, int kernel,
          int isreg, double reg, double rad, int mordering);
+int starsh_mddata_tlr_support(STARSH_blrf **format, STARSH_problem *problem,
+        char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster);
 void starsh_mddata_free(STARSH_mddata *data);
 
 /* RBF Kernels headers */
@@ -96,6 +96,10 @@ void starsh_ssdata_block_parsimonious_kernel_2d_simd(int nrows, int ncols,
 void starsh_ssdata_block_parsimonious2_kernel_2d_simd(int nrows, int ncols,
         STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
         void *result, int ld);
+
+void starsh_ssdata_block_parsimonious_kernel_nd_tensor(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
 //! @}
 // End of group
 
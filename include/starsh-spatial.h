@@ -59,6 +59,11 @@ typedef struct starsh_ssdata
     //!< Variance for the second variable (in the parsimonious bivariate case).
    double corr;
     //!< spatial range parameter (define the correlation between the two variables in the parsimonious bivariate case).
+    double *sphere;
+    //!< Unit vectors of points on a sphere for great-circle distance.
+    /*!< Coordinates are stored dimension by dimension, like coordinates of
+     * particles. Equal to NULL until computed by starsh_ssdata_gcd_prepare().
+     * */
 } STARSH_ssdata;
 
 enum STARSH_SPATIAL_KERNEL
@@ -188,6 +193,7 @@ int starsh_ssdata_generate_va(STARSH_ssdata **data, STARSH_int count,
 int starsh_ssdata_generate_el(STARSH_ssdata **data, STARSH_int count, ...);
 int starsh_ssdata_get_kernel(STARSH_kernel **kernel, STARSH_ssdata *data,
 	enum STARSH_SPATIAL_KERNEL type);
+int starsh_ssdata_gcd_prepare(STARSH_ssdata *data);
 void starsh_ssdata_free(STARSH_ssdata *data);
 
 // KERNELS
@@ -46,6 +46,8 @@ struct starsh_params
     //!< What low-rank engine to use (e.g. RSVD).
     int oversample;
     //!< Oversampling parameter for RSVD and RRQR.
+    enum STARSH_TOLMODE tolmode;
+    //!< How error tolerance is applied (to each tile or to whole matrix).
 };
 
 //! Built-in parameters of STARS-H, accessible through environment.
@@ -55,6 +57,7 @@ int starsh_init();
 int starsh_set_backend(const char *string);
 int starsh_set_lrengine(const char *string);
 int starsh_set_oversample(const char *string);
+int starsh_set_tolmode(const char *string);
 
 //! @}
 // End of group
@@ -93,6 +96,14 @@ typedef struct starsh_blrf STARSH_blrf;
 //! @ingroup blrm
 typedef struct starsh_blrm STARSH_blrm;
 
+//! Typedef for [block low-rank matrix with shared bases](@ref ::starsh_blrm2)
+//! @ingroup blrm
+typedef struct starsh_blrm2 STARSH_blrm2;
+
+//! Typedef for [plan of multiplication](@ref ::starsh_blrm_mml_plan)
+//! @ingroup matmul
+typedef struct starsh_blrm_mml_plan STARSH_blrm_mml_plan;
+
 
 ///////////////////////////////////////////////////////////////////////////////
 //                               APPLICATIONS                                //
@@ -152,6 +163,10 @@ struct array
     //!< Size of data buffer in bytes.
     void *data;
     //!< Pointer to data buffer.
+    int mapped;
+    //!< Equal to `1` if data buffer is a memory-mapped file.
+    /*!< Such a buffer is unmapped instead of freed by array_free().
+     * */
 };
 
 int array_from_buffer(Array **A, int ndim, int *shape, char dtype, char order,
@@ -159,6 +174,8 @@ int array_from_buffer(Array **A, int ndim, int *shape, char dtype, char order,
 int array_new(Array **A, int ndim, int *shape, char dtype, char order);
 int array_new_like(Array **A, Array *B);
 int array_new_copy(Array **A, Array *B, char order);
+int array_from_file(Array **A, int ndim, int *shape, char dtype, char order,
+        const char *filename);
 void array_free(Array *A);
 void array_info(Array *A);
 void array_print(Array *A);
@@ -247,8 +264,13 @@ void starsh_problem_free(STARSH_problem *problem);
 void starsh_problem_info(STARSH_problem *problem);
 int starsh_problem_get_block(STARSH_problem *problem, int nrows, int ncols,
         STARSH_int *irow, STARSH_int *icol, Array **A);
+void starsh_problem_kernel(STARSH_problem *problem, int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld);
 int starsh_problem_from_array(STARSH_problem **problem, Array *A, char symm);
 int starsh_problem_to_array(STARSH_problem *problem, Array **A);
+int starsh_problem_from_tensor(STARSH_problem **problem,
+        STARSH_problem *tensor);
 
 //! @}
 // End of group
@@ -320,6 +342,22 @@ struct starsh_cluster
      * */
     enum STARSH_CLUSTER_TYPE type;
     //!< Type of cluster (tiled or hierarchical).
+    int ndim;
+    //!< Dimensionality of space of discrete elements.
+    /*!< Equal to `0` if geometry is not set.
+     * */
+    double *point;
+    //!< Coordinates of discrete elements.
+    /*!< `d`-th coordinate of `k`-th discrete element is stored in
+     * `point[d*ndata+k]`. Not owned by the cluster. Equal to `NULL` if
+     * geometry is not set. Set by starsh_cluster_set_geometry().
+     * */
+    double *box;
+    //!< Bounding box of each cluster.
+    /*!< Lower corner of `i`-th bounding box is stored in `box[2*ndim*i]`
+     * and upper corner is stored in `box[2*ndim*i+ndim]`. Equal to `NULL`
+     * if geometry is not set. Set by starsh_cluster_set_geometry().
+     * */
 };
 
 int starsh_cluster_new(STARSH_cluster **cluster, void *data, STARSH_int ndata,
@@ -331,6 +369,8 @@ void starsh_cluster_free(STARSH_cluster *cluster);
 void starsh_cluster_info(STARSH_cluster *cluster);
 int starsh_cluster_new_plain(STARSH_cluster **cluster, void *data,
         STARSH_int ndata, STARSH_int block_size);
+int starsh_cluster_set_geometry(STARSH_cluster *cluster, int ndim,
+        double *point);
 
 //! @}
 // End of group
@@ -478,11 +518,21 @@ int starsh_blrf_new_from_coo(STARSH_blrf **format, STARSH_problem *problem,
         enum STARSH_BLRF_TYPE type);
 int starsh_blrf_new_tlr(STARSH_blrf **format, STARSH_problem *problem,
         char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster);
+int starsh_blrf_new_tlr_eta(STARSH_blrf **format, STARSH_problem *problem,
+        char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster,
+        double eta);
 void starsh_blrf_free(STARSH_blrf *format);
 void starsh_blrf_info(STARSH_blrf *format);
 void starsh_blrf_print(STARSH_blrf *format);
 int starsh_blrf_get_block(STARSH_blrf *format, STARSH_int i, STARSH_int j,
         int *shape, void **D);
+int starsh_blrf_dnorm_estimate(STARSH_blrf *format, int nsamples,
+        double *norm);
+int starsh_blrf_dtol_norm(STARSH_blrf *format, double *norm);
+double starsh_blrf_dtile_tol(STARSH_blrf *format, double norm, double tol,
+        STARSH_int i, STARSH_int j);
+int starsh_blrf__bcol_list(STARSH_int nbcols, STARSH_int nblocks,
+        STARSH_int *block, STARSH_int **bcol_start, STARSH_int **bcol);
 
 //! @}
 // End of group
@@ -516,7 +566,15 @@ struct starsh_blrm
     Array **far_V;
     //!< Low rank factor of each far-field block.
     /*!< Multiplication of `far_U[i]` by transposed `far_V[i]` is an
-     * approximation of `i`-th far-field block.
+     * approximation of `i`-th far-field block. Equal to NULL if matrix keeps
+     * skeleton rows `far_skel` instead.
+     * */
+    int **far_skel;
+    //!< Skeleton rows of each far-field block.
+    /*!< If not NULL, `far_V[i]` is not stored, but it is a transposed
+     * submatrix of `i`-th far-field block on rows `far_skel[i]`, generated on
+     * demand by @ref starsh_blrm__dget_far_V(). Indexes start from 0 for each
+     * block row.
      * */
     int onfly;
     //!< Equal to `1` to store dense blocks, `0` to compute it on demand.
@@ -526,13 +584,22 @@ struct starsh_blrm
     //!< Pointer to memory buffer, holding all `far_U`.
     void *alloc_V;
     //!< Pointer to memory buffer, holding all `far_V`.
+    void *alloc_skel;
+    //!< Pointer to memory buffer, holding all `far_skel`.
     void *alloc_D;
     //!< Pointer to memory buffer, holding all `near_D`.
     char alloc_type;
     //!< Type of memory allocation.
     /*!< Equal to `1` if allocating 3 big buffers `U_alloc`, `V_alloc` and
      * `D_alloc`; `2` if allocating many small buffers for each `far_U`,
-     * `far_V` and `near_D`.
+     * `far_V` and `near_D`; `3` if allocating big buffers `U_alloc` and
+     * `V_alloc` and a small buffer for each `near_D`, so that dense blocks
+     * computed during approximation are kept without copying.
+     * */
+    int *far_engine;
+    //!< Low-rank engine, used for each far-field block.
+    /*!< Only set by @ref STARSH_LRENGINE_AUTO engine, NULL otherwise. Values
+     * are of @ref STARSH_LRENGINE type.
      * */
     size_t nbytes;
     //!< Total size of block low-rank matrix, including auxiliary buffers.
@@ -543,10 +610,74 @@ struct starsh_blrm
 int starsh_blrm_new(STARSH_blrm **matrix, STARSH_blrf *format, int *far_rank,
         Array **far_U, Array **far_V, int onfly, Array **near_D, void *alloc_U,
         void *alloc_V, void *alloc_D, char alloc_type);
+int starsh_blrm_new_skel(STARSH_blrm **matrix, STARSH_blrf *format,
+        int *far_rank, Array **far_U, int **far_skel, int onfly,
+        Array **near_D, void *alloc_U, void *alloc_skel, void *alloc_D,
+        char alloc_type);
 void starsh_blrm_free(STARSH_blrm *matrix);
 void starsh_blrm_info(STARSH_blrm *matrix);
 int starsh_blrm_get_block(STARSH_blrm *matrix, STARSH_int i, STARSH_int j,
         int *shape, int *rank, void **U, void **V, void **D);
+int starsh_blrm__dget_far_V(STARSH_blrm *matrix, STARSH_int bi, double *V);
+
+struct starsh_blrm2
+//! Block low-rank matrix with shared bases of block rows and block columns.
+/*! Each far-field block `(i,j)` is approximated by `row_basis[i]*far_S[k]*
+ * col_basis[j]^T`, where bases are orthonormal and shared by all far-field
+ * blocks of the same block row or block column, and only small coupling
+ * matrix `far_S[k]` is stored for each block. Blocks, for which it does not
+ * save memory, keep low-rank factors `far_U[k]*far_V[k]^T` instead. Such a
+ * matrix is obtained by recompression of @ref STARSH_blrm by
+ * starsh_blrm__dshared().
+ * */
+{
+    STARSH_blrf *format;
+    //!< Pointer to block low-rank format.
+    int *row_rank;
+    //!< Rank of shared basis of each block row.
+    int *col_rank;
+    //!< Rank of shared basis of each block column.
+    /*!< Equal to `row_rank` in case of symmetric format.
+     * */
+    double **row_basis;
+    //!< Orthonormal shared basis of each block row.
+    double **col_basis;
+    //!< Orthonormal shared basis of each block column.
+    /*!< Equal to `row_basis` in case of symmetric format.
+     * */
+    double **far_S;
+    //!< Coupling matrix of each far-field block.
+    /*!< Equal to NULL for blocks, that keep their own low-rank factors.
+     * */
+    int *far_rank;
+    //!< Rank of each far-field block, that keeps its own low-rank factors.
+    double **far_U;
+    //!< Low-rank factor `U` of each far-field block without coupling matrix.
+    /*!< Coupling matrix is not stored if it is not smaller than low-rank
+     * factors of a block. Equal to NULL for all the other blocks.
+     * */
+    double **far_V;
+    //!< Low-rank factor `V` of each far-field block without coupling matrix.
+    int onfly;
+    //!< Equal to `1` to store dense blocks, `0` to compute it on demand.
+    double **near_D;
+    //!< Array of pointers to dense near-field blocks.
+    size_t nbytes;
+    //!< Total size of matrix, including auxiliary buffers.
+    size_t data_nbytes;
+    //!< Size of bases, coupling matrices and dense blocks.
+};
+
+int starsh_blrm2__new_empty(STARSH_blrm2 **matrix, STARSH_blrf *format,
+        int onfly);
+void starsh_blrm2_free(STARSH_blrm2 *matrix);
+void starsh_blrm2_info(STARSH_blrm2 *matrix);
+int starsh_blrm__dshared(STARSH_blrm2 **matrix2, STARSH_blrm *matrix,
+        double tol);
+int starsh_blrm2__dmml(STARSH_blrm2 *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm2__dmml_omp(STARSH_blrm2 *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb);
 
 //! @}
 // End of group
@@ -576,6 +707,21 @@ int starsh_blrm__drsdd(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
         double tol, int onfly);
 int starsh_blrm__dqp3(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
         double tol, int onfly);
+int starsh_blrm__did(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
+        double tol, int onfly);
+int starsh_blrm__dcheb(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly);
+int starsh_blrm__dauto(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
+        double tol, int onfly);
+int starsh_blrm__dnew_far(STARSH_blrm **matrix, STARSH_blrf *format,
+        int *far_rank, Array **far_U, Array **far_V, int *far_engine,
+        double **false_far_D, int onfly, double *alloc_U, double *alloc_V);
+int starsh_blrm__dauto_cost(STARSH_blrf *format, double *kernel_cost,
+        double *flop_cost);
+int starsh_blrm__dauto_select(int nrows, int ncols, int maxrank,
+        int oversample, double rank, double kernel_cost, double flop_cost);
+int starsh_blrm__dcheb_basis(STARSH_cluster *cluster, int p, double **Q,
+        double **R, STARSH_int **skel, int **rank);
 //int starsh_blrm__dna(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
 //        double tol, int onfly);
 
@@ -585,6 +731,19 @@ int starsh_blrm__drsdd_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         int maxrank, double tol, int onfly);
 int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         int maxrank, double tol, int onfly);
+int starsh_blrm__did_omp(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly);
+int starsh_blrm__dauto_omp(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly);
+int starsh_blrm__dcheb_omp(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly);
+int starsh_blrm__dnew_far_omp(STARSH_blrm **matrix, STARSH_blrf *format,
+        int *far_rank, Array **far_U, Array **far_V, int *far_engine,
+        double **false_far_D, int onfly, double *alloc_U, double *alloc_V);
+int starsh_blrm__zrsdd(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
+        double tol, int onfly);
+int starsh_blrm__zrsdd_omp(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly);
 //int starsh_blrm__dna_omp(STARSH_blrm **matrix, STARSH_blrf *format,
 //        int maxrank, double tol, int onfly);
 
@@ -603,10 +762,119 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
 //! @{
 // This will automatically include all entities between @{ and @} into group.
 
+struct starsh_blrm_mml_plan
+//! Precomputed plan of multiplication of H-matrix by dense matrix.
+/*! Keeps temporary buffers of all threads, so that repeated multiplications
+ * by the same matrix, e.g. in iterative solvers, do not allocate memory.
+ * Plan is owned by its caller and must not be executed by several threads at
+ * once, since buffers are shared by all executions.
+ * */
+{
+    STARSH_blrm *matrix;
+    //!< Pointer to block low-rank matrix.
+    int nrhs;
+    //!< Maximum number of right hand sides.
+    int mpi;
+    //!< Equal to `1` if only local blocks of MPI node are multiplied.
+    int num_threads;
+    //!< Number of OpenMP threads, for which buffers are allocated.
+    size_t size_D;
+    //!< Size of temporary buffer of each thread for blocks.
+    double *temp_D;
+    //!< Temporary buffers of all threads for blocks.
+    double *temp_B;
+    //!< Private copies of result of all threads.
+    int *panel_rank;
+    //!< Total rank of each block row, followed by each block column.
+    /*!< Equal to NULL if far-field blocks are multiplied one by one.
+     * Otherwise all far-field blocks of each block row (block column) are
+     * multiplied together, and factors, which are adjacent in memory, are
+     * multiplied by a single GEMM.
+     * */
+    double **panel_W;
+    //!< Concatenated factors of each block row, followed by each block column.
+    /*!< Panel of a block column consists of factors `V` of its far-field
+     * blocks and, in case of symmetric matrix, of factors `U` of transposed
+     * blocks, so that all of them are multiplied by corresponding rows of
+     * right hand sides by a single GEMM. Panel of a block row consists of
+     * factors `U` of its far-field blocks and is used by transposed
+     * multiplication of nonsymmetric matrix. Points to factors of the matrix
+     * if they are adjacent in memory and to their copies in `panel_buf`
+     * otherwise. Equal to NULL for empty and unused panels.
+     * */
+    double *panel_buf;
+    //!< Copies of factors of panels, which are not adjacent in memory.
+    size_t *panel_offset;
+    //!< Offset of product of each panel by right hand sides in `temp_T`.
+    int *far_pos;
+    //!< Positions of factors `V` and `U` of each far-field block in panels.
+    double *temp_T;
+    //!< Products of all panels by right hand sides.
+    double **far_V;
+    //!< Low-rank factor `V` of each far-field block.
+    /*!< Points to stored factor `V` or, if only skeleton rows are stored,
+     * to factor `V`, computed once by starsh_blrm_mml_plan_create_panel().
+     * */
+    double *skel_V;
+    //!< Buffer for factors `V`, computed from skeleton rows.
+    STARSH_int *bcol_far_start;
+    //!< Start of list of far-field blocks of each block column.
+    /*!< Set only for panels of symmetric matrix, since lists `bcol_far` and
+     * `bcol_near` of symmetric @ref STARSH_blrf are aliases of lists of block
+     * rows. Equal to NULL otherwise.
+     * */
+    STARSH_int *bcol_far;
+    //!< Stored far-field blocks of each block column of symmetric matrix.
+    STARSH_int *bcol_near_start;
+    //!< Start of list of near-field blocks of each block column.
+    STARSH_int *bcol_near;
+    //!< Stored near-field blocks of each block column of symmetric matrix.
+    int **sparse_ptr;
+    //!< Row pointers of near-field blocks, stored in CSR format.
+    /*!< Equal to NULL if all near-field blocks are multiplied as dense
+     * blocks. Otherwise `sparse_ptr[i]` is NULL for dense near-field block
+     * and row pointers of CSR copy of `i`-th near-field block are stored in
+     * it otherwise. Set by starsh_blrm_mml_plan_sparse().
+     * */
+    int **sparse_ind;
+    //!< Column indexes of nonzero elements of CSR near-field blocks.
+    double **sparse_val;
+    //!< Values of nonzero elements of CSR near-field blocks.
+};
+
+int starsh_blrm_mml_plan_create(STARSH_blrm_mml_plan **plan,
+        STARSH_blrm *matrix, int nrhs);
+int starsh_blrm_mml_plan_create_panel(STARSH_blrm_mml_plan **plan,
+        STARSH_blrm *matrix, int nrhs);
+int starsh_blrm__mml_plan_new(STARSH_blrm_mml_plan **plan,
+        STARSH_blrm *matrix, int nrhs, int mpi);
+int starsh_blrm__mml_plan_panel(STARSH_blrm_mml_plan *plan);
+int starsh_blrm_mml_plan_execute(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm_mml_plan_execute_trans(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm_mml_plan_sparse(STARSH_blrm_mml_plan *plan, double fill);
+void starsh_blrm_mml_plan_destroy(STARSH_blrm_mml_plan *plan);
+int starsh_blrm__dmml_plan_omp(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__dmml_panel_omp(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__dmml_trans_panel_omp(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb);
 int starsh_blrm__dmml(STARSH_blrm *matrix, int nrhs, double alpha,
         double *A, int lda, double beta, double *B, int ldb);
 int starsh_blrm__dmml_omp(STARSH_blrm *matrix, int nrhs, double alpha,
         double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__dmml_trans(STARSH_blrm *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__dmml_trans_omp(STARSH_blrm *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb);
+int starsh_blrm__zmml(STARSH_blrm *matrix, int nrhs, double _Complex alpha,
+        double _Complex *A, int lda, double _Complex beta, double _Complex *B,
+        int ldb);
+int starsh_blrm__zmml_omp(STARSH_blrm *matrix, int nrhs,
+        double _Complex alpha, double _Complex *A, int lda,
+        double _Complex beta, double _Complex *B, int ldb);
 
 //! @}
 // End of group
@@ -651,9 +919,34 @@ void starsh_dense_dlrsdd(int nrows, int ncols, double *D, int ldD, double *U,
 void starsh_dense_dlrrsdd(int nrows, int ncols, double *D, int ldD, double *U,
         int ldU, double *V, int ldV, int *rank, int maxrank, int oversample,
         double tol, double *work, int lwork, int *iwork);
+int starsh_dense_dlrrsdd_grow(int nrows, int ncols, double *D, int ldD,
+        double **U, double **V, int *rank, int oversample, double tol);
+int starsh_dense_zlrrsdd(int nrows, int ncols, double _Complex *D, int ldD,
+        double _Complex *U, int ldU, double _Complex *V, int ldV, int *rank,
+        int maxrank, int oversample, double tol, double _Complex *work,
+        int lwork, double *rwork, int *iwork);
 void starsh_dense_dlrqp3(int nrows, int ncols, double *D, int ldD, double *U,
         int ldU, double *V, int ldV, int *rank, int maxrank, int oversample,
         double tol, double *work, int lwork, int *iwork);
+void starsh_dense_dlrid(int nrows, int ncols, double *D, int ldD, double *U,
+        int ldU, int *skel, int *rank, int maxrank, double tol, double *work,
+        int lwork, int *iwork);
+void starsh_dense_dchebnodes(int ndim, int p, const double *box, double *node,
+        STARSH_int ldnode);
+void starsh_dense_dchebbasis(int npoints, int ndim, int p, const double *box,
+        const double *point, STARSH_int ldpoint, double *S, int ldS);
+void starsh_dense_dlrcheb(int nrows, int ncols, int krow, int kcol,
+        double *core, double *Qrow, double *Rrow, double *Qcol, double *Rcol,
+        double *U, int ldU, double *V, int ldV, int *rank, int maxrank,
+        double tol, double *work, int lwork, int *iwork);
+void starsh_dense_dlrcheb_check(int nrows, int ncols, STARSH_kernel *kernel,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        double *U, int ldU, double *V, int ldV, int *rank, double tol,
+        int nsample, double *work, STARSH_int *iwork);
+void starsh_dense_dlraca(int nrows, int ncols, STARSH_kernel *kernel,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        double *U, int ldU, double *V, int ldV, int *rank, int maxrank,
+        double tol, int *iwork);
 void starsh_dense_dlrna(int nrows, int ncols, double *D, double *U, double *V,
         int *rank, int maxrank, double tol, double *work, int lwork,
         int *iwork);
@@ -674,6 +967,15 @@ void starsh_dense_dlrna(int nrows, int ncols, double *D, double *U, double *V,
 
 int starsh_itersolvers__dcg_omp(STARSH_blrm *matrix, int nrhs, double *B,
         int ldb, double *X, int ldx, double tol, double *work);
+int starsh_itersolvers__dbcg_omp(STARSH_blrm *matrix, int nrhs, double *B,
+        int ldb, double *X, int ldx, double tol, double *work);
+int starsh_itersolvers__dgmres_omp(STARSH_blrm *matrix, int nrhs, double *B,
+        int ldb, double *X, int ldx, double tol, int restart, double *work);
+int starsh_itersolvers__dbicgstab_omp(STARSH_blrm *matrix, int nrhs,
+        double *B, int ldb, double *X, int ldx, double tol, double *work);
+int starsh_itersolvers__zgmres_omp(STARSH_blrm *matrix, int nrhs,
+        double _Complex *B, int ldb, double _Complex *X, int ldx, double tol,
+        int restart, double _Complex *work);
 
 //! @}
 // End of group
@@ -272,6 +272,12 @@ static int starsh_eddata_get_kernel_1d(STARSH_kernel **kernel,
         case STARSH_ELECTRODYNAMICS_COS_SIMD:
             *kernel = starsh_eddata_block_cos_kernel_1d_simd;
             break;
+        case STARSH_ELECTRODYNAMICS_EXP:
+            *kernel = starsh_eddata_block_exp_kernel_1d;
+            break;
+        case STARSH_ELECTRODYNAMICS_EXP_SIMD:
+            *kernel = starsh_eddata_block_exp_kernel_1d_simd;
+            break;
         default:
             STARSH_ERROR("Wrong type of kernel");
             return STARSH_WRONG_PARAMETER;
@@ -298,6 +304,12 @@ static int starsh_eddata_get_kernel_2d(STARSH_kernel **kernel,
         case STARSH_ELECTRODYNAMICS_COS_SIMD:
             *kernel = starsh_eddata_block_cos_kernel_2d_simd;
             break;
+        case STARSH_ELECTRODYNAMICS_EXP:
+            *kernel = starsh_eddata_block_exp_kernel_2d;
+            break;
+        case STARSH_ELECTRODYNAMICS_EXP_SIMD:
+            *kernel = starsh_eddata_block_exp_kernel_2d_simd;
+            break;
         default:
             STARSH_ERROR("Wrong type of kernel");
             return STARSH_WRONG_PARAMETER;
@@ -324,6 +336,12 @@ static int starsh_eddata_get_kernel_3d(STARSH_kernel **kernel,
         case STARSH_ELECTRODYNAMICS_COS_SIMD:
             *kernel = starsh_eddata_block_cos_kernel_3d_simd;
             break;
+        case STARSH_ELECTRODYNAMICS_EXP:
+            *kernel = starsh_eddata_block_exp_kernel_3d;
+            break;
+        case STARSH_ELECTRODYNAMICS_EXP_SIMD:
+            *kernel = starsh_eddata_block_exp_kernel_3d_simd;
+            break;
         default:
             STARSH_ERROR("Wrong type of kernel");
             return STARSH_WRONG_PARAMETER;
@@ -350,6 +368,12 @@ static int starsh_eddata_get_kernel_4d(STARSH_kernel **kernel,
         case STARSH_ELECTRODYNAMICS_COS_SIMD:
             *kernel = starsh_eddata_block_cos_kernel_4d_simd;
             break;
+        case STARSH_ELECTRODYNAMICS_EXP:
+            *kernel = starsh_eddata_block_exp_kernel_4d;
+            break;
+        case STARSH_ELECTRODYNAMICS_EXP_SIMD:
+            *kernel = starsh_eddata_block_exp_kernel_4d_simd;
+            break;
         default:
             STARSH_ERROR("Wrong type of kernel");
             return STARSH_WRONG_PARAMETER;
@@ -376,6 +400,12 @@ static int starsh_eddata_get_kernel_nd(STARSH_kernel **kernel,
         case STARSH_ELECTRODYNAMICS_COS_SIMD:
             *kernel = starsh_eddata_block_cos_kernel_nd_simd;
             break;
+        case STARSH_ELECTRODYNAMICS_EXP:
+            *kernel = starsh_eddata_block_exp_kernel_nd;
+            break;
+        case STARSH_ELECTRODYNAMICS_EXP_SIMD:
+            *kernel = starsh_eddata_block_exp_kernel_nd_simd;
+            break;
         default:
             STARSH_ERROR("Wrong type of kernel");
             return STARSH_WRONG_PARAMETER;
@@ -397,7 +427,9 @@ int starsh_eddata_get_kernel(STARSH_kernel **kernel, STARSH_eddata *data,
  * @sa starsh_eddata_block_sin_kernel_nd(),
  *      starsh_eddata_block_sin_kernel_nd_simd(),
  *      starsh_eddata_block_cos_kernel_nd(),
- *      starsh_eddata_block_cos_kernel_nd_simd().
+ *      starsh_eddata_block_cos_kernel_nd_simd(),
+ *      starsh_eddata_block_exp_kernel_nd(),
+ *      starsh_eddata_block_exp_kernel_nd_simd().
  * @ingroup app-electrodynamics
  * */
 {
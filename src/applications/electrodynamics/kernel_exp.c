@@ -0,0 +1,334 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @generate NDIM -> n 1 2 3 4
+ * Generate different functions for different dimensions. This hack improves
+ * performance in certain cases. Value 'n' stands for general case, whereas all
+ * other values correspond to static values of dimensionality.
+ * During code generation step, each appearance of @NDIM (including this one)
+ * will be replace by proposed values. If you want to use this file outside
+ * STARS-H, simply do substitutions yourself.
+ *
+ * @file src/applications/electrodynamics/kernel_exp.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ */
+
+#include "common.h"
+#include "starsh.h"
+#include "starsh-electrodynamics.h"
+
+// If dimensionality is static
+#if (@NDIM != n)
+//! Replace variable ndim with static integer value
+#define ndim @NDIM
+#endif
+
+//! Number of rows, processed at once by SIMD kernels.
+#define CHUNK 64
+//! Arguments of sin and cos, which are reduced by a fast path.
+#define MAX_REDUCE 1e6
+
+static void sincos_chunk(int n, const double *x, double *s, double *c)
+// Compute sin and cos of `n` arguments at once. Arguments are reduced to
+// [-pi/4, pi/4] by 3-part Cody-Waite reduction, which is exact for
+// arguments up to MAX_REDUCE, and then polynomials of fdlibm are evaluated.
+// All the branches are replaced by selects, so that the loop is vectorized.
+// Larger arguments are passed to sin() and cos() after the loop.
+{
+    const double invpio2 = 6.36619772367581382433e-01;
+    const double pio2_1 = 1.57079632673412561417e+00;
+    const double pio2_2 = 6.07710050630396597660e-11;
+    const double pio2_3 = 2.02226624871116645580e-21;
+    // Adding and subtracting this constant rounds to nearest integer
+    const double shift = 6755399441055744.0;
+    int i;
+    double maxarg = 0.;
+    #pragma omp simd reduction(max:maxarg)
+    for(i = 0; i < n; i++)
+    {
+        double fn = (x[i]*invpio2+shift)-shift;
+        double r = ((x[i]-fn*pio2_1)-fn*pio2_2)-fn*pio2_3;
+        double z = r*r;
+        double ps = r+r*z*(-1.66666666666666324348e-01+z*(
+                    8.33333333332248946124e-03+z*(-1.98412698298579493134e-04+
+                    z*(2.75573137070700676789e-06+z*(
+                    -2.50507602534068634195e-08+z*1.58969099521155010221e-10)
+                    ))));
+        double pc = 1.0-0.5*z+z*z*(4.16666666666666019037e-02+z*(
+                    -1.38888888888741095749e-03+z*(2.48015872894767294178e-05+
+                    z*(-2.75573143513906633035e-07+z*(
+                    2.08757232129817482790e-09-z*1.13596475577881948265e-11)
+                    ))));
+        // Quadrant of argument is kept in floating point to keep all the
+        // operations of the same width
+        double q = fn-4.0*floor(0.25*fn);
+        double ss = (q == 1. || q == 3.) ? pc : ps;
+        double cc = (q == 1. || q == 3.) ? ps : pc;
+        s[i] = q >= 2. ? -ss : ss;
+        c[i] = (q == 1. || q == 2.) ? -cc : cc;
+        double absx = fabs(x[i]);
+        maxarg = maxarg > absx ? maxarg : absx;
+    }
+    if(maxarg > MAX_REDUCE)
+        for(i = 0; i < n; i++)
+            if(fabs(x[i]) > MAX_REDUCE)
+            {
+                s[i] = sin(x[i]);
+                c[i] = cos(x[i]);
+            }
+}
+
+void starsh_eddata_block_exp_kernel_@NDIMd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld)
+//! Complex Helmholtz kernel for @NDIM-dimensional electrodynamics problem.
+/*! Fills complex matrix \f$ A \f$ with values
+ * \f[
+ *      A_{ij} = \frac{e^{i k r_{ij}}}{r_{ij}},
+ * \f]
+ * \f$ r_{ij} \f$ is a distance between \f$i\f$-th and \f$j\f$-th spatial
+ * points and \f$ k \f$ is a wave number. Real part of diagonal elements is
+ * equal to `diag` and imaginary part is equal to \f$ k \f$, which is a limit
+ * of \f$ sin(k r)/r \f$. No memory is allocated in this function!
+ *
+ * @param[in] nrows: Number of rows of \f$ A \f$.
+ * @param[in] ncols: Number of columns of \f$ A \f$.
+ * @param[in] irow: Array of row indexes.
+ * @param[in] icol: Array of column indexes.
+ * @param[in] row_data: Pointer to physical data (@ref STARSH_eddata object).
+ * @param[in] col_data: Pointer to physical data (@ref STARSH_eddata object).
+ * @param[out] result: Pointer to memory of \f$ A \f$.
+ * @param[in] ld: Leading dimension of `result`.
+ * @sa starsh_eddata_block_exp_kernel_1d(),
+ *      starsh_eddata_block_exp_kernel_2d(),
+ *      starsh_eddata_block_exp_kernel_3d(),
+ *      starsh_eddata_block_exp_kernel_4d(),
+ *      starsh_eddata_block_exp_kernel_nd().
+ * @ingroup app-electrodynamics-kernels
+ * */
+{
+    int i, j, k;
+    STARSH_eddata *data1 = row_data;
+    STARSH_eddata *data2 = col_data;
+    double tmp, dist;
+    // Read parameters
+// If dimensionality is not static
+#if (@NDIM == n)
+    int ndim = data1->particles.ndim;
+#endif
+    // Get coordinates
+    STARSH_int count1 = data1->particles.count;
+    STARSH_int count2 = data2->particles.count;
+    double *x1[ndim], *x2[ndim];
+    double wave_k = data1->k;
+    double diag = data1->diag;
+    x1[0] = data1->particles.point;
+    x2[0] = data2->particles.point;
+    for(i = 1; i < ndim; i++)
+    {
+        x1[i] = x1[0]+i*count1;
+        x2[i] = x2[0]+i*count2;
+    }
+    double _Complex *buffer = result;
+    // Fill column-major matrix
+    for(j = 0; j < ncols; j++)
+    {
+        for(i = 0; i < nrows; i++)
+        {
+            dist = 0.0;
+            for(k = 0; k < ndim; k++)
+            {
+                tmp = x1[k][irow[i]]-x2[k][icol[j]];
+                dist += tmp*tmp;
+            }
+            if(dist == 0)
+                buffer[j*(size_t)ld+i] = diag+wave_k*I;
+            else
+            {
+                dist = sqrt(dist);
+                buffer[j*(size_t)ld+i] = (cos(wave_k*dist)+
+                        sin(wave_k*dist)*I)/dist;
+            }
+        }
+    }
+}
+
+void starsh_eddata_block_exp_kernel_@NDIMd_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld)
+//! Complex Helmholtz kernel for @NDIM-dimensional electrodynamics problem.
+/*! Fills complex matrix \f$ A \f$ with values
+ * \f[
+ *      A_{ij} = \frac{e^{i k r_{ij}}}{r_{ij}},
+ * \f]
+ * \f$ r_{ij} \f$ is a distance between \f$i\f$-th and \f$j\f$-th spatial
+ * points and \f$ k \f$ is a wave number. Real part of diagonal elements is
+ * equal to `diag` and imaginary part is equal to \f$ k \f$, which is a limit
+ * of \f$ sin(k r)/r \f$. No memory is allocated in this function!
+ *
+ * Uses SIMD instructions. Each column is processed by chunks of rows: first,
+ * distances are computed, then sin and cos of all the chunk are computed at
+ * once by a vectorized loop with a shared range reduction.
+ *
+ * @param[in] nrows: Number of rows of \f$ A \f$.
+ * @param[in] ncols: Number of columns of \f$ A \f$.
+ * @param[in] irow: Array of row indexes.
+ * @param[in] icol: Array of column indexes.
+ * @param[in] row_data: Pointer to physical data (@ref STARSH_eddata object).
+ * @param[in] col_data: Pointer to physical data (@ref STARSH_eddata object).
+ * @param[out] result: Pointer to memory of \f$ A \f$.
+ * @param[in] ld: Leading dimension of `result`.
+ * @sa starsh_eddata_block_exp_kernel_1d_simd(),
+ *      starsh_eddata_block_exp_kernel_2d_simd(),
+ *      starsh_eddata_block_exp_kernel_3d_simd(),
+ *      starsh_eddata_block_exp_kernel_4d_simd(),
+ *      starsh_eddata_block_exp_kernel_nd_simd().
+ * @ingroup app-electrodynamics-kernels
+ * */
+{
+    int i, j, k, m;
+    STARSH_eddata *data1 = row_data;
+    STARSH_eddata *data2 = col_data;
+    // Read parameters
+// If dimensionality is not static
+#if (@NDIM == n)
+    int ndim = data1->particles.ndim;
+#endif
+    // Get coordinates
+    STARSH_int count1 = data1->particles.count;
+    STARSH_int count2 = data2->particles.count;
+    double *x1[ndim], *x2[ndim];
+    double wave_k = data1->k;
+    double diag = data1->diag;
+    x1[0] = data1->particles.point;
+    x2[0] = data2->particles.point;
+    for(i = 1; i < ndim; i++)
+    {
+        x1[i] = x1[0]+i*count1;
+        x2[i] = x2[0]+i*count2;
+    }
+    // Real and imaginary parts are stored one after another
+    double *buffer = result;
+    double dist[CHUNK], arg[CHUNK], s[CHUNK], c[CHUNK];
+    // Fill column-major matrix
+    for(j = 0; j < ncols; j++)
+    {
+        double *out = buffer+2*j*(size_t)ld;
+        for(i = 0; i < nrows; i += CHUNK)
+        {
+            int n = nrows-i < CHUNK ? nrows-i : CHUNK;
+            #pragma omp simd
+            for(m = 0; m < n; m++)
+            {
+                double tmp, d = 0.0;
+                for(k = 0; k < ndim; k++)
+                {
+                    tmp = x1[k][irow[i+m]]-x2[k][icol[j]];
+                    d += tmp*tmp;
+                }
+                dist[m] = sqrt(d);
+                arg[m] = wave_k*dist[m];
+            }
+            sincos_chunk(n, arg, s, c);
+            #pragma omp simd
+            for(m = 0; m < n; m++)
+            {
+                double inv = 1.0/dist[m];
+                out[2*(i+m)] = dist[m] == 0. ? diag : c[m]*inv;
+                out[2*(i+m)+1] = dist[m] == 0. ? wave_k : s[m]*inv;
+            }
+        }
+    }
+}
+
+void starsh_eddata_block_sincos_kernel_@NDIMd_simd(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld)
+//! Helmholtz sin and cos for @NDIM-dimensional electrodynamics problem.
+/*! Computes the same values as starsh_eddata_block_sin_kernel_@NDIMd() and
+ * starsh_eddata_block_cos_kernel_@NDIMd(), but distances and range reduction
+ * are computed only once for both outputs. Result is a tensor of shape
+ * `(nrows, 2, ncols)` in Fortran order, where element \f$ (i, 0, j) \f$ is
+ * \f$ sin(k r_{ij})/r_{ij} \f$ and element \f$ (i, 1, j) \f$ is
+ * \f$ cos(k r_{ij})/r_{ij} \f$, stored at `result[i+ld*(a+2*j)]`. Both
+ * outputs are equal to `diag` for zero distance. Use it with a
+ * 3-dimensional @ref STARSH_problem of shape `(N, 2, N)` and
+ * starsh_problem_from_tensor() to get sin and cos parts as a single matrix.
+ * No memory is allocated in this function!
+ *
+ * Uses SIMD instructions.
+ *
+ * @param[in] nrows: Number of rows of \f$ A \f$.
+ * @param[in] ncols: Number of columns of \f$ A \f$.
+ * @param[in] irow: Array of row indexes.
+ * @param[in] icol: Array of column indexes.
+ * @param[in] row_data: Pointer to physical data (@ref STARSH_eddata object).
+ * @param[in] col_data: Pointer to physical data (@ref STARSH_eddata object).
+ * @param[out] result: Pointer to memory of \f$ A \f$.
+ * @param[in] ld: Leading dimension of `result`.
+ * @sa starsh_eddata_block_sincos_kernel_1d_simd(),
+ *      starsh_eddata_block_sincos_kernel_2d_simd(),
+ *      starsh_eddata_block_sincos_kernel_3d_simd(),
+ *      starsh_eddata_block_sincos_kernel_4d_simd(),
+ *      starsh_eddata_block_sincos_kernel_nd_simd().
+ * @ingroup app-electrodynamics-kernels
+ * */
+{
+    int i, j, k, m;
+    STARSH_eddata *data1 = row_data;
+    STARSH_eddata *data2 = col_data;
+    // Read parameters
+// If dimensionality is not static
+#if (@NDIM == n)
+    int ndim = data1->particles.ndim;
+#endif
+    // Get coordinates
+    STARSH_int count1 = data1->particles.count;
+    STARSH_int count2 = data2->particles.count;
+    double *x1[ndim], *x2[ndim];
+    double wave_k = data1->k;
+    double diag = data1->diag;
+    x1[0] = data1->particles.point;
+    x2[0] = data2->particles.point;
+    for(i = 1; i < ndim; i++)
+    {
+        x1[i] = x1[0]+i*count1;
+        x2[i] = x2[0]+i*count2;
+    }
+    double *buffer = result;
+    double dist[CHUNK], arg[CHUNK];
+    // Fill column-major tensor
+    for(j = 0; j < ncols; j++)
+    {
+        double *out_sin = buffer+2*j*(size_t)ld;
+        double *out_cos = out_sin+ld;
+        for(i = 0; i < nrows; i += CHUNK)
+        {
+            int n = nrows-i < CHUNK ? nrows-i : CHUNK;
+            #pragma omp simd
+            for(m = 0; m < n; m++)
+            {
+                double tmp, d = 0.0;
+                for(k = 0; k < ndim; k++)
+                {
+                    tmp = x1[k][irow[i+m]]-x2[k][icol[j]];
+                    d += tmp*tmp;
+                }
+                dist[m] = sqrt(d);
+                arg[m] = wave_k*dist[m];
+            }
+            sincos_chunk(n, arg, out_sin+i, out_cos+i);
+            #pragma omp simd
+            for(m = 0; m < n; m++)
+            {
+                double inv = 1.0/dist[m];
+                out_sin[i+m] = dist[m] == 0. ? diag : out_sin[i+m]*inv;
+                out_cos[i+m] = dist[m] == 0. ? diag : out_cos[i+m]*inv;
+            }
+        }
+    }
+}
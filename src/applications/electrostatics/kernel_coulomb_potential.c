@@ -28,6 +28,35 @@
 #define ndim @NDIM
 #endif
 
+//! Number of rows, gathered at once by SIMD kernels.
+#define CHUNK 256
+
+static inline double coulomb_rsqrt(double x)
+// Reciprocal square root of a nonnegative number, which is zero for zero
+// argument. No division, sqrt() or comparison of floating point numbers is
+// used, so that a loop with it is vectorized even with default trapping math.
+// Initial approximation by integer arithmetic on bits of `x` has relative
+// error below 3.5e-2, and 4 Newton steps bring it to full double accuracy.
+// Zero argument is masked out by integer arithmetic on bits as well.
+// Subnormal arguments (distances below 1e-154) are not supported.
+{
+    uint64_t bits, mask;
+    double y, half = 0.5*x;
+    memcpy(&bits, &x, sizeof(bits));
+    // All ones if x is not zero and all zeros otherwise
+    mask = 0-((bits | (0-bits)) >> 63);
+    bits = 0x5fe6eb50c7b537a9ULL-(bits >> 1);
+    memcpy(&y, &bits, sizeof(y));
+    y = y*(1.5-half*y*y);
+    y = y*(1.5-half*y*y);
+    y = y*(1.5-half*y*y);
+    y = y*(1.5-half*y*y);
+    memcpy(&bits, &y, sizeof(bits));
+    bits &= mask;
+    memcpy(&y, &bits, sizeof(y));
+    return y;
+}
+
 void starsh_esdata_block_coulomb_potential_kernel_@NDIMd(int nrows, int ncols,
         STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
         void *result, int ld)
@@ -109,7 +138,14 @@ void starsh_esdata_block_coulomb_potential_kernel_@NDIMd_simd(int nrows,
  * \f$ r_{ij} \f$ is a distance between \f$i\f$-th and \f$j\f$-th spatial
  * points. No memory is allocated in this function!
  *
- * Uses SIMD instructions.
+ * Uses SIMD instructions. Coordinates of rows are gathered by chunks into
+ * contiguous buffers, and inner loop is branch-free: reciprocal square root
+ * is computed by Newton iterations, and entries with zero distance (e.g.
+ * diagonal ones) are zeroed by a bit mask instead of a branch. Loops are
+ * vectorized with any instruction set, but work best with AVX2 or AVX-512
+ * enabled (e.g. by `-mavx2` in `CMAKE_C_FLAGS`). Result matches
+ * starsh_esdata_block_coulomb_potential_kernel_@NDIMd() up to a few units in
+ * the last place.
  *
  * @param[in] nrows: Number of rows of \f$ A \f$.
  * @param[in] ncols: Number of columns of \f$ A \f$.
@@ -130,8 +166,6 @@ void starsh_esdata_block_coulomb_potential_kernel_@NDIMd_simd(int nrows,
     int i, j, k;
     STARSH_esdata *data1 = row_data;
     STARSH_esdata *data2 = col_data;
-    double tmp, dist;
-    // Read parameters
 // If dimensionality is not static
 #if (@NDIM == n)
     int ndim = data1->ndim;
@@ -139,33 +173,60 @@ void starsh_esdata_block_coulomb_potential_kernel_@NDIMd_simd(int nrows,
     // Get coordinates
     size_t count1 = data1->count;
     size_t count2 = data2->count;
-    double *x1[ndim], *x2[ndim];
-    x1[0] = data1->point;
-    x2[0] = data2->point;
-    #pragma omp simd
-    for(i = 1; i < ndim; i++)
-    {
-        x1[i] = x1[0]+i*count1;
-        x2[i] = x2[0]+i*count2;
-    }
-    double *x1_cur, *x2_cur;
     double *buffer = result;
-    // Fill column-major matrix
-    #pragma omp simd
-    for(j = 0; j < ncols; j++)
+    int i0;
+    double *x1 = data1->point;
+    double *x2 = data2->point;
+    double xchunk[ndim][CHUNK], y[ndim];
+#if (@NDIM == n)
+    double dist[CHUNK];
+#endif
+    for(i0 = 0; i0 < nrows; i0 += CHUNK)
     {
-        for(i = 0; i < nrows; i++)
+        int nchunk = nrows-i0 < CHUNK ? nrows-i0 : CHUNK;
+        // Gather coordinates of rows of current chunk
+        for(k = 0; k < ndim; k++)
+            for(i = 0; i < nchunk; i++)
+                xchunk[k][i] = x1[k*count1+irow[i0+i]];
+        // Fill column-major matrix
+        for(j = 0; j < ncols; j++)
         {
-            dist = 0.0;
+            double *out = buffer+j*(size_t)ld+i0;
             for(k = 0; k < ndim; k++)
+                y[k] = x2[k*count2+icol[j]];
+// If dimensionality is static
+#if (@NDIM != n)
+            // Loop over dimensions is unrolled by compiler
+            #pragma omp simd
+            for(i = 0; i < nchunk; i++)
             {
-                tmp = x1[k][irow[i]]-x2[k][icol[j]];
-                dist += tmp*tmp;
+                double tmp, dist = 0.0;
+                for(k = 0; k < ndim; k++)
+                {
+                    tmp = xchunk[k][i]-y[k];
+                    dist += tmp*tmp;
+                }
+                out[i] = coulomb_rsqrt(dist);
             }
-            if(dist == 0)
-                buffer[j*(size_t)ld+i] = 0.0;
-            else
-                buffer[j*(size_t)ld+i] = 1.0/sqrt(dist);
+#else
+            // Accumulate squared distances dimension by dimension, so that
+            // inner loops are vectorized for dynamic dimensionality
+            #pragma omp simd
+            for(i = 0; i < nchunk; i++)
+                dist[i] = 0.0;
+            for(k = 0; k < ndim; k++)
+            {
+                #pragma omp simd
+                for(i = 0; i < nchunk; i++)
+                {
+                    double tmp = xchunk[k][i]-y[k];
+                    dist[i] += tmp*tmp;
+                }
+            }
+            #pragma omp simd
+            for(i = 0; i < nchunk; i++)
+                out[i] = coulomb_rsqrt(dist[i]);
+#endif
         }
     }
 }
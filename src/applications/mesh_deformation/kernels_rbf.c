@@ -107,6 +107,95 @@ double CTPS(double x)
                 return pow(1 - x, 5);
 }
 
+/*! Generate function, filling block of RBF matrix with a given basis
+ * function. Coordinates of mesh points are stored dimension by dimension,
+ * so the inner loop over rows is vectorized. Regularization is added to the
+ * diagonal without branches.
+ */
+#define RBF_BLOCK(name, expr)\
+static void rbf_block_##name(int nrows, int ncols, STARSH_int *irow,\
+        STARSH_int *icol, double *x, double *y, double *z, double rad,\
+        double reg, double *A, int lda)\
+{\
+        for(int k = 0; k < ncols; k++)\
+        {\
+                STARSH_int j0 = icol[k];\
+                double xj = x[j0], yj = y[j0], zj = z[j0];\
+                double *out = A+k*(size_t)lda;\
+                _Pragma("omp simd")\
+                for(int m = 0; m < nrows; m++)\
+                {\
+                        STARSH_int i0 = irow[m];\
+                        double dx = x[i0]-xj, dy = y[i0]-yj, dz = z[i0]-zj;\
+                        double d = sqrt(dx*dx+dy*dy+dz*dz)/rad;\
+                        out[m] = (expr)+(i0 == j0 ? reg : 0.);\
+                }\
+        }\
+}
+
+RBF_BLOCK(gaussian, exp(-d*d))
+RBF_BLOCK(expon, exp(-d))
+RBF_BLOCK(invquad, 1/(1+d*d))
+RBF_BLOCK(invmquad, 1/sqrt(1+d*d))
+RBF_BLOCK(maternc1, exp(-d)+(1+d))
+RBF_BLOCK(tps, d*d*log(d))
+RBF_BLOCK(ctps, d > 1 ? 0. : (1-d)*(1-d)*(1-d)*(1-d)*(1-d))
+RBF_BLOCK(quad, 1+d*d)
+RBF_BLOCK(wendland, d > 1 ? 0. : (1-d)*(1-d)*(1-d)*(1-d)*(4*d+1))
+
+/*! Fills block of RBF matrix for 3D mesh deformation.
+ * Type of basis function is selected once per block, so that each type has
+ * its own vectorized loop. Numbering of kernels is the same as in
+ * starsh_generate_3d_virus() and starsh_generate_3d_cube().
+ *
+ * @param[in] nrows: Number of rows of \f$ A \f$.
+ * @param[in] ncols: Number of columns of \f$ A \f$.
+ * @param[in] irow: Array of row indexes.
+ * @param[in] icol: Array of column indexes.
+ * @param[in] data: Pointer to physical data (\ref STARSH_mddata object).
+ * @param[out] A: Pointer to memory of \f$ A \f$.
+ * @param[in] lda: Leading dimension of `A`.
+ */
+void starsh_generate_3d_rbf_block(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, STARSH_mddata *data, double *A, int lda)
+{
+        STARSH_int count = data->particles.count;
+        double *x = data->point_soa, *y = x+count, *z = y+count;
+        double rad = data->scale;
+        double reg = data->isreg ? data->reg : 0.;
+        switch(data->kernel){
+                case 0: rbf_block_gaussian(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                case 1: rbf_block_expon(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                case 2: rbf_block_invquad(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                case 3: rbf_block_invmquad(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                // Both types 4 and 5 use Maternc1
+                case 4:
+                case 5: rbf_block_maternc1(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                case 6: rbf_block_tps(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                case 7: rbf_block_ctps(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                case 8: rbf_block_quad(nrows, ncols, irow, icol, x, y, z,
+                                rad, reg, A, lda);
+                        break;
+                default: rbf_block_wendland(nrows, ncols, irow, icol, x, y, z,
+                                 rad, reg, A, lda);
+                         break;
+        }
+}
+
 /*! Computing Euclidean distance
  * @param[in] x: Mesh Coordinates along x-axis
  * @param[in] y: Mesh Coordinates along y-axis
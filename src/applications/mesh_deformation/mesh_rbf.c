@@ -22,6 +22,8 @@
 #include "starsh-rbf.h"
 #include <inttypes.h>
 
+#define pi 3.14159265358979323846
+
 static uint32_t Part1By1(uint32_t x)
 	// Spread lower bits of input
 {
@@ -202,6 +204,21 @@ static void starsh_morton_zsort3(int n, double *points)
 	}
 }
 
+static int starsh_mddata_soa(STARSH_mddata *data)
+	// Copy coordinates of mesh points, stored point by point, into a buffer,
+	// where they are stored dimension by dimension. This allows vectorized
+	// loops in kernels.
+{
+	STARSH_int count = data->particles.count, i;
+	int ndim = data->particles.ndim, k;
+	double *mesh = data->particles.point;
+	STARSH_MALLOC(data->point_soa, count*ndim);
+	for(i = 0; i < count; i++)
+		for(k = 0; k < ndim; k++)
+			data->point_soa[k*count+i] = mesh[i*ndim+k];
+	return STARSH_SUCCESS;
+}
+
 /*! It reads mesh pointd fron file
  *
  * @param[inout] data: STARSH_mddata mesh deformation 
@@ -231,7 +248,7 @@ int starsh_generate_3d_rbf_mesh_coordinates_virus(STARSH_mddata **data, char *fi
 
 	FILE *p_file = fopen(file_name,"r");
 	char line[100];
-	int i=0, j=0;
+	int i=0, j=0, info;
 	if(!p_file)
 	{
 		printf("\n File missing or error when reading file:");
@@ -268,6 +285,17 @@ int starsh_generate_3d_rbf_mesh_coordinates_virus(STARSH_mddata **data, char *fi
 	(*data)->kernel = kernel;
 	(*data)->rad = rad;
         (*data)->denst = denst;
+	// Scaling factor does not depend on mesh points, so it is computed once
+	(*data)->scale = rad;
+	if(numobj > 1 && rad < 0 && denst < 0)
+		(*data)->scale = 0.25*numobj*sqrt(3); // For uniform dist
+	else if(numobj > 1 && rad < 0 && denst > 0)
+		// For sphere packing. Note, that integer division 1/3 is zero
+		(*data)->scale = (sqrt(3)) * (pow(((4 * pi * (0.09 * 0.09 * 0.09) *
+				numobj / 3) / denst), (1/3)) + 0.18);
+	info = starsh_mddata_soa(*data);
+	if(info != STARSH_SUCCESS)
+		return info;
        
         return STARSH_SUCCESS;
 
@@ -328,17 +356,158 @@ int starsh_generate_3d_rbf_mesh_coordinates_cube(STARSH_mddata **data, STARSH_in
 	(*data)->kernel = kernel;
 	(*data)->rad = rad;
         (*data)->denst = -1;
+	(*data)->scale = rad;
+	int info = starsh_mddata_soa(*data);
+	if(info != STARSH_SUCCESS)
+		return info;
        
         return STARSH_SUCCESS;
 
 }
 
+int starsh_mddata_tlr_support(STARSH_blrf **format, STARSH_problem *problem,
+		char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster)
+	//! TLR partitioning, that skips zero tiles of compactly supported RBF.
+	/*! Wendland and CTPS basis functions are exactly zero, if distance
+	 * between mesh points is larger than scaling factor of RBF. Tiles, whose
+	 * bounding boxes of row and column clusters are farther apart, are zero
+	 * tiles. They are dropped from the format, so they are neither
+	 * approximated nor stored nor multiplied. Diagonal tiles are near-field
+	 * tiles and all the other tiles are far-field tiles. For other basis
+	 * functions it simply calls starsh_blrf_new_tlr().
+	 *
+	 * @param[out] format: Address of pointer to @ref STARSH_blrf object.
+	 * @param[in] problem: Pointer to @ref STARSH_problem object.
+	 * @param[in] symm: 'S' if format is symmetric and 'N' otherwise.
+	 * @param[in] row_cluster, col_cluster: pointers to @ref STARSH_cluster
+	 *      objects, corresponding to clusterization of rows and columns.
+	 * @return Error code @ref STARSH_ERRNO.
+	 * @sa starsh_blrf_new_tlr(), starsh_blrm_mml_plan_sparse().
+	 * @ingroup blrf
+	 * */
+{
+	if(problem == NULL || row_cluster == NULL || col_cluster == NULL)
+	{
+		STARSH_ERROR("Invalid value of `problem` or clusters");
+		return STARSH_WRONG_PARAMETER;
+	}
+	STARSH_mddata *data = row_cluster->data;
+	// Only Wendland (default) and CTPS (7) basis functions have compact
+	// support
+	if(data == NULL || data != col_cluster->data ||
+			(data->kernel >= 0 && data->kernel <= 8 && data->kernel != 7))
+		return starsh_blrf_new_tlr(format, problem, symm, row_cluster,
+				col_cluster);
+	if(symm == 'S' && row_cluster != col_cluster)
+	{
+		STARSH_ERROR("`row_cluster` and `col_cluster` should be equal");
+		return STARSH_WRONG_PARAMETER;
+	}
+	STARSH_int count = data->particles.count;
+	STARSH_int nbrows = row_cluster->nblocks, nbcols = col_cluster->nblocks;
+	STARSH_int i, j, k, nblocks, nblocks_far = 0, nblocks_near = 0;
+	STARSH_int *block_far, *block_near;
+	int ndim = data->particles.ndim, d;
+	double *box;
+	STARSH_MALLOC(box, 2*ndim*(nbrows+nbcols));
+	// Bounding boxes of row clusters, followed by boxes of column clusters
+	for(i = 0; i < nbrows+nbcols; i++)
+	{
+		STARSH_cluster *X = i < nbrows ? row_cluster : col_cluster;
+		STARSH_int bi = i < nbrows ? i : i-nbrows;
+		STARSH_int *pivot = X->pivot+X->start[bi];
+		double *lower = box+2*ndim*i, *upper = lower+ndim;
+		for(d = 0; d < ndim; d++)
+		{
+			double *x = data->point_soa+d*count;
+			lower[d] = x[pivot[0]];
+			upper[d] = x[pivot[0]];
+			for(k = 1; k < X->size[bi]; k++)
+			{
+				if(x[pivot[k]] < lower[d])
+					lower[d] = x[pivot[k]];
+				if(x[pivot[k]] > upper[d])
+					upper[d] = x[pivot[k]];
+			}
+		}
+	}
+	if(symm == 'N')
+		nblocks = nbrows*nbcols;
+	else
+		nblocks = nbrows*(nbrows+1)/2;
+	block_far = malloc(sizeof(*block_far)*2*nblocks);
+	block_near = malloc(sizeof(*block_near)*2*nblocks);
+	if(block_far == NULL || block_near == NULL)
+	{
+		STARSH_ERROR("malloc() failed");
+		free(box);
+		free(block_far);
+		free(block_near);
+		return STARSH_MALLOC_ERROR;
+	}
+	for(i = 0; i < nbrows; i++)
+	{
+		double *lower_i = box+2*ndim*i, *upper_i = lower_i+ndim;
+		STARSH_int jmax = symm == 'N' ? nbcols : i+1;
+		for(j = 0; j < jmax; j++)
+		{
+			double *lower_j = box+2*ndim*(nbrows+j);
+			double *upper_j = lower_j+ndim;
+			// Squared distance between bounding boxes
+			double dist = 0.;
+			for(d = 0; d < ndim; d++)
+			{
+				double gap = lower_j[d]-upper_i[d];
+				if(lower_i[d]-upper_j[d] > gap)
+					gap = lower_i[d]-upper_j[d];
+				if(gap > 0.)
+					dist += gap*gap;
+			}
+			if(dist > data->scale*data->scale)
+				continue;
+			if(i == j)
+			{
+				block_near[2*nblocks_near] = i;
+				block_near[2*nblocks_near+1] = j;
+				nblocks_near++;
+			}
+			else
+			{
+				block_far[2*nblocks_far] = i;
+				block_far[2*nblocks_far+1] = j;
+				nblocks_far++;
+			}
+		}
+	}
+	free(box);
+	// Lists are only shrunk, so they are kept as they are if realloc() fails
+	STARSH_int *tmp;
+	if(nblocks_far == 0)
+	{
+		free(block_far);
+		block_far = NULL;
+	}
+	else if((tmp = realloc(block_far, sizeof(*tmp)*2*nblocks_far)) != NULL)
+		block_far = tmp;
+	if(nblocks_near == 0)
+	{
+		free(block_near);
+		block_near = NULL;
+	}
+	else if((tmp = realloc(block_near, sizeof(*tmp)*2*nblocks_near)) != NULL)
+		block_near = tmp;
+	return starsh_blrf_new_from_coo(format, problem, symm, row_cluster,
+			col_cluster, nblocks_far, block_far, nblocks_near,
+			block_near, STARSH_TLR);
+}
+
 void starsh_mddata_free(STARSH_mddata *data)
 	//! Free memory of @ref STARSH_mddata object.
 	/*! @sa starsh_mddata_new(), starsh_mddata_init(), starsh_mddata_generate().
 	 * @ingroup app-spatial
 	 * */
 {
+	free(data->point_soa);
 	starsh_particles_free(&data->particles);
 }
 
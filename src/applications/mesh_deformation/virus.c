@@ -23,8 +23,6 @@
 #include <math.h>
 #include <stdio.h>
 
-#define pi 3.14159265358979323846
-
 /*! Fills matrix \f$ A \f$ with values
  *
  * @param[in] nrows: Number of rows of \f$ A \f$.
@@ -42,55 +40,9 @@ void starsh_generate_3d_virus(int nrows, int ncols,
 		STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
 		void *result, int lda)
 {
-	int m, k;
 	STARSH_mddata *data = row_data;
-	double *mesh = data->particles.point;
-	double rad = data->rad;
-
-	if((data->numobj)>1 && (data->rad)<0 && (data->denst)<0){
-                rad=0.25*(data->numobj)*sqrt(3); // For uniform dist
-        }else if((data->numobj)>1 && (data->rad)<0 && (data->denst)>0){
-           rad= (sqrt(3)) * (pow(((4 * pi * (0.09 * 0.09 * 0.09) * (data->numobj)/ 3) / (data->denst) ), (1/3)) + 0.18); // For sphere packing
-        }
-
-	double *A= (double *)result;
-
-	for(m=0;m<nrows;m++){
-		int i0=irow[m];
-		int posi=i0*3;
-		double vi[3] = {mesh[posi], mesh[posi+1], mesh[posi+2]};
-
-		for(k=0;k<ncols;k++){
-			int j0=icol[k];
-			int posj=j0*3;
-			double vj[3] = {mesh[posj], mesh[posj+1], mesh[posj+2]};
-			double d = diff(vi, vj) / rad;
-			switch(data->kernel){
-				case 0: A[lda*k+m]=Gaussian(d);
-					break;
-				case 1: A[lda*k+m]=Expon(d);
-					break;
-				case 2: A[lda*k+m]=InvQUAD(d);
-					break;
-				case 3: A[lda*k+m]=InvMQUAD(d);
-					break;
-				case 4: A[lda*k+m]=Maternc1(d);
-					break;
-				case 5: A[lda*k+m]=Maternc1(d);
-					break;
-				case 6: A[lda*k+m]=TPS(d);
-					break;
-				case 7: A[lda*k+m]=CTPS(d);
-					break;
-				case 8: A[lda*k+m]=QUAD(d);
-					break;
-				default: A[lda*k+m]=Wendland(d);
-					 break;
-			}
-			if( i0==j0 && (data->isreg)) A[lda*k+m]+=(data->reg);
-		}
-	}
-
+	starsh_generate_3d_rbf_block(nrows, ncols, irow, icol, data, result,
+			lda);
 }
 
 /*! Fills matrix (RHS) \f$ A \f$ with values
@@ -0,0 +1,243 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/applications/radial.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+#include "starsh-radial.h"
+
+// Number of doubles in stack workspace of starsh_raddata_block_kernel()
+#define RADIAL_WORK 4096
+// Squared distances, computed by GEMM, are recomputed directly if they are
+// not larger than this fraction of sum of squared norms of shifted points
+#define RADIAL_RECOMPUTE 1e-2
+
+int starsh_raddata_init(STARSH_raddata **data, STARSH_int count, int ndim,
+        double *point, STARSH_radial_func *phi, STARSH_radial_batch *phi_batch,
+        void *param, double nugget)
+//! Initialize @ref STARSH_raddata object by given data.
+/*! Array `point` should be stored in a special way: `x_1 x_2 ... x_count y_1
+ * y_2 ... y_count z_1 z_2 ...`.
+ * This function does not allocate memory for coordinates and uses provided
+ * pointer `point`. Do not free memory of `point` until you finish using
+ * returned @ref STARSH_raddata object. At least one of `phi` and `phi_batch`
+ * must be provided.
+ * Do not forget to sort `data->particles` by starsh_particles_zsort_inplace()
+ * to take advantage of low-rank submatrices.
+ *
+ * @param[out] data: Address of pointer to @ref STARSH_raddata object.
+ * @param[in] count: Number of particles.
+ * @param[in] ndim: Dimensionality of space.
+ * @param[in] point: Pointer to array of coordinates of particles.
+ * @param[in] phi: Scalar radial function or NULL.
+ * @param[in] phi_batch: Batched radial function or NULL.
+ * @param[in] param: Parameters, passed to radial function.
+ * @param[in] nugget: Value to add to diagonal elements.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_raddata_free(), starsh_raddata_block_kernel().
+ * @ingroup app-radial
+ * */
+{
+    if(data == NULL)
+    {
+        STARSH_ERROR("Invalid value of `data`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(ndim <= 0)
+    {
+        STARSH_ERROR("Invalid value of `ndim`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(phi == NULL && phi_batch == NULL)
+    {
+        STARSH_ERROR("Invalid value of `phi` and `phi_batch`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_MALLOC(*data, 1);
+    (*data)->particles.count = count;
+    (*data)->particles.ndim = ndim;
+    (*data)->particles.point = point;
+    (*data)->phi = phi;
+    (*data)->phi_batch = phi_batch;
+    (*data)->param = param;
+    (*data)->nugget = nugget;
+    (*data)->gemm_ndim = STARSH_RADIAL_GEMM_NDIM;
+    return STARSH_SUCCESS;
+}
+
+void starsh_raddata_free(STARSH_raddata *data)
+//! Free memory of @ref STARSH_raddata object.
+/*! Coordinates of particles are not freed, since they were provided by user.
+ *
+ * @sa starsh_raddata_init().
+ * @ingroup app-radial
+ * */
+{
+    if(data == NULL)
+        return;
+    free(data);
+}
+
+void starsh_raddata_block_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+//! Kernel for @ref STARSH_raddata object.
+/*! Fills matrix \f$ A \f$ with values
+ * \f[
+ *      A_{ij} = \phi(r_{ij}) + \delta_{ij} \cdot nugget,
+ * \f]
+ * where \f$ r_{ij} \f$ is a distance between \f$i\f$-th and \f$j\f$-th
+ * spatial points. Distances are computed column by column with a vectorized
+ * loop. For high dimensionality (not lower than `gemm_ndim` of row data),
+ * block is processed by subblocks, small enough for their coordinates to fit
+ * into a workspace on stack. Coordinates of a subblock are gathered and
+ * shifted by the mean of its rows, and distances are computed as
+ * \f$ \sqrt{\|x\|^2+\|y\|^2-2x^Ty} \f$ with a single GEMM. Shift keeps
+ * norms of close blocks small, and squared distances, that are still small
+ * compared to the norms, are recomputed directly to avoid cancellation.
+ * Distances are then replaced inplace by values of radial function, column by
+ * column. Nugget is added only if `row_data` and `col_data` point to the same
+ * object. No memory is allocated in this function!
+ *
+ * @param[in] nrows: Number of rows of \f$ A \f$.
+ * @param[in] ncols: Number of columns of \f$ A \f$.
+ * @param[in] irow: Array of row indexes.
+ * @param[in] icol: Array of column indexes.
+ * @param[in] row_data: Pointer to physical data (@ref STARSH_raddata object).
+ * @param[in] col_data: Pointer to physical data (@ref STARSH_raddata object).
+ * @param[out] result: Pointer to memory of \f$ A \f$.
+ * @param[in] ld: Leading dimension of `result`.
+ * @ingroup app-radial
+ * */
+{
+    STARSH_raddata *data1 = row_data;
+    STARSH_raddata *data2 = col_data;
+    int ndim = data1->particles.ndim;
+    STARSH_int count1 = data1->particles.count;
+    STARSH_int count2 = data2->particles.count;
+    double *x1 = data1->particles.point;
+    double *x2 = data2->particles.point;
+    double *buffer = result;
+    int i, j, k;
+    if(nrows <= 0 || ncols <= 0)
+        return;
+    // Number of rows and columns of a subblock, processed by GEMM
+    int bsize = 0;
+    if(ndim >= data1->gemm_ndim)
+        bsize = (RADIAL_WORK-ndim)/(2*(ndim+1));
+    if(bsize > 0)
+    {
+        double work[RADIAL_WORK];
+        double *center = work, *X1 = center+ndim, *X2 = X1+bsize*ndim;
+        double *norm1 = X2+bsize*ndim, *norm2 = norm1+bsize;
+        for(int i0 = 0; i0 < nrows; i0 += bsize)
+        {
+            int ni = nrows-i0 < bsize ? nrows-i0 : bsize;
+            STARSH_int *ir = irow+i0;
+            // Gather coordinates of rows and shift them by their mean
+            for(k = 0; k < ndim; k++)
+            {
+                double *x = x1+k*count1, *X = X1+k*ni, sum = 0.;
+                for(i = 0; i < ni; i++)
+                    sum += x[ir[i]];
+                center[k] = sum/ni;
+                for(i = 0; i < ni; i++)
+                    X[i] = x[ir[i]]-center[k];
+            }
+            for(i = 0; i < ni; i++)
+                norm1[i] = 0.;
+            for(k = 0; k < ndim; k++)
+                for(i = 0; i < ni; i++)
+                    norm1[i] += X1[k*ni+i]*X1[k*ni+i];
+            for(int j0 = 0; j0 < ncols; j0 += bsize)
+            {
+                int nj = ncols-j0 < bsize ? ncols-j0 : bsize;
+                STARSH_int *ic = icol+j0;
+                // Gather coordinates of columns with the same shift
+                for(k = 0; k < ndim; k++)
+                {
+                    double *x = x2+k*count2, *X = X2+k*nj;
+                    for(j = 0; j < nj; j++)
+                        X[j] = x[ic[j]]-center[k];
+                }
+                for(j = 0; j < nj; j++)
+                    norm2[j] = 0.;
+                for(k = 0; k < ndim; k++)
+                    for(j = 0; j < nj; j++)
+                        norm2[j] += X2[k*nj+j]*X2[k*nj+j];
+                double *sub = buffer+j0*(size_t)ld+i0;
+                cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, ni, nj,
+                        ndim, -2.0, X1, ni, X2, nj, 0.0, sub, ld);
+                for(j = 0; j < nj; j++)
+                {
+                    double *out = sub+j*(size_t)ld;
+                    double norm_j = norm2[j];
+                    #pragma omp simd
+                    for(i = 0; i < ni; i++)
+                        out[i] += norm1[i]+norm_j;
+                    // Small values lost most of their digits, so they are
+                    // computed again by differences of coordinates. Distance
+                    // of a point to itself becomes exact zero this way
+                    for(i = 0; i < ni; i++)
+                        if(out[i] <= RADIAL_RECOMPUTE*(norm1[i]+norm_j))
+                        {
+                            double tmp, dist = 0.;
+                            for(k = 0; k < ndim; k++)
+                            {
+                                tmp = x1[k*count1+ir[i]]-x2[k*count2+ic[j]];
+                                dist += tmp*tmp;
+                            }
+                            out[i] = dist;
+                        }
+                    #pragma omp simd
+                    for(i = 0; i < ni; i++)
+                        out[i] = sqrt(out[i]);
+                }
+            }
+        }
+    }
+    else
+    {
+        for(j = 0; j < ncols; j++)
+        {
+            double *out = buffer+j*(size_t)ld;
+            STARSH_int jj = icol[j];
+            #pragma omp simd
+            for(i = 0; i < nrows; i++)
+            {
+                double tmp, dist = 0.;
+                for(k = 0; k < ndim; k++)
+                {
+                    tmp = x1[k*count1+irow[i]]-x2[k*count2+jj];
+                    dist += tmp*tmp;
+                }
+                out[i] = sqrt(dist);
+            }
+        }
+    }
+    // Apply radial function and nugget column by column. Indexes of
+    // different sets of points may coincide, so nugget is added only to
+    // diagonal of a matrix, built on the same set of points
+    double nugget = row_data == col_data ? data1->nugget : 0.;
+    for(j = 0; j < ncols; j++)
+    {
+        double *out = buffer+j*(size_t)ld;
+        STARSH_int jj = icol[j];
+        if(data1->phi_batch != NULL)
+            data1->phi_batch(nrows, out, data1->param);
+        else
+            for(i = 0; i < nrows; i++)
+                out[i] = data1->phi(out[i], data1->param);
+        if(nugget != 0.)
+            #pragma omp simd
+            for(i = 0; i < nrows; i++)
+                out[i] += irow[i] == jj ? nugget : 0.;
+    }
+}
@@ -18,7 +18,12 @@ void starsh_randtlr_block_kernel(int nrows, int ncols, STARSH_int *irow,
         STARSH_int *icol, void *row_data, void *col_data, void *result,
         int ld)
 //! The only kernel for @ref STARSH_randtlr object.
-/*! @param[in] nrows: Number of rows of \f$ A \f$.
+/*! Matrix is `U*diag(S)*U^T` by construction, so rows of `U`, corresponding
+ * to `irow`, are gathered and scaled by `S`, rows of `U`, corresponding to
+ * `icol`, are gathered (or used inplace, if `icol` is a contiguous range),
+ * and the block is computed by a single GEMM.
+ *
+ * @param[in] nrows: Number of rows of \f$ A \f$.
  * @param[in] ncols: Number of columns of \f$ A \f$.
  * @param[in] irow: Array of row indexes.
  * @param[in] icol: Array of column indexes.
@@ -31,29 +36,69 @@ void starsh_randtlr_block_kernel(int nrows, int ncols, STARSH_int *irow,
 {
     STARSH_randtlr *data = row_data;
     STARSH_int count = data->count;
-    STARSH_int nblocks = data->nblocks;
     STARSH_int block_size = data->block_size;
     double diag = data->diag;
     double *U = data->U;
     double *S = data->S;
     double *buffer = result;
-    for(STARSH_int i = 0; i < nrows; i++)
-    {
-        STARSH_int ii = irow[i];
-        STARSH_int ibrow = ii/block_size;
-        for(STARSH_int j = 0; j < ncols; j++)
+    STARSH_int i, j, k;
+    if(nrows <= 0 || ncols <= 0)
+        return;
+    // Check if column indexes are contiguous
+    int contiguous = 1;
+    for(j = 1; j < ncols; j++)
+        if(icol[j] != icol[0]+j)
         {
-            STARSH_int jj = icol[j];
-            STARSH_int jbcol = jj/block_size;
-            double res = 0;
-            for(STARSH_int k = 0; k < block_size; k++)
-                res += U[ii+k*count]*U[jj+k*count]*S[k];
-            if(ii == jj)
-                buffer[j*(size_t)ld+i] = res+diag;
-            else
+            contiguous = 0;
+            break;
+        }
+    size_t size_row = (size_t)nrows*block_size;
+    size_t size_col = contiguous ? 0 : (size_t)ncols*block_size;
+    double *row_panel = malloc(sizeof(*row_panel)*(size_row+size_col));
+    if(row_panel == NULL)
+    {
+        // Fall back to dot products if there is not enough memory
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < ncols; j++)
+            {
+                double res = 0;
+                for(k = 0; k < block_size; k++)
+                    res += U[irow[i]+k*count]*U[icol[j]+k*count]*S[k];
                 buffer[j*(size_t)ld+i] = res;
+            }
+    }
+    else
+    {
+        double *col_panel = U+icol[0];
+        int ldcol = count;
+        for(k = 0; k < block_size; k++)
+        {
+            double *src = U+k*count, *dst = row_panel+k*(size_t)nrows;
+            for(i = 0; i < nrows; i++)
+                dst[i] = src[irow[i]]*S[k];
+        }
+        if(!contiguous)
+        {
+            col_panel = row_panel+size_row;
+            ldcol = ncols;
+            for(k = 0; k < block_size; k++)
+            {
+                double *src = U+k*count, *dst = col_panel+k*(size_t)ncols;
+                for(j = 0; j < ncols; j++)
+                    dst[j] = src[icol[j]];
+            }
         }
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, ncols,
+                block_size, 1.0, row_panel, nrows, col_panel, ldcol, 0.0,
+                buffer, ld);
+        free(row_panel);
     }
+    // Add diagonal shift to elements with equal row and column indexes
+    if(diag != 0.)
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < ncols; j++)
+                if(irow[i] == icol[j])
+                    buffer[j*(size_t)ld+i] += diag;
 }
 
 int starsh_randtlr_generate(STARSH_randtlr **data, STARSH_int count,
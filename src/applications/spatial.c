@@ -49,6 +49,7 @@ int starsh_ssdata_new(STARSH_ssdata **data, STARSH_int count, int ndim)
     tmp->particles.count = count;
     tmp->particles.ndim = ndim;
     STARSH_MALLOC(tmp->particles.point, count*ndim);
+    tmp->sphere = NULL;
     *data = tmp;
     return STARSH_SUCCESS;
 }
@@ -114,6 +115,7 @@ int starsh_ssdata_init(STARSH_ssdata **data, STARSH_int count, int ndim,
     tmp->particles.count = count;
     tmp->particles.ndim = ndim;
     tmp->particles.point = point;
+    tmp->sphere = NULL;
     tmp->beta = beta;
     tmp->nu = nu;
     tmp->noise = noise;
@@ -185,6 +187,7 @@ int starsh_ssdata_init_parsimonious(STARSH_ssdata **data, STARSH_int count, int
     tmp->particles.count = count;
     tmp->particles.ndim = ndim;
     tmp->particles.point = point;
+    tmp->sphere = NULL;
     tmp->beta = beta;
     tmp->nu = nu1;
     tmp->noise = noise;
@@ -251,6 +254,7 @@ int starsh_ssdata_generate(STARSH_ssdata **data, STARSH_int count, int ndim,
     STARSH_MALLOC(*data, 1);
     (*data)->particles = *particles;
     free(particles);
+    (*data)->sphere = NULL;
     (*data)->beta = beta;
     (*data)->nu = nu;
     (*data)->noise = noise;
@@ -317,6 +321,7 @@ int starsh_ssdata_generate_parsimonious(STARSH_ssdata **data, STARSH_int count,
     STARSH_MALLOC(*data, 1);
     (*data)->particles = *particles;
     free(particles);
+    (*data)->sphere = NULL;
     (*data)->beta = beta;
     (*data)->nu = nu;
     (*data)->noise = noise;
@@ -485,6 +490,8 @@ void starsh_ssdata_free(STARSH_ssdata *data)
      * @ingroup app-spatial
      * */
 {
+    // Particles are the first member, so this also frees `data`
+    free(data->sphere);
     starsh_particles_free(&data->particles);
 }
 
@@ -855,6 +862,14 @@ int starsh_ssdata_get_kernel(STARSH_kernel **kernel, STARSH_ssdata *data,
      * @ingroup app-spatial
      * */
 {
+    // Kernels with great-circle distance use precomputed unit vectors
+    if(data->particles.ndim == 2 && type >= STARSH_SPATIAL_EXP_GCD &&
+            type <= STARSH_SPATIAL_PARSIMONIOUS2_GCD)
+    {
+        int info = starsh_ssdata_gcd_prepare(data);
+        if(info != STARSH_SUCCESS)
+            return info;
+    }
     switch(data->particles.ndim)
     {
         case 1:
@@ -901,6 +916,82 @@ static double distanceEarth(double lat1d, double lon1d, double lat2d, double lon
     return 2.0 * earthRadiusKm * asin(sqrt(u * u + cos(lat1r) * cos(lat2r) * v * v));
 }
 
+int starsh_ssdata_gcd_prepare(STARSH_ssdata *data)
+    //! Precompute unit vectors of points on a sphere.
+    /*! First coordinate of each 2-dimensional particle is a latitude and
+     * second is a longitude, both in degrees. Great-circle distance between
+     * two points is then computed through length `c` of a chord between
+     * their unit vectors as \f$ 2 R \arcsin(c/2) \f$, which does not need
+     * any trigonometric function of coordinates. This function is called by
+     * starsh_ssdata_get_kernel() for kernels with great-circle distance, call
+     * it again if coordinates of particles are changed.
+     *
+     * @param[in,out] data: Pointer to @ref STARSH_ssdata object.
+     * @return Error code @ref STARSH_ERRNO.
+     * @sa starsh_ssdata_block_exp_kernel_2d_simd_gcd().
+     * @ingroup app-spatial
+     * */
+{
+    if(data == NULL || data->particles.ndim != 2)
+    {
+        STARSH_ERROR("Invalid value of `data`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_int count = data->particles.count, i;
+    double *lat = data->particles.point, *lon = lat+count;
+    if(data->sphere == NULL)
+        STARSH_MALLOC(data->sphere, 3*count);
+    double *x = data->sphere, *y = x+count, *z = y+count;
+    for(i = 0; i < count; i++)
+    {
+        double latr = deg2rad(lat[i]), lonr = deg2rad(lon[i]);
+        x[i] = cos(latr)*cos(lonr);
+        y[i] = cos(latr)*sin(lonr);
+        z[i] = sin(latr);
+    }
+    return STARSH_SUCCESS;
+}
+
+static void gcd_distance(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, STARSH_ssdata *data1, STARSH_ssdata *data2,
+        double *buffer, int ld)
+// Fill column-major matrix with great-circle distances in kilometers. Chord
+// lengths between precomputed unit vectors are used if available.
+{
+    int i, j;
+    STARSH_int count1 = data1->particles.count;
+    STARSH_int count2 = data2->particles.count;
+    if(data1->sphere == NULL || data2->sphere == NULL)
+    {
+        double *x1[2], *x2[2];
+        x1[0] = data1->particles.point;
+        x1[1] = x1[0]+count1;
+        x2[0] = data2->particles.point;
+        x2[1] = x2[0]+count2;
+        for(j = 0; j < ncols; j++)
+            for(i = 0; i < nrows; i++)
+                buffer[j*(size_t)ld+i] = distanceEarth(x1[0][irow[i]],
+                        x1[1][irow[i]], x2[0][icol[j]], x2[1][icol[j]]);
+        return;
+    }
+    double *x1 = data1->sphere, *y1 = x1+count1, *z1 = y1+count1;
+    double *x2 = data2->sphere, *y2 = x2+count2, *z2 = y2+count2;
+    for(j = 0; j < ncols; j++)
+    {
+        double x = x2[icol[j]], y = y2[icol[j]], z = z2[icol[j]];
+        double *out = buffer+j*(size_t)ld;
+        #pragma omp simd
+        for(i = 0; i < nrows; i++)
+        {
+            double dx = x1[irow[i]]-x, dy = y1[irow[i]]-y;
+            double dz = z1[irow[i]]-z;
+            // Half of chord length can exceed 1 only due to rounding errors
+            double h = fmin(0.5*sqrt(dx*dx+dy*dy+dz*dz), 1.0);
+            out[i] = 2.0*earthRadiusKm*asin(h);
+        }
+    }
+}
+
 void starsh_ssdata_block_exp_kernel_2d_simd_gcd(int nrows, int ncols,
         STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
         void *result, int ld)
@@ -938,43 +1029,28 @@ void starsh_ssdata_block_exp_kernel_2d_simd_gcd(int nrows, int ncols,
      * @ingroup app-spatial-kernels
      * */
 {
-    int i, j, k;
+    int i, j;
     STARSH_ssdata *data1 = row_data;
     STARSH_ssdata *data2 = col_data;
-    double tmp, dist;
     // Read parameters
     //int ndim = 2;
     double beta = -data1->beta;
     double noise = data1->noise;
     double sigma = data1->sigma;
-    // Get coordinates
-    size_t count1 = data1->particles.count;
-    size_t count2 = data2->particles.count;
-    double *x1[2], *x2[2];
-    //printf("%===============%f(4), \n", sigma);
-    x1[0] = data1->particles.point;
-    x2[0] = data2->particles.point;
-#pragma omp simd
-    for(i = 1; i < 2; i++)
-    {
-        x1[i] = x1[0]+i*count1;
-        x2[i] = x2[0]+i*count2;
-    }
-    double *x1_cur, *x2_cur;
     double *buffer = result;
+    // Great-circle distances are computed first, then kernel is applied to
+    // them in place
+    gcd_distance(nrows, ncols, irow, icol, data1, data2, buffer, ld);
     // Fill column-major matrix
-#pragma omp simd
     for(j = 0; j < ncols; j++)
     {
+        double *out = buffer+j*(size_t)ld;
+#pragma omp simd
         for(i = 0; i < nrows; i++)
         {
-            dist = distanceEarth(x1[0][irow[i]], x1[1][irow[i]],
-                    x2[0][icol[j]], x2[1][icol[j]]);
+            double dist = out[i];
             dist = dist/beta;
-            if(dist == 0)
-                buffer[j*(size_t)ld+i] = sigma+noise;
-            else
-                buffer[j*(size_t)ld+i] = sigma*exp(dist);
+            out[i] = dist == 0 ? sigma+noise : sigma*exp(dist);
         }
     }
 }
@@ -1016,42 +1092,27 @@ void starsh_ssdata_block_sqrexp_kernel_2d_simd_gcd(int nrows, int ncols,
      * @ingroup app-spatial-kernels
      * */
 {
-    int i, j, k;
+    int i, j;
     STARSH_ssdata *data1 = row_data;
     STARSH_ssdata *data2 = col_data;
-    double tmp, dist;
     // Read parameters
     double beta = -2*data1->beta*data1->beta;
     double noise = data1->noise;
     double sigma = data1->sigma;
-    // Get coordinates
-    STARSH_int count1 = data1->particles.count;
-    STARSH_int count2 = data2->particles.count;
-    double *x1[2], *x2[2];
-    x1[0] = data1->particles.point;
-    x2[0] = data2->particles.point;
-    //printf("%===============(3)%f, \n", sigma);
-#pragma omp simd
-    for(i = 1; i < 2; i++)
-    {
-        x1[i] = x1[0]+i*count1;
-        x2[i] = x2[0]+i*count2;
-    }
-    double *x1_cur, *x2_cur;
     double *buffer = result;
+    // Great-circle distances are computed first, then kernel is applied to
+    // them in place
+    gcd_distance(nrows, ncols, irow, icol, data1, data2, buffer, ld);
     // Fill column-major matrix
-#pragma omp simd
     for(j = 0; j < ncols; j++)
     {
+        double *out = buffer+j*(size_t)ld;
+#pragma omp simd
         for(i = 0; i < nrows; i++)
         {
-            dist = distanceEarth(x1[0][irow[i]], x1[1][irow[i]],
-                    x2[0][icol[j]], x2[1][icol[j]]);
+            double dist = out[i];
             dist = dist*dist/beta;
-            if(dist == 0)
-                buffer[j*(size_t)ld+i] = sigma+noise;
-            else
-                buffer[j*(size_t)ld+i] = sigma*exp(dist);
+            out[i] = dist == 0 ? sigma+noise : sigma*exp(dist);
         }
     }
 }
@@ -1108,29 +1169,17 @@ void starsh_ssdata_block_matern_kernel_2d_simd_gcd(int nrows, int ncols,
     double theta = sqrt(2*nu)/beta;
     double noise = data1->noise;
     double sigma = data1->sigma;
-    // Get coordinates
-    STARSH_int count1 = data1->particles.count;
-    STARSH_int count2 = data2->particles.count;
-    double *x1[2], *x2[2];
-    x1[0] = data1->particles.point;
-    x2[0] = data2->particles.point;
-    //printf("%===============(2)%f, \n", sigma);
-#pragma omp simd
-    for(i = 1; i < 2; i++)
-    {
-        x1[i] = x1[0]+i*count1;
-        x2[i] = x2[0]+i*count2;
-    }
-    double *x1_cur, *x2_cur;
     double *buffer = result;
+    // Great-circle distances are computed first, then kernel is applied to
+    // them in place
+    gcd_distance(nrows, ncols, irow, icol, data1, data2, buffer, ld);
     // Fill column-major matrix
 #pragma omp simd
     for(j = 0; j < ncols; j++)
     {
         for(i = 0; i < nrows; i++)
         {
-            dist = distanceEarth(x1[0][irow[i]], x1[1][irow[i]],
-                    x2[0][icol[j]], x2[1][icol[j]]);
+            dist = buffer[j*(size_t)ld+i];
             dist = dist*theta;
             if(dist == 0)
                 buffer[j*(size_t)ld+i] = sigma+noise;
@@ -1191,29 +1240,17 @@ void starsh_ssdata_block_matern2_kernel_2d_simd_gcd(int nrows, int ncols,
     double nu = data1->nu;
     double noise = data1->noise;
     double sigma = data1->sigma;
-    // Get coordinates
-    STARSH_int count1 = data1->particles.count;
-    STARSH_int count2 = data2->particles.count;
-    double *x1[2], *x2[2];
-    x1[0] = data1->particles.point;
-    x2[0] = data2->particles.point;
-    //printf("%(14)===============(test)%f, \n", sigma);
-#pragma omp simd
-    for(i = 1; i < 2; i++)
-    {
-        x1[i] = x1[0]+i*count1;
-        x2[i] = x2[0]+i*count2;
-    }
-    double *x1_cur, *x2_cur;
     double *buffer = result;
+    // Great-circle distances are computed first, then kernel is applied to
+    // them in place
+    gcd_distance(nrows, ncols, irow, icol, data1, data2, buffer, ld);
     // Fill column-major matrix
 #pragma omp simd
     for(j = 0; j < ncols; j++)
     {
         for(i = 0; i < nrows; i++)
         {
-            dist = distanceEarth(x1[0][irow[i]], x1[1][irow[i]],
-                    x2[0][icol[j]], x2[1][icol[j]]);
+            dist = buffer[j*(size_t)ld+i];
             dist = dist/beta;
             if(dist == 0)
                 buffer[j*(size_t)ld+i] = sigma+noise;
@@ -1283,20 +1320,10 @@ void starsh_ssdata_block_parsimonious_kernel_2d_simd_gcd(int nrows, int ncols,
     double corr  = data1->corr;
 
     //printf("%(13)===============%f, %f, %f, %f, %f, %f\n", sigma1, sigma2, beta, nu1, nu2, corr);
-    // Get coordinates
-    STARSH_int count1 = data1->particles.count;
-    STARSH_int count2 = data2->particles.count;
-    double *x1[2], *x2[2];
-    x1[0] = data1->particles.point;
-    x2[0] = data2->particles.point;
-#pragma omp simd
-    for(i = 1; i < 2; i++)
-    {
-        x1[i] = x1[0]+i*count1;
-        x2[i] = x2[0]+i*count2;
-    }
-    double *x1_cur, *x2_cur;
     double *buffer = result;
+    // Great-circle distances are computed first, then kernel is applied to
+    // them in place
+    gcd_distance(nrows, ncols, irow, icol, data1, data2, buffer, ld);
 
 
     //    double con= sigma*pow(2.0, 1.0-nu)/gsl_sf_gamma(nu);
@@ -1330,8 +1357,7 @@ void starsh_ssdata_block_parsimonious_kernel_2d_simd_gcd(int nrows, int ncols,
         for(i = 0; i < nrows; i++)
         {
 
-            dist = distanceEarth(x1[0][irow[i]], x1[1][irow[i]],
-                    x2[0][icol[j]], x2[1][icol[j]]);
+            dist = buffer[j*(size_t)ld+i];
             dist = dist/beta;
             if( i % 2 ==0)
             {
@@ -1494,8 +1520,10 @@ void starsh_ssdata_block_parsimonious_kernel_2d_simd(int nrows, int ncols,
             else
             {
                 buffer[j*(size_t)ld+i] = con1 * pow(dist, nu1) * gsl_sf_bessel_Knu(nu1, dist);//+noise1;
-                buffer[j*(size_t)ld+(i+1)] = con12 * pow(dist, nu12) * gsl_sf_bessel_Knu(nu12, dist);
-                buffer[(j+1)*(size_t)ld+i] = con12 * pow(dist, nu12) * gsl_sf_bessel_Knu(nu12, dist);
+                // Cross-covariance is symmetric, so compute it only once
+                double cross = con12 * pow(dist, nu12) * gsl_sf_bessel_Knu(nu12, dist);
+                buffer[j*(size_t)ld+(i+1)] = cross;
+                buffer[(j+1)*(size_t)ld+i] = cross;
                 buffer[(j+1)*(size_t)ld+(i+1)] = con2 * pow(dist, nu2) * gsl_sf_bessel_Knu(nu2, dist);//;+noise2;
             }
 
@@ -1507,6 +1535,91 @@ void starsh_ssdata_block_parsimonious_kernel_2d_simd(int nrows, int ncols,
 
 
 
+void starsh_ssdata_block_parsimonious_kernel_nd_tensor(int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld)
+    //! Bivariate parsimonious Mat&eacute;rn kernel with tensor output.
+    /*! Computes the same covariances as
+     * starsh_ssdata_block_parsimonious_kernel_2d_simd(), but for each pair
+     * of spatial points distance is computed only once and all 4 outputs
+     * \f$ C_{11}, C_{12}, C_{21}, C_{22} \f$ are written at once. Result is
+     * a tensor of shape `(nrows, 2, 2, ncols)` in Fortran order, where
+     * element \f$ (i, a, b, j) \f$ is stored at `result[i+ld*(a+2*(b+2*j))]`.
+     * Use it with a 4-dimensional @ref STARSH_problem of shape `(N, 2, 2, N)`
+     * and starsh_problem_from_tensor() to compress the whole bivariate
+     * system as a single matrix. No memory is allocated in this function!
+     *
+     * @param[in] nrows: Number of rows of \f$ A \f$.
+     * @param[in] ncols: Number of columns of \f$ A \f$.
+     * @param[in] irow: Array of row indexes.
+     * @param[in] icol: Array of column indexes.
+     * @param[in] row_data: Pointer to physical data (\ref STARSH_ssdata object).
+     * @param[in] col_data: Pointer to physical data (\ref STARSH_ssdata object).
+     * @param[out] result: Pointer to memory of \f$ A \f$.
+     * @param[in] ld: Leading dimension of `result`.
+     * @ingroup app-spatial-kernels
+     * */
+{
+    int i, j, k;
+    STARSH_ssdata *data1 = row_data;
+    STARSH_ssdata *data2 = col_data;
+    // Read parameters
+    int ndim = data1->particles.ndim;
+    double beta = data1->beta;
+    double nu1 = data1->nu;
+    double nu2 = data1->nu2;
+    double noise = data1->noise;
+    double sigma1 = data1->sigma;
+    double sigma2 = data1->sigma2;
+    double corr = data1->corr;
+    // Get coordinates
+    STARSH_int count1 = data1->particles.count;
+    STARSH_int count2 = data2->particles.count;
+    double *x1 = data1->particles.point;
+    double *x2 = data2->particles.point;
+    double *buffer = result;
+    double nu12 = 0.5*(nu1+nu2);
+    double rho = corr*sqrt((tgamma(nu1+1)*tgamma(nu2+1)) /
+            (tgamma(nu1)*tgamma(nu2))) * tgamma(nu12)/tgamma(nu12+1);
+    double con1 = sigma1/(pow(2, nu1-1)*tgamma(nu1));
+    double con2 = sigma2/(pow(2, nu2-1)*tgamma(nu2));
+    double con12 = rho*sqrt(sigma1*sigma2)/(pow(2, nu12-1)*tgamma(nu12));
+    size_t stride = ld;
+    // Fill column-major tensor
+    for(j = 0; j < ncols; j++)
+    {
+        double *out11 = buffer+4*j*stride;
+        double *out21 = out11+stride;
+        double *out12 = out11+2*stride;
+        double *out22 = out11+3*stride;
+        for(i = 0; i < nrows; i++)
+        {
+            double tmp, dist = 0.0;
+            for(k = 0; k < ndim; k++)
+            {
+                tmp = x1[k*count1+irow[i]]-x2[k*count2+icol[j]];
+                dist += tmp*tmp;
+            }
+            dist = sqrt(dist)/beta;
+            if(dist == 0)
+            {
+                out11[i] = sigma1+noise;
+                out21[i] = rho*sqrt(sigma1*sigma2);
+                out12[i] = out21[i];
+                out22[i] = sigma2+noise;
+            }
+            else
+            {
+                out11[i] = con1*pow(dist, nu1)*gsl_sf_bessel_Knu(nu1, dist);
+                out21[i] = con12*pow(dist, nu12)*
+                    gsl_sf_bessel_Knu(nu12, dist);
+                out12[i] = out21[i];
+                out22[i] = con2*pow(dist, nu2)*gsl_sf_bessel_Knu(nu2, dist);
+            }
+        }
+    }
+}
+
 void starsh_ssdata_block_parsimonious2_kernel_2d_simd_gcd(int nrows, int ncols,
         STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
         void *result, int ld)
@@ -1562,20 +1675,10 @@ void starsh_ssdata_block_parsimonious2_kernel_2d_simd_gcd(int nrows, int ncols,
     double sigma2 = data1->sigma2;
     double corr  = data1->corr;
 
-    // Get coordinates
-    STARSH_int count1 = data1->particles.count;
-    STARSH_int count2 = data2->particles.count;
-    double *x1[2], *x2[2];
-    x1[0] = data1->particles.point;
-    x2[0] = data2->particles.point;
-#pragma omp simd
-    for(i = 1; i < 2; i++)
-    {
-        x1[i] = x1[0]+i*count1;
-        x2[i] = x2[0]+i*count2;
-    }
-    double *x1_cur, *x2_cur;
     double *buffer = result;
+    // Great-circle distances are computed first, then kernel is applied to
+    // them in place
+    gcd_distance(nrows, ncols, irow, icol, data1, data2, buffer, ld);
     double con1 = 0.0, con2 = 0.0, con12 = 0.0, rho = 0.0, nu12 = 0.0;
 
     con1 = pow(2,(nu1-1)) * tgamma(nu1);
@@ -1604,8 +1707,7 @@ void starsh_ssdata_block_parsimonious2_kernel_2d_simd_gcd(int nrows, int ncols,
         for(i = 0; i < nrows; i++)
         {
 
-            dist = distanceEarth(x1[0][irow[i]], x1[1][irow[i]],
-                    x2[0][icol[j]], x2[1][icol[j]]);
+            dist = buffer[j*(size_t)ld+i];
             dist = dist/beta;
             if( i % 2 ==0)
             {
@@ -123,8 +123,8 @@ double starsh_blrm__dfe_mpi(STARSH_blrm *matrix)
             double *D, D_norm[ncols];
             // Allocate temporary array and fill it with elements of a block
             STARSH_PMALLOC(D, (size_t)nrows*(size_t)ncols, info);
-            kernel(nrows, ncols, R->pivot+R->start[i], C->pivot+C->start[j],
-                    RD, CD, D, nrows);
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
             // Compute norm of a block
             for(STARSH_int k = 0; k < ncols; k++)
                 D_norm[k] = cblas_dnrm2(nrows, D+k*(size_t)nrows, 1);
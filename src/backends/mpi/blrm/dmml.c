@@ -18,8 +18,9 @@ int starsh_blrm__dmml_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
         double *A, int lda, double beta, double *B, int ldb)
 //! Multiply blr-matrix by dense matrix on MPI nodes.
 /*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` and dense matrices
- * `B` and `C`. All the integer types are int, since they are used in BLAS
- * calls.
+ * `B` and `C`. Temporary buffers are allocated for each call, use
+ * starsh_blrm_mml_plan_create() to reuse them in repeated multiplications.
+ * All the integer types are int, since they are used in BLAS calls.
  *
  * @param[in] matrix: Pointer to @ref STARSH_blrm object.
  * @param[in] nrhs: Number of right hand sides.
@@ -33,10 +34,40 @@ int starsh_blrm__dmml_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
  * @ingroup blrm
  * */
 {
-    STARSH_blrm *M = matrix;
+    STARSH_blrm_mml_plan *plan;
+    int info = starsh_blrm__mml_plan_new(&plan, matrix, nrhs, 1);
+    if(info != STARSH_SUCCESS)
+        return info;
+    info = starsh_blrm__dmml_plan_mpi(plan, nrhs, alpha, A, lda, beta, B,
+            ldb);
+    starsh_blrm_mml_plan_destroy(plan);
+    return info;
+}
+
+int starsh_blrm__dmml_plan_mpi(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb)
+//! Multiply blr-matrix by dense matrix on MPI nodes with precomputed plan.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` and dense matrices
+ * `B` and `C`, using temporary buffers of a given plan. Right hand sides
+ * are broadcasted from root node by a single call if they are stored
+ * contiguously. Result is kept only on root node. All the integer types are
+ * int, since they are used in BLAS calls.
+ *
+ * @param[in] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] nrhs: Number of right hand sides, not greater than in plan.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = plan->matrix;
     STARSH_blrf *F = M->format;
     STARSH_problem *P = F->problem;
-    STARSH_kernel *kernel = P->kernel;
     STARSH_int nrows = P->shape[0];
     STARSH_int ncols = P->shape[P->ndim-1];
     // Shorcuts to information about clusters
@@ -48,53 +79,38 @@ int starsh_blrm__dmml_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
     STARSH_int nblocks_near_local = F->nblocks_near_local;
     STARSH_int lbi;
     char symm = F->symm;
-    int maxrank = 0;
-    for(lbi = 0; lbi < nblocks_far_local; lbi++)
-        if(maxrank < M->far_rank[lbi])
-            maxrank = M->far_rank[lbi];
-    STARSH_int maxnb = nrows/F->nbrows;
     int mpi_size, mpi_rank;
     MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
     MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
-    for(int i = 0; i < nrhs; i++)
-        MPI_Bcast(A+i*lda, ncols, MPI_DOUBLE, 0, MPI_COMM_WORLD);
-    double *temp_D, *temp_B;
-    int num_threads;
-#ifdef OPENMP
-    #pragma omp parallel
-    #pragma omp master
-    num_threads = omp_get_num_threads();
-#else
-    num_threads = 1;
-#endif
-    if(M->onfly == 0)
-    {
-        STARSH_MALLOC(temp_D, num_threads*nrhs*maxrank);
-    }
+    if(lda == ncols)
+        MPI_Bcast(A, nrhs*ncols, MPI_DOUBLE, 0, MPI_COMM_WORLD);
     else
-    {
-        STARSH_MALLOC(temp_D, num_threads*maxnb*maxnb);
-    }
-    STARSH_MALLOC(temp_B, num_threads*nrhs*nrows);
+        for(int i = 0; i < nrhs; i++)
+            MPI_Bcast(A+i*(size_t)lda, ncols, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    // Buffers of a plan are used only by threads, for which they were
+    // allocated
+    int num_threads = plan->num_threads;
+    size_t size_D = plan->size_D;
+    double *temp_D = plan->temp_D, *temp_B = plan->temp_B;
+    int ldout = nrows;
     // Setting temp_B=beta*B for master thread of root node and B=0 otherwise
-    #pragma omp parallel
+    #pragma omp parallel num_threads(num_threads)
     {
 #ifdef OPENMP
-        double *out = temp_B+omp_get_thread_num()*nrhs*nrows;
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
 #else
         double *out = temp_B;
 #endif
-        for(size_t j = 0; j < nrhs*(size_t)nrows; j++)
+        for(size_t j = 0; j < nrhs*(size_t)ldout; j++)
             out[j] = 0.;
     }
     if(beta != 0. && mpi_rank == 0)
-        #pragma omp parallel for schedule(static)
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
         for(STARSH_int i = 0; i < nrows; i++)
             for(STARSH_int j = 0; j < nrhs; j++)
-                temp_B[j*ldb+i] = beta*B[j*ldb+i];
-    int ldout = nrows;
+                temp_B[j*(size_t)ldout+i] = beta*B[j*(size_t)ldb+i];
     // Simple cycle over all far-field admissible blocks
-    #pragma omp parallel for schedule(dynamic, 1)
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
     for(lbi = 0; lbi < nblocks_far_local; lbi++)
     {
         STARSH_int bi = F->block_far_local[lbi];
@@ -109,10 +125,9 @@ int starsh_blrm__dmml_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
             continue;
         // Get pointers to data buffers
         double *U = M->far_U[lbi]->data, *V = M->far_V[lbi]->data;
-        int info = 0;
 #ifdef OPENMP
-        double *D = temp_D+omp_get_thread_num()*nrhs*maxrank;
-        double *out = temp_B+omp_get_thread_num()*nrhs*ldout;
+        double *D = temp_D+omp_get_thread_num()*size_D;
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
 #else
         double *D = temp_D;
         double *out = temp_B;
@@ -133,86 +148,57 @@ int starsh_blrm__dmml_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
                     out+C->start[j], ldout);
         }
     }
-    if(M->onfly == 1)
-        // Simple cycle over all near-field blocks
-        #pragma omp parallel for schedule(dynamic, 1)
-        for(lbi = 0; lbi < nblocks_near_local; lbi++)
-        {
-            STARSH_int bi = F->block_near_local[lbi];
-            // Get indexes and sizes of corresponding block row and column
-            STARSH_int i = F->block_near[2*bi];
-            STARSH_int j = F->block_near[2*bi+1];
-            int nrows = R->size[i];
-            int ncols = C->size[j];
-            int info = 0;
+    // Simple cycle over all near-field blocks
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+    for(lbi = 0; lbi < nblocks_near_local; lbi++)
+    {
+        STARSH_int bi = F->block_near_local[lbi];
+        // Get indexes and sizes of corresponding block row and column
+        STARSH_int i = F->block_near[2*bi];
+        STARSH_int j = F->block_near[2*bi+1];
+        int nrows = R->size[i];
+        int ncols = C->size[j];
 #ifdef OPENMP
-            double *D = temp_D+omp_get_thread_num()*maxnb*maxnb;
-            double *out = temp_B+omp_get_thread_num()*nrhs*ldout;
+        double *D = temp_D+omp_get_thread_num()*size_D;
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
 #else
-            double *D = temp_D;
-            double *out = temp_B;
+        double *D = temp_D;
+        double *out = temp_B;
 #endif
+        if(M->onfly == 1)
             // Fill temporary buffer with elements of corresponding block
-            kernel(nrows, ncols, R->pivot+R->start[i],
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
                     C->pivot+C->start[j], RD, CD, D, nrows);
-            // Multiply 2 dense matrices
-            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
-                    nrhs, ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
-                    out+R->start[i], ldout);
-            if(i != j && symm == 'S')
-            {
-                // Repeat in case of symmetric matrix
-                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols,
-                        nrhs, nrows, alpha, D, nrows, A+R->start[i], lda,
-                        1.0, out+C->start[j], ldout);
-            }
-        }
-    else
-        // Simple cycle over all near-field blocks
-        #pragma omp parallel for schedule(dynamic, 1)
-        for(lbi = 0; lbi < nblocks_near_local; lbi++)
+        else
+            D = M->near_D[lbi]->data;
+        // Multiply 2 dense matrices
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
+                out+R->start[i], ldout);
+        if(i != j && symm == 'S')
         {
-            STARSH_int bi = F->block_near_local[lbi];
-            // Get indexes and sizes of corresponding block row and column
-            STARSH_int i = F->block_near[2*bi];
-            STARSH_int j = F->block_near[2*bi+1];
-            int nrows = R->size[i];
-            int ncols = C->size[j];
-            // Get pointers to data buffers
-            double *D = M->near_D[lbi]->data;
-#ifdef OPENMP
-            double *out = temp_B+omp_get_thread_num()*nrhs*ldout;
-#else
-            double *out = temp_B;
-#endif
-            // Multiply 2 dense matrices
-            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
-                    nrhs, ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
-                    out+R->start[i], ldout);
-            if(i != j && symm == 'S')
-            {
-                // Repeat in case of symmetric matrix
-                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols,
-                        nrhs, nrows, alpha, D, nrows, A+R->start[i], lda,
-                        1.0, out+C->start[j], ldout);
-            }
+            // Repeat in case of symmetric matrix
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols, nrhs,
+                    nrows, alpha, D, nrows, A+R->start[i], lda, 1.0,
+                    out+C->start[j], ldout);
         }
+    }
     // Reduce result to temp_B, corresponding to master openmp thread
-    #pragma omp parallel for schedule(static)
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
     for(int i = 0; i < ldout; i++)
         for(int j = 0; j < nrhs; j++)
             for(int k = 1; k < num_threads; k++)
                 temp_B[j*(size_t)ldout+i] +=
                         temp_B[(k*(size_t)nrhs+j)*ldout+i];
-    // Since I keep result only on root node, following code is commented
-    //for(int i = 0; i < nrhs; i++)
-    //    MPI_Allreduce(temp_B+i*ldout, B+i*ldb, ldout, MPI_DOUBLE, MPI_SUM,
-    //            MPI_COMM_WORLD);
-    for(int i = 0; i < nrhs; i++)
-        MPI_Reduce(temp_B+i*ldout, B+i*ldb, ldout, MPI_DOUBLE, MPI_SUM, 0,
+    // Result is kept only on root node, all right hand sides are reduced by
+    // a single call if they are stored contiguously
+    if(ldb == ldout)
+        MPI_Reduce(temp_B, B, nrhs*ldout, MPI_DOUBLE, MPI_SUM, 0,
                 MPI_COMM_WORLD);
-    free(temp_B);
-    free(temp_D);
+    else
+        for(int i = 0; i < nrhs; i++)
+            MPI_Reduce(temp_B+i*(size_t)ldout, B+i*(size_t)ldb, ldout,
+                    MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
     return STARSH_SUCCESS;
 }
 
@@ -240,7 +226,6 @@ int starsh_blrm__dmml_mpi_tlr(STARSH_blrm *matrix, int nrhs, double alpha,
     STARSH_blrm *M = matrix;
     STARSH_blrf *F = M->format;
     STARSH_problem *P = F->problem;
-    STARSH_kernel *kernel = P->kernel;
     STARSH_int nrows = P->shape[0];
     STARSH_int ncols = P->shape[P->ndim-1];
     // Shorcuts to information about clusters
@@ -468,7 +453,7 @@ int starsh_blrm__dmml_mpi_tlr(STARSH_blrm *matrix, int nrhs, double alpha,
             double *out = temp_B;
 #endif
             // Fill temporary buffer with elements of corresponding block
-            kernel(nrows, ncols, R->pivot+R->start[i],
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
                     C->pivot+C->start[j], RD, CD, D, nrows);
             // Multiply 2 dense matrices
             //cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
@@ -590,3 +575,162 @@ int starsh_blrm__dmml_mpi_tlr(STARSH_blrm *matrix, int nrhs, double alpha,
     free(temp_D);
     return STARSH_SUCCESS;
 }
+
+int starsh_blrm__dmml_trans_mpi(STARSH_blrm *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb)
+//! Multiply transposed blr-matrix by dense matrix on MPI nodes.
+/*! Performs `C=alpha*A^T*B+beta*C` with @ref STARSH_blrm `A` and dense
+ * matrices `B` and `C`. Each node multiplies only its local tiles, so lists
+ * `block_far_local` and `block_near_local` are used instead of global lists
+ * of tiles in each block column. Result is kept only on root node. Symmetric
+ * matrix is simply multiplied by starsh_blrm__dmml_mpi(). All the integer
+ * types are int, since they are used in BLAS calls.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Number of right hand sides.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int nrows = P->shape[0];
+    STARSH_int ncols = P->shape[P->ndim-1];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    // Number of far-field and near-field blocks
+    STARSH_int nblocks_far_local = F->nblocks_far_local;
+    STARSH_int nblocks_near_local = F->nblocks_near_local;
+    STARSH_int lbi;
+    if(F->symm == 'S')
+        return starsh_blrm__dmml_mpi(matrix, nrhs, alpha, A, lda, beta, B,
+                ldb);
+    // Get maximal rank and maximal size of tile to allocate buffers.
+    // Starting value 1 keeps buffer size from being zero
+    int maxrank = 1, maxrow = 1, maxcol = 1;
+    for(lbi = 0; lbi < nblocks_far_local; lbi++)
+        if(maxrank < M->far_rank[lbi])
+            maxrank = M->far_rank[lbi];
+    for(lbi = 0; lbi < F->nbrows; lbi++)
+        if(maxrow < R->size[lbi])
+            maxrow = R->size[lbi];
+    for(lbi = 0; lbi < F->nbcols; lbi++)
+        if(maxcol < C->size[lbi])
+            maxcol = C->size[lbi];
+    size_t size_D = nrhs*(size_t)maxrank;
+    if(M->onfly == 1 && size_D < maxrow*(size_t)maxcol)
+        size_D = maxrow*(size_t)maxcol;
+    int mpi_size, mpi_rank;
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    for(int i = 0; i < nrhs; i++)
+        MPI_Bcast(A+i*lda, nrows, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    double *temp_D, *temp_B;
+    int num_threads;
+#ifdef OPENMP
+    #pragma omp parallel
+    #pragma omp master
+    num_threads = omp_get_num_threads();
+#else
+    num_threads = 1;
+#endif
+    STARSH_MALLOC(temp_D, num_threads*size_D);
+    STARSH_MALLOC(temp_B, num_threads*nrhs*(size_t)ncols);
+    // Setting temp_B=beta*B for master thread of root node and B=0 otherwise
+    #pragma omp parallel
+    {
+#ifdef OPENMP
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ncols;
+#else
+        double *out = temp_B;
+#endif
+        for(size_t j = 0; j < nrhs*(size_t)ncols; j++)
+            out[j] = 0.;
+    }
+    int ldout = ncols;
+    if(beta != 0. && mpi_rank == 0)
+        #pragma omp parallel for schedule(static)
+        for(STARSH_int i = 0; i < ncols; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                temp_B[j*(size_t)ldout+i] = beta*B[j*(size_t)ldb+i];
+    // Simple cycle over all local far-field admissible blocks
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(lbi = 0; lbi < nblocks_far_local; lbi++)
+    {
+        STARSH_int bi = F->block_far_local[lbi];
+        // Get indexes of corresponding block row and block column
+        STARSH_int i = F->block_far[2*bi];
+        STARSH_int j = F->block_far[2*bi+1];
+        // Get sizes and rank
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+        int rank = M->far_rank[lbi];
+        if(rank == 0)
+            continue;
+        // Get pointers to data buffers
+        double *U = M->far_U[lbi]->data, *V = M->far_V[lbi]->data;
+#ifdef OPENMP
+        double *D = temp_D+omp_get_thread_num()*size_D;
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
+#else
+        double *D = temp_D;
+        double *out = temp_B;
+#endif
+        // Multiply low-rank matrix in V*U^T format by a dense matrix
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                nrows, 1.0, U, nrows, A+R->start[i], lda, 0.0, D, rank);
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, ncols, nrhs,
+                rank, alpha, V, ncols, D, rank, 1.0, out+C->start[j], ldout);
+    }
+    // Simple cycle over all local near-field blocks
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(lbi = 0; lbi < nblocks_near_local; lbi++)
+    {
+        STARSH_int bi = F->block_near_local[lbi];
+        // Get indexes and sizes of corresponding block row and column
+        STARSH_int i = F->block_near[2*bi];
+        STARSH_int j = F->block_near[2*bi+1];
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+#ifdef OPENMP
+        double *D = temp_D+omp_get_thread_num()*size_D;
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
+#else
+        double *D = temp_D;
+        double *out = temp_B;
+#endif
+        if(M->onfly == 1)
+            // Fill temporary buffer with elements of corresponding block
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
+        else
+            D = M->near_D[lbi]->data;
+        // Multiply transposed dense matrix by a dense matrix
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols, nrhs,
+                nrows, alpha, D, nrows, A+R->start[i], lda, 1.0,
+                out+C->start[j], ldout);
+    }
+    // Reduce result to temp_B, corresponding to master openmp thread
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < ldout; i++)
+        for(int j = 0; j < nrhs; j++)
+            for(int k = 1; k < num_threads; k++)
+                temp_B[j*(size_t)ldout+i] +=
+                        temp_B[(k*(size_t)nrhs+j)*ldout+i];
+    // Result is kept only on root node
+    for(int i = 0; i < nrhs; i++)
+        MPI_Reduce(temp_B+i*(size_t)ldout, B+i*(size_t)ldb, ldout,
+                MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    free(temp_B);
+    free(temp_D);
+    return STARSH_SUCCESS;
+}
@@ -27,7 +27,6 @@ int starsh_blrm__dna_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
 {
     STARSH_blrf *F = format;
     STARSH_problem *P = F->problem;
-    STARSH_kernel *kernel = P->kernel;
     STARSH_int nblocks_far = F->nblocks_far;
     STARSH_int nblocks_near = F->nblocks_near;
     STARSH_int nblocks_far_local = F->nblocks_far_local;
@@ -324,7 +323,7 @@ int starsh_blrm__dna_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
 #ifdef OPENMP
             double time0 = omp_get_wtime();
 #endif
-            kernel(nrows, ncols, RC->pivot+RC->start[i],
+            starsh_problem_kernel(P, nrows, ncols, RC->pivot+RC->start[i],
                     CC->pivot+CC->start[j], RD, CD, D, nrows);
 #ifdef OPENMP
             double time1 = omp_get_wtime();
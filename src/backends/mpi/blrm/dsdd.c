@@ -27,6 +27,11 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
  * @ingroup blrm
  * */
 {
+    if(maxrank <= 0)
+    {
+        STARSH_ERROR("Parameter `maxrank` must be positive");
+        return STARSH_WRONG_PARAMETER;
+    }
     STARSH_blrf *F = format;
     STARSH_problem *P = F->problem;
     STARSH_kernel *kernel = P->kernel;
@@ -51,9 +56,21 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
     // Places to store low-rank factors, dense blocks and ranks
     Array **far_U = NULL, **far_V = NULL, **near_D = NULL;
     int *far_rank = NULL;
-    double *alloc_U = NULL, *alloc_V = NULL, *alloc_D = NULL;
-    size_t offset_U = 0, offset_V = 0, offset_D = 0;
+    double *alloc_U = NULL, *alloc_V = NULL;
+    size_t offset_U = 0, offset_V = 0;
     STARSH_int lbi, lbj, bi, bj = 0;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Dense false far-field blocks, kept to avoid computing them again
+    double **false_far_D = NULL;
+    if(onfly == 0 && nblocks_far_local > 0)
+    {
+        STARSH_MALLOC(false_far_D, nblocks_far_local);
+    }
     double drsdd_time = 0, kernel_time = 0;
     // Init buffers to store low-rank factors of far-field blocks if needed
     if(nblocks_far > 0)
@@ -96,8 +113,6 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
         offset_U = 0;
         offset_V = 0;
     }
-    // Work variables
-    int info;
     // Simple cycle over all far-field admissible blocks
     #pragma omp parallel for schedule(dynamic, 1)
     for(lbi = 0; lbi < nblocks_far_local; lbi++)
@@ -125,11 +140,21 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
 #endif
         kernel(nrows, ncols, RC->pivot+RC->start[i], CC->pivot+CC->start[j],
                 RD, CD, D, nrows);
+        // Factorization overwrites elements of the block, so they are copied
+        // in case the block turns out to be a false far-field block
+        double *DD = NULL;
+        if(onfly == 0)
+        {
+            STARSH_PMALLOC(DD, (size_t)nrows*(size_t)ncols, info);
+            if(DD != NULL)
+                memcpy(DD, D, sizeof(*D)*(size_t)nrows*(size_t)ncols);
+        }
 #ifdef OPENMP
         double time1 = omp_get_wtime();
 #endif
+        double tile_tol = starsh_blrf_dtile_tol(F, norm, tol, i, j);
         starsh_dense_dlrsdd(nrows, ncols, D, nrows, far_U[lbi]->data, nrows,
-                far_V[lbi]->data, ncols, far_rank+lbi, maxrank, tol, work,
+                far_V[lbi]->data, ncols, far_rank+lbi, maxrank, tile_tol, work,
                 lwork, iwork);
 #ifdef OPENMP
         double time2 = omp_get_wtime();
@@ -139,6 +164,11 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
             kernel_time += time1-time0;
         }
 #endif
+        // Keep dense false far-field block for near-field blocks or free it
+        if(far_rank[lbi] == -1 && onfly == 0)
+            false_far_D[lbi] = DD;
+        else
+            free(DD);
         // Free temporary arrays
         free(D);
         free(work);
@@ -158,7 +188,13 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
         lbj = 0;
         for(lbi = 0; lbi < nblocks_far_local; lbi++)
             if(far_rank[lbi] == -1)
+            {
+                // Order of kept dense blocks is the same, as order of local
+                // false far-field blocks in updated list of near-field blocks
+                if(onfly == 0)
+                    false_far_D[lbj] = false_far_D[lbi];
                 false_far_local[lbj++] = block_far_local[lbi];
+            }
     }
     // Sync list of all false far-field blocks
     STARSH_int nblocks_false_far = 0;
@@ -272,8 +308,8 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
     if(onfly == 0 && new_nblocks_near > 0)
     {
         STARSH_MALLOC(near_D, new_nblocks_near_local);
-        size_t size_D = 0;
-        // Simple cycle over all near-field blocks
+        // Each near-field block gets its own buffer, so that dense false
+        // far-field blocks become near-field blocks without copying
         for(lbi = 0; lbi < new_nblocks_near_local; lbi++)
         {
             STARSH_int bi = block_near_local[lbi];
@@ -281,16 +317,24 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
             STARSH_int i = block_near[2*bi];
             STARSH_int j = block_near[2*bi+1];
             // Get corresponding sizes and minimum of them
-            size_t nrows = RC->size[i];
-            size_t ncols = CC->size[j];
-            // Update size_D
-            size_D += nrows*ncols;
+            int nrows = RC->size[i];
+            int ncols = CC->size[j];
+            int shape[2] = {nrows, ncols};
+            double *D = NULL;
+            // False far-field block could be already computed
+            if(lbi >= nblocks_near_local)
+                D = false_far_D[lbi-nblocks_near_local];
+            if(D == NULL)
+                STARSH_MALLOC(D, (size_t)nrows*(size_t)ncols);
+            array_from_buffer(near_D+lbi, 2, shape, 'd', 'F', D);
         }
-        STARSH_MALLOC(alloc_D, size_D);
         // For each near-field block compute its elements
         #pragma omp parallel for schedule(dynamic, 1)
         for(lbi = 0; lbi < new_nblocks_near_local; lbi++)
         {
+            if(lbi >= nblocks_near_local
+                    && false_far_D[lbi-nblocks_near_local] != NULL)
+                continue;
             STARSH_int bi = block_near_local[lbi];
             // Get indexes of corresponding block row and block column
             STARSH_int i = block_near[2*bi];
@@ -298,21 +342,11 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
             // Get corresponding sizes and minimum of them
             int nrows = RC->size[i];
             int ncols = CC->size[j];
-            int shape[2] = {nrows, ncols};
-            double *D;
-            #pragma omp critical
-            {
-                D = alloc_D+offset_D;
-                offset_D += nrows*ncols;
-                //array_from_buffer(near_D+lbi, 2, shape, 'd', 'F', D);
-                //offset_D += near_D[lbi]->size;
-            }
-            array_from_buffer(near_D+lbi, 2, shape, 'd', 'F', D);
 #ifdef OPENMP
             double time0 = omp_get_wtime();
 #endif
-            kernel(nrows, ncols, RC->pivot+RC->start[i],
-                    CC->pivot+CC->start[j], RD, CD, D, nrows);
+            starsh_problem_kernel(P, nrows, ncols, RC->pivot+RC->start[i],
+                    CC->pivot+CC->start[j], RD, CD, near_D[lbi]->data, nrows);
 #ifdef OPENMP
             double time1 = omp_get_wtime();
             #pragma omp critical
@@ -364,6 +398,7 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
         free(false_far);
     if(nblocks_false_far_local > 0)
         free(false_far_local);
+    free(false_far_D);
     // Finish with creating instance of Block Low-Rank Matrix with given
     // buffers
 #ifdef OPENMP
@@ -379,6 +414,6 @@ int starsh_blrm__dsdd_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
     }
 #endif
     return starsh_blrm_new_mpi(matrix, F, far_rank, far_U, far_V, onfly,
-            near_D, alloc_U, alloc_V, alloc_D, '1');
+            near_D, alloc_U, alloc_V, NULL, '3');
 }
 
@@ -0,0 +1,215 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/mpi/blrm/zmml.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+#include "starsh-mpi.h"
+
+int starsh_blrm__zmml_mpi(STARSH_blrm *matrix, int nrhs,
+        double _Complex alpha, double _Complex *A, int lda,
+        double _Complex beta, double _Complex *B, int ldb)
+//! Multiply complex blr-matrix by dense matrix on MPI nodes.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` and dense matrices
+ * `B` and `C`. Far-field tiles are stored as `U*V^T` and symmetric matrix is
+ * assumed to be complex symmetric (not hermitian). Result is kept only on
+ * root node. All the integer types are int, since they are used in BLAS
+ * calls.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Number of right hand sides.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int nrows = P->shape[0];
+    STARSH_int ncols = P->shape[P->ndim-1];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    // Number of far-field and near-field blocks
+    STARSH_int nblocks_far_local = F->nblocks_far_local;
+    STARSH_int nblocks_near_local = F->nblocks_near_local;
+    STARSH_int lbi;
+    char symm = F->symm;
+    int maxrank = 1;
+    for(lbi = 0; lbi < nblocks_far_local; lbi++)
+        if(maxrank < M->far_rank[lbi])
+            maxrank = M->far_rank[lbi];
+    STARSH_int maxnb = nrows/F->nbrows;
+    int mpi_size, mpi_rank;
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    for(int i = 0; i < nrhs; i++)
+        MPI_Bcast(A+i*lda, ncols, MPI_C_DOUBLE_COMPLEX, 0, MPI_COMM_WORLD);
+    double _Complex *temp_D, *temp_B;
+    double _Complex zero = 0.0, one = 1.0;
+    int num_threads;
+#ifdef OPENMP
+    #pragma omp parallel
+    #pragma omp master
+    num_threads = omp_get_num_threads();
+#else
+    num_threads = 1;
+#endif
+    if(M->onfly == 0)
+    {
+        STARSH_MALLOC(temp_D, num_threads*nrhs*maxrank);
+    }
+    else
+    {
+        STARSH_MALLOC(temp_D, num_threads*maxnb*maxnb);
+    }
+    STARSH_MALLOC(temp_B, num_threads*nrhs*nrows);
+    // Setting temp_B=beta*B for master thread of root node and B=0 otherwise
+    #pragma omp parallel
+    {
+#ifdef OPENMP
+        double _Complex *out = temp_B+omp_get_thread_num()*nrhs*nrows;
+#else
+        double _Complex *out = temp_B;
+#endif
+        for(size_t j = 0; j < nrhs*(size_t)nrows; j++)
+            out[j] = 0.;
+    }
+    if(beta != 0. && mpi_rank == 0)
+        #pragma omp parallel for schedule(static)
+        for(STARSH_int i = 0; i < nrows; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                temp_B[j*ldb+i] = beta*B[j*ldb+i];
+    int ldout = nrows;
+    // Simple cycle over all far-field admissible blocks
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(lbi = 0; lbi < nblocks_far_local; lbi++)
+    {
+        STARSH_int bi = F->block_far_local[lbi];
+        // Get indexes of corresponding block row and block column
+        STARSH_int i = F->block_far[2*bi];
+        STARSH_int j = F->block_far[2*bi+1];
+        // Get sizes and rank
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+        int rank = M->far_rank[lbi];
+        if(rank == 0)
+            continue;
+        // Get pointers to data buffers
+        double _Complex *U = M->far_U[lbi]->data;
+        double _Complex *V = M->far_V[lbi]->data;
+#ifdef OPENMP
+        double _Complex *D = temp_D+omp_get_thread_num()*nrhs*maxrank;
+        double _Complex *out = temp_B+omp_get_thread_num()*nrhs*ldout;
+#else
+        double _Complex *D = temp_D;
+        double _Complex *out = temp_B;
+#endif
+        // Multiply low-rank matrix in U*V^T format by a dense matrix
+        cblas_zgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                ncols, &one, V, ncols, A+C->start[j], lda, &zero, D, rank);
+        cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                rank, &alpha, U, nrows, D, rank, &one, out+R->start[i], ldout);
+        if(i != j && symm == 'S')
+        {
+            // Multiply low-rank matrix in V*U^T format by a dense matrix
+            // U and V are simply swapped in case of symmetric block
+            cblas_zgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                    nrows, &one, U, nrows, A+R->start[i], lda, &zero, D, rank);
+            cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, ncols,
+                    nrhs, rank, &alpha, V, ncols, D, rank, &one,
+                    out+C->start[j], ldout);
+        }
+    }
+    if(M->onfly == 1)
+        // Simple cycle over all near-field blocks
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(lbi = 0; lbi < nblocks_near_local; lbi++)
+        {
+            STARSH_int bi = F->block_near_local[lbi];
+            // Get indexes and sizes of corresponding block row and column
+            STARSH_int i = F->block_near[2*bi];
+            STARSH_int j = F->block_near[2*bi+1];
+            int nrows = R->size[i];
+            int ncols = C->size[j];
+#ifdef OPENMP
+            double _Complex *D = temp_D+omp_get_thread_num()*maxnb*maxnb;
+            double _Complex *out = temp_B+omp_get_thread_num()*nrhs*ldout;
+#else
+            double _Complex *D = temp_D;
+            double _Complex *out = temp_B;
+#endif
+            // Fill temporary buffer with elements of corresponding block
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
+            // Multiply 2 dense matrices
+            cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                    nrhs, ncols, &alpha, D, nrows, A+C->start[j], lda, &one,
+                    out+R->start[i], ldout);
+            if(i != j && symm == 'S')
+            {
+                // Repeat in case of symmetric matrix
+                cblas_zgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols,
+                        nrhs, nrows, &alpha, D, nrows, A+R->start[i], lda,
+                        &one, out+C->start[j], ldout);
+            }
+        }
+    else
+        // Simple cycle over all near-field blocks
+        #pragma omp parallel for schedule(dynamic, 1)
+        for(lbi = 0; lbi < nblocks_near_local; lbi++)
+        {
+            STARSH_int bi = F->block_near_local[lbi];
+            // Get indexes and sizes of corresponding block row and column
+            STARSH_int i = F->block_near[2*bi];
+            STARSH_int j = F->block_near[2*bi+1];
+            int nrows = R->size[i];
+            int ncols = C->size[j];
+            // Get pointers to data buffers
+            double _Complex *D = M->near_D[lbi]->data;
+#ifdef OPENMP
+            double _Complex *out = temp_B+omp_get_thread_num()*nrhs*ldout;
+#else
+            double _Complex *out = temp_B;
+#endif
+            // Multiply 2 dense matrices
+            cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                    nrhs, ncols, &alpha, D, nrows, A+C->start[j], lda, &one,
+                    out+R->start[i], ldout);
+            if(i != j && symm == 'S')
+            {
+                // Repeat in case of symmetric matrix
+                cblas_zgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols,
+                        nrhs, nrows, &alpha, D, nrows, A+R->start[i], lda,
+                        &one, out+C->start[j], ldout);
+            }
+        }
+    // Reduce result to temp_B, corresponding to master openmp thread
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < ldout; i++)
+        for(int j = 0; j < nrhs; j++)
+            for(int k = 1; k < num_threads; k++)
+                temp_B[j*(size_t)ldout+i] +=
+                        temp_B[(k*(size_t)nrhs+j)*ldout+i];
+    // Result is kept only on root node
+    for(int i = 0; i < nrhs; i++)
+        MPI_Reduce(temp_B+i*ldout, B+i*ldb, ldout, MPI_C_DOUBLE_COMPLEX,
+                MPI_SUM, 0, MPI_COMM_WORLD);
+    free(temp_B);
+    free(temp_D);
+    return STARSH_SUCCESS;
+}
@@ -27,6 +27,11 @@ int starsh_blrm__drsdd_mpi_starpu(STARSH_blrm **matrix, STARSH_blrf *format,
  * @ingroup blrm
  * */
 {
+    if(maxrank <= 0)
+    {
+        STARSH_ERROR("Parameter `maxrank` must be positive");
+        return STARSH_WRONG_PARAMETER;
+    }
     STARSH_blrf *F = format;
     STARSH_problem *P = F->problem;
     STARSH_kernel *kernel = P->kernel;
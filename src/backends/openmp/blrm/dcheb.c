@@ -0,0 +1,273 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/openmp/blrm/dcheb.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_blrm__dcheb_omp(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly)
+//! Approximate each tile by polynomial interpolation of a kernel.
+/*! Far-field blocks are approximated in parallel by their submatrices on
+ * skeleton particles, as in starsh_blrm__dcheb(). Number of nodes `p` in
+ * each dimension grows from 2 for blocks, whose interpolation error on a few
+ * computed columns is larger than `tol`, while `p^ndim` does not exceed
+ * `maxrank`. Remaining blocks are stored as dense blocks. Geometry of both
+ * clusters must be set by starsh_cluster_set_geometry().
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
+ * @param[in] format: Block low-rank format.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance.
+ * @param[in] onfly: Whether not to store dense blocks.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    if(maxrank <= 0)
+    {
+        STARSH_ERROR("Parameter `maxrank` must be positive");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = format;
+    STARSH_problem *P = F->problem;
+    STARSH_kernel *kernel = P->kernel;
+    STARSH_int nblocks_far = F->nblocks_far;
+    // Shortcuts to information about clusters
+    STARSH_cluster *RC = F->row_cluster;
+    STARSH_cluster *CC = F->col_cluster;
+    void *RD = RC->data, *CD = CC->data;
+    if(P->ndim != 2 || P->dtype != 'd')
+    {
+        STARSH_ERROR("Chebyshev interpolation requires real 2D problem");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(RC->point == NULL || CC->point == NULL || RC->ndim != CC->ndim)
+    {
+        STARSH_ERROR("Chebyshev interpolation requires geometry of clusters, "
+                "set by starsh_cluster_set_geometry()");
+        return STARSH_WRONG_PARAMETER;
+    }
+    int ndim = RC->ndim, pmax = 1, p, r, d;
+    // Get largest number of nodes in each dimension
+    while(1)
+    {
+        int r2 = 1;
+        for(d = 0; d < ndim; d++)
+            r2 *= pmax+1;
+        if(r2 > maxrank)
+            break;
+        pmax++;
+    }
+    STARSH_int *block_far = F->block_far;
+    // Places to store low-rank factors and ranks
+    Array **far_U = NULL, **far_V = NULL;
+    int *far_rank = NULL;
+    double *alloc_U = NULL, *alloc_V = NULL, **false_far_D = NULL;
+    size_t offset_U = 0, offset_V = 0;
+    STARSH_int bi, bk;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Init buffers to store low-rank factors of far-field blocks if needed
+    if(nblocks_far > 0)
+    {
+        size_t size_U = 0, size_V = 0;
+        // Simple cycle over all far-field blocks
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            size_U += RC->size[i];
+            size_V += CC->size[j];
+        }
+        size_U *= maxrank;
+        size_V *= maxrank;
+        STARSH_PMALLOC(far_U, nblocks_far, info);
+        STARSH_PMALLOC(far_V, nblocks_far, info);
+        STARSH_PMALLOC(far_rank, nblocks_far, info);
+        STARSH_PMALLOC(alloc_U, size_U, info);
+        STARSH_PMALLOC(alloc_V, size_V, info);
+        if(onfly == 0)
+        {
+            false_far_D = calloc(nblocks_far, sizeof(*false_far_D));
+            if(false_far_D == NULL)
+            {
+                STARSH_ERROR("calloc() failed");
+                info = STARSH_MALLOC_ERROR;
+            }
+        }
+        if(info != STARSH_SUCCESS)
+        {
+            free(far_U);
+            free(far_V);
+            free(far_rank);
+            free(alloc_U);
+            free(alloc_V);
+            free(false_far_D);
+            return info;
+        }
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            size_t nrows = RC->size[i], ncols = CC->size[j];
+            int shape_U[] = {nrows, maxrank};
+            int shape_V[] = {ncols, maxrank};
+            double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
+            offset_U += nrows*maxrank;
+            offset_V += ncols*maxrank;
+            array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
+            array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+            // Block is not approximated yet
+            far_rank[bi] = -1;
+        }
+        STARSH_int *pending, npending = nblocks_far;
+        size_t *row_offset, *col_offset;
+        STARSH_PMALLOC(pending, nblocks_far, info);
+        STARSH_PMALLOC(row_offset, RC->nblocks, info);
+        STARSH_PMALLOC(col_offset, CC->nblocks, info);
+        // Far-field blocks, whose interpolation error is too large, are
+        // approximated again with more nodes
+        for(bi = 0; bi < nblocks_far; bi++)
+            pending[bi] = bi;
+        for(p = pmax < 2 ? pmax : 2; info == STARSH_SUCCESS && p <= pmax &&
+                npending > 0; p++)
+        {
+            // Interpolation matrices and skeletons of row and column clusters
+            double *row_Q, *row_R, *col_Q, *col_R;
+            STARSH_int *row_skel, *col_skel;
+            int *row_rank, *col_rank;
+            for(d = 0, r = 1; d < ndim; d++)
+                r *= p;
+            info = starsh_blrm__dcheb_basis(RC, p, &row_Q, &row_R, &row_skel,
+                    &row_rank);
+            if(info != STARSH_SUCCESS)
+                break;
+            if(CC != RC)
+            {
+                info = starsh_blrm__dcheb_basis(CC, p, &col_Q, &col_R,
+                        &col_skel, &col_rank);
+                if(info != STARSH_SUCCESS)
+                {
+                    free(row_Q);
+                    free(row_R);
+                    free(row_skel);
+                    free(row_rank);
+                    break;
+                }
+            }
+            else
+            {
+                col_Q = row_Q;
+                col_R = row_R;
+                col_skel = row_skel;
+                col_rank = row_rank;
+            }
+            row_offset[0] = 0;
+            for(bi = 1; bi < RC->nblocks; bi++)
+                row_offset[bi] = row_offset[bi-1]+(size_t)RC->size[bi-1]*r;
+            col_offset[0] = 0;
+            for(bi = 1; bi < CC->nblocks; bi++)
+                col_offset[bi] = col_offset[bi-1]+(size_t)CC->size[bi-1]*r;
+            int nsample = starsh_params.oversample;
+            int lwork = 8*r*(r+1), liwork = 8*r;
+            // Cycle over far-field blocks, that are not approximated yet
+            #pragma omp parallel for schedule(dynamic,1)
+            for(bk = 0; bk < npending; bk++)
+            {
+                STARSH_int bi = pending[bk];
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_far[2*bi];
+                STARSH_int j = block_far[2*bi+1];
+                // Get corresponding sizes and minimum of them
+                int nrows = RC->size[i];
+                int ncols = CC->size[j];
+                int krow = row_rank[i], kcol = col_rank[j];
+                int mlwork = lwork > nrows*nsample ? lwork : nrows*nsample;
+                double *core = NULL, *work = NULL;
+                int *iwork = NULL;
+                STARSH_int *sample = NULL;
+                int info = STARSH_SUCCESS;
+                // Allocate temporary arrays
+                STARSH_PMALLOC(core, (size_t)krow*kcol, info);
+                STARSH_PMALLOC(work, mlwork, info);
+                STARSH_PMALLOC(iwork, liwork, info);
+                STARSH_PMALLOC(sample, nsample, info);
+                if(info == STARSH_SUCCESS)
+                {
+                    double tile_tol = starsh_blrf_dtile_tol(F, norm, tol, i,
+                            j);
+                    // Compute kernel on skeleton particles
+                    kernel(krow, kcol, row_skel+i*r, col_skel+j*r, RD, CD,
+                            core, krow);
+                    starsh_dense_dlrcheb(nrows, ncols, krow, kcol, core,
+                            row_Q+row_offset[i], row_R+(size_t)i*r*r,
+                            col_Q+col_offset[j], col_R+(size_t)j*r*r,
+                            far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                            far_rank+bi, maxrank, tile_tol, work, mlwork,
+                            iwork);
+                    starsh_dense_dlrcheb_check(nrows, ncols, kernel,
+                            RC->pivot+RC->start[i], CC->pivot+CC->start[j],
+                            RD, CD, far_U[bi]->data, nrows, far_V[bi]->data,
+                            ncols, far_rank+bi, tile_tol, nsample, work,
+                            sample);
+                }
+                // If there is no memory for approximation, rank of the block
+                // stays -1 and the block is tried again with more nodes
+                // Free temporary arrays
+                free(core);
+                free(work);
+                free(iwork);
+                free(sample);
+            }
+            STARSH_int nfailed = 0;
+            for(bk = 0; bk < npending; bk++)
+                if(far_rank[pending[bk]] == -1)
+                    pending[nfailed++] = pending[bk];
+            npending = nfailed;
+            free(row_Q);
+            free(row_R);
+            free(row_skel);
+            free(row_rank);
+            if(CC != RC)
+            {
+                free(col_Q);
+                free(col_R);
+                free(col_skel);
+                free(col_rank);
+            }
+        }
+        free(pending);
+        free(row_offset);
+        free(col_offset);
+        if(info != STARSH_SUCCESS)
+        {
+            free(far_U);
+            free(far_V);
+            free(far_rank);
+            free(alloc_U);
+            free(alloc_V);
+            free(false_far_D);
+            return info;
+        }
+    }
+    // Blocks, that are not approximated with largest number of nodes, are
+    // false far-field blocks
+    return starsh_blrm__dnew_far_omp(matrix, F, far_rank, far_U, far_V, NULL,
+            false_far_D, onfly, alloc_U, alloc_V);
+}
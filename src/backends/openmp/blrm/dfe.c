@@ -71,9 +71,22 @@ double starsh_blrm__dfe_omp(STARSH_blrm *matrix)
         double tmpnorm = cblas_dnrm2(ncols, D_norm, 1);
         far_block_norm[bi] = tmpnorm;
         // Get difference of initial and approximated block
-        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, ncols,
-                rank, -1., U[bi]->data, nrows, V[bi]->data, ncols, 1.,
-                D, nrows);
+        if(M->far_skel == NULL)
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, ncols,
+                    rank, -1., U[bi]->data, nrows, V[bi]->data, ncols, 1.,
+                    D, nrows);
+        else
+        {
+            // Approximation is U*D(skel,:), so copy skeleton rows first
+            double *S;
+            STARSH_PMALLOC(S, (size_t)rank*(size_t)ncols, info);
+            for(int k = 0; k < rank; k++)
+                cblas_dcopy(ncols, D+M->far_skel[bi][k], nrows, S+k, rank);
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                    ncols, rank, -1., U[bi]->data, nrows, S, rank, 1., D,
+                    nrows);
+            free(S);
+        }
         // Compute Frobenius norm of the latter
         for(size_t k = 0; k < ncols; k++)
             D_norm[k] = cblas_dnrm2(nrows, D+k*nrows, 1);
@@ -125,8 +138,8 @@ double starsh_blrm__dfe_omp(STARSH_blrm *matrix)
             double *D, D_norm[ncols];
             // Allocate temporary array and fill it with elements of a block
             STARSH_PMALLOC(D, (size_t)nrows*(size_t)ncols, info);
-            kernel(nrows, ncols, R->pivot+R->start[i], C->pivot+C->start[j],
-                    RD, CD, D, nrows);
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
             // Compute norm of a block
             for(size_t k = 0; k < ncols; k++)
                 D_norm[k] = cblas_dnrm2(nrows, D+k*nrows, 1);
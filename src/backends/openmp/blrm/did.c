@@ -0,0 +1,306 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/openmp/blrm/did.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_blrm__did_omp(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly)
+//! Approximate each tile by interpolative decomposition.
+/*! Each far-field tile is approximated by its interpolation matrix and its
+ * skeleton rows. Only indexes of skeleton rows are stored, so resulting
+ * matrix requires roughly half of memory of other low-rank engines.
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
+ * @param[in] format: Block low-rank format.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance.
+ * @param[in] onfly: Whether not to store dense blocks.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    if(maxrank <= 0)
+    {
+        STARSH_ERROR("Parameter `maxrank` must be positive");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = format;
+    STARSH_problem *P = F->problem;
+    STARSH_kernel *kernel = P->kernel;
+    STARSH_int nblocks_far = F->nblocks_far;
+    STARSH_int nblocks_near = F->nblocks_near;
+    // Shortcuts to information about clusters
+    STARSH_cluster *RC = F->row_cluster;
+    STARSH_cluster *CC = F->col_cluster;
+    void *RD = RC->data, *CD = CC->data;
+    // Following values default to given block low-rank format F, but they are
+    // changed when there are false far-field blocks.
+    STARSH_int new_nblocks_far = nblocks_far;
+    STARSH_int new_nblocks_near = nblocks_near;
+    STARSH_int *block_far = F->block_far;
+    STARSH_int *block_near = F->block_near;
+    // Places to store interpolation matrices, skeleton rows, dense blocks
+    // and ranks
+    Array **far_U = NULL, **near_D = NULL;
+    int **far_skel = NULL;
+    int *far_rank = NULL, *alloc_skel = NULL;
+    double *alloc_U = NULL;
+    size_t offset_U = 0;
+    STARSH_int bi, bj = 0;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Dense false far-field blocks, kept to avoid computing them again
+    double **false_far_D = NULL;
+    if(onfly == 0 && nblocks_far > 0)
+    {
+        STARSH_MALLOC(false_far_D, nblocks_far);
+    }
+    // Init buffers to store interpolation matrices and skeleton rows of
+    // far-field blocks if needed
+    if(nblocks_far > 0)
+    {
+        STARSH_MALLOC(far_U, nblocks_far);
+        STARSH_MALLOC(far_skel, nblocks_far);
+        STARSH_MALLOC(far_rank, nblocks_far);
+        size_t size_U = 0;
+        // Simple cycle over all far-field blocks
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row
+            STARSH_int i = block_far[2*bi];
+            size_U += RC->size[i];
+        }
+        size_U *= maxrank;
+        STARSH_MALLOC(alloc_U, size_U);
+        STARSH_MALLOC(alloc_skel, nblocks_far*(size_t)maxrank);
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row
+            STARSH_int i = block_far[2*bi];
+            size_t nrows = RC->size[i];
+            int shape_U[] = {nrows, maxrank};
+            double *U = alloc_U+offset_U;
+            offset_U += nrows*maxrank;
+            array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
+            far_skel[bi] = alloc_skel+bi*(size_t)maxrank;
+        }
+        offset_U = 0;
+    }
+    // Simple cycle over all far-field admissible blocks
+    #pragma omp parallel for schedule(dynamic,1)
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        // Get indexes of corresponding block row and block column
+        STARSH_int i = block_far[2*bi];
+        STARSH_int j = block_far[2*bi+1];
+        // Get corresponding sizes and minimum of them
+        int nrows = RC->size[i];
+        int ncols = CC->size[j];
+        int mn = nrows < ncols ? nrows : ncols;
+        // Get size of temporary arrays
+        int lwork = nrows*ncols+2*mn+3*nrows+1;
+        int liwork = nrows;
+        double *D, *work;
+        int *iwork;
+        int info = STARSH_SUCCESS;
+        // Allocate temporary arrays
+        STARSH_PMALLOC(D, (size_t)nrows*(size_t)ncols, info);
+        STARSH_PMALLOC(iwork, liwork, info);
+        STARSH_PMALLOC(work, lwork, info);
+        if(info != STARSH_SUCCESS)
+        {
+            // Block is stored as dense one, if it can not be approximated
+            free(D);
+            free(work);
+            free(iwork);
+            far_rank[bi] = -1;
+            if(onfly == 0)
+                false_far_D[bi] = NULL;
+            continue;
+        }
+        // Compute elements of a block
+        kernel(nrows, ncols, RC->pivot+RC->start[i], CC->pivot+CC->start[j],
+                RD, CD, D, nrows);
+        starsh_dense_dlrid(nrows, ncols, D, nrows, far_U[bi]->data, nrows,
+                far_skel[bi], far_rank+bi, maxrank,
+                starsh_blrf_dtile_tol(F, norm, tol, i, j), work, lwork, iwork);
+        // Keep dense false far-field block for near-field blocks or free it
+        if(far_rank[bi] == -1 && onfly == 0)
+            false_far_D[bi] = D;
+        else
+            free(D);
+        // Free temporary arrays
+        free(work);
+        free(iwork);
+    }
+    // Get number of false far-field blocks
+    STARSH_int nblocks_false_far = 0;
+    STARSH_int *false_far = NULL;
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(far_rank[bi] == -1)
+            nblocks_false_far++;
+    if(nblocks_false_far > 0)
+    {
+        // IMPORTANT: `false_far` must to be in ascending order for later code
+        // to work normally
+        STARSH_MALLOC(false_far, nblocks_false_far);
+        bj = 0;
+        for(bi = 0; bi < nblocks_far; bi++)
+            if(far_rank[bi] == -1)
+                false_far[bj++] = bi;
+        // Order of kept dense blocks is the same, as order of false far-field
+        // blocks in updated list of near-field blocks
+        if(onfly == 0)
+            for(bi = 0; bi < nblocks_false_far; bi++)
+                false_far_D[bi] = false_far_D[false_far[bi]];
+    }
+    // Update lists of far-field and near-field blocks using previously
+    // generated list of false far-field blocks
+    if(nblocks_false_far > 0)
+    {
+        // Update list of near-field blocks
+        new_nblocks_near = nblocks_near+nblocks_false_far;
+        STARSH_MALLOC(block_near, 2*new_nblocks_near);
+        // At first get all near-field blocks, assumed to be dense
+        #pragma omp parallel for schedule(static)
+        for(bi = 0; bi < 2*nblocks_near; bi++)
+            block_near[bi] = F->block_near[bi];
+        // Add false far-field blocks
+        #pragma omp parallel for schedule(static)
+        for(bi = 0; bi < nblocks_false_far; bi++)
+        {
+            STARSH_int bj = false_far[bi];
+            block_near[2*(bi+nblocks_near)] = F->block_far[2*bj];
+            block_near[2*(bi+nblocks_near)+1] = F->block_far[2*bj+1];
+        }
+        // Update list of far-field blocks
+        new_nblocks_far = nblocks_far-nblocks_false_far;
+        if(new_nblocks_far > 0)
+        {
+            STARSH_MALLOC(block_far, 2*new_nblocks_far);
+            bj = 0;
+            for(bi = 0; bi < nblocks_far; bi++)
+            {
+                // `false_far` must be in ascending order for this to work
+                if(bj < nblocks_false_far && false_far[bj] == bi)
+                {
+                    bj++;
+                }
+                else
+                {
+                    block_far[2*(bi-bj)] = F->block_far[2*bi];
+                    block_far[2*(bi-bj)+1] = F->block_far[2*bi+1];
+                }
+            }
+        }
+        // Update format by creating new format
+        STARSH_blrf *F2;
+        info = starsh_blrf_new_from_coo(&F2, P, F->symm, RC, CC,
+                new_nblocks_far, block_far, new_nblocks_near, block_near,
+                F->type);
+        // Swap internal data of formats and free unnecessary data
+        STARSH_blrf tmp_blrf = *F;
+        *F = *F2;
+        *F2 = tmp_blrf;
+        STARSH_WARNING("`F` was modified due to false far-field blocks");
+        starsh_blrf_free(F2);
+    }
+    // Compute near-field blocks if needed
+    if(onfly == 0 && new_nblocks_near > 0)
+    {
+        STARSH_MALLOC(near_D, new_nblocks_near);
+        // Each near-field block gets its own buffer, so that dense false
+        // far-field blocks become near-field blocks without copying
+        for(bi = 0; bi < new_nblocks_near; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_near[2*bi];
+            STARSH_int j = block_near[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            int nrows = RC->size[i];
+            int ncols = CC->size[j];
+            int shape[2] = {nrows, ncols};
+            double *D = NULL;
+            // False far-field block could be already computed
+            if(bi >= nblocks_near)
+                D = false_far_D[bi-nblocks_near];
+            if(D == NULL)
+                STARSH_MALLOC(D, (size_t)nrows*(size_t)ncols);
+            array_from_buffer(near_D+bi, 2, shape, 'd', 'F', D);
+        }
+        // For each near-field block compute its elements
+        #pragma omp parallel for schedule(dynamic,1)
+        for(bi = 0; bi < new_nblocks_near; bi++)
+        {
+            if(bi >= nblocks_near && false_far_D[bi-nblocks_near] != NULL)
+                continue;
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_near[2*bi];
+            STARSH_int j = block_near[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            int nrows = RC->size[i];
+            int ncols = CC->size[j];
+            starsh_problem_kernel(P, nrows, ncols, RC->pivot+RC->start[i],
+                    CC->pivot+CC->start[j], RD, CD, near_D[bi]->data, nrows);
+        }
+    }
+    // Change sizes of far_rank, far_U and far_skel if there were false
+    // far-field blocks
+    if(nblocks_false_far > 0 && new_nblocks_far > 0)
+    {
+        bj = 0;
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            if(far_rank[bi] == -1)
+                bj++;
+            else
+            {
+                int shape_U[2] = {far_U[bi]->shape[0], far_rank[bi]};
+                array_from_buffer(far_U+bi-bj, 2, shape_U, 'd', 'F',
+                        far_U[bi]->data);
+                far_skel[bi-bj] = far_skel[bi];
+                far_rank[bi-bj] = far_rank[bi];
+            }
+        }
+        STARSH_REALLOC(far_rank, new_nblocks_far);
+        STARSH_REALLOC(far_U, new_nblocks_far);
+        STARSH_REALLOC(far_skel, new_nblocks_far);
+    }
+    // If all far-field blocks are false, then dealloc buffers
+    if(new_nblocks_far == 0 && nblocks_far > 0)
+    {
+        block_far = NULL;
+        free(far_rank);
+        far_rank = NULL;
+        free(far_U);
+        far_U = NULL;
+        free(far_skel);
+        far_skel = NULL;
+        free(alloc_U);
+        alloc_U = NULL;
+        free(alloc_skel);
+        alloc_skel = NULL;
+    }
+    // Dealloc list of false far-field blocks if it is not empty
+    if(nblocks_false_far > 0)
+        free(false_far);
+    free(false_far_D);
+    // Finish with creating instance of Block Low-Rank Matrix with given
+    // buffers
+    return starsh_blrm_new_skel(matrix, F, far_rank, far_U, far_skel, onfly,
+            near_D, alloc_U, alloc_skel, NULL, '3');
+}
+
@@ -13,12 +13,149 @@
 #include "common.h"
 #include "starsh.h"
 
+static void dmml_csr(int nrows, int nrhs, double alpha, const int *ptr,
+        const int *ind, const double *val, const double *A, int lda,
+        double *B, int ldb)
+// Multiply block in CSR format by dense matrix: B += alpha*D*A
+{
+    for(int l = 0; l < nrhs; l++)
+    {
+        const double *a = A+l*(size_t)lda;
+        double *b = B+l*(size_t)ldb;
+        for(int k = 0; k < nrows; k++)
+        {
+            double sum = 0.;
+            for(int m = ptr[k]; m < ptr[k+1]; m++)
+                sum += val[m]*a[ind[m]];
+            b[k] += alpha*sum;
+        }
+    }
+}
+
+static void dmml_csr_trans(int nrows, int nrhs, double alpha, const int *ptr,
+        const int *ind, const double *val, const double *A, int lda,
+        double *B, int ldb)
+// Multiply transposed block in CSR format by dense matrix: B += alpha*D^T*A
+{
+    for(int l = 0; l < nrhs; l++)
+    {
+        const double *a = A+l*(size_t)lda;
+        double *b = B+l*(size_t)ldb;
+        for(int k = 0; k < nrows; k++)
+        {
+            double ak = alpha*a[k];
+            for(int m = ptr[k]; m < ptr[k+1]; m++)
+                b[ind[m]] += val[m]*ak;
+        }
+    }
+}
+
+static void dmml_panel_products(STARSH_blrm_mml_plan *plan, int trans,
+        int nrhs, const double *A, int lda)
+// Multiply panels of block columns (block rows if `trans` is not zero) by
+// corresponding rows of right hand sides: T=W^T*A. Each panel is multiplied
+// by a single GEMM and its product is stored in `temp_T` of a plan.
+{
+    STARSH_blrf *F = plan->matrix->format;
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    STARSH_int nbrows = F->nbrows;
+    STARSH_int first = trans ? 0 : nbrows;
+    STARSH_int npanels = trans ? nbrows : F->nbcols;
+    #pragma omp parallel for schedule(dynamic, 1) \
+            num_threads(plan->num_threads)
+    for(STARSH_int k = 0; k < npanels; k++)
+    {
+        STARSH_int p = first+k;
+        int rank = plan->panel_rank[p];
+        if(rank == 0 || plan->panel_W[p] == NULL)
+            continue;
+        int nrows = trans ? R->size[k] : C->size[k];
+        STARSH_int start = trans ? R->start[k] : C->start[k];
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                nrows, 1.0, plan->panel_W[p], nrows, A+start, lda, 0.0,
+                plan->temp_T+plan->panel_offset[p], rank);
+    }
+}
+
+static int dmml_far_list(STARSH_blrm_mml_plan *plan, STARSH_int nblocks,
+        const STARSH_int *block, int trans, STARSH_int skip, int nrhs,
+        double alpha, double *D, int ldd, int pos, double *B, int ldb)
+// Multiply far-field blocks of a list, sharing the same block row (block
+// column if `trans` is not zero): B += alpha*U*V^T*A (B += alpha*V*U^T*A).
+// Products V^T*A (U^T*A) are computed by dmml_panel_products() and gathered
+// in D, starting from row `pos`, and factors U (V), adjacent in memory, are
+// multiplied by a single GEMM. Blocks of block column (block row) `skip` are
+// ignored. Returns next row of D.
+{
+    STARSH_blrm *M = plan->matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    STARSH_int nbrows = F->nbrows;
+    // Current run of adjacent factors
+    double *W = NULL;
+    int nrows = 0, rank = 0, start = pos;
+    for(STARSH_int k = 0; k < nblocks; k++)
+    {
+        STARSH_int bi = block[k];
+        STARSH_int i = F->block_far[2*bi];
+        STARSH_int j = F->block_far[2*bi+1];
+        int bi_rank = M->far_rank[bi];
+        if((trans ? i : j) == skip || bi_rank == 0)
+            continue;
+        double *next;
+        int next_nrows;
+        // Panel, containing product of a block by right hand sides
+        STARSH_int p;
+        if(trans)
+        {
+            p = F->symm == 'S' ? nbrows+i : i;
+            next = plan->far_V[bi];
+            next_nrows = C->size[j];
+        }
+        else
+        {
+            p = nbrows+j;
+            next = M->far_U[bi]->data;
+            next_nrows = R->size[i];
+        }
+        double *T = plan->temp_T+plan->panel_offset[p]+
+            plan->far_pos[2*bi+trans];
+        for(int l = 0; l < nrhs; l++)
+            cblas_dcopy(bi_rank, T+(size_t)l*plan->panel_rank[p], 1,
+                    D+pos+(size_t)l*ldd, 1);
+        if(W != NULL && next != W+(size_t)nrows*rank)
+        {
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                    nrhs, rank, alpha, W, nrows, D+start, ldd, 1.0, B, ldb);
+            W = NULL;
+        }
+        if(W == NULL)
+        {
+            W = next;
+            nrows = next_nrows;
+            rank = 0;
+            start = pos;
+        }
+        rank += bi_rank;
+        pos += bi_rank;
+    }
+    if(W != NULL)
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                rank, alpha, W, nrows, D+start, ldd, 1.0, B, ldb);
+    return pos;
+}
+
 int starsh_blrm__dmml_omp(STARSH_blrm *matrix, int nrhs, double alpha,
         double *A, int lda, double beta, double *B, int ldb)
 //! Multiply blr-matrix by dense matrix.
 /*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` and dense matrices
- * `B` and `C`. All the integer types are int, since they are used in BLAS
- * calls.
+ * `B` and `C`. Temporary plan of multiplication is created for each call, so
+ * that concurrent calls with the same `matrix` are allowed. Use
+ * starsh_blrm_mml_plan_create() to reuse temporary buffers in repeated
+ * multiplications. All the integer types are int, since they are used in
+ * BLAS calls.
  *
  * @param[in] matrix: Pointer to @ref STARSH_blrm object.
  * @param[in] nrhs: Number of right hand sides.
@@ -32,12 +169,40 @@ int starsh_blrm__dmml_omp(STARSH_blrm *matrix, int nrhs, double alpha,
  * @ingroup blrm
  * */
 {
-    STARSH_blrm *M = matrix;
+    STARSH_blrm_mml_plan *plan;
+    int info = starsh_blrm__mml_plan_new(&plan, matrix, nrhs, 0);
+    if(info != STARSH_SUCCESS)
+        return info;
+    info = starsh_blrm__dmml_plan_omp(plan, nrhs, alpha, A, lda, beta, B,
+            ldb);
+    starsh_blrm_mml_plan_destroy(plan);
+    return info;
+}
+
+int starsh_blrm__dmml_plan_omp(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb)
+//! Multiply blr-matrix by dense matrix with precomputed plan.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` and dense matrices
+ * `B` and `C`, using temporary buffers of a given plan. Each thread
+ * accumulates its own copy of result, which are summed up at the end. All
+ * the integer types are int, since they are used in BLAS calls.
+ *
+ * @param[in] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] nrhs: Number of right hand sides, not greater than in plan.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = plan->matrix;
     STARSH_blrf *F = M->format;
     STARSH_problem *P = F->problem;
-    STARSH_kernel *kernel = P->kernel;
     STARSH_int nrows = P->shape[0];
-    STARSH_int ncols = P->shape[P->ndim-1];
     // Shorcuts to information about clusters
     STARSH_cluster *R = F->row_cluster;
     STARSH_cluster *C = F->col_cluster;
@@ -46,42 +211,33 @@ int starsh_blrm__dmml_omp(STARSH_blrm *matrix, int nrhs, double alpha,
     STARSH_int nblocks_far = F->nblocks_far;
     STARSH_int nblocks_near = F->nblocks_near, bi;
     char symm = F->symm;
-    int maxrank = 100;
-    int maxnb = nrows/F->nbrows;
+    // Buffers of a plan are used only by threads, for which they were
+    // allocated
+    int num_threads = plan->num_threads;
+    size_t size_D = plan->size_D;
+    double *temp_D = plan->temp_D, *temp_B = plan->temp_B;
     // Setting B = beta*B
     if(beta == 0.)
-        #pragma omp parallel for schedule(static)
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
         for(int i = 0; i < nrows; i++)
             for(int j = 0; j < nrhs; j++)
-                B[j*ldb+i] = 0.;
+                B[j*(size_t)ldb+i] = 0.;
     else
-        #pragma omp parallel for schedule(static)
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
         for(int i = 0; i < nrows; i++)
             for(int j = 0; j < nrhs; j++)
-                B[j*ldb+i] *= beta;
-    double *temp_D, *temp_B;
-    int num_threads;
-    #pragma omp parallel
-    #pragma omp master
-    num_threads = omp_get_num_threads();
-    if(M->onfly == 0)
+                B[j*(size_t)ldb+i] *= beta;
+    #pragma omp parallel num_threads(num_threads)
     {
-        STARSH_MALLOC(temp_D, num_threads*nrhs*maxrank);
-    }
-    else
-    {
-        STARSH_MALLOC(temp_D, num_threads*maxnb*maxnb);
-    }
-    STARSH_MALLOC(temp_B, num_threads*nrhs*nrows);
-    #pragma omp parallel
-    {
-        double *out = temp_B+omp_get_thread_num()*nrhs*nrows;
-        for(int j = 0; j < nrhs*nrows; j++)
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)nrows;
+        for(size_t j = 0; j < nrhs*(size_t)nrows; j++)
             out[j] = 0.;
     }
     int ldout = nrows;
+    // Error of allocation of temporary buffer in any thread
+    int error = STARSH_SUCCESS;
     // Simple cycle over all far-field admissible blocks
-    #pragma omp parallel for schedule(dynamic, 1)
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
     for(bi = 0; bi < nblocks_far; bi++)
     {
         // Get indexes of corresponding block row and block column
@@ -91,11 +247,34 @@ int starsh_blrm__dmml_omp(STARSH_blrm *matrix, int nrhs, double alpha,
         int nrows = R->size[i];
         int ncols = C->size[j];
         int rank = M->far_rank[bi];
+        if(rank == 0)
+            continue;
         // Get pointers to data buffers
-        double *U = M->far_U[bi]->data, *V = M->far_V[bi]->data;
+        double *U = M->far_U[bi]->data, *V;
         int info = 0;
-        double *D = temp_D+omp_get_thread_num()*nrhs*maxrank;
-        double *out = temp_B+omp_get_thread_num()*nrhs*ldout;
+        double *D = temp_D+omp_get_thread_num()*size_D;
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
+        // Compute factor V from skeleton rows if it is not stored
+        if(M->far_skel == NULL)
+            V = M->far_V[bi]->data;
+        else
+        {
+            STARSH_PMALLOC(V, (size_t)ncols*(size_t)rank, info);
+            if(info != STARSH_SUCCESS)
+            {
+                #pragma omp critical
+                error = info;
+                continue;
+            }
+            info = starsh_blrm__dget_far_V(M, bi, V);
+            if(info != STARSH_SUCCESS)
+            {
+                free(V);
+                #pragma omp critical
+                error = info;
+                continue;
+            }
+        }
         // Multiply low-rank matrix in U*V^T format by a dense matrix
         cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
                 ncols, 1.0, V, ncols, A+C->start[j], lda, 0.0, D, rank);
@@ -111,66 +290,335 @@ int starsh_blrm__dmml_omp(STARSH_blrm *matrix, int nrhs, double alpha,
                     nrhs, rank, alpha, V, ncols, D, rank, 1.0,
                     out+C->start[j], ldout);
         }
+        if(M->far_skel != NULL)
+            free(V);
     }
-    if(M->onfly == 1)
-        // Simple cycle over all near-field blocks
-        #pragma omp parallel for schedule(dynamic, 1)
-        for(bi = 0; bi < nblocks_near; bi++)
+    // Simple cycle over all near-field blocks
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+    for(bi = 0; bi < nblocks_near; bi++)
+    {
+        // Get indexes and sizes of corresponding block row and column
+        STARSH_int i = F->block_near[2*bi];
+        STARSH_int j = F->block_near[2*bi+1];
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+        double *D;
+        double *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
+        if(plan->sparse_ptr != NULL && plan->sparse_ptr[bi] != NULL)
         {
-            // Get indexes and sizes of corresponding block row and column
-            STARSH_int i = F->block_near[2*bi];
-            STARSH_int j = F->block_near[2*bi+1];
-            int nrows = R->size[i];
-            int ncols = C->size[j];
-            int info = 0;
-            double *D = temp_D+omp_get_thread_num()*maxnb*maxnb;
-            double *out = temp_B+omp_get_thread_num()*nrhs*ldout;
-            // Fill temporary buffer with elements of corresponding block
-            kernel(nrows, ncols, R->pivot+R->start[i],
-                    C->pivot+C->start[j], RD, CD, D, nrows);
-            // Multiply 2 dense matrices
-            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
-                    nrhs, ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
+            // Multiply sparse block, stored in CSR format
+            int *ptr = plan->sparse_ptr[bi], *ind = plan->sparse_ind[bi];
+            double *val = plan->sparse_val[bi];
+            dmml_csr(nrows, nrhs, alpha, ptr, ind, val, A+C->start[j], lda,
                     out+R->start[i], ldout);
             if(i != j && symm == 'S')
+                dmml_csr_trans(nrows, nrhs, alpha, ptr, ind, val,
+                        A+R->start[i], lda, out+C->start[j], ldout);
+            continue;
+        }
+        if(M->onfly == 1)
+        {
+            // Fill temporary buffer with elements of corresponding block
+            D = temp_D+omp_get_thread_num()*size_D;
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
+        }
+        else
+            D = M->near_D[bi]->data;
+        // Multiply 2 dense matrices
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
+                out+R->start[i], ldout);
+        if(i != j && symm == 'S')
+        {
+            // Repeat in case of symmetric matrix
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols, nrhs,
+                    nrows, alpha, D, nrows, A+R->start[i], lda, 1.0,
+                    out+C->start[j], ldout);
+        }
+    }
+    #pragma omp parallel for schedule(static) num_threads(num_threads)
+    for(int i = 0; i < ldout; i++)
+        for(int j = 0; j < nrhs; j++)
+            for(int k = 0; k < num_threads; k++)
+                B[j*(size_t)ldb+i] += temp_B[(k*(size_t)nrhs+j)*ldout+i];
+    return error;
+}
+
+int starsh_blrm__dmml_panel_omp(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb)
+//! Multiply blr-matrix by dense matrix by panels of block rows.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` and dense matrices
+ * `B` and `C`, using panels of a plan, created by
+ * starsh_blrm_mml_plan_create_panel(). Concatenated factors `V` of each
+ * block column are multiplied by corresponding rows of `B` by a single GEMM.
+ * Then for each block row, these products are gathered and multiplied by
+ * factors `U`, followed by near-field blocks of the block row. Each block row is processed by a single thread, so no
+ * private copies of result are needed. All the integer types are int, since
+ * they are used in BLAS calls.
+ *
+ * @param[in] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] nrhs: Number of right hand sides, not greater than in plan.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = plan->matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int nrows = P->shape[0];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    STARSH_int nbrows = F->nbrows;
+    char symm = F->symm;
+    int num_threads = plan->num_threads;
+    size_t size_D = plan->size_D;
+    int *panel_rank = plan->panel_rank;
+    // Setting B = beta*B
+    if(beta == 0.)
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(STARSH_int i = 0; i < nrows; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] = 0.;
+    else
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(STARSH_int i = 0; i < nrows; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] *= beta;
+    // Products of panels of block columns by right hand sides
+    if(F->nblocks_far > 0)
+        dmml_panel_products(plan, 0, nrhs, A, lda);
+    // Each block row is processed by a single thread
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+    for(STARSH_int i = 0; i < nbrows; i++)
+    {
+        int nrows = R->size[i];
+        int rank = panel_rank[i];
+        double *D = plan->temp_D+omp_get_thread_num()*size_D;
+        double *out = B+R->start[i];
+        STARSH_int k, bi;
+        if(rank > 0)
+        {
+            // Far-field blocks of block row
+            STARSH_int start = F->brow_far_start[i];
+            int pos = dmml_far_list(plan, F->brow_far_start[i+1]-start,
+                    F->brow_far+start, 0, -1, nrhs, alpha, D, rank, 0, out,
+                    ldb);
+            // Transposed far-field blocks in case of symmetric matrix
+            if(symm == 'S')
             {
-                // Repeat in case of symmetric matrix
-                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols,
-                        nrhs, nrows, alpha, D, nrows, A+R->start[i], lda,
-                        1.0, out+C->start[j], ldout);
+                start = plan->bcol_far_start[i];
+                dmml_far_list(plan, plan->bcol_far_start[i+1]-start,
+                        plan->bcol_far+start, 1, i, nrhs, alpha, D, rank,
+                        pos, out, ldb);
             }
         }
-    else
-        // Simple cycle over all near-field blocks
-        #pragma omp parallel for schedule(dynamic, 1)
-        for(bi = 0; bi < nblocks_near; bi++)
+        if(F->nblocks_near == 0)
+            continue;
+        // Near-field blocks of block row
+        for(k = F->brow_near_start[i]; k < F->brow_near_start[i+1]; k++)
         {
-            // Get indexes and sizes of corresponding block row and column
-            STARSH_int i = F->block_near[2*bi];
+            bi = F->brow_near[k];
             STARSH_int j = F->block_near[2*bi+1];
-            int nrows = R->size[i];
             int ncols = C->size[j];
-            // Get pointers to data buffers
-            double *D = M->near_D[bi]->data;
-            double *out = temp_B+omp_get_thread_num()*nrhs*ldout;
-            // Multiply 2 dense matrices
+            double *ND = D;
+            if(plan->sparse_ptr != NULL && plan->sparse_ptr[bi] != NULL)
+            {
+                dmml_csr(nrows, nrhs, alpha, plan->sparse_ptr[bi],
+                        plan->sparse_ind[bi], plan->sparse_val[bi],
+                        A+C->start[j], lda, out, ldb);
+                continue;
+            }
+            if(M->onfly == 1)
+                // Fill temporary buffer with elements of corresponding block
+                starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                        C->pivot+C->start[j], RD, CD, ND, nrows);
+            else
+                ND = M->near_D[bi]->data;
             cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
-                    nrhs, ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
-                    out+R->start[i], ldout);
-            if(i != j && symm == 'S')
+                    nrhs, ncols, alpha, ND, nrows, A+C->start[j], lda, 1.0,
+                    out, ldb);
+        }
+        // Transposed near-field blocks in case of symmetric matrix
+        if(symm == 'S')
+            for(k = plan->bcol_near_start[i]; k < plan->bcol_near_start[i+1];
+                    k++)
             {
-                // Repeat in case of symmetric matrix
-                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols,
-                        nrhs, nrows, alpha, D, nrows, A+R->start[i], lda,
-                        1.0, out+C->start[j], ldout);
+                bi = plan->bcol_near[k];
+                STARSH_int j = F->block_near[2*bi];
+                if(j == i)
+                    continue;
+                int ncols = R->size[j];
+                double *ND = D;
+                if(plan->sparse_ptr != NULL && plan->sparse_ptr[bi] != NULL)
+                {
+                    // Rows of CSR block correspond to block row `j`
+                    dmml_csr_trans(ncols, nrhs, alpha, plan->sparse_ptr[bi],
+                            plan->sparse_ind[bi], plan->sparse_val[bi],
+                            A+R->start[j], lda, out, ldb);
+                    continue;
+                }
+                if(M->onfly == 1)
+                    starsh_problem_kernel(P, ncols, nrows,
+                            R->pivot+R->start[j], C->pivot+C->start[i], RD, CD,
+                            ND, ncols);
+                else
+                    ND = M->near_D[bi]->data;
+                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, nrows,
+                        nrhs, ncols, alpha, ND, ncols, A+R->start[j], lda,
+                        1.0, out, ldb);
             }
+    }
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrm__dmml_trans_omp(STARSH_blrm *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb)
+//! Multiply transposed blr-matrix by dense matrix.
+/*! Performs `C=alpha*A^T*B+beta*C` with @ref STARSH_blrm `A` and dense
+ * matrices `B` and `C`. Temporary plan of multiplication with panels is
+ * created for each call. Use starsh_blrm_mml_plan_create_panel() and
+ * starsh_blrm_mml_plan_execute_trans() to reuse it in repeated
+ * multiplications. All the integer types are int, since they are used in
+ * BLAS calls.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Number of right hand sides.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm_mml_plan *plan;
+    int info = starsh_blrm__mml_plan_new(&plan, matrix, nrhs, 0);
+    if(info != STARSH_SUCCESS)
+        return info;
+    info = starsh_blrm__mml_plan_panel(plan);
+    if(info == STARSH_SUCCESS)
+        info = starsh_blrm__dmml_trans_panel_omp(plan, nrhs, alpha, A, lda,
+                beta, B, ldb);
+    starsh_blrm_mml_plan_destroy(plan);
+    return info;
+}
+
+int starsh_blrm__dmml_trans_panel_omp(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb)
+//! Multiply transposed blr-matrix by dense matrix by panels of block columns.
+/*! Performs `C=alpha*A^T*B+beta*C` with @ref STARSH_blrm `A` and dense
+ * matrices `B` and `C`, using panels of a plan, created by
+ * starsh_blrm_mml_plan_create_panel(). Each block column is processed by a
+ * single thread, and its blocks are found with help of lists `bcol_far` and
+ * `bcol_near` of @ref STARSH_blrf. Concatenated factors `U` of each block
+ * row are multiplied by corresponding rows of `B` by a single GEMM, and
+ * these products are gathered for each block column and multiplied by
+ * factors `V`, followed by near-field blocks, which are multiplied in CSR format if
+ * they were converted by starsh_blrm_mml_plan_sparse(). Symmetric matrix is
+ * simply multiplied by starsh_blrm__dmml_panel_omp(). All the integer types
+ * are int, since they are used in BLAS calls.
+ *
+ * @param[in] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] nrhs: Number of right hand sides, not greater than in plan.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = plan->matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int ncols = P->shape[P->ndim-1];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    STARSH_int nbrows = F->nbrows;
+    int num_threads = plan->num_threads;
+    size_t size_D = plan->size_D;
+    int *panel_rank = plan->panel_rank;
+    if(F->symm == 'S')
+    {
+        // Private copies of result are freed if panels are built
+        if(panel_rank != NULL)
+            return starsh_blrm__dmml_panel_omp(plan, nrhs, alpha, A, lda,
+                    beta, B, ldb);
+        return starsh_blrm__dmml_plan_omp(plan, nrhs, alpha, A, lda, beta, B,
+                ldb);
+    }
+    // Setting B = beta*B
+    if(beta == 0.)
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(STARSH_int i = 0; i < ncols; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] = 0.;
+    else
+        #pragma omp parallel for schedule(static) num_threads(num_threads)
+        for(STARSH_int i = 0; i < ncols; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] *= beta;
+    // Products of panels of block rows by right hand sides
+    if(panel_rank != NULL)
+        dmml_panel_products(plan, 1, nrhs, A, lda);
+    // Each block column is processed by a single thread
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+    for(STARSH_int j = 0; j < F->nbcols; j++)
+    {
+        int ncols = C->size[j];
+        double *D = plan->temp_D+omp_get_thread_num()*size_D;
+        double *out = B+C->start[j];
+        STARSH_int k, bi;
+        // Far-field blocks of block column, panels are absent only if there
+        // are no far-field blocks
+        if(panel_rank != NULL && panel_rank[nbrows+j] > 0)
+        {
+            STARSH_int start = F->bcol_far_start[j];
+            dmml_far_list(plan, F->bcol_far_start[j+1]-start,
+                    F->bcol_far+start, 1, -1, nrhs, alpha, D,
+                    panel_rank[nbrows+j], 0, out, ldb);
         }
-    #pragma omp parallel for schedule(static)
-    for(int i = 0; i < ldout; i++)
-        for(int j = 0; j < nrhs; j++)
-            for(int k = 0; k < num_threads; k++)
-                B[j*ldb+i] += temp_B[(k*nrhs+j)*ldout+i];
-    free(temp_B);
-    free(temp_D);
-    return 0;
+        if(F->nblocks_near == 0)
+            continue;
+        // Near-field blocks of block column
+        for(k = F->bcol_near_start[j]; k < F->bcol_near_start[j+1]; k++)
+        {
+            bi = F->bcol_near[k];
+            STARSH_int i = F->block_near[2*bi];
+            int nrows = R->size[i];
+            double *ND = D;
+            if(plan->sparse_ptr != NULL && plan->sparse_ptr[bi] != NULL)
+            {
+                dmml_csr_trans(nrows, nrhs, alpha, plan->sparse_ptr[bi],
+                        plan->sparse_ind[bi], plan->sparse_val[bi],
+                        A+R->start[i], lda, out, ldb);
+                continue;
+            }
+            if(M->onfly == 1)
+                // Fill temporary buffer with elements of corresponding block
+                starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                        C->pivot+C->start[j], RD, CD, ND, nrows);
+            else
+                ND = M->near_D[bi]->data;
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols, nrhs,
+                    nrows, alpha, ND, nrows, A+R->start[i], lda, 1.0, out,
+                    ldb);
+        }
+    }
+    return STARSH_SUCCESS;
 }
@@ -26,6 +26,11 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
  * @ingroup blrm
  * */
 {
+    if(maxrank <= 0)
+    {
+        STARSH_ERROR("Parameter `maxrank` must be positive");
+        return STARSH_WRONG_PARAMETER;
+    }
     STARSH_blrf *F = format;
     STARSH_problem *P = F->problem;
     STARSH_kernel *kernel = P->kernel;
@@ -44,9 +49,21 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
     // Places to store low-rank factors, dense blocks and ranks
     Array **far_U = NULL, **far_V = NULL, **near_D = NULL;
     int *far_rank = NULL;
-    double *alloc_U = NULL, *alloc_V = NULL, *alloc_D = NULL;
-    size_t offset_U = 0, offset_V = 0, offset_D = 0;
+    double *alloc_U = NULL, *alloc_V = NULL;
+    size_t offset_U = 0, offset_V = 0;
     STARSH_int bi, bj = 0;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Dense false far-field blocks, kept to avoid computing them again
+    double **false_far_D = NULL;
+    if(onfly == 0 && nblocks_far > 0)
+    {
+        STARSH_MALLOC(false_far_D, nblocks_far);
+    }
     const int oversample = starsh_params.oversample;
     // Init buffers to store low-rank factors of far-field blocks if needed
     if(nblocks_far > 0)
@@ -87,8 +104,6 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         offset_U = 0;
         offset_V = 0;
     }
-    // Work variables
-    int info;
     // Simple cycle over all far-field admissible blocks
     #pragma omp parallel for schedule(dynamic,1)
     for(bi = 0; bi < nblocks_far; bi++)
@@ -121,9 +136,24 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         // Compute elements of a block
         kernel(nrows, ncols, RC->pivot+RC->start[i], CC->pivot+CC->start[j],
                 RD, CD, D, nrows);
+        // Factorization overwrites elements of the block, so they are copied
+        // in case the block turns out to be a false far-field block
+        double *DD = NULL;
+        if(onfly == 0)
+        {
+            STARSH_PMALLOC(DD, (size_t)nrows*(size_t)ncols, info);
+            if(DD != NULL)
+                memcpy(DD, D, sizeof(*D)*(size_t)nrows*(size_t)ncols);
+        }
+        double tile_tol = starsh_blrf_dtile_tol(F, norm, tol, i, j);
         starsh_dense_dlrqp3(nrows, ncols, D, nrows, far_U[bi]->data, nrows,
-                far_V[bi]->data, ncols, far_rank+bi, maxrank, oversample, tol,
-                work, lwork, iwork);
+                far_V[bi]->data, ncols, far_rank+bi, maxrank, oversample,
+                tile_tol, work, lwork, iwork);
+        // Keep dense false far-field block for near-field blocks or free it
+        if(far_rank[bi] == -1 && onfly == 0)
+            false_far_D[bi] = DD;
+        else
+            free(DD);
         // Free temporary arrays
         free(D);
         free(work);
@@ -144,6 +174,11 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         for(bi = 0; bi < nblocks_far; bi++)
             if(far_rank[bi] == -1)
                 false_far[bj++] = bi;
+        // Order of kept dense blocks is the same, as order of false far-field
+        // blocks in updated list of near-field blocks
+        if(onfly == 0)
+            for(bi = 0; bi < nblocks_false_far; bi++)
+                false_far_D[bi] = false_far_D[false_far[bi]];
     }
     // Update lists of far-field and near-field blocks using previously
     // generated list of false far-field blocks
@@ -200,40 +235,39 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
     if(onfly == 0 && new_nblocks_near > 0)
     {
         STARSH_MALLOC(near_D, new_nblocks_near);
-        size_t size_D = 0;
-        // Simple cycle over all near-field blocks
+        // Each near-field block gets its own buffer, so that dense false
+        // far-field blocks become near-field blocks without copying
         for(bi = 0; bi < new_nblocks_near; bi++)
         {
             // Get indexes of corresponding block row and block column
             STARSH_int i = block_near[2*bi];
             STARSH_int j = block_near[2*bi+1];
             // Get corresponding sizes and minimum of them
-            size_t nrows = RC->size[i];
-            size_t ncols = CC->size[j];
-            // Update size_D
-            size_D += nrows*ncols;
+            int nrows = RC->size[i];
+            int ncols = CC->size[j];
+            int shape[2] = {nrows, ncols};
+            double *D = NULL;
+            // False far-field block could be already computed
+            if(bi >= nblocks_near)
+                D = false_far_D[bi-nblocks_near];
+            if(D == NULL)
+                STARSH_MALLOC(D, (size_t)nrows*(size_t)ncols);
+            array_from_buffer(near_D+bi, 2, shape, 'd', 'F', D);
         }
-        STARSH_MALLOC(alloc_D, size_D);
         // For each near-field block compute its elements
         #pragma omp parallel for schedule(dynamic,1)
         for(bi = 0; bi < new_nblocks_near; bi++)
         {
+            if(bi >= nblocks_near && false_far_D[bi-nblocks_near] != NULL)
+                continue;
             // Get indexes of corresponding block row and block column
             STARSH_int i = block_near[2*bi];
             STARSH_int j = block_near[2*bi+1];
             // Get corresponding sizes and minimum of them
             int nrows = RC->size[i];
             int ncols = CC->size[j];
-            int shape[2] = {nrows, ncols};
-            double *D;
-            #pragma omp critical
-            {
-                D = alloc_D+offset_D;
-                array_from_buffer(near_D+bi, 2, shape, 'd', 'F', D);
-                offset_D += near_D[bi]->size;
-            }
-            kernel(nrows, ncols, RC->pivot+RC->start[i],
-                    CC->pivot+CC->start[j], RD, CD, D, nrows);
+            starsh_problem_kernel(P, nrows, ncols, RC->pivot+RC->start[i],
+                    CC->pivot+CC->start[j], RD, CD, near_D[bi]->data, nrows);
         }
     }
     // Change sizes of far_rank, far_U and far_V if there were false
@@ -280,9 +314,10 @@ int starsh_blrm__dqp3_omp(STARSH_blrm **matrix, STARSH_blrf *format,
     // Dealloc list of false far-field blocks if it is not empty
     if(nblocks_false_far > 0)
         free(false_far);
+    free(false_far_D);
     // Finish with creating instance of Block Low-Rank Matrix with given
     // buffers
     return starsh_blrm_new(matrix, F, far_rank, far_U, far_V, onfly, near_D,
-            alloc_U, alloc_V, alloc_D, '1');
+            alloc_U, alloc_V, NULL, '3');
 }
 
@@ -13,10 +13,33 @@
 #include "common.h"
 #include "starsh.h"
 
+//! Estimated cost of a task of approximation of a single tile
+struct drsdd_task
+{
+    double cost;
+    //!< Estimated time of generation and compression of a tile.
+    STARSH_int index;
+    //!< Index of far-field block, followed by indexes of near-field blocks.
+};
+
+static int drsdd_task_cmp(const void *a, const void *b)
+//! Compare tasks by cost in descending order
+{
+    double _a = ((const struct drsdd_task *)a)->cost;
+    double _b = ((const struct drsdd_task *)b)->cost;
+    if(_a < _b) return 1;
+    if(_a == _b) return 0;
+    return -1;
+}
+
 int starsh_blrm__drsdd_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         int maxrank, double tol, int onfly)
 //! Approximate each tile by randomized SVD.
-/*!
+/*! Far-field and near-field tiles are processed by a single set of OpenMP
+ * tasks, submitted in descending order of estimated cost. If `maxrank` is not
+ * positive, rank of each tile is limited only by break-even point of
+ * low-rank and dense storage, see starsh_dense_dlrrsdd_grow().
+ *
  * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
  * @param[in] format: Block low-rank format.
  * @param[in] maxrank: Maximum possible rank.
@@ -43,105 +66,281 @@ int starsh_blrm__drsdd_omp(STARSH_blrm **matrix, STARSH_blrf *format,
     // Places to store low-rank factors, dense blocks and ranks
     Array **far_U = NULL, **far_V = NULL, **near_D = NULL;
     int *far_rank = NULL;
-    double *alloc_U = NULL, *alloc_V = NULL, *alloc_D = NULL;
-    size_t offset_U = 0, offset_V = 0, offset_D = 0;
+    double *alloc_U = NULL, *alloc_V = NULL;
+    size_t offset_U = 0, offset_V = 0;
     STARSH_int bi, bj = 0;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation together with costs of tasks
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    double kernel_cost, flop_cost;
+    info = starsh_blrm__dauto_cost(F, &kernel_cost, &flop_cost);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Dense false far-field blocks, kept to avoid computing them again
+    double **false_far_D = NULL;
+    if(onfly == 0 && nblocks_far > 0)
+    {
+        STARSH_MALLOC(false_far_D, nblocks_far);
+    }
     double drsdd_time = 0, kernel_time = 0;
     int BAD_TILE = 0;
     const int oversample = starsh_params.oversample;
+    // Non-positive maxrank means that rank of each block is limited only by
+    // break-even point of low-rank and dense storage
+    const int dynamic = maxrank <= 0;
+    double **tile_U = NULL, **tile_V = NULL;
     // Init buffers to store low-rank factors of far-field blocks if needed
     if(nblocks_far > 0)
     {
         STARSH_MALLOC(far_U, nblocks_far);
         STARSH_MALLOC(far_V, nblocks_far);
         STARSH_MALLOC(far_rank, nblocks_far);
+        if(dynamic)
+        {
+            // Factors of each block are allocated with exact size later
+            STARSH_MALLOC(tile_U, nblocks_far);
+            STARSH_MALLOC(tile_V, nblocks_far);
+        }
+        else
+        {
+            size_t size_U = 0, size_V = 0;
+            // Simple cycle over all far-field blocks
+            for(bi = 0; bi < nblocks_far; bi++)
+            {
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_far[2*bi];
+                STARSH_int j = block_far[2*bi+1];
+                // Get corresponding sizes and minimum of them
+                size_U += RC->size[i];
+                size_V += CC->size[j];
+            }
+            size_U *= maxrank;
+            size_V *= maxrank;
+            STARSH_MALLOC(alloc_U, size_U);
+            STARSH_MALLOC(alloc_V, size_V);
+            for(bi = 0; bi < nblocks_far; bi++)
+            {
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_far[2*bi];
+                STARSH_int j = block_far[2*bi+1];
+                // Get corresponding sizes and minimum of them
+                size_t nrows = RC->size[i], ncols = CC->size[j];
+                int shape_U[] = {nrows, maxrank};
+                int shape_V[] = {ncols, maxrank};
+                double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
+                offset_U += nrows*maxrank;
+                offset_V += ncols*maxrank;
+                array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
+                array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+            }
+            offset_U = 0;
+            offset_V = 0;
+        }
+    }
+    // Storage for near-field blocks, known before approximation, is set up
+    // in advance, so that they are computed together with far-field blocks
+    if(onfly == 0 && nblocks_near > 0)
+    {
+        STARSH_MALLOC(near_D, nblocks_near);
+        // Each near-field block gets its own buffer, so that dense false
+        // far-field blocks are appended later without copying
+        for(bi = 0; bi < nblocks_near; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_near[2*bi];
+            STARSH_int j = block_near[2*bi+1];
+            int shape[2] = {RC->size[i], CC->size[j]};
+            double *D;
+            STARSH_MALLOC(D, (size_t)shape[0]*(size_t)shape[1]);
+            array_from_buffer(near_D+bi, 2, shape, 'd', 'F', D);
+        }
+    }
+    // Tasks for far-field blocks go first, then tasks for near-field blocks
+    STARSH_int ntasks = nblocks_far;
+    if(onfly == 0)
+        ntasks += nblocks_near;
+    struct drsdd_task *task = NULL;
+    if(ntasks > 0)
+    {
+        STARSH_MALLOC(task, ntasks);
+    }
+    for(bi = 0; bi < ntasks; bi++)
+    {
+        STARSH_int i, j;
+        task[bi].index = bi;
+        if(bi < nblocks_far)
+        {
+            i = block_far[2*bi];
+            j = block_far[2*bi+1];
+        }
+        else
+        {
+            i = block_near[2*(bi-nblocks_far)];
+            j = block_near[2*(bi-nblocks_far)+1];
+        }
+        // Costs of generation and compression are measured in seconds, so
+        // that near-field and far-field tasks are comparable
+        double m = RC->size[i], n = CC->size[j];
+        double cost = m*n*kernel_cost;
+        if(bi < nblocks_far)
+        {
+            // Flops of randomized SVD with a given number of random vectors
+            double mn = m < n ? m : n;
+            double k = dynamic ? oversample : maxrank+oversample;
+            if(k > mn)
+                k = mn;
+            cost += flop_cost*(4*m*n*k+4*m*k*k+8*n*k*k);
+        }
+        task[bi].cost = cost;
+    }
+    // Largest tasks are submitted first to avoid idle threads in the end
+    if(ntasks > 0)
+        qsort(task, ntasks, sizeof(*task), drsdd_task_cmp);
+    // Single task graph over all far-field and near-field blocks
+    #pragma omp parallel
+    #pragma omp single
+    for(bj = 0; bj < ntasks; bj++)
+    {
+        STARSH_int bi = task[bj].index;
+        if(bi < nblocks_far)
+        // Far-field block is approximated by randomized SVD
+        {
+            #pragma omp task firstprivate(bi)
+            {
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_far[2*bi];
+                STARSH_int j = block_far[2*bi+1];
+                // Get corresponding sizes and minimum of them
+                int nrows = RC->size[i];
+                int ncols = CC->size[j];
+                if(nrows != ncols && BAD_TILE == 0)
+                {
+                    #pragma omp critical
+                    BAD_TILE = 1;
+                    STARSH_WARNING("This was only tested on square tiles, "
+                            "error of approximation may be much higher, than "
+                            "demanded");
+                }
+                int mn = nrows < ncols ? nrows : ncols;
+                int mn2 = maxrank+oversample;
+                if(mn2 > mn)
+                    mn2 = mn;
+                // Get size of temporary arrays
+                int lwork = ncols, lwork_sdd = (4*mn2+7)*mn2;
+                if(lwork_sdd > lwork)
+                    lwork = lwork_sdd;
+                lwork += (size_t)mn2*(2*ncols+nrows+mn2+1);
+                int liwork = 8*mn2;
+                double *D, *work = NULL;
+                int *iwork = NULL;
+                int info;
+                // Allocate temporary arrays
+                STARSH_PMALLOC(D, (size_t)nrows*(size_t)ncols, info);
+                if(!dynamic)
+                {
+                    STARSH_PMALLOC(iwork, liwork, info);
+                    STARSH_PMALLOC(work, lwork, info);
+                }
+                // Compute elements of a block
+                double time0 = omp_get_wtime();
+                kernel(nrows, ncols, RC->pivot+RC->start[i],
+                        CC->pivot+CC->start[j], RD, CD, D, nrows);
+                double time1 = omp_get_wtime();
+                double tile_tol = starsh_blrf_dtile_tol(F, norm, tol, i, j);
+                if(dynamic)
+                {
+                    info = starsh_dense_dlrrsdd_grow(nrows, ncols, D, nrows,
+                            tile_U+bi, tile_V+bi, far_rank+bi, oversample,
+                            tile_tol);
+                    // Block is stored as dense one, if there is no memory for
+                    // its low-rank factors
+                    if(info != STARSH_SUCCESS)
+                        far_rank[bi] = -1;
+                }
+                else
+                    starsh_dense_dlrrsdd(nrows, ncols, D, nrows,
+                            far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                            far_rank+bi, maxrank, oversample, tile_tol, work,
+                            lwork, iwork);
+                double time2 = omp_get_wtime();
+                #pragma omp critical
+                {
+                    drsdd_time += time2-time1;
+                    kernel_time += time1-time0;
+                }
+                // Keep dense false far-field block or free it
+                if(far_rank[bi] == -1 && onfly == 0)
+                    false_far_D[bi] = D;
+                else
+                    free(D);
+                // Free temporary arrays
+                free(work);
+                free(iwork);
+            }
+        }
+        else
+        // Near-field block is computed and stored
+        {
+            bi -= nblocks_far;
+            #pragma omp task firstprivate(bi)
+            {
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_near[2*bi];
+                STARSH_int j = block_near[2*bi+1];
+                int nrows = RC->size[i];
+                double time0 = omp_get_wtime();
+                starsh_problem_kernel(P, nrows, CC->size[j],
+                        RC->pivot+RC->start[i], CC->pivot+CC->start[j], RD, CD,
+                        near_D[bi]->data, nrows);
+                double time1 = omp_get_wtime();
+                #pragma omp critical
+                kernel_time += time1-time0;
+            }
+        }
+    }
+    free(task);
+    // Pack factors of exact size into contiguous buffers
+    if(dynamic && nblocks_far > 0)
+    {
         size_t size_U = 0, size_V = 0;
-        // Simple cycle over all far-field blocks
         for(bi = 0; bi < nblocks_far; bi++)
         {
-            // Get indexes of corresponding block row and block column
             STARSH_int i = block_far[2*bi];
             STARSH_int j = block_far[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            size_U += RC->size[i];
-            size_V += CC->size[j];
+            if(far_rank[bi] > 0)
+            {
+                size_U += (size_t)RC->size[i]*(size_t)far_rank[bi];
+                size_V += (size_t)CC->size[j]*(size_t)far_rank[bi];
+            }
         }
-        size_U *= maxrank;
-        size_V *= maxrank;
-        STARSH_MALLOC(alloc_U, size_U);
-        STARSH_MALLOC(alloc_V, size_V);
+        // Extra element keeps malloc() from returning NULL
+        STARSH_MALLOC(alloc_U, size_U+1);
+        STARSH_MALLOC(alloc_V, size_V+1);
         for(bi = 0; bi < nblocks_far; bi++)
         {
-            // Get indexes of corresponding block row and block column
             STARSH_int i = block_far[2*bi];
             STARSH_int j = block_far[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            size_t nrows = RC->size[i], ncols = CC->size[j];
-            int shape_U[] = {nrows, maxrank};
-            int shape_V[] = {ncols, maxrank};
+            int rank = far_rank[bi] > 0 ? far_rank[bi] : 0;
+            int shape_U[] = {RC->size[i], rank};
+            int shape_V[] = {CC->size[j], rank};
             double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
-            offset_U += nrows*maxrank;
-            offset_V += ncols*maxrank;
             array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
             array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+            offset_U += far_U[bi]->size;
+            offset_V += far_V[bi]->size;
+            if(far_rank[bi] >= 0)
+            {
+                memcpy(U, tile_U[bi], far_U[bi]->data_nbytes);
+                memcpy(V, tile_V[bi], far_V[bi]->data_nbytes);
+                free(tile_U[bi]);
+                free(tile_V[bi]);
+            }
         }
-        offset_U = 0;
-        offset_V = 0;
-    }
-    // Work variables
-    int info;
-    // Simple cycle over all far-field admissible blocks
-    #pragma omp parallel for schedule(dynamic,1)
-    for(bi = 0; bi < nblocks_far; bi++)
-    {
-        // Get indexes of corresponding block row and block column
-        STARSH_int i = block_far[2*bi];
-        STARSH_int j = block_far[2*bi+1];
-        // Get corresponding sizes and minimum of them
-        int nrows = RC->size[i];
-        int ncols = CC->size[j];
-        if(nrows != ncols && BAD_TILE == 0)
-        {
-            #pragma omp critical
-            BAD_TILE = 1;
-            STARSH_WARNING("This was only tested on square tiles, error of "
-                    "approximation may be much higher, than demanded");
-        }
-        int mn = nrows < ncols ? nrows : ncols;
-        int mn2 = maxrank+oversample;
-        if(mn2 > mn)
-            mn2 = mn;
-        // Get size of temporary arrays
-        int lwork = ncols, lwork_sdd = (4*mn2+7)*mn2;
-        if(lwork_sdd > lwork)
-            lwork = lwork_sdd;
-        lwork += (size_t)mn2*(2*ncols+nrows+mn2+1);
-        int liwork = 8*mn2;
-        double *D, *work;
-        int *iwork;
-        int info;
-        // Allocate temporary arrays
-        STARSH_PMALLOC(D, (size_t)nrows*(size_t)ncols, info);
-        STARSH_PMALLOC(iwork, liwork, info);
-        STARSH_PMALLOC(work, lwork, info);
-        // Compute elements of a block
-        double time0 = omp_get_wtime();
-        kernel(nrows, ncols, RC->pivot+RC->start[i], CC->pivot+CC->start[j],
-                RD, CD, D, nrows);
-        double time1 = omp_get_wtime();
-        starsh_dense_dlrrsdd(nrows, ncols, D, nrows, far_U[bi]->data, nrows,
-                far_V[bi]->data, ncols, far_rank+bi, maxrank, oversample, tol,
-                work, lwork, iwork);
-        double time2 = omp_get_wtime();
-        #pragma omp critical
-        {
-            drsdd_time += time2-time1;
-            kernel_time += time1-time0;
-        }
-        // Free temporary arrays
-        free(D);
-        free(work);
-        free(iwork);
+        free(tile_U);
+        free(tile_V);
     }
     // Get number of false far-field blocks
     STARSH_int nblocks_false_far = 0;
@@ -158,6 +357,11 @@ int starsh_blrm__drsdd_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         for(bi = 0; bi < nblocks_far; bi++)
             if(far_rank[bi] == -1)
                 false_far[bj++] = bi;
+        // Order of kept dense blocks is the same, as order of false far-field
+        // blocks in updated list of near-field blocks
+        if(onfly == 0)
+            for(bi = 0; bi < nblocks_false_far; bi++)
+                false_far_D[bi] = false_far_D[false_far[bi]];
     }
     // Update lists of far-field and near-field blocks using previously
     // generated list of false far-field blocks
@@ -210,48 +414,18 @@ int starsh_blrm__drsdd_omp(STARSH_blrm **matrix, STARSH_blrf *format,
         STARSH_WARNING("`F` was modified due to false far-field blocks");
         starsh_blrf_free(F2);
     }
-    // Compute near-field blocks if needed
-    if(onfly == 0 && new_nblocks_near > 0)
+    // Append already computed false far-field blocks to near-field blocks
+    if(onfly == 0 && nblocks_false_far > 0)
     {
-        STARSH_MALLOC(near_D, new_nblocks_near);
-        size_t size_D = 0;
-        // Simple cycle over all near-field blocks
-        for(bi = 0; bi < new_nblocks_near; bi++)
+        STARSH_REALLOC(near_D, new_nblocks_near);
+        for(bi = nblocks_near; bi < new_nblocks_near; bi++)
         {
             // Get indexes of corresponding block row and block column
             STARSH_int i = block_near[2*bi];
             STARSH_int j = block_near[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            size_t nrows = RC->size[i];
-            size_t ncols = CC->size[j];
-            // Update size_D
-            size_D += nrows*ncols;
-        }
-        STARSH_MALLOC(alloc_D, size_D);
-        // For each near-field block compute its elements
-        #pragma omp parallel for schedule(dynamic,1)
-        for(bi = 0; bi < new_nblocks_near; bi++)
-        {
-            // Get indexes of corresponding block row and block column
-            STARSH_int i = block_near[2*bi];
-            STARSH_int j = block_near[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            int nrows = RC->size[i];
-            int ncols = CC->size[j];
-            int shape[2] = {nrows, ncols};
-            double *D;
-            #pragma omp critical
-            {
-                D = alloc_D+offset_D;
-                array_from_buffer(near_D+bi, 2, shape, 'd', 'F', D);
-                offset_D += near_D[bi]->size;
-            }
-            double time0 = omp_get_wtime();
-            kernel(nrows, ncols, RC->pivot+RC->start[i],
-                    CC->pivot+CC->start[j], RD, CD, D, nrows);
-            double time1 = omp_get_wtime();
-            #pragma omp critical
-            kernel_time += time1-time0;
+            int shape[2] = {RC->size[i], CC->size[j]};
+            array_from_buffer(near_D+bi, 2, shape, 'd', 'F',
+                    false_far_D[bi-nblocks_near]);
         }
     }
     // Change sizes of far_rank, far_U and far_V if there were false
@@ -298,11 +472,12 @@ int starsh_blrm__drsdd_omp(STARSH_blrm **matrix, STARSH_blrf *format,
     // Dealloc list of false far-field blocks if it is not empty
     if(nblocks_false_far > 0)
         free(false_far);
+    free(false_far_D);
     // Finish with creating instance of Block Low-Rank Matrix with given
     // buffers
     //STARSH_WARNING("DRSDD kernel total time: %e secs", drsdd_time);
     //STARSH_WARNING("MATRIX kernel total time: %e secs", kernel_time);
     return starsh_blrm_new(matrix, F, far_rank, far_U, far_V, onfly, near_D,
-            alloc_U, alloc_V, alloc_D, '1');
+            alloc_U, alloc_V, NULL, '3');
 }
 
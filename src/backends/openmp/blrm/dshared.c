@@ -0,0 +1,259 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/openmp/blrm/dshared.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_blrm2__dmml_omp(STARSH_blrm2 *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb)
+//! Multiply block low-rank matrix with shared bases by dense matrix.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm2 `A` and dense
+ * matrices `B` and `C`. Right hand sides are projected onto bases of block
+ * columns in parallel. Then each block row is processed by a single thread:
+ * projections are multiplied by coupling matrices, expanded by basis of the
+ * block row and followed by far-field blocks with own low-rank factors and
+ * near-field blocks of the block row. Transposed blocks of symmetric matrix
+ * are found with help of lists of stored blocks of each block column, so no
+ * private copies of result are needed. All the integer types are int, since
+ * they are used in BLAS calls.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm2 object.
+ * @param[in] nrhs: Number of right hand sides.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm2 *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int nrows = P->shape[0];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    STARSH_int nbrows = F->nbrows, nbcols = F->nbcols;
+    STARSH_int nblocks_far = F->nblocks_far, nblocks_near = F->nblocks_near;
+    STARSH_int bi, i, j;
+    char symm = F->symm;
+    int info;
+    // Setting B = beta*B
+    if(beta == 0.)
+        #pragma omp parallel for schedule(static)
+        for(STARSH_int i = 0; i < nrows; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] = 0.;
+    else
+        #pragma omp parallel for schedule(static)
+        for(STARSH_int i = 0; i < nrows; i++)
+            for(STARSH_int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] *= beta;
+    // Lists of block columns of symmetric format are aliases of lists of
+    // block rows, so actual lists of stored blocks of each block column are
+    // required to find transposed blocks
+    STARSH_int *bcol_far_start = NULL, *bcol_far = NULL;
+    STARSH_int *bcol_near_start = NULL, *bcol_near = NULL;
+    if(symm == 'S')
+    {
+        info = starsh_blrf__bcol_list(nbcols, nblocks_far, F->block_far,
+                &bcol_far_start, &bcol_far);
+        if(info != STARSH_SUCCESS)
+            return info;
+        info = starsh_blrf__bcol_list(nbcols, nblocks_near, F->block_near,
+                &bcol_near_start, &bcol_near);
+        if(info != STARSH_SUCCESS)
+        {
+            free(bcol_far_start);
+            free(bcol_far);
+            return info;
+        }
+    }
+    // Offsets of projections onto bases of block columns and sizes of
+    // temporary buffers of threads
+    size_t *col_offset = malloc(sizeof(*col_offset)*(nbcols+1)), size_X = 0;
+    int maxrank = 0, maxrow = 0, maxcol = 0;
+    for(j = 0; j < nbcols && col_offset != NULL; j++)
+    {
+        col_offset[j] = size_X;
+        size_X += (size_t)nrhs*M->col_rank[j];
+    }
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(M->far_rank[bi] > maxrank)
+            maxrank = M->far_rank[bi];
+    for(i = 0; i < nbrows; i++)
+    {
+        if(M->row_rank[i] > maxrank)
+            maxrank = M->row_rank[i];
+        if(R->size[i] > maxrow)
+            maxrow = R->size[i];
+    }
+    for(j = 0; j < nbcols; j++)
+        if(C->size[j] > maxcol)
+            maxcol = C->size[j];
+    // Each thread needs projection of result onto basis of its block row and
+    // a buffer for low-rank or dense block
+    size_t size_Y = (size_t)nrhs*maxrank, size_D = size_Y;
+    if(M->onfly == 1 && (size_t)maxrow*maxcol > size_D)
+        size_D = (size_t)maxrow*maxcol;
+    size_D += size_Y;
+    int num_threads = omp_get_max_threads();
+    double *X = malloc(sizeof(*X)*(size_X+1));
+    double *temp_D = malloc(sizeof(*temp_D)*(num_threads*size_D+1));
+    if(col_offset == NULL || X == NULL || temp_D == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        free(col_offset);
+        free(X);
+        free(temp_D);
+        free(bcol_far_start);
+        free(bcol_far);
+        free(bcol_near_start);
+        free(bcol_near);
+        return STARSH_MALLOC_ERROR;
+    }
+    // Project right hand sides onto bases of block columns. In case of
+    // symmetric matrix, projections onto bases of block rows are the same
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(STARSH_int j = 0; j < nbcols; j++)
+        if(M->col_rank[j] > 0)
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans,
+                    M->col_rank[j], nrhs, C->size[j], 1.0, M->col_basis[j],
+                    C->size[j], A+C->start[j], lda, 0.0, X+col_offset[j],
+                    M->col_rank[j]);
+    // Each block row is processed by a single thread
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(num_threads)
+    for(STARSH_int i = 0; i < nbrows; i++)
+    {
+        int nrows = R->size[i];
+        int krow = M->row_rank[i];
+        double *Y = temp_D+omp_get_thread_num()*size_D;
+        double *D = Y+size_Y;
+        double *out = B+R->start[i];
+        STARSH_int k, bi;
+        // Coupling matrices of block row
+        if(krow > 0)
+        {
+            for(size_t l = 0; l < (size_t)nrhs*krow; l++)
+                Y[l] = 0.;
+            for(k = F->brow_far_start[i]; k < F->brow_far_start[i+1]; k++)
+            {
+                bi = F->brow_far[k];
+                if(M->far_S[bi] == NULL)
+                    continue;
+                STARSH_int j = F->block_far[2*bi+1];
+                cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, krow,
+                        nrhs, M->col_rank[j], 1.0, M->far_S[bi], krow,
+                        X+col_offset[j], M->col_rank[j], 1.0, Y, krow);
+            }
+            if(symm == 'S')
+                for(k = bcol_far_start[i]; k < bcol_far_start[i+1]; k++)
+                {
+                    bi = bcol_far[k];
+                    STARSH_int j = F->block_far[2*bi];
+                    if(M->far_S[bi] == NULL || j == i)
+                        continue;
+                    cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans,
+                            krow, nrhs, M->row_rank[j], 1.0, M->far_S[bi],
+                            M->row_rank[j], X+col_offset[j], M->row_rank[j],
+                            1.0, Y, krow);
+                }
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                    nrhs, krow, alpha, M->row_basis[i], nrows, Y, krow, 1.0,
+                    out, ldb);
+        }
+        // Far-field blocks with own low-rank factors
+        if(nblocks_far > 0)
+            for(k = F->brow_far_start[i]; k < F->brow_far_start[i+1]; k++)
+            {
+                bi = F->brow_far[k];
+                int rank = M->far_rank[bi];
+                if(M->far_U[bi] == NULL || rank == 0)
+                    continue;
+                STARSH_int j = F->block_far[2*bi+1];
+                int ncols = C->size[j];
+                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank,
+                        nrhs, ncols, 1.0, M->far_V[bi], ncols, A+C->start[j],
+                        lda, 0.0, D, rank);
+                cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                        nrhs, rank, alpha, M->far_U[bi], nrows, D, rank, 1.0,
+                        out, ldb);
+            }
+        if(symm == 'S')
+            for(k = bcol_far_start[i]; k < bcol_far_start[i+1]; k++)
+            {
+                bi = bcol_far[k];
+                int rank = M->far_rank[bi];
+                STARSH_int j = F->block_far[2*bi];
+                if(M->far_U[bi] == NULL || rank == 0 || j == i)
+                    continue;
+                int ncols = R->size[j];
+                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank,
+                        nrhs, ncols, 1.0, M->far_U[bi], ncols, A+R->start[j],
+                        lda, 0.0, D, rank);
+                cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                        nrhs, rank, alpha, M->far_V[bi], nrows, D, rank, 1.0,
+                        out, ldb);
+            }
+        // Near-field blocks of block row
+        if(nblocks_near > 0)
+            for(k = F->brow_near_start[i]; k < F->brow_near_start[i+1]; k++)
+            {
+                bi = F->brow_near[k];
+                STARSH_int j = F->block_near[2*bi+1];
+                int ncols = C->size[j];
+                double *ND = D;
+                if(M->onfly == 1)
+                    // Fill temporary buffer with elements of corresponding
+                    // block
+                    starsh_problem_kernel(P, nrows, ncols,
+                            R->pivot+R->start[i], C->pivot+C->start[j], RD,
+                            CD, ND, nrows);
+                else
+                    ND = M->near_D[bi];
+                cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                        nrhs, ncols, alpha, ND, nrows, A+C->start[j], lda,
+                        1.0, out, ldb);
+            }
+        // Transposed near-field blocks in case of symmetric matrix
+        if(symm == 'S')
+            for(k = bcol_near_start[i]; k < bcol_near_start[i+1]; k++)
+            {
+                bi = bcol_near[k];
+                STARSH_int j = F->block_near[2*bi];
+                if(j == i)
+                    continue;
+                int ncols = R->size[j];
+                double *ND = D;
+                if(M->onfly == 1)
+                    starsh_problem_kernel(P, ncols, nrows,
+                            R->pivot+R->start[j], C->pivot+C->start[i], RD,
+                            CD, ND, ncols);
+                else
+                    ND = M->near_D[bi];
+                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, nrows,
+                        nrhs, ncols, alpha, ND, ncols, A+R->start[j], lda,
+                        1.0, out, ldb);
+            }
+    }
+    free(col_offset);
+    free(X);
+    free(temp_D);
+    free(bcol_far_start);
+    free(bcol_far);
+    free(bcol_near_start);
+    free(bcol_near);
+    return STARSH_SUCCESS;
+}
@@ -0,0 +1,159 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/openmp/blrm/zmml.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_blrm__zmml_omp(STARSH_blrm *matrix, int nrhs,
+        double _Complex alpha, double _Complex *A, int lda,
+        double _Complex beta, double _Complex *B, int ldb)
+//! Multiply complex blr-matrix by dense matrix.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` and dense matrices
+ * `B` and `C`. Far-field tiles are stored as `U*V^T` and symmetric matrix is
+ * assumed to be complex symmetric (not hermitian). Each thread accumulates
+ * its own copy of result, which are summed up at the end. All the integer
+ * types are int, since they are used in BLAS calls.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Number of right hand sides.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int nrows = P->shape[0];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    // Number of far-field and near-field blocks
+    STARSH_int nblocks_far = F->nblocks_far;
+    STARSH_int nblocks_near = F->nblocks_near, bi;
+    char symm = F->symm;
+    double _Complex zero = 0.0, one = 1.0;
+    // Get maximal rank, starting value 1 keeps buffer size from being zero
+    int maxrank = 1;
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(maxrank < M->far_rank[bi])
+            maxrank = M->far_rank[bi];
+    int maxnb = nrows/F->nbrows;
+    // Setting B = beta*B
+    if(beta == 0.)
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < nrows; i++)
+            for(int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] = 0.;
+    else
+        #pragma omp parallel for schedule(static)
+        for(int i = 0; i < nrows; i++)
+            for(int j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] *= beta;
+    double _Complex *temp_D, *temp_B;
+    int num_threads;
+    #pragma omp parallel
+    #pragma omp master
+    num_threads = omp_get_num_threads();
+    size_t size_D = nrhs*(size_t)maxrank;
+    if(M->onfly == 1 && size_D < maxnb*(size_t)maxnb)
+        size_D = maxnb*(size_t)maxnb;
+    STARSH_MALLOC(temp_D, num_threads*size_D);
+    STARSH_MALLOC(temp_B, num_threads*nrhs*(size_t)nrows);
+    #pragma omp parallel
+    {
+        double _Complex *out = temp_B+omp_get_thread_num()*nrhs*(size_t)nrows;
+        for(size_t j = 0; j < nrhs*(size_t)nrows; j++)
+            out[j] = 0.;
+    }
+    int ldout = nrows;
+    // Simple cycle over all far-field admissible blocks
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        // Get indexes of corresponding block row and block column
+        STARSH_int i = F->block_far[2*bi];
+        STARSH_int j = F->block_far[2*bi+1];
+        // Get sizes and rank
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+        int rank = M->far_rank[bi];
+        if(rank == 0)
+            continue;
+        // Get pointers to data buffers
+        double _Complex *U = M->far_U[bi]->data, *V = M->far_V[bi]->data;
+        double _Complex *D = temp_D+omp_get_thread_num()*size_D;
+        double _Complex *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
+        // Multiply low-rank matrix in U*V^T format by a dense matrix
+        cblas_zgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                ncols, &one, V, ncols, A+C->start[j], lda, &zero, D, rank);
+        cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                rank, &alpha, U, nrows, D, rank, &one, out+R->start[i],
+                ldout);
+        if(i != j && symm == 'S')
+        {
+            // Multiply low-rank matrix in V*U^T format by a dense matrix
+            // U and V are simply swapped in case of symmetric block
+            cblas_zgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                    nrows, &one, U, nrows, A+R->start[i], lda, &zero, D,
+                    rank);
+            cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, ncols,
+                    nrhs, rank, &alpha, V, ncols, D, rank, &one,
+                    out+C->start[j], ldout);
+        }
+    }
+    // Simple cycle over all near-field blocks
+    #pragma omp parallel for schedule(dynamic, 1)
+    for(bi = 0; bi < nblocks_near; bi++)
+    {
+        // Get indexes and sizes of corresponding block row and column
+        STARSH_int i = F->block_near[2*bi];
+        STARSH_int j = F->block_near[2*bi+1];
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+        double _Complex *D;
+        double _Complex *out = temp_B+omp_get_thread_num()*nrhs*(size_t)ldout;
+        if(M->onfly == 1)
+        {
+            // Fill temporary buffer with elements of corresponding block
+            D = temp_D+omp_get_thread_num()*size_D;
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
+        }
+        else
+            D = M->near_D[bi]->data;
+        // Multiply 2 dense matrices
+        cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                ncols, &alpha, D, nrows, A+C->start[j], lda, &one,
+                out+R->start[i], ldout);
+        if(i != j && symm == 'S')
+        {
+            // Repeat in case of symmetric matrix
+            cblas_zgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols, nrhs,
+                    nrows, &alpha, D, nrows, A+R->start[i], lda, &one,
+                    out+C->start[j], ldout);
+        }
+    }
+    #pragma omp parallel for schedule(static)
+    for(int i = 0; i < ldout; i++)
+        for(int j = 0; j < nrhs; j++)
+            for(int k = 0; k < num_threads; k++)
+                B[j*(size_t)ldb+i] += temp_B[(k*(size_t)nrhs+j)*ldout+i];
+    free(temp_B);
+    free(temp_D);
+    return STARSH_SUCCESS;
+}
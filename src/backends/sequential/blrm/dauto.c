@@ -0,0 +1,348 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/sequential/blrm/dauto.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+#include <time.h>
+
+static double starsh_blrm__dauto_wtime()
+//! Wall time in seconds for measurements of costs.
+{
+#ifdef OPENMP
+    return omp_get_wtime();
+#else
+    return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+int starsh_blrm__dauto_cost(STARSH_blrf *format, double *kernel_cost,
+        double *flop_cost)
+//! Measure time of kernel per entry and time of arithmetics per flop.
+/*! Kernel is measured on a submatrix of the first admissible block of size up
+ * to 64 by 64, and arithmetics are measured on a GEMM of the same size.
+ *
+ * @param[in] format: Block low-rank format.
+ * @param[out] kernel_cost: Time of computing a single entry by a kernel.
+ * @param[out] flop_cost: Time of a single floating point operation.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrf *F = format;
+    STARSH_kernel *kernel = F->problem->kernel;
+    STARSH_cluster *RC = F->row_cluster;
+    STARSH_cluster *CC = F->col_cluster;
+    STARSH_int i, j;
+    const int nb = 64, maxiter = 100;
+    const double mintime = 1e-3;
+    *kernel_cost = 0.;
+    *flop_cost = 0.;
+    if(F->nblocks_far > 0)
+    {
+        i = F->block_far[0];
+        j = F->block_far[1];
+    }
+    else if(F->nblocks_near > 0)
+    {
+        i = F->block_near[0];
+        j = F->block_near[1];
+    }
+    else
+        return STARSH_SUCCESS;
+    int nrows = RC->size[i] < nb ? RC->size[i] : nb;
+    int ncols = CC->size[j] < nb ? CC->size[j] : nb;
+    int k, iter = 0;
+    double *D, time0, time1;
+    STARSH_MALLOC(D, 3*(size_t)nb*(size_t)nb);
+    // Time of kernel
+    time0 = starsh_blrm__dauto_wtime();
+    do
+    {
+        kernel(nrows, ncols, RC->pivot+RC->start[i], CC->pivot+CC->start[j],
+                RC->data, CC->data, D, nrows);
+        iter++;
+        time1 = starsh_blrm__dauto_wtime();
+    } while(time1-time0 < mintime && iter < maxiter);
+    *kernel_cost = (time1-time0)/iter/nrows/ncols;
+    // Time of GEMM
+    for(k = 0; k < 2*nb*nb; k++)
+        D[k] = 1.;
+    iter = 0;
+    time0 = starsh_blrm__dauto_wtime();
+    do
+    {
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nb, nb, nb,
+                1.0, D, nb, D+nb*nb, nb, 0.0, D+2*nb*nb, nb);
+        iter++;
+        time1 = starsh_blrm__dauto_wtime();
+    } while(time1-time0 < mintime && iter < maxiter);
+    *flop_cost = (time1-time0)/iter/(2.*nb*nb*nb);
+    free(D);
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrm__dauto_select(int nrows, int ncols, int maxrank,
+        int oversample, double rank, double kernel_cost, double flop_cost)
+//! Choose low-rank engine for a tile by estimated time of approximation.
+/*! Dense SVD is the cheapest for small tiles and randomized SVD is the
+ * cheapest for large ones. Cross approximation computes only a few rows and
+ * columns, but it is less robust, so it is used only if computing of a tile
+ * takes more time, than compression by the best of SVD and randomized SVD.
+ *
+ * @param[in] nrows: Number of rows of a tile.
+ * @param[in] ncols: Number of columns of a tile.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] oversample: Oversampling parameter of randomized SVD.
+ * @param[in] rank: Expected rank of a tile.
+ * @param[in] kernel_cost: Time of computing a single entry by a kernel.
+ * @param[in] flop_cost: Time of a single floating point operation.
+ * @return @ref STARSH_LRENGINE_DCSVD, @ref STARSH_LRENGINE_RSVD or @ref
+ *      STARSH_LRENGINE_CROSS.
+ * @sa starsh_blrm__dauto_cost().
+ * @ingroup blrm
+ * */
+{
+    double m = nrows, n = ncols, mn = nrows < ncols ? nrows : ncols;
+    double k = maxrank+oversample, r = rank+1;
+    if(k > mn)
+        k = mn;
+    double gen = m*n*kernel_cost;
+    double sdd = flop_cost*(4*m*n*mn+8*mn*mn*mn);
+    double rsdd = flop_cost*(4*m*n*k+4*m*k*k+8*n*k*k);
+    double best = sdd < rsdd ? sdd : rsdd;
+    // Cross approximation computes `r` rows and columns and updates them by
+    // previous crosses
+    double aca = (m+n)*r*kernel_cost+flop_cost*2*(m+n)*r*r;
+    if(gen > best && aca < gen+best)
+        return STARSH_LRENGINE_CROSS;
+    if(sdd <= rsdd)
+        return STARSH_LRENGINE_DCSVD;
+    return STARSH_LRENGINE_RSVD;
+}
+
+int starsh_blrm__dauto(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
+        double tol, int onfly)
+//! Approximate each tile by SVD, randomized SVD or cross approximation.
+/*! Low-rank engine is chosen for each tile separately by
+ * starsh_blrm__dauto_select(), using average rank of already approximated
+ * tiles as an expected rank. Chosen engines are stored in `far_engine` field
+ * of output matrix.
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
+ * @param[in] format: Block low-rank format.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance.
+ * @param[in] onfly: Whether not to store dense blocks.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    if(maxrank <= 0)
+    {
+        STARSH_ERROR("Parameter `maxrank` must be positive");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = format;
+    STARSH_problem *P = F->problem;
+    STARSH_kernel *kernel = P->kernel;
+    STARSH_int nblocks_far = F->nblocks_far;
+    // Shortcuts to information about clusters
+    STARSH_cluster *RC = F->row_cluster;
+    STARSH_cluster *CC = F->col_cluster;
+    void *RD = RC->data, *CD = CC->data;
+    STARSH_int *block_far = F->block_far;
+    // Places to store low-rank factors and ranks
+    Array **far_U = NULL, **far_V = NULL;
+    int *far_rank = NULL;
+    double *alloc_U = NULL, *alloc_V = NULL;
+    size_t offset_U = 0, offset_V = 0;
+    STARSH_int bi;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Measure costs of kernel and arithmetics to choose engines
+    double kernel_cost, flop_cost;
+    info = starsh_blrm__dauto_cost(F, &kernel_cost, &flop_cost);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Dense false far-field blocks, kept to avoid computing them again
+    double **false_far_D = NULL;
+    if(onfly == 0 && nblocks_far > 0)
+    {
+        STARSH_MALLOC(false_far_D, nblocks_far);
+        for(bi = 0; bi < nblocks_far; bi++)
+            false_far_D[bi] = NULL;
+    }
+    // Low-rank engine of each far-field block
+    int *far_engine = NULL;
+    if(nblocks_far > 0)
+    {
+        STARSH_MALLOC(far_engine, nblocks_far);
+    }
+    int BAD_TILE = 0;
+    const int oversample = starsh_params.oversample;
+    // Init buffers to store low-rank factors of far-field blocks if needed
+    if(nblocks_far > 0)
+    {
+        STARSH_MALLOC(far_U, nblocks_far);
+        STARSH_MALLOC(far_V, nblocks_far);
+        STARSH_MALLOC(far_rank, nblocks_far);
+        size_t size_U = 0, size_V = 0;
+        // Simple cycle over all far-field blocks
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            size_U += RC->size[i];
+            size_V += CC->size[j];
+        }
+        size_U *= maxrank;
+        size_V *= maxrank;
+        STARSH_MALLOC(alloc_U, size_U);
+        STARSH_MALLOC(alloc_V, size_V);
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            size_t nrows = RC->size[i], ncols = CC->size[j];
+            int shape_U[] = {nrows, maxrank};
+            int shape_V[] = {ncols, maxrank};
+            double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
+            offset_U += nrows*maxrank;
+            offset_V += ncols*maxrank;
+            array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
+            array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+        }
+        offset_U = 0;
+        offset_V = 0;
+    }
+    // Expected rank is an average rank of already approximated blocks
+    double rank_sum = 0.;
+    STARSH_int rank_count = 0;
+    // Simple cycle over all far-field admissible blocks
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        // Get indexes of corresponding block row and block column
+        STARSH_int i = block_far[2*bi];
+        STARSH_int j = block_far[2*bi+1];
+        // Get corresponding sizes and minimum of them
+        int nrows = RC->size[i];
+        int ncols = CC->size[j];
+        if(nrows != ncols && BAD_TILE == 0)
+        {
+            BAD_TILE = 1;
+            STARSH_WARNING("This was only tested on square tiles, error of "
+                    "approximation may be much higher, than demanded");
+        }
+        double rank = rank_count > 0 ? rank_sum/rank_count : 0.5*maxrank;
+        int engine = starsh_blrm__dauto_select(nrows, ncols, maxrank,
+                oversample, rank, kernel_cost, flop_cost);
+        double tile_tol = starsh_blrf_dtile_tol(F, norm, tol, i, j);
+        far_engine[bi] = engine;
+        if(engine == STARSH_LRENGINE_CROSS)
+        {
+            int *iwork;
+            int tile_info = STARSH_SUCCESS;
+            STARSH_PMALLOC(iwork, nrows, tile_info);
+            // Block is stored as dense one, if it can not be approximated
+            if(tile_info != STARSH_SUCCESS)
+                far_rank[bi] = -1;
+            else
+                starsh_dense_dlraca(nrows, ncols, kernel,
+                        RC->pivot+RC->start[i], CC->pivot+CC->start[j], RD,
+                        CD, far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                        far_rank+bi, maxrank, tile_tol, iwork);
+            free(iwork);
+        }
+        else
+        {
+            int mn = nrows < ncols ? nrows : ncols;
+            int mn2 = maxrank+oversample;
+            if(mn2 > mn)
+                mn2 = mn;
+            // Get size of temporary arrays for both SVD and randomized SVD
+            int lwork = ncols, lwork_sdd = (4*mn2+7)*mn2;
+            if(lwork_sdd > lwork)
+                lwork = lwork_sdd;
+            lwork += (size_t)mn2*(2*ncols+nrows+mn2+1);
+            if(lwork < (4*mn+8+nrows+ncols)*mn)
+                lwork = (4*mn+8+nrows+ncols)*mn;
+            int liwork = 8*mn;
+            double *D, *DD = NULL, *work;
+            int *iwork;
+            int tile_info = STARSH_SUCCESS;
+            // Allocate temporary arrays
+            STARSH_PMALLOC(D, (size_t)nrows*(size_t)ncols, tile_info);
+            STARSH_PMALLOC(iwork, liwork, tile_info);
+            STARSH_PMALLOC(work, lwork, tile_info);
+            if(tile_info != STARSH_SUCCESS)
+            {
+                // Block is stored as dense one, if it can not be approximated
+                free(D);
+                D = NULL;
+                far_rank[bi] = -1;
+            }
+            else
+            {
+                // Compute elements of a block
+                kernel(nrows, ncols, RC->pivot+RC->start[i],
+                        CC->pivot+CC->start[j], RD, CD, D, nrows);
+                if(engine == STARSH_LRENGINE_DCSVD)
+                {
+                    // SVD overwrites elements of the block, so they are
+                    // copied in case it is a false far-field block
+                    if(onfly == 0)
+                    {
+                        STARSH_PMALLOC(DD, (size_t)nrows*(size_t)ncols,
+                                tile_info);
+                        if(DD != NULL)
+                            memcpy(DD, D,
+                                    sizeof(*D)*(size_t)nrows*(size_t)ncols);
+                    }
+                    starsh_dense_dlrsdd(nrows, ncols, D, nrows,
+                            far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                            far_rank+bi, maxrank, tile_tol, work, lwork,
+                            iwork);
+                    free(D);
+                    D = DD;
+                }
+                else
+                    starsh_dense_dlrrsdd(nrows, ncols, D, nrows,
+                            far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                            far_rank+bi, maxrank, oversample, tile_tol, work,
+                            lwork, iwork);
+            }
+            // Keep dense false far-field block for near-field blocks or free
+            // it
+            if(far_rank[bi] == -1 && onfly == 0)
+                false_far_D[bi] = D;
+            else
+                free(D);
+            // Free temporary arrays
+            free(work);
+            free(iwork);
+        }
+        // False far-field blocks count with maximal rank
+        rank_sum += far_rank[bi] >= 0 ? far_rank[bi] : maxrank;
+        rank_count++;
+    }
+    // Move false far-field blocks to near-field blocks, compute dense blocks
+    // and create instance of Block Low-Rank Matrix
+    return starsh_blrm__dnew_far(matrix, F, far_rank, far_U, far_V, far_engine,
+            false_far_D, onfly, alloc_U, alloc_V);
+}
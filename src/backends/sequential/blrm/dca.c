@@ -36,9 +36,17 @@ int starsh_blrm__dca(STARSH_blrm *matrix, Array *A)
     {
         STARSH_int i = F->block_far[2*bi];
         STARSH_int j = F->block_far[2*bi+1];
-        double *U = M->far_U[bi]->data, *V = M->far_V[bi]->data;
+        double *U = M->far_U[bi]->data, *V;
         double *B = data+RC->start[i]+CC->start[j]*(size_t)lda;
         int nrows = RC->size[i], ncols = CC->size[j], rank = M->far_rank[bi];
+        // Compute factor V from skeleton rows if it is not stored
+        if(M->far_skel == NULL)
+            V = M->far_V[bi]->data;
+        else
+        {
+            STARSH_MALLOC(V, (size_t)ncols*(size_t)rank);
+            starsh_blrm__dget_far_V(M, bi, V);
+        }
         cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, ncols,
                 rank, 1.0, U, nrows, V, ncols, 0.0, B, lda);
         if(F->symm == 'S' && i != j)
@@ -47,6 +55,8 @@ int starsh_blrm__dca(STARSH_blrm *matrix, Array *A)
             for(int k = 0; k < ncols; k++)
                 cblas_dcopy(nrows, B+k*lda, 1, B2+k, lda);
         }
+        if(M->far_skel != NULL)
+            free(V);
     }
     // Restore near-field blocks
     for(bi = 0; bi < F->nblocks_near; bi++)
@@ -61,7 +71,7 @@ int starsh_blrm__dca(STARSH_blrm *matrix, Array *A)
         else
         {
             STARSH_MALLOC(D, (size_t)nrows*(size_t)ncols);
-            P->kernel(nrows, ncols, RC->pivot+RC->start[i],
+            starsh_problem_kernel(P, nrows, ncols, RC->pivot+RC->start[i],
                     CC->pivot+CC->start[j], RD, CD, D, nrows);
         }
         for(int k = 0; k < ncols; k++)
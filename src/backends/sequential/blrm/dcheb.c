@@ -0,0 +1,424 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/sequential/blrm/dcheb.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_blrm__dcheb_basis(STARSH_cluster *cluster, int p, double **Q,
+        double **R, STARSH_int **skel, int **rank)
+//! Skeleton particles and interpolation matrices of each cluster.
+/*! For each subcluster selects skeleton particles, such that polynomials of
+ * degree less than `p` in each coordinate are well interpolated by their
+ * values at skeleton particles. Skeleton particles (approximate Fekete
+ * points) are selected by rank-revealing QR of transposed matrix of values
+ * of Lagrange polynomials on tensor Chebyshev nodes of the bounding box of
+ * the subcluster. Chebyshev nodes themselves are used only as a
+ * well-conditioned basis of polynomials. Interpolation matrix, whose rows
+ * corresponding to skeleton particles are rows of identity matrix, is then
+ * factorized by QR. Geometry of the cluster must be set by
+ * starsh_cluster_set_geometry().
+ *
+ * @param[in] cluster: Pointer to @ref STARSH_cluster object.
+ * @param[in] p: Number of Chebyshev nodes in each dimension.
+ * @param[out] Q: Factors Q of all subclusters, `size[i]` by `rank[i]` each,
+ *      stored with offsets of `size[i]*p^ndim`.
+ * @param[out] R: Factors R of all subclusters, `rank[i]` by `rank[i]` each,
+ *      stored with offsets of `p^ndim*p^ndim`.
+ * @param[out] skel: Indexes of skeleton particles of all subclusters, stored
+ *      with offsets of `p^ndim`.
+ * @param[out] rank: Number of skeleton particles of each subcluster.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup approximations
+ * */
+{
+    if(cluster->point == NULL)
+    {
+        STARSH_ERROR("Geometry of `cluster` is not set");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_int count = cluster->ndata, i, k;
+    int ndim = cluster->ndim, r = 1, d, l;
+    double *point = cluster->point;
+    for(d = 0; d < ndim; d++)
+        r *= p;
+    STARSH_int nblocks = cluster->nblocks;
+    size_t size_Q = 0;
+    int maxsize = 0;
+    for(i = 0; i < nblocks; i++)
+    {
+        size_Q += cluster->size[i];
+        if(cluster->size[i] > maxsize)
+            maxsize = cluster->size[i];
+    }
+    int lwork = 3*maxsize+1;
+    double *alloc_Q, *alloc_R, *tmp_point, *St, *tau, *diag, *work;
+    STARSH_int *alloc_skel;
+    int *alloc_rank, *jpvt;
+    int info = STARSH_SUCCESS;
+    STARSH_PMALLOC(alloc_Q, size_Q*r, info);
+    STARSH_PMALLOC(alloc_R, (size_t)nblocks*r*r, info);
+    STARSH_PMALLOC(alloc_skel, (size_t)nblocks*r, info);
+    STARSH_PMALLOC(alloc_rank, nblocks, info);
+    STARSH_PMALLOC(tmp_point, (size_t)maxsize*ndim, info);
+    STARSH_PMALLOC(St, (size_t)maxsize*r, info);
+    STARSH_PMALLOC(tau, 2*r, info);
+    STARSH_PMALLOC(work, lwork, info);
+    STARSH_PMALLOC(jpvt, maxsize, info);
+    if(info != STARSH_SUCCESS)
+    {
+        free(alloc_Q);
+        free(alloc_R);
+        free(alloc_skel);
+        free(alloc_rank);
+        free(tmp_point);
+        free(St);
+        free(tau);
+        free(work);
+        free(jpvt);
+        return info;
+    }
+    diag = tau+r;
+    size_t offset_Q = 0;
+    for(i = 0; i < nblocks; i++)
+    {
+        int size = cluster->size[i];
+        int mr = size < r ? size : r;
+        STARSH_int *pivot = cluster->pivot+cluster->start[i];
+        double box[2*ndim];
+        double *Qi = alloc_Q+offset_Q, *Ri = alloc_R+(size_t)i*r*r;
+        offset_Q += (size_t)size*r;
+        // Gather points of subcluster and get its bounding box
+        for(d = 0; d < ndim; d++)
+        {
+            box[d] = point[d*count+pivot[0]];
+            box[ndim+d] = box[d];
+            for(k = 0; k < size; k++)
+            {
+                double x = point[d*count+pivot[k]];
+                tmp_point[d*size+k] = x;
+                if(x < box[d])
+                    box[d] = x;
+                if(x > box[ndim+d])
+                    box[ndim+d] = x;
+            }
+        }
+        starsh_dense_dchebbasis(size, ndim, p, box, tmp_point, size, Qi,
+                size);
+        // Skeleton points are selected by pivoted QR of transposed values of
+        // Lagrange polynomials
+        for(l = 0; l < r; l++)
+            cblas_dcopy(size, Qi+l*(size_t)size, 1, St+l, r);
+        for(k = 0; k < size; k++)
+            jpvt[k] = 0;
+        LAPACKE_dgeqp3_work(LAPACK_COL_MAJOR, r, size, St, r, jpvt, tau, work,
+                lwork);
+        for(l = 0; l < mr; l++)
+            diag[l] = fabs(St[l*(size_t)r+l]);
+        // Skip skeleton points, that make interpolation ill-conditioned
+        int rank_i = starsh_dense_dsvfr(mr, diag, 1e-12);
+        if(rank_i < 1)
+            rank_i = 1;
+        // Interpolation coefficients inv(R11)*R12 in place of R12
+        cblas_dtrsm(CblasColMajor, CblasLeft, CblasUpper, CblasNoTrans,
+                CblasNonUnit, rank_i, size-rank_i, 1.0, St, r,
+                St+rank_i*(size_t)r, r);
+        for(l = 0; l < rank_i; l++)
+        {
+            alloc_skel[i*r+l] = pivot[jpvt[l]-1];
+            for(k = 0; k < size; k++)
+                Qi[l*(size_t)size+k] = 0.;
+            Qi[l*(size_t)size+jpvt[l]-1] = 1.;
+        }
+        for(k = rank_i; k < size; k++)
+            cblas_dcopy(rank_i, St+k*(size_t)r, 1, Qi+jpvt[k]-1, size);
+        // QR factorization of interpolation matrix
+        LAPACKE_dgeqrf_work(LAPACK_COL_MAJOR, size, rank_i, Qi, size, tau,
+                work, lwork);
+        for(k = 0; k < rank_i; k++)
+        {
+            for(l = 0; l <= k; l++)
+                Ri[k*rank_i+l] = Qi[k*(size_t)size+l];
+            for(l = k+1; l < rank_i; l++)
+                Ri[k*rank_i+l] = 0.;
+        }
+        LAPACKE_dorgqr_work(LAPACK_COL_MAJOR, size, rank_i, rank_i, Qi, size,
+                tau, work, lwork);
+        alloc_rank[i] = rank_i;
+    }
+    free(tmp_point);
+    free(St);
+    free(tau);
+    free(work);
+    free(jpvt);
+    *Q = alloc_Q;
+    *R = alloc_R;
+    *skel = alloc_skel;
+    *rank = alloc_rank;
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrm__dcheb(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
+        double tol, int onfly)
+//! Approximate each tile by polynomial interpolation of a kernel.
+/*! Kernel is interpolated at skeleton particles of row and column clusters,
+ * selected by starsh_blrm__dcheb_basis(), so each far-field block is
+ * approximated by its submatrix on skeleton rows and columns. Only a few
+ * columns of each block are computed to check the error. Number of nodes
+ * `p` in each dimension starts at 2 and grows for those blocks, whose error
+ * on these columns is larger than `tol`. Largest `p` is such that `p^ndim`
+ * does not exceed `maxrank`, and blocks, that are not approximated with it,
+ * are stored as dense blocks. Kernel must be a smooth function of
+ * coordinates of discrete elements, and geometry of both clusters must be
+ * set by starsh_cluster_set_geometry().
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
+ * @param[in] format: Block low-rank format.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance.
+ * @param[in] onfly: Whether not to store dense blocks.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    if(maxrank <= 0)
+    {
+        STARSH_ERROR("Parameter `maxrank` must be positive");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = format;
+    STARSH_problem *P = F->problem;
+    STARSH_kernel *kernel = P->kernel;
+    STARSH_int nblocks_far = F->nblocks_far;
+    // Shortcuts to information about clusters
+    STARSH_cluster *RC = F->row_cluster;
+    STARSH_cluster *CC = F->col_cluster;
+    void *RD = RC->data, *CD = CC->data;
+    if(P->ndim != 2 || P->dtype != 'd')
+    {
+        STARSH_ERROR("Chebyshev interpolation requires real 2D problem");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(RC->point == NULL || CC->point == NULL || RC->ndim != CC->ndim)
+    {
+        STARSH_ERROR("Chebyshev interpolation requires geometry of clusters, "
+                "set by starsh_cluster_set_geometry()");
+        return STARSH_WRONG_PARAMETER;
+    }
+    int ndim = RC->ndim, pmax = 1, rmax = 1, p, r, d;
+    // Get largest number of nodes in each dimension
+    while(1)
+    {
+        int r2 = 1;
+        for(d = 0; d < ndim; d++)
+            r2 *= pmax+1;
+        if(r2 > maxrank)
+            break;
+        pmax++;
+        rmax = r2;
+    }
+    STARSH_int *block_far = F->block_far;
+    // Places to store low-rank factors and ranks
+    Array **far_U = NULL, **far_V = NULL;
+    int *far_rank = NULL;
+    double *alloc_U = NULL, *alloc_V = NULL, **false_far_D = NULL;
+    size_t offset_U = 0, offset_V = 0;
+    STARSH_int bi, bk;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Init buffers to store low-rank factors of far-field blocks if needed
+    if(nblocks_far > 0)
+    {
+        size_t size_U = 0, size_V = 0;
+        // Simple cycle over all far-field blocks
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            size_U += RC->size[i];
+            size_V += CC->size[j];
+        }
+        size_U *= maxrank;
+        size_V *= maxrank;
+        STARSH_PMALLOC(far_U, nblocks_far, info);
+        STARSH_PMALLOC(far_V, nblocks_far, info);
+        STARSH_PMALLOC(far_rank, nblocks_far, info);
+        STARSH_PMALLOC(alloc_U, size_U, info);
+        STARSH_PMALLOC(alloc_V, size_V, info);
+        if(onfly == 0)
+        {
+            false_far_D = calloc(nblocks_far, sizeof(*false_far_D));
+            if(false_far_D == NULL)
+            {
+                STARSH_ERROR("calloc() failed");
+                info = STARSH_MALLOC_ERROR;
+            }
+        }
+        if(info != STARSH_SUCCESS)
+        {
+            free(far_U);
+            free(far_V);
+            free(far_rank);
+            free(alloc_U);
+            free(alloc_V);
+            free(false_far_D);
+            return info;
+        }
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            size_t nrows = RC->size[i], ncols = CC->size[j];
+            int shape_U[] = {nrows, maxrank};
+            int shape_V[] = {ncols, maxrank};
+            double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
+            offset_U += nrows*maxrank;
+            offset_V += ncols*maxrank;
+            array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
+            array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+            // Block is not approximated yet
+            far_rank[bi] = -1;
+        }
+        // Temporary buffers are big enough for any far-field block and any
+        // number of nodes
+        int maxrow = 0;
+        for(bi = 0; bi < RC->nblocks; bi++)
+            if(RC->size[bi] > maxrow)
+                maxrow = RC->size[bi];
+        int nsample = starsh_params.oversample;
+        int lwork = 8*rmax*(rmax+1), liwork = 8*rmax;
+        if(lwork < maxrow*nsample)
+            lwork = maxrow*nsample;
+        double *core, *work;
+        int *iwork;
+        STARSH_int *sample, *pending, npending = nblocks_far;
+        size_t *row_offset, *col_offset;
+        STARSH_PMALLOC(core, (size_t)rmax*rmax, info);
+        STARSH_PMALLOC(work, lwork, info);
+        STARSH_PMALLOC(iwork, liwork, info);
+        STARSH_PMALLOC(sample, nsample, info);
+        STARSH_PMALLOC(pending, nblocks_far, info);
+        STARSH_PMALLOC(row_offset, RC->nblocks, info);
+        STARSH_PMALLOC(col_offset, CC->nblocks, info);
+        // Far-field blocks, whose interpolation error is too large, are
+        // approximated again with more nodes
+        for(bi = 0; bi < nblocks_far; bi++)
+            pending[bi] = bi;
+        for(p = pmax < 2 ? pmax : 2; info == STARSH_SUCCESS && p <= pmax &&
+                npending > 0; p++)
+        {
+            // Interpolation matrices and skeletons of row and column clusters
+            double *row_Q, *row_R, *col_Q, *col_R;
+            STARSH_int *row_skel, *col_skel;
+            int *row_rank, *col_rank;
+            for(d = 0, r = 1; d < ndim; d++)
+                r *= p;
+            info = starsh_blrm__dcheb_basis(RC, p, &row_Q, &row_R, &row_skel,
+                    &row_rank);
+            if(info != STARSH_SUCCESS)
+                break;
+            if(CC != RC)
+            {
+                info = starsh_blrm__dcheb_basis(CC, p, &col_Q, &col_R,
+                        &col_skel, &col_rank);
+                if(info != STARSH_SUCCESS)
+                {
+                    free(row_Q);
+                    free(row_R);
+                    free(row_skel);
+                    free(row_rank);
+                    break;
+                }
+            }
+            else
+            {
+                col_Q = row_Q;
+                col_R = row_R;
+                col_skel = row_skel;
+                col_rank = row_rank;
+            }
+            row_offset[0] = 0;
+            for(bi = 1; bi < RC->nblocks; bi++)
+                row_offset[bi] = row_offset[bi-1]+(size_t)RC->size[bi-1]*r;
+            col_offset[0] = 0;
+            for(bi = 1; bi < CC->nblocks; bi++)
+                col_offset[bi] = col_offset[bi-1]+(size_t)CC->size[bi-1]*r;
+            // Cycle over far-field blocks, that are not approximated yet
+            STARSH_int nfailed = 0;
+            for(bk = 0; bk < npending; bk++)
+            {
+                bi = pending[bk];
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_far[2*bi];
+                STARSH_int j = block_far[2*bi+1];
+                // Get corresponding sizes and minimum of them
+                int nrows = RC->size[i];
+                int ncols = CC->size[j];
+                int krow = row_rank[i], kcol = col_rank[j];
+                double tile_tol = starsh_blrf_dtile_tol(F, norm, tol, i, j);
+                // Compute kernel on skeleton particles
+                kernel(krow, kcol, row_skel+i*r, col_skel+j*r, RD, CD, core,
+                        krow);
+                starsh_dense_dlrcheb(nrows, ncols, krow, kcol, core,
+                        row_Q+row_offset[i], row_R+(size_t)i*r*r,
+                        col_Q+col_offset[j], col_R+(size_t)j*r*r,
+                        far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                        far_rank+bi, maxrank, tile_tol, work, lwork, iwork);
+                starsh_dense_dlrcheb_check(nrows, ncols, kernel,
+                        RC->pivot+RC->start[i], CC->pivot+CC->start[j], RD,
+                        CD, far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                        far_rank+bi, tile_tol, nsample, work, sample);
+                if(far_rank[bi] == -1)
+                    pending[nfailed++] = bi;
+            }
+            npending = nfailed;
+            free(row_Q);
+            free(row_R);
+            free(row_skel);
+            free(row_rank);
+            if(CC != RC)
+            {
+                free(col_Q);
+                free(col_R);
+                free(col_skel);
+                free(col_rank);
+            }
+        }
+        free(core);
+        free(work);
+        free(iwork);
+        free(sample);
+        free(pending);
+        free(row_offset);
+        free(col_offset);
+        if(info != STARSH_SUCCESS)
+        {
+            free(far_U);
+            free(far_V);
+            free(far_rank);
+            free(alloc_U);
+            free(alloc_V);
+            free(false_far_D);
+            return info;
+        }
+    }
+    // Blocks, that are not approximated with largest number of nodes, are
+    // false far-field blocks
+    return starsh_blrm__dnew_far(matrix, F, far_rank, far_U, far_V, NULL,
+            false_far_D, onfly, alloc_U, alloc_V);
+}
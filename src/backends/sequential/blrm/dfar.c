@@ -0,0 +1,242 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/sequential/blrm/dfar.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_blrm__dnew_far(STARSH_blrm **matrix, STARSH_blrf *format,
+        int *far_rank, Array **far_U, Array **far_V, int *far_engine,
+        double **false_far_D, int onfly, double *alloc_U, double *alloc_V)
+//! Create BLR matrix from approximated far-field blocks.
+/*! Far-field blocks with rank -1 (false far-field blocks) are moved to the
+ * list of near-field blocks and `format` is updated accordingly. Dense
+ * near-field blocks are computed if `onfly` is 0, each in its own buffer.
+ * False far-field blocks, kept in `false_far_D` by approximation routine,
+ * are used as near-field blocks as they are.
+ * Ownership of all the given buffers is passed to this function.
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
+ * @param[in,out] format: Block low-rank format.
+ * @param[in] far_rank: Ranks of far-field blocks.
+ * @param[in] far_U: Low-rank factors `U` of far-field blocks.
+ * @param[in] far_V: Low-rank factors `V` of far-field blocks.
+ * @param[in] far_engine: Low-rank engine of each far-field block or NULL.
+ * @param[in] false_far_D: Dense false far-field blocks, indexed by far-field
+ *      blocks. Only entries of false far-field blocks are read, NULL entries
+ *      are computed again. Can be NULL if `onfly` is not 0.
+ * @param[in] onfly: Whether not to store dense blocks.
+ * @param[in] alloc_U: Buffer, containing all factors `U`.
+ * @param[in] alloc_V: Buffer, containing all factors `V`.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrf *F = format;
+    STARSH_problem *P = F->problem;
+    STARSH_int nblocks_far = F->nblocks_far;
+    STARSH_int nblocks_near = F->nblocks_near;
+    // Shortcuts to information about clusters
+    STARSH_cluster *RC = F->row_cluster;
+    STARSH_cluster *CC = F->col_cluster;
+    void *RD = RC->data, *CD = CC->data;
+    // Following values default to given block low-rank format F, but they are
+    // changed when there are false far-field blocks.
+    STARSH_int new_nblocks_far = nblocks_far;
+    STARSH_int new_nblocks_near = nblocks_near;
+    STARSH_int *block_far = F->block_far;
+    STARSH_int *block_near = F->block_near;
+    // Places to store dense blocks
+    Array **near_D = NULL;
+    STARSH_int bi, bj = 0;
+    int info;
+    // Get number of false far-field blocks
+    STARSH_int nblocks_false_far = 0;
+    STARSH_int *false_far = NULL;
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(far_rank[bi] == -1)
+            nblocks_false_far++;
+    if(nblocks_false_far > 0)
+    {
+        // IMPORTANT: `false_far` must to be in ascending order for later code
+        // to work normally
+        STARSH_MALLOC(false_far, nblocks_false_far);
+        bj = 0;
+        for(bi = 0; bi < nblocks_far; bi++)
+            if(far_rank[bi] == -1)
+                false_far[bj++] = bi;
+        // Order of kept dense blocks is the same, as order of false far-field
+        // blocks in updated list of near-field blocks
+        if(onfly == 0)
+            for(bi = 0; bi < nblocks_false_far; bi++)
+                false_far_D[bi] = false_far_D[false_far[bi]];
+    }
+    // Update lists of far-field and near-field blocks using previously
+    // generated list of false far-field blocks
+    if(nblocks_false_far > 0)
+    {
+        // Update list of near-field blocks
+        new_nblocks_near = nblocks_near+nblocks_false_far;
+        STARSH_MALLOC(block_near, 2*new_nblocks_near);
+        // At first get all near-field blocks, assumed to be dense
+        for(bi = 0; bi < 2*nblocks_near; bi++)
+            block_near[bi] = F->block_near[bi];
+        // Add false far-field blocks
+        for(bi = 0; bi < nblocks_false_far; bi++)
+        {
+            STARSH_int bk = false_far[bi];
+            block_near[2*(bi+nblocks_near)] = F->block_far[2*bk];
+            block_near[2*(bi+nblocks_near)+1] = F->block_far[2*bk+1];
+        }
+        // Update list of far-field blocks
+        new_nblocks_far = nblocks_far-nblocks_false_far;
+        if(new_nblocks_far > 0)
+        {
+            STARSH_MALLOC(block_far, 2*new_nblocks_far);
+            bj = 0;
+            for(bi = 0; bi < nblocks_far; bi++)
+            {
+                // `false_far` must be in ascending order for this to work
+                if(bj < nblocks_false_far && false_far[bj] == bi)
+                {
+                    bj++;
+                }
+                else
+                {
+                    block_far[2*(bi-bj)] = F->block_far[2*bi];
+                    block_far[2*(bi-bj)+1] = F->block_far[2*bi+1];
+                }
+            }
+        }
+        // Update format by creating new format
+        STARSH_blrf *F2;
+        info = starsh_blrf_new_from_coo(&F2, P, F->symm, RC, CC,
+                new_nblocks_far, block_far, new_nblocks_near, block_near,
+                F->type);
+        if(info != STARSH_SUCCESS)
+            return info;
+        // Swap internal data of formats and free unnecessary data
+        STARSH_blrf tmp_blrf = *F;
+        *F = *F2;
+        *F2 = tmp_blrf;
+        STARSH_WARNING("`F` was modified due to false far-field blocks");
+        starsh_blrf_free(F2);
+    }
+    // Compute near-field blocks if needed
+    if(onfly == 0 && new_nblocks_near > 0)
+    {
+        STARSH_MALLOC(near_D, new_nblocks_near);
+        // Each near-field block gets its own buffer, so that dense false
+        // far-field blocks become near-field blocks without copying
+        for(bi = 0; bi < new_nblocks_near; bi++)
+        {
+            // Get indexes of corresponding block row and block column
+            STARSH_int i = block_near[2*bi];
+            STARSH_int j = block_near[2*bi+1];
+            // Get corresponding sizes and minimum of them
+            int nrows = RC->size[i];
+            int ncols = CC->size[j];
+            int shape[2] = {nrows, ncols};
+            double *D = NULL;
+            // False far-field block could be already computed
+            if(bi >= nblocks_near)
+                D = false_far_D[bi-nblocks_near];
+            if(D == NULL)
+            {
+                STARSH_MALLOC(D, (size_t)nrows*(size_t)ncols);
+                starsh_problem_kernel(P, nrows, ncols, RC->pivot+RC->start[i],
+                        CC->pivot+CC->start[j], RD, CD, D, nrows);
+            }
+            array_from_buffer(near_D+bi, 2, shape, 'd', 'F', D);
+        }
+    }
+    // Change sizes of far_rank, far_U and far_V if there were false
+    // far-field blocks
+    if(nblocks_false_far > 0 && new_nblocks_far > 0)
+    {
+        bj = 0;
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            // Old headers of arrays are replaced by headers of proper shape,
+            // while data stays in buffers `alloc_U` and `alloc_V`
+            Array *U = far_U[bi], *V = far_V[bi];
+            if(far_rank[bi] == -1)
+                bj++;
+            else
+            {
+                int shape_U[2] = {U->shape[0], far_rank[bi]};
+                int shape_V[2] = {V->shape[0], far_rank[bi]};
+                array_from_buffer(far_U+bi-bj, 2, shape_U, 'd', 'F',
+                        U->data);
+                array_from_buffer(far_V+bi-bj, 2, shape_V, 'd', 'F',
+                        V->data);
+                far_rank[bi-bj] = far_rank[bi];
+                if(far_engine != NULL)
+                    far_engine[bi-bj] = far_engine[bi];
+            }
+            U->data = NULL;
+            V->data = NULL;
+            array_free(U);
+            array_free(V);
+        }
+        STARSH_REALLOC(far_rank, new_nblocks_far);
+        if(far_engine != NULL)
+            STARSH_REALLOC(far_engine, new_nblocks_far);
+        STARSH_REALLOC(far_U, new_nblocks_far);
+        STARSH_REALLOC(far_V, new_nblocks_far);
+        //STARSH_REALLOC(alloc_U, offset_U);
+        //STARSH_REALLOC(alloc_V, offset_V);
+    }
+    // If all far-field blocks are false, then dealloc buffers
+    if(new_nblocks_far == 0 && nblocks_far > 0)
+    {
+        block_far = NULL;
+        free(far_rank);
+        far_rank = NULL;
+        free(far_engine);
+        far_engine = NULL;
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            far_U[bi]->data = NULL;
+            far_V[bi]->data = NULL;
+            array_free(far_U[bi]);
+            array_free(far_V[bi]);
+        }
+        free(far_U);
+        far_U = NULL;
+        free(far_V);
+        far_V = NULL;
+        free(alloc_U);
+        alloc_U = NULL;
+        free(alloc_V);
+        alloc_V = NULL;
+    }
+    // Dealloc list of false far-field blocks if it is not empty
+    if(nblocks_false_far > 0)
+        free(false_far);
+    free(false_far_D);
+    // Finish with creating instance of Block Low-Rank Matrix with given
+    // buffers
+    info = starsh_blrm_new(matrix, F, far_rank, far_U, far_V, onfly, near_D,
+            alloc_U, alloc_V, NULL, '3');
+    if(info != STARSH_SUCCESS)
+    {
+        // Dense blocks are not owned by any matrix
+        if(near_D != NULL)
+            for(bi = 0; bi < new_nblocks_near; bi++)
+                array_free(near_D[bi]);
+        free(near_D);
+        return info;
+    }
+    // Keep chosen low-rank engines for statistics, if they are given
+    (*matrix)->far_engine = far_engine;
+    return STARSH_SUCCESS;
+}
+
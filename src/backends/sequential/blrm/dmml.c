@@ -35,7 +35,6 @@ int starsh_blrm__dmml(STARSH_blrm *matrix, int nrhs, double alpha, double *A,
     STARSH_blrm *M = matrix;
     STARSH_blrf *F = M->format;
     STARSH_problem *P = F->problem;
-    STARSH_kernel *kernel = P->kernel;
     STARSH_int nrows = P->shape[0];
     STARSH_int ncols = P->shape[P->ndim-1];
     // Shorcuts to information about clusters
@@ -66,10 +65,20 @@ int starsh_blrm__dmml(STARSH_blrm *matrix, int nrhs, double alpha, double *A,
         int nrows = R->size[i];
         int ncols = C->size[j];
         int rank = M->far_rank[bi];
+        if(rank == 0)
+            continue;
         // Get pointers to data buffers
-        double *D, *U = M->far_U[bi]->data, *V = M->far_V[bi]->data;
+        double *D, *U = M->far_U[bi]->data, *V;
         // Allocate temporary buffer
         STARSH_MALLOC(D, nrhs*(size_t)rank);
+        // Compute factor V from skeleton rows if it is not stored
+        if(M->far_skel == NULL)
+            V = M->far_V[bi]->data;
+        else
+        {
+            STARSH_MALLOC(V, (size_t)ncols*(size_t)rank);
+            starsh_blrm__dget_far_V(M, bi, V);
+        }
         // Multiply low-rank matrix in U*V^T format by a dense matrix
         cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
                 ncols, 1.0, V, ncols, A+C->start[j], lda, 0.0, D, rank);
@@ -86,6 +95,8 @@ int starsh_blrm__dmml(STARSH_blrm *matrix, int nrhs, double alpha, double *A,
                     B+C->start[j], ldb);
         }
         free(D);
+        if(M->far_skel != NULL)
+            free(V);
     }
     if(M->onfly == 1)
         // Simple cycle over all near-field blocks
@@ -102,8 +113,8 @@ int starsh_blrm__dmml(STARSH_blrm *matrix, int nrhs, double alpha, double *A,
             // Allocate temporary buffer
             STARSH_MALLOC(D, (size_t)nrows*ncols);
             // Fill temporary buffer with elements of corresponding block
-            kernel(nrows, ncols, R->pivot+R->start[i], C->pivot+C->start[j],
-                    RD, CD, D, nrows);
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
             // Multiply 2 dense matrices
             cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
                     nrhs, ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
@@ -143,3 +154,115 @@ int starsh_blrm__dmml(STARSH_blrm *matrix, int nrhs, double alpha, double *A,
         }
     return 0;
 }
+
+int starsh_blrm__dmml_trans(STARSH_blrm *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb)
+//! Multiply transposed blr-matrix by dense matrix.
+/*! Performs `C=alpha*A^T*B+beta*C` with @ref STARSH_blrm `A` and dense
+ * matrices `B` and `C`. Tiles are traversed block column by block column
+ * with help of lists `bcol_far` and `bcol_near` of @ref STARSH_blrf, so each
+ * part of result is updated by consecutive operations. Symmetric matrix is
+ * simply multiplied by starsh_blrm__dmml(). All the integer types are int,
+ * since they are used in BLAS calls.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Number of right hand sides.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int ncols = P->shape[P->ndim-1];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    STARSH_int j, k;
+    if(F->symm == 'S')
+        return starsh_blrm__dmml(matrix, nrhs, alpha, A, lda, beta, B, ldb);
+    // Setting B = beta*B
+    if(beta == 0.)
+        for(int i = 0; i < nrhs; i++)
+            for(STARSH_int j = 0; j < ncols; j++)
+                B[(size_t)i*ldb+j] = 0.;
+    else
+        for(int i = 0; i < nrhs; i++)
+            for(STARSH_int j = 0; j < ncols; j++)
+                B[(size_t)i*ldb+j] *= beta;
+    // Simple cycle over all block columns
+    for(j = 0; j < F->nbcols; j++)
+    {
+        // Far-field blocks of current block column
+        if(F->nblocks_far > 0)
+            for(k = F->bcol_far_start[j]; k < F->bcol_far_start[j+1]; k++)
+            {
+                STARSH_int bi = F->bcol_far[k];
+                STARSH_int i = F->block_far[2*bi];
+                // Get sizes and rank in int type due to BLAS calls
+                int nrows = R->size[i];
+                int ncols = C->size[j];
+                int rank = M->far_rank[bi];
+                if(rank == 0)
+                    continue;
+                // Get pointers to data buffers
+                double *D, *U = M->far_U[bi]->data, *V;
+                // Allocate temporary buffer
+                STARSH_MALLOC(D, nrhs*(size_t)rank);
+                // Compute factor V from skeleton rows if it is not stored
+                if(M->far_skel == NULL)
+                    V = M->far_V[bi]->data;
+                else
+                {
+                    STARSH_MALLOC(V, (size_t)ncols*(size_t)rank);
+                    starsh_blrm__dget_far_V(M, bi, V);
+                }
+                // Multiply low-rank matrix in V*U^T format by a dense matrix
+                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank,
+                        nrhs, nrows, 1.0, U, nrows, A+R->start[i], lda, 0.0,
+                        D, rank);
+                cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, ncols,
+                        nrhs, rank, alpha, V, ncols, D, rank, 1.0,
+                        B+C->start[j], ldb);
+                free(D);
+                if(M->far_skel != NULL)
+                    free(V);
+            }
+        // Near-field blocks of current block column
+        if(F->nblocks_near > 0)
+            for(k = F->bcol_near_start[j]; k < F->bcol_near_start[j+1]; k++)
+            {
+                STARSH_int bi = F->bcol_near[k];
+                STARSH_int i = F->block_near[2*bi];
+                // Get sizes in int type due to BLAS calls
+                int nrows = R->size[i];
+                int ncols = C->size[j];
+                double *D;
+                if(M->onfly == 1)
+                {
+                    // Fill temporary buffer with elements of corresponding
+                    // block
+                    STARSH_MALLOC(D, (size_t)nrows*ncols);
+                    starsh_problem_kernel(P, nrows, ncols,
+                            R->pivot+R->start[i], C->pivot+C->start[j], RD, CD,
+                            D, nrows);
+                }
+                else
+                    D = M->near_D[bi]->data;
+                // Multiply transposed dense matrix by a dense matrix
+                cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols,
+                        nrhs, nrows, alpha, D, nrows, A+R->start[i], lda,
+                        1.0, B+C->start[j], ldb);
+                if(M->onfly == 1)
+                    free(D);
+            }
+    }
+    return STARSH_SUCCESS;
+}
@@ -16,7 +16,10 @@
 int starsh_blrm__drsdd(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
         double tol, int onfly)
 //! Approximate each tile by randomized SVD.
-/*!
+/*! If `maxrank` is not positive, rank of each tile is limited only by
+ * break-even point of low-rank and dense storage, see
+ * starsh_dense_dlrrsdd_grow().
+ *
  * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
  * @param[in] format: Block low-rank format.
  * @param[in] maxrank: Maximum possible rank.
@@ -30,66 +33,83 @@ int starsh_blrm__drsdd(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
     STARSH_problem *P = F->problem;
     STARSH_kernel *kernel = P->kernel;
     STARSH_int nblocks_far = F->nblocks_far;
-    STARSH_int nblocks_near = F->nblocks_near;
     // Shortcuts to information about clusters
     STARSH_cluster *RC = F->row_cluster;
     STARSH_cluster *CC = F->col_cluster;
     void *RD = RC->data, *CD = CC->data;
-    // Following values default to given block low-rank format F, but they are
-    // changed when there are false far-field blocks.
-    STARSH_int new_nblocks_far = nblocks_far;
-    STARSH_int new_nblocks_near = nblocks_near;
     STARSH_int *block_far = F->block_far;
-    STARSH_int *block_near = F->block_near;
-    // Places to store low-rank factors, dense blocks and ranks
-    Array **far_U = NULL, **far_V = NULL, **near_D = NULL;
+    // Places to store low-rank factors and ranks
+    Array **far_U = NULL, **far_V = NULL;
     int *far_rank = NULL;
-    double *alloc_U = NULL, *alloc_V = NULL, *alloc_D = NULL;
-    size_t offset_U = 0, offset_V = 0, offset_D = 0;
-    STARSH_int bi, bj = 0;
+    double *alloc_U = NULL, *alloc_V = NULL;
+    size_t offset_U = 0, offset_V = 0;
+    STARSH_int bi;
+    // Norm of the whole matrix distributes global error among tiles, it is
+    // estimated before any allocation
+    double norm;
+    int info = starsh_blrf_dtol_norm(F, &norm);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Dense false far-field blocks, kept to avoid computing them again
+    double **false_far_D = NULL;
+    if(onfly == 0 && nblocks_far > 0)
+    {
+        STARSH_MALLOC(false_far_D, nblocks_far);
+    }
     int BAD_TILE = 0;
     const int oversample = starsh_params.oversample;
+    // Non-positive maxrank means that rank of each block is limited only by
+    // break-even point of low-rank and dense storage
+    const int dynamic = maxrank <= 0;
+    double **tile_U = NULL, **tile_V = NULL;
     // Init buffers to store low-rank factors of far-field blocks if needed
     if(nblocks_far > 0)
     {
         STARSH_MALLOC(far_U, nblocks_far);
         STARSH_MALLOC(far_V, nblocks_far);
         STARSH_MALLOC(far_rank, nblocks_far);
-        size_t size_U = 0, size_V = 0;
-        // Simple cycle over all far-field blocks
-        for(bi = 0; bi < nblocks_far; bi++)
+        if(dynamic)
         {
-            // Get indexes of corresponding block row and block column
-            STARSH_int i = block_far[2*bi];
-            STARSH_int j = block_far[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            size_U += RC->size[i];
-            size_V += CC->size[j];
+            // Factors of each block are allocated with exact size later
+            STARSH_MALLOC(tile_U, nblocks_far);
+            STARSH_MALLOC(tile_V, nblocks_far);
         }
-        size_U *= maxrank;
-        size_V *= maxrank;
-        STARSH_MALLOC(alloc_U, size_U);
-        STARSH_MALLOC(alloc_V, size_V);
-        for(bi = 0; bi < nblocks_far; bi++)
+        else
         {
-            // Get indexes of corresponding block row and block column
-            STARSH_int i = block_far[2*bi];
-            STARSH_int j = block_far[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            size_t nrows = RC->size[i], ncols = CC->size[j];
-            int shape_U[] = {nrows, maxrank};
-            int shape_V[] = {ncols, maxrank};
-            double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
-            offset_U += nrows*maxrank;
-            offset_V += ncols*maxrank;
-            array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
-            array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+            size_t size_U = 0, size_V = 0;
+            // Simple cycle over all far-field blocks
+            for(bi = 0; bi < nblocks_far; bi++)
+            {
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_far[2*bi];
+                STARSH_int j = block_far[2*bi+1];
+                // Get corresponding sizes and minimum of them
+                size_U += RC->size[i];
+                size_V += CC->size[j];
+            }
+            size_U *= maxrank;
+            size_V *= maxrank;
+            STARSH_MALLOC(alloc_U, size_U);
+            STARSH_MALLOC(alloc_V, size_V);
+            for(bi = 0; bi < nblocks_far; bi++)
+            {
+                // Get indexes of corresponding block row and block column
+                STARSH_int i = block_far[2*bi];
+                STARSH_int j = block_far[2*bi+1];
+                // Get corresponding sizes and minimum of them
+                size_t nrows = RC->size[i], ncols = CC->size[j];
+                int shape_U[] = {nrows, maxrank};
+                int shape_V[] = {ncols, maxrank};
+                double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
+                offset_U += nrows*maxrank;
+                offset_V += ncols*maxrank;
+                array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
+                array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+            }
+            offset_U = 0;
+            offset_V = 0;
         }
-        offset_U = 0;
-        offset_V = 0;
     }
-    // Work variables
-    int info;
     // Simple cycle over all far-field admissible blocks
     for(bi = 0; bi < nblocks_far; bi++)
     {
@@ -115,171 +135,85 @@ int starsh_blrm__drsdd(STARSH_blrm **matrix, STARSH_blrf *format, int maxrank,
             lwork = lwork_sdd;
         lwork += (size_t)mn2*(2*ncols+nrows+mn2+1);
         int liwork = 8*mn2;
-        double *D, *work;
-        int *iwork;
+        double *D, *work = NULL;
+        int *iwork = NULL;
         int info;
         // Allocate temporary arrays
         STARSH_PMALLOC(D, (size_t)nrows*(size_t)ncols, info);
-        STARSH_PMALLOC(iwork, liwork, info);
-        STARSH_PMALLOC(work, lwork, info);
+        if(!dynamic)
+        {
+            STARSH_PMALLOC(iwork, liwork, info);
+            STARSH_PMALLOC(work, lwork, info);
+        }
         // Compute elements of a block
         kernel(nrows, ncols, RC->pivot+RC->start[i], CC->pivot+CC->start[j],
                 RD, CD, D, nrows);
-        starsh_dense_dlrrsdd(nrows, ncols, D, nrows, far_U[bi]->data, nrows,
-                far_V[bi]->data, ncols, far_rank+bi, maxrank, oversample, tol,
-                work, lwork, iwork);
+        double tile_tol = starsh_blrf_dtile_tol(F, norm, tol, i, j);
+        if(dynamic)
+        {
+            info = starsh_dense_dlrrsdd_grow(nrows, ncols, D, nrows,
+                    tile_U+bi, tile_V+bi, far_rank+bi, oversample, tile_tol);
+            // Block is stored as dense one, if there is no memory for its
+            // low-rank factors
+            if(info != STARSH_SUCCESS)
+                far_rank[bi] = -1;
+        }
+        else
+            starsh_dense_dlrrsdd(nrows, ncols, D, nrows,
+                    far_U[bi]->data, nrows, far_V[bi]->data, ncols,
+                    far_rank+bi, maxrank, oversample, tile_tol, work, lwork,
+                    iwork);
+        // Keep dense false far-field block for near-field blocks or free it
+        if(far_rank[bi] == -1 && onfly == 0)
+            false_far_D[bi] = D;
+        else
+            free(D);
         // Free temporary arrays
-        free(D);
         free(work);
         free(iwork);
     }
-    // Get number of false far-field blocks
-    STARSH_int nblocks_false_far = 0;
-    STARSH_int *false_far = NULL;
-    for(bi = 0; bi < nblocks_far; bi++)
-        if(far_rank[bi] == -1)
-            nblocks_false_far++;
-    if(nblocks_false_far > 0)
+    // Pack factors of exact size into contiguous buffers
+    if(dynamic && nblocks_far > 0)
     {
-        // IMPORTANT: `false_far` must to be in ascending order for later code
-        // to work normally
-        STARSH_MALLOC(false_far, nblocks_false_far);
-        bj = 0;
+        size_t size_U = 0, size_V = 0;
         for(bi = 0; bi < nblocks_far; bi++)
-            if(far_rank[bi] == -1)
-                false_far[bj++] = bi;
-    }
-    // Update lists of far-field and near-field blocks using previously
-    // generated list of false far-field blocks
-    if(nblocks_false_far > 0)
-    {
-        // Update list of near-field blocks
-        new_nblocks_near = nblocks_near+nblocks_false_far;
-        STARSH_MALLOC(block_near, 2*new_nblocks_near);
-        // At first get all near-field blocks, assumed to be dense
-        for(bi = 0; bi < 2*nblocks_near; bi++)
-            block_near[bi] = F->block_near[bi];
-        // Add false far-field blocks
-        for(bi = 0; bi < nblocks_false_far; bi++)
         {
-            STARSH_int bj = false_far[bi];
-            block_near[2*(bi+nblocks_near)] = F->block_far[2*bj];
-            block_near[2*(bi+nblocks_near)+1] = F->block_far[2*bj+1];
-        }
-        // Update list of far-field blocks
-        new_nblocks_far = nblocks_far-nblocks_false_far;
-        if(new_nblocks_far > 0)
-        {
-            STARSH_MALLOC(block_far, 2*new_nblocks_far);
-            bj = 0;
-            for(bi = 0; bi < nblocks_far; bi++)
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            if(far_rank[bi] > 0)
             {
-                // `false_far` must be in ascending order for this to work
-                if(bj < nblocks_false_far && false_far[bj] == bi)
-                {
-                    bj++;
-                }
-                else
-                {
-                    block_far[2*(bi-bj)] = F->block_far[2*bi];
-                    block_far[2*(bi-bj)+1] = F->block_far[2*bi+1];
-                }
+                size_U += (size_t)RC->size[i]*(size_t)far_rank[bi];
+                size_V += (size_t)CC->size[j]*(size_t)far_rank[bi];
             }
         }
-        // Update format by creating new format
-        STARSH_blrf *F2;
-        info = starsh_blrf_new_from_coo(&F2, P, F->symm, RC, CC,
-                new_nblocks_far, block_far, new_nblocks_near, block_near,
-                F->type);
-        // Swap internal data of formats and free unnecessary data
-        STARSH_blrf tmp_blrf = *F;
-        *F = *F2;
-        *F2 = tmp_blrf;
-        STARSH_WARNING("`F` was modified due to false far-field blocks");
-        starsh_blrf_free(F2);
-    }
-    // Compute near-field blocks if needed
-    if(onfly == 0 && new_nblocks_near > 0)
-    {
-        STARSH_MALLOC(near_D, new_nblocks_near);
-        size_t size_D = 0;
-        // Simple cycle over all near-field blocks
-        for(bi = 0; bi < new_nblocks_near; bi++)
-        {
-            // Get indexes of corresponding block row and block column
-            STARSH_int i = block_near[2*bi];
-            STARSH_int j = block_near[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            size_t nrows = RC->size[i];
-            size_t ncols = CC->size[j];
-            // Update size_D
-            size_D += nrows*ncols;
-        }
-        STARSH_MALLOC(alloc_D, size_D);
-        // For each near-field block compute its elements
-        for(bi = 0; bi < new_nblocks_near; bi++)
-        {
-            // Get indexes of corresponding block row and block column
-            STARSH_int i = block_near[2*bi];
-            STARSH_int j = block_near[2*bi+1];
-            // Get corresponding sizes and minimum of them
-            int nrows = RC->size[i];
-            int ncols = CC->size[j];
-            int shape[2] = {nrows, ncols};
-            double *D = alloc_D+offset_D;
-            array_from_buffer(near_D+bi, 2, shape, 'd', 'F', D);
-            offset_D += near_D[bi]->size;
-            kernel(nrows, ncols, RC->pivot+RC->start[i],
-                    CC->pivot+CC->start[j], RD, CD, D, nrows);
-        }
-    }
-    // Change sizes of far_rank, far_U and far_V if there were false
-    // far-field blocks
-    if(nblocks_false_far > 0 && new_nblocks_far > 0)
-    {
-        bj = 0;
+        // Extra element keeps malloc() from returning NULL
+        STARSH_MALLOC(alloc_U, size_U+1);
+        STARSH_MALLOC(alloc_V, size_V+1);
         for(bi = 0; bi < nblocks_far; bi++)
         {
-            if(far_rank[bi] == -1)
-                bj++;
-            else
+            STARSH_int i = block_far[2*bi];
+            STARSH_int j = block_far[2*bi+1];
+            int rank = far_rank[bi] > 0 ? far_rank[bi] : 0;
+            int shape_U[] = {RC->size[i], rank};
+            int shape_V[] = {CC->size[j], rank};
+            double *U = alloc_U+offset_U, *V = alloc_V+offset_V;
+            array_from_buffer(far_U+bi, 2, shape_U, 'd', 'F', U);
+            array_from_buffer(far_V+bi, 2, shape_V, 'd', 'F', V);
+            offset_U += far_U[bi]->size;
+            offset_V += far_V[bi]->size;
+            if(far_rank[bi] >= 0)
             {
-                int shape_U[2] = {far_U[bi]->shape[0], far_rank[bi]};
-                int shape_V[2] = {far_V[bi]->shape[0], far_rank[bi]};
-                array_from_buffer(far_U+bi-bj, 2, shape_U, 'd', 'F',
-                        far_U[bi]->data);
-                array_from_buffer(far_V+bi-bj, 2, shape_V, 'd', 'F',
-                        far_V[bi]->data);
-                far_rank[bi-bj] = far_rank[bi];
+                memcpy(U, tile_U[bi], far_U[bi]->data_nbytes);
+                memcpy(V, tile_V[bi], far_V[bi]->data_nbytes);
+                free(tile_U[bi]);
+                free(tile_V[bi]);
             }
         }
-        STARSH_REALLOC(far_rank, new_nblocks_far);
-        STARSH_REALLOC(far_U, new_nblocks_far);
-        STARSH_REALLOC(far_V, new_nblocks_far);
-        //STARSH_REALLOC(alloc_U, offset_U);
-        //STARSH_REALLOC(alloc_V, offset_V);
+        free(tile_U);
+        free(tile_V);
     }
-    // If all far-field blocks are false, then dealloc buffers
-    if(new_nblocks_far == 0 && nblocks_far > 0)
-    {
-        block_far = NULL;
-        free(far_rank);
-        far_rank = NULL;
-        free(far_U);
-        far_U = NULL;
-        free(far_V);
-        far_V = NULL;
-        free(alloc_U);
-        alloc_U = NULL;
-        free(alloc_V);
-        alloc_V = NULL;
-    }
-    // Dealloc list of false far-field blocks if it is not empty
-    if(nblocks_false_far > 0)
-        free(false_far);
-    // Finish with creating instance of Block Low-Rank Matrix with given
-    // buffers
-    return starsh_blrm_new(matrix, F, far_rank, far_U, far_V, onfly, near_D,
-            alloc_U, alloc_V, alloc_D, '1');
+    // Move false far-field blocks to near-field blocks, compute dense blocks
+    // and create instance of Block Low-Rank Matrix
+    return starsh_blrm__dnew_far(matrix, F, far_rank, far_U, far_V, NULL,
+            false_far_D, onfly, alloc_U, alloc_V);
 }
-
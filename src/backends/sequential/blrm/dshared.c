@@ -0,0 +1,708 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/sequential/blrm/dshared.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+static void dshared_qr_r(int nrows, int rank, double *A, double *R,
+        double *work)
+// Factor R of QR decomposition of a tall matrix A. Matrix A is not changed.
+// Size of work must be at least nrows*rank+2*rank.
+{
+    double *Q = work, *tau = Q+(size_t)nrows*rank, *qr_work = tau+rank;
+    cblas_dcopy(nrows*rank, A, 1, Q, 1);
+    LAPACKE_dgeqrf_work(LAPACK_COL_MAJOR, nrows, rank, Q, nrows, tau,
+            qr_work, rank);
+    for(int i = 0; i < rank; i++)
+        for(int j = 0; j < rank; j++)
+            R[j*(size_t)rank+i] = i <= j ? Q[j*(size_t)nrows+i] : 0.;
+}
+
+static int dshared_basis(int nrows, int ncols, double *W, double tol,
+        int *rank, double **basis)
+// Orthonormal basis of columns of a panel W, truncated with respect to given
+// absolute tolerance. Panel W is overwritten.
+{
+    int mn = nrows < ncols ? nrows : ncols;
+    *rank = 0;
+    *basis = NULL;
+    if(mn == 0)
+        return STARSH_SUCCESS;
+    int lwork = (4*mn+8+nrows+ncols)*mn, liwork = 8*mn;
+    double *S = malloc(sizeof(*S)*mn);
+    double *U = malloc(sizeof(*U)*(size_t)nrows*mn);
+    double *VT = malloc(sizeof(*VT)*(size_t)mn*ncols);
+    double *work = malloc(sizeof(*work)*lwork);
+    int *iwork = malloc(sizeof(*iwork)*liwork);
+    int info = STARSH_SUCCESS;
+    if(S == NULL || U == NULL || VT == NULL || work == NULL || iwork == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        info = STARSH_MALLOC_ERROR;
+    }
+    else
+    {
+        LAPACKE_dgesdd_work(LAPACK_COL_MAJOR, 'S', nrows, ncols, W, nrows, S,
+                U, nrows, VT, mn, work, lwork, iwork);
+        *rank = starsh_dense_dsvfr(mn, S, -tol);
+        if(*rank > 0)
+        {
+            *basis = malloc(sizeof(**basis)*(size_t)nrows*(*rank));
+            if(*basis == NULL)
+            {
+                STARSH_ERROR("malloc() failed");
+                *rank = 0;
+                info = STARSH_MALLOC_ERROR;
+            }
+            else
+                cblas_dcopy(nrows*(*rank), U, 1, *basis, 1);
+        }
+    }
+    free(S);
+    free(U);
+    free(VT);
+    free(work);
+    free(iwork);
+    return info;
+}
+
+static int dshared_panel(int nrows, int nblocks, STARSH_int *block,
+        int *rank, double **factor, double *far_R, size_t *far_R_offset,
+        double *far_norm, int transposed, STARSH_int *block_far,
+        STARSH_int skip, double *W)
+// Concatenate factors of given far-field blocks, weighted by factors `R` of
+// QR decompositions of the other factors and scaled by norms of blocks, so
+// that each block has unit norm in a panel. Factors `V`, weighted by `R` of
+// factors `U`, are used for transposed blocks, except for diagonal block of
+// block row `skip`.
+{
+    int pos = 0;
+    for(int k = 0; k < nblocks; k++)
+    {
+        STARSH_int bi = block[k];
+        if(transposed && block_far[2*bi] == skip)
+            continue;
+        double *RW = far_R+far_R_offset[bi];
+        if(!transposed)
+            RW += (size_t)rank[bi]*rank[bi];
+        double *Wk = W+(size_t)pos*nrows;
+        cblas_dcopy(nrows*rank[bi], factor[bi], 1, Wk, 1);
+        cblas_dtrmm(CblasColMajor, CblasRight, CblasUpper, CblasTrans,
+                CblasNonUnit, nrows, rank[bi], 1.0/far_norm[bi], RW,
+                rank[bi], Wk, nrows);
+        pos += rank[bi];
+    }
+    return pos;
+}
+
+static int dshared_build(STARSH_blrm2 *M2, STARSH_blrm *M, double tol,
+        double **far_U, double **far_V, STARSH_int *bcol_far_start,
+        STARSH_int *bcol_far)
+// Compute shared bases and coupling matrices. Everything is stored in M2 as
+// soon as it is allocated, so M2 is simply freed in case of error.
+{
+    STARSH_blrf *F = M->format;
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    STARSH_int nbrows = F->nbrows, nbcols = F->nbcols;
+    STARSH_int nblocks_far = F->nblocks_far;
+    STARSH_int bi, i, j;
+    char symm = F->symm;
+    int *rank = M->far_rank, info = STARSH_SUCCESS;
+    // Factors `R` of QR decompositions of `U` and `V` of each block
+    size_t *far_R_offset, size_R = 0;
+    int maxsize = 0, maxrank = 0;
+    for(i = 0; i < nbrows; i++)
+        if(R->size[i] > maxsize)
+            maxsize = R->size[i];
+    for(j = 0; j < nbcols; j++)
+        if(C->size[j] > maxsize)
+            maxsize = C->size[j];
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        size_R += 2*(size_t)rank[bi]*rank[bi];
+        if(rank[bi] > maxrank)
+            maxrank = rank[bi];
+    }
+    // Panels W are also big enough for all the factors of a block row or a
+    // block column
+    size_t size_W = (size_t)maxsize*maxrank+2*maxrank;
+    for(i = 0; i < nbrows; i++)
+    {
+        size_t ncols = 0;
+        for(STARSH_int k = F->brow_far_start[i]; k < F->brow_far_start[i+1];
+                k++)
+            ncols += rank[F->brow_far[k]];
+        if(symm == 'S')
+            for(STARSH_int k = bcol_far_start[i]; k < bcol_far_start[i+1];
+                    k++)
+                ncols += rank[bcol_far[k]];
+        if(ncols*maxsize > size_W)
+            size_W = ncols*maxsize;
+    }
+    if(symm == 'N')
+        for(j = 0; j < nbcols; j++)
+        {
+            size_t ncols = 0;
+            for(STARSH_int k = bcol_far_start[j]; k < bcol_far_start[j+1];
+                    k++)
+                ncols += rank[bcol_far[k]];
+            if(ncols*maxsize > size_W)
+                size_W = ncols*maxsize;
+        }
+    double *far_R = malloc(sizeof(*far_R)*(size_R+1));
+    double *far_norm = malloc(sizeof(*far_norm)*(nblocks_far+1));
+    double *W = malloc(sizeof(*W)*(size_W+1));
+    far_R_offset = malloc(sizeof(*far_R_offset)*(nblocks_far+1));
+    int *use_S = malloc(sizeof(*use_S)*(nblocks_far+1));
+    if(far_R == NULL || far_norm == NULL || W == NULL || far_R_offset == NULL
+            || use_S == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        free(far_R);
+        free(far_norm);
+        free(W);
+        free(far_R_offset);
+        free(use_S);
+        return STARSH_MALLOC_ERROR;
+    }
+    size_R = 0;
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        i = F->block_far[2*bi];
+        j = F->block_far[2*bi+1];
+        far_R_offset[bi] = size_R;
+        size_R += 2*(size_t)rank[bi]*rank[bi];
+        far_norm[bi] = 1.;
+        if(rank[bi] == 0)
+            continue;
+        double *RU = far_R+far_R_offset[bi];
+        double *RV = RU+(size_t)rank[bi]*rank[bi];
+        dshared_qr_r(R->size[i], rank[bi], far_U[bi], RU, W);
+        dshared_qr_r(C->size[j], rank[bi], far_V[bi], RV, W);
+        // Norm of a block is equal to norm of RU*RV^T
+        cblas_dcopy(rank[bi]*rank[bi], RU, 1, W, 1);
+        cblas_dtrmm(CblasColMajor, CblasRight, CblasUpper, CblasTrans,
+                CblasNonUnit, rank[bi], rank[bi], 1.0, RV, rank[bi], W,
+                rank[bi]);
+        far_norm[bi] = cblas_dnrm2(rank[bi]*rank[bi], W, 1);
+        if(far_norm[bi] == 0.)
+            far_norm[bi] = 1.;
+    }
+    // Shared bases of block rows. In case of symmetric matrix, transposed
+    // blocks are also taken into account. Each block has unit norm in a
+    // panel, so absolute tolerance of a panel is relative tolerance of each
+    // block.
+    for(i = 0; i < nbrows && info == STARSH_SUCCESS; i++)
+    {
+        STARSH_int start = F->brow_far_start[i];
+        int nrows = R->size[i];
+        int ncols = dshared_panel(nrows, F->brow_far_start[i+1]-start,
+                F->brow_far+start, rank, far_U, far_R, far_R_offset,
+                far_norm, 0, F->block_far, -1, W);
+        if(symm == 'S')
+            ncols += dshared_panel(nrows, bcol_far_start[i+1]-
+                    bcol_far_start[i], bcol_far+bcol_far_start[i], rank,
+                    far_V, far_R, far_R_offset, far_norm, 1, F->block_far,
+                    i, W+(size_t)ncols*nrows);
+        info = dshared_basis(nrows, ncols, W, tol, M2->row_rank+i,
+                M2->row_basis+i);
+    }
+    // Shared bases of block columns
+    if(symm == 'N')
+        for(j = 0; j < nbcols && info == STARSH_SUCCESS; j++)
+        {
+            STARSH_int start = bcol_far_start[j];
+            int nrows = C->size[j];
+            int ncols = dshared_panel(nrows, bcol_far_start[j+1]-start,
+                    bcol_far+start, rank, far_V, far_R, far_R_offset,
+                    far_norm, 1, F->block_far, -1, W);
+            info = dshared_basis(nrows, ncols, W, tol, M2->col_rank+j,
+                    M2->col_basis+j);
+        }
+    free(far_R);
+    free(far_norm);
+    free(far_R_offset);
+    free(W);
+    if(info != STARSH_SUCCESS)
+    {
+        free(use_S);
+        return info;
+    }
+    // Coupling matrix is used instead of low-rank factors only if it is
+    // smaller. Then each basis must pay off: its size must not exceed half of
+    // memory, saved by coupling matrices of its blocks (the other half goes
+    // to the basis of the other side of a block). Otherwise the basis is
+    // dropped together with coupling matrices of its blocks, which can make
+    // other bases useless, so this is repeated until nothing changes. As a
+    // result, this matrix never takes more memory than the initial one.
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        i = F->block_far[2*bi];
+        j = F->block_far[2*bi+1];
+        size_t size_S = (size_t)M2->row_rank[i]*M2->col_rank[j];
+        size_t size_UV = (size_t)rank[bi]*(R->size[i]+C->size[j]);
+        use_S[bi] = rank[bi] > 0 && size_S < size_UV;
+    }
+    double *saved_row = malloc(sizeof(*saved_row)*(nbrows+1));
+    double *saved_col = malloc(sizeof(*saved_col)*(nbcols+1));
+    if(saved_row == NULL || saved_col == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        free(saved_row);
+        free(saved_col);
+        free(use_S);
+        return STARSH_MALLOC_ERROR;
+    }
+    if(symm == 'S')
+    {
+        free(saved_col);
+        saved_col = saved_row;
+    }
+    int changed = 1;
+    while(changed)
+    {
+        changed = 0;
+        for(i = 0; i < nbrows; i++)
+            saved_row[i] = 0.;
+        for(j = 0; j < nbcols; j++)
+            saved_col[j] = 0.;
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            if(!use_S[bi])
+                continue;
+            i = F->block_far[2*bi];
+            j = F->block_far[2*bi+1];
+            double saved = (double)rank[bi]*(R->size[i]+C->size[j])-
+                (double)M2->row_rank[i]*M2->col_rank[j];
+            saved_row[i] += 0.5*saved;
+            saved_col[j] += 0.5*saved;
+        }
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            if(!use_S[bi])
+                continue;
+            i = F->block_far[2*bi];
+            j = F->block_far[2*bi+1];
+            if((double)R->size[i]*M2->row_rank[i] > saved_row[i] ||
+                    (double)C->size[j]*M2->col_rank[j] > saved_col[j])
+            {
+                use_S[bi] = 0;
+                changed = 1;
+            }
+        }
+    }
+    if(symm == 'N')
+        free(saved_col);
+    free(saved_row);
+    // Drop bases, that are not used by any coupling matrix
+    int *used_row = M2->row_rank, *used_col = M2->col_rank;
+    char *used = calloc(nbrows+nbcols+1, sizeof(*used));
+    if(used == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        free(use_S);
+        return STARSH_MALLOC_ERROR;
+    }
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(use_S[bi])
+        {
+            used[F->block_far[2*bi]] = 1;
+            used[symm == 'S' ? F->block_far[2*bi+1] :
+                nbrows+F->block_far[2*bi+1]] = 1;
+        }
+    for(i = 0; i < nbrows; i++)
+        if(!used[i])
+        {
+            free(M2->row_basis[i]);
+            M2->row_basis[i] = NULL;
+            used_row[i] = 0;
+        }
+    if(symm == 'N')
+        for(j = 0; j < nbcols; j++)
+            if(!used[nbrows+j])
+            {
+                free(M2->col_basis[j]);
+                M2->col_basis[j] = NULL;
+                used_col[j] = 0;
+            }
+    free(used);
+    // Coupling matrices `S=(row_basis^T*U)*(col_basis^T*V)^T` or copies of
+    // low-rank factors of each far-field block
+    for(bi = 0; bi < nblocks_far && info == STARSH_SUCCESS; bi++)
+    {
+        i = F->block_far[2*bi];
+        j = F->block_far[2*bi+1];
+        int nrows = R->size[i], ncols = C->size[j];
+        int krow = M2->row_rank[i], kcol = M2->col_rank[j];
+        if(rank[bi] == 0)
+            continue;
+        if(!use_S[bi])
+        {
+            M2->far_rank[bi] = rank[bi];
+            M2->far_U[bi] = malloc(sizeof(double)*(size_t)nrows*rank[bi]);
+            M2->far_V[bi] = malloc(sizeof(double)*(size_t)ncols*rank[bi]);
+            if(M2->far_U[bi] == NULL || M2->far_V[bi] == NULL)
+            {
+                STARSH_ERROR("malloc() failed");
+                info = STARSH_MALLOC_ERROR;
+                continue;
+            }
+            cblas_dcopy(nrows*rank[bi], far_U[bi], 1, M2->far_U[bi], 1);
+            cblas_dcopy(ncols*rank[bi], far_V[bi], 1, M2->far_V[bi], 1);
+            continue;
+        }
+        double *tmp_U = malloc(sizeof(*tmp_U)*(size_t)krow*rank[bi]);
+        double *tmp_V = malloc(sizeof(*tmp_V)*(size_t)kcol*rank[bi]);
+        M2->far_S[bi] = malloc(sizeof(double)*(size_t)krow*kcol);
+        if(tmp_U == NULL || tmp_V == NULL || M2->far_S[bi] == NULL)
+        {
+            STARSH_ERROR("malloc() failed");
+            info = STARSH_MALLOC_ERROR;
+        }
+        else
+        {
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, krow,
+                    rank[bi], nrows, 1.0, M2->row_basis[i], nrows, far_U[bi],
+                    nrows, 0.0, tmp_U, krow);
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, kcol,
+                    rank[bi], ncols, 1.0, M2->col_basis[j], ncols, far_V[bi],
+                    ncols, 0.0, tmp_V, kcol);
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, krow, kcol,
+                    rank[bi], 1.0, tmp_U, krow, tmp_V, kcol, 0.0,
+                    M2->far_S[bi], krow);
+        }
+        free(tmp_U);
+        free(tmp_V);
+    }
+    free(use_S);
+    return info;
+}
+
+int starsh_blrm__dshared(STARSH_blrm2 **matrix2, STARSH_blrm *matrix,
+        double tol)
+//! Recompress block low-rank matrix into a matrix with shared bases.
+/*! Low-rank factors `U` of all far-field blocks of each block row, weighted
+ * by factors `R` of QR decompositions of corresponding factors `V`, are
+ * scaled to unit norm of each block and concatenated into a panel. Truncated
+ * SVD of this panel with respect to given tolerance gives an orthonormal
+ * basis, shared by all far-field blocks of the block row, which keeps
+ * relative accuracy of each block regardless of its norm. The same is done for block columns, and each far-field
+ * block keeps only a coupling matrix in these bases. Far-field blocks, for
+ * which coupling matrix is not smaller than low-rank factors, keep their
+ * factors instead, and bases, that do not pay off, are dropped. So the
+ * result never takes more memory than the initial matrix. Dense near-field
+ * blocks are copied, so that initial matrix can be freed.
+ *
+ * @param[out] matrix2: Address of pointer to @ref STARSH_blrm2 object.
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] tol: Relative error tolerance of each far-field block for bases
+ *      of each block row and block column.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrm2__dmml(), starsh_blrm2_free().
+ * @ingroup blrm
+ * */
+{
+    if(matrix2 == NULL)
+    {
+        STARSH_ERROR("Invalid value of `matrix2`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(matrix == NULL)
+    {
+        STARSH_ERROR("Invalid value of `matrix`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrm *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    STARSH_int nbrows = F->nbrows, nbcols = F->nbcols;
+    STARSH_int nblocks_far = F->nblocks_far, nblocks_near = F->nblocks_near;
+    STARSH_int bi, i, j;
+    char symm = F->symm;
+    int info;
+    // Empty matrix is filled step by step, so it can be freed at any moment
+    STARSH_blrm2 *M2;
+    info = starsh_blrm2__new_empty(&M2, F, M->onfly);
+    if(info != STARSH_SUCCESS)
+        return info;
+    // Lists of block columns of symmetric format are aliases of lists of
+    // block rows, so actual lists of stored blocks of each block column are
+    // required to find transposed blocks
+    STARSH_int *bcol_far_start = F->bcol_far_start, *bcol_far = F->bcol_far;
+    if(symm == 'S')
+    {
+        info = starsh_blrf__bcol_list(nbcols, nblocks_far, F->block_far,
+                &bcol_far_start, &bcol_far);
+        if(info != STARSH_SUCCESS)
+        {
+            starsh_blrm2_free(M2);
+            return info;
+        }
+    }
+    // Factors `U` and `V`. Factors `V` are computed in case of skeleton
+    // format.
+    double **far_U = malloc(sizeof(*far_U)*(nblocks_far+1));
+    double **far_V = malloc(sizeof(*far_V)*(nblocks_far+1));
+    if(far_U == NULL || far_V == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        info = STARSH_MALLOC_ERROR;
+    }
+    else
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            far_U[bi] = M->far_U[bi]->data;
+            far_V[bi] = M->far_skel == NULL ? M->far_V[bi]->data : NULL;
+        }
+    if(M->far_skel != NULL)
+        for(bi = 0; bi < nblocks_far && info == STARSH_SUCCESS; bi++)
+        {
+            far_V[bi] = malloc(sizeof(double)*
+                    ((size_t)C->size[F->block_far[2*bi+1]]*M->far_rank[bi]+1));
+            if(far_V[bi] == NULL)
+            {
+                STARSH_ERROR("malloc() failed");
+                info = STARSH_MALLOC_ERROR;
+            }
+            else
+                info = starsh_blrm__dget_far_V(M, bi, far_V[bi]);
+        }
+    if(info == STARSH_SUCCESS && nblocks_far > 0)
+        info = dshared_build(M2, M, tol, far_U, far_V, bcol_far_start,
+                bcol_far);
+    if(far_V != NULL && M->far_skel != NULL)
+        for(bi = 0; bi < nblocks_far; bi++)
+            free(far_V[bi]);
+    free(far_U);
+    free(far_V);
+    if(symm == 'S')
+    {
+        free(bcol_far_start);
+        free(bcol_far);
+    }
+    // Copy dense near-field blocks
+    if(info == STARSH_SUCCESS && M->onfly == 0)
+        for(bi = 0; bi < nblocks_near; bi++)
+        {
+            i = F->block_near[2*bi];
+            j = F->block_near[2*bi+1];
+            size_t size = (size_t)R->size[i]*C->size[j];
+            M2->near_D[bi] = malloc(sizeof(double)*size);
+            if(M2->near_D[bi] == NULL)
+            {
+                STARSH_ERROR("malloc() failed");
+                info = STARSH_MALLOC_ERROR;
+                break;
+            }
+            cblas_dcopy(size, M->near_D[bi]->data, 1, M2->near_D[bi], 1);
+        }
+    if(info != STARSH_SUCCESS)
+    {
+        starsh_blrm2_free(M2);
+        return info;
+    }
+    // Memory footprint
+    size_t data_nbytes = 0;
+    for(i = 0; i < nbrows; i++)
+        data_nbytes += (size_t)R->size[i]*M2->row_rank[i]*sizeof(double);
+    if(symm == 'N')
+        for(j = 0; j < nbcols; j++)
+            data_nbytes += (size_t)C->size[j]*M2->col_rank[j]*sizeof(double);
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        i = F->block_far[2*bi];
+        j = F->block_far[2*bi+1];
+        if(M2->far_S[bi] != NULL)
+            data_nbytes += (size_t)M2->row_rank[i]*M2->col_rank[j]*
+                sizeof(double);
+        else
+            data_nbytes += (size_t)M2->far_rank[bi]*(R->size[i]+C->size[j])*
+                sizeof(double);
+    }
+    if(M->onfly == 0)
+        for(bi = 0; bi < nblocks_near; bi++)
+            data_nbytes += (size_t)R->size[F->block_near[2*bi]]*
+                C->size[F->block_near[2*bi+1]]*sizeof(double);
+    M2->data_nbytes = data_nbytes;
+    M2->nbytes = data_nbytes+sizeof(*M2)+
+        (nbrows+nbcols)*(sizeof(int)+sizeof(double *))+
+        nblocks_far*(3*sizeof(double *)+sizeof(int))+
+        nblocks_near*sizeof(double *);
+    *matrix2 = M2;
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrm2__dmml(STARSH_blrm2 *matrix, int nrhs, double alpha,
+        double *A, int lda, double beta, double *B, int ldb)
+//! Multiply block low-rank matrix with shared bases by dense matrix.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm2 `A` and dense
+ * matrices `B` and `C`. Right hand sides are projected onto basis of each
+ * block column, multiplied by coupling matrices and expanded by basis of
+ * each block row, so every basis is read only once. All the integer types
+ * are int, since they are used in BLAS calls.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm2 object.
+ * @param[in] nrhs: Number of right hand sides.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm2 *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_int nrows = P->shape[0];
+    // Shorcuts to information about clusters
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    void *RD = R->data, *CD = C->data;
+    STARSH_int nbrows = F->nbrows, nbcols = F->nbcols;
+    STARSH_int nblocks_far = F->nblocks_far, nblocks_near = F->nblocks_near;
+    STARSH_int bi, i, j;
+    char symm = F->symm;
+    // Setting B = beta*B
+    if(beta == 0.)
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] = 0.;
+    else
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < nrhs; j++)
+                B[j*(size_t)ldb+i] *= beta;
+    // Offsets of projections onto bases of block columns and block rows
+    size_t *col_offset, *row_offset, size_X = 0, size_Y = 0;
+    STARSH_MALLOC(col_offset, nbcols+nbrows);
+    row_offset = col_offset+nbcols;
+    for(j = 0; j < nbcols; j++)
+    {
+        col_offset[j] = size_X;
+        size_X += (size_t)nrhs*M->col_rank[j];
+    }
+    for(i = 0; i < nbrows; i++)
+    {
+        row_offset[i] = size_Y;
+        size_Y += (size_t)nrhs*M->row_rank[i];
+    }
+    double *X = malloc(sizeof(*X)*(size_X+size_Y+1)), *Y = X+size_X;
+    if(X == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        free(col_offset);
+        return STARSH_MALLOC_ERROR;
+    }
+    // Project right hand sides onto bases of block columns. In case of
+    // symmetric matrix, projections onto bases of block rows are the same
+    for(j = 0; j < nbcols; j++)
+        if(M->col_rank[j] > 0)
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans,
+                    M->col_rank[j], nrhs, C->size[j], 1.0, M->col_basis[j],
+                    C->size[j], A+C->start[j], lda, 0.0, X+col_offset[j],
+                    M->col_rank[j]);
+    for(size_t l = 0; l < size_Y; l++)
+        Y[l] = 0.;
+    // Multiply by coupling matrices
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        if(M->far_S[bi] == NULL)
+            continue;
+        i = F->block_far[2*bi];
+        j = F->block_far[2*bi+1];
+        int krow = M->row_rank[i], kcol = M->col_rank[j];
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, krow, nrhs,
+                kcol, 1.0, M->far_S[bi], krow, X+col_offset[j], kcol, 1.0,
+                Y+row_offset[i], krow);
+        if(i != j && symm == 'S')
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, kcol, nrhs,
+                    krow, 1.0, M->far_S[bi], krow, X+col_offset[i], krow,
+                    1.0, Y+row_offset[j], kcol);
+    }
+    // Expand results by bases of block rows
+    for(i = 0; i < nbrows; i++)
+        if(M->row_rank[i] > 0)
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans,
+                    R->size[i], nrhs, M->row_rank[i], alpha,
+                    M->row_basis[i], R->size[i], Y+row_offset[i],
+                    M->row_rank[i], 1.0, B+R->start[i], ldb);
+    free(X);
+    free(col_offset);
+    // Far-field blocks, that keep their own low-rank factors
+    int maxrank = 0, maxrow = 0, maxcol = 0;
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(M->far_rank[bi] > maxrank)
+            maxrank = M->far_rank[bi];
+    for(i = 0; i < nbrows; i++)
+        if(R->size[i] > maxrow)
+            maxrow = R->size[i];
+    for(j = 0; j < nbcols; j++)
+        if(C->size[j] > maxcol)
+            maxcol = C->size[j];
+    size_t size_D = (size_t)nrhs*maxrank;
+    if(M->onfly == 1 && (size_t)maxrow*maxcol > size_D)
+        size_D = (size_t)maxrow*maxcol;
+    double *temp_D;
+    STARSH_MALLOC(temp_D, size_D+1);
+    for(bi = 0; bi < nblocks_far; bi++)
+    {
+        int rank = M->far_rank[bi];
+        if(M->far_U[bi] == NULL || rank == 0)
+            continue;
+        i = F->block_far[2*bi];
+        j = F->block_far[2*bi+1];
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                ncols, 1.0, M->far_V[bi], ncols, A+C->start[j], lda, 0.0,
+                temp_D, rank);
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                rank, alpha, M->far_U[bi], nrows, temp_D, rank, 1.0,
+                B+R->start[i], ldb);
+        if(i != j && symm == 'S')
+        {
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, rank, nrhs,
+                    nrows, 1.0, M->far_U[bi], nrows, A+R->start[i], lda, 0.0,
+                    temp_D, rank);
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, ncols,
+                    nrhs, rank, alpha, M->far_V[bi], ncols, temp_D, rank, 1.0,
+                    B+C->start[j], ldb);
+        }
+    }
+    // Simple cycle over all near-field blocks
+    for(bi = 0; bi < nblocks_near; bi++)
+    {
+        i = F->block_near[2*bi];
+        j = F->block_near[2*bi+1];
+        int nrows = R->size[i];
+        int ncols = C->size[j];
+        double *D = temp_D;
+        if(M->onfly == 1)
+            // Fill temporary buffer with elements of corresponding block
+            starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+                    C->pivot+C->start[j], RD, CD, D, nrows);
+        else
+            D = M->near_D[bi];
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                ncols, alpha, D, nrows, A+C->start[j], lda, 1.0,
+                B+R->start[i], ldb);
+        if(i != j && symm == 'S')
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols, nrhs,
+                    nrows, alpha, D, nrows, A+R->start[i], lda, 1.0,
+                    B+C->start[j], ldb);
+    }
+    free(temp_D);
+    return STARSH_SUCCESS;
+}
@@ -0,0 +1,157 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/sequential/dense/daca.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+// Number of rows, whose residuals are checked before stopping
+#define ACA_NSAMPLE 8
+
+void starsh_dense_dlraca(int nrows, int ncols, STARSH_kernel *kernel,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        double *U, int ldU, double *V, int ldV, int *rank, int maxrank,
+        double tol, int *iwork)
+//! Adaptive cross approximation with partial pivoting of a kernel block.
+/*! Unlike other low-rank engines, this one does not need a dense block, since
+ * it computes only required rows and columns of a block by a kernel. Thus,
+ * it is the cheapest way to approximate blocks of expensive kernels. Columns
+ * of factors `U` and `V` are used as temporary buffers, so they must have at
+ * least `maxrank` columns. Size of `iwork` must be at least `nrows`. Stopping
+ * criterion is based on the estimated Frobenius norm of an approximation,
+ * and it is confirmed by residuals of a few unused rows.
+ *
+ * @param[in] nrows: Number of rows of a block.
+ * @param[in] ncols: Number of columns of a block.
+ * @param[in] kernel: Kernel function.
+ * @param[in] irow: Indexes of rows of a block.
+ * @param[in] icol: Indexes of columns of a block.
+ * @param[in] row_data: Data for rows of a block.
+ * @param[in] col_data: Data for columns of a block.
+ * @param[out] U: Pointer to low-rank factor `U`.
+ * @param[in] ldU: leading dimensions of `U`.
+ * @param[out] V: Pointer to low-rank factor `V`.
+ * @param[in] ldV: leading dimensions of `V`.
+ * @param[out] rank: Address of rank variable.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance or minus absolute one, like in
+ *      starsh_dense_dsvfr().
+ * @param[in] iwork: Temporary integer array.
+ * */
+{
+    int mn = nrows < ncols ? nrows : ncols;
+    int i, k = 0, l, pivot_row = 0, pivot_col;
+    // Squared Frobenius norm of current approximation
+    double norm2 = 0.;
+    // Mark all rows as not used as pivots
+    for(i = 0; i < nrows; i++)
+        iwork[i] = 0;
+    *rank = -1;
+    while(k < maxrank && k < mn)
+    {
+        double *u = U+k*(size_t)ldU, *v = V+k*(size_t)ldV;
+        iwork[pivot_row] = 1;
+        // Residual of pivot row
+        kernel(1, ncols, irow+pivot_row, icol, row_data, col_data, v, 1);
+        for(l = 0; l < k; l++)
+            cblas_daxpy(ncols, -U[l*(size_t)ldU+pivot_row], V+l*(size_t)ldV,
+                    1, v, 1);
+        pivot_col = cblas_idamax(ncols, v, 1);
+        double delta = v[pivot_col];
+        if(delta == 0.)
+        {
+            // Residual row is zero, so try next row, not used as pivot
+            for(i = 0; i < nrows && iwork[i] == 1; i++);
+            if(i == nrows)
+            {
+                // Approximation is exact
+                *rank = k;
+                break;
+            }
+            pivot_row = i;
+            continue;
+        }
+        // Residual of pivot column, scaled by pivot element
+        kernel(nrows, 1, irow, icol+pivot_col, row_data, col_data, u, nrows);
+        for(l = 0; l < k; l++)
+            cblas_daxpy(nrows, -V[l*(size_t)ldV+pivot_col], U+l*(size_t)ldU,
+                    1, u, 1);
+        cblas_dscal(nrows, 1./delta, u, 1);
+        // Update norm of approximation
+        double unorm = cblas_dnrm2(nrows, u, 1);
+        double vnorm = cblas_dnrm2(ncols, v, 1);
+        double step2 = unorm*unorm*vnorm*vnorm;
+        for(l = 0; l < k; l++)
+            norm2 += 2*cblas_ddot(nrows, u, 1, U+l*(size_t)ldU, 1)*
+                cblas_ddot(ncols, v, 1, V+l*(size_t)ldV, 1);
+        norm2 += step2;
+        k++;
+        // Check if new cross is small enough
+        if((tol < 0 && step2 <= tol*tol) || (tol >= 0 &&
+                    step2 <= tol*tol*norm2))
+        {
+            // A small cross does not mean the residual is small, for example
+            // if pivot row is far from the column cluster. Residuals of
+            // several unused rows are checked with the next column of `V`
+            // as a buffer. The worst of them becomes the next pivot row
+            if(k == maxrank || k == mn)
+            {
+                *rank = k;
+                break;
+            }
+            double *r = V+k*(size_t)ldV, check2 = 0., maxcheck = -1.;
+            int nsample = 0, stride = (nrows+ACA_NSAMPLE-1)/ACA_NSAMPLE;
+            for(i = stride/2; i < nrows; i += stride)
+            {
+                if(iwork[i] == 1)
+                    continue;
+                kernel(1, ncols, irow+i, icol, row_data, col_data, r, 1);
+                for(l = 0; l < k; l++)
+                    cblas_daxpy(ncols, -U[l*(size_t)ldU+i], V+l*(size_t)ldV,
+                            1, r, 1);
+                double rnorm = cblas_dnrm2(ncols, r, 1);
+                check2 += rnorm*rnorm;
+                nsample++;
+                if(rnorm > maxcheck)
+                {
+                    maxcheck = rnorm;
+                    pivot_row = i;
+                }
+            }
+            // Squared norm of residual is extrapolated from sampled rows
+            check2 *= (double)nrows/(nsample > 0 ? nsample : 1);
+            if((tol < 0 && check2 <= tol*tol) || (tol >= 0 &&
+                        check2 <= tol*tol*norm2))
+            {
+                *rank = k;
+                break;
+            }
+            continue;
+        }
+        // Next pivot row corresponds to the largest element of new column
+        double maxval = -1.;
+        pivot_row = -1;
+        for(i = 0; i < nrows; i++)
+            if(iwork[i] == 0 && fabs(u[i]) > maxval)
+            {
+                maxval = fabs(u[i]);
+                pivot_row = i;
+            }
+        if(pivot_row == -1)
+        {
+            *rank = k;
+            break;
+        }
+    }
+    // If far-field block is dense, although it was initially assumed
+    // to be low-rank. Let denote such a block as false far-field block
+    if(*rank >= mn/2 || *rank > maxrank)
+        *rank = -1;
+}
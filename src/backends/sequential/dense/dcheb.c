@@ -0,0 +1,233 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/sequential/dense/dcheb.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "starsh.h"
+#include "common.h"
+
+void starsh_dense_dchebnodes(int ndim, int p, const double *box, double *node,
+        STARSH_int ldnode)
+//! Tensor Chebyshev nodes in a bounding box.
+/*! Nodes are ordered in a way, that `k`-th node corresponds to multi-index
+ * `(k%p, (k/p)%p, (k/p/p)%p, ...)`. Coordinates of nodes are stored
+ * dimension by dimension, like coordinates of @ref STARSH_particles.
+ *
+ * @param[in] ndim: Dimensionality of space.
+ * @param[in] p: Number of nodes in each dimension.
+ * @param[in] box: Lower corner of a box, followed by its upper corner.
+ * @param[out] node: Coordinates of `p^ndim` nodes.
+ * @param[in] ldnode: Leading dimension of `node`.
+ * */
+{
+    int r = 1, i, k, l;
+    double pi = acos(-1.);
+    for(i = 0; i < ndim; i++)
+        r *= p;
+    for(i = 0; i < ndim; i++)
+    {
+        double center = 0.5*(box[i]+box[ndim+i]);
+        double radius = 0.5*(box[ndim+i]-box[i]);
+        for(k = 0, l = 1; k < i; k++)
+            l *= p;
+        for(k = 0; k < r; k++)
+            node[i*ldnode+k] = center+radius*cos(pi*(2*((k/l)%p)+1)/(2.*p));
+    }
+}
+
+void starsh_dense_dchebbasis(int npoints, int ndim, int p, const double *box,
+        const double *point, STARSH_int ldpoint, double *S, int ldS)
+//! Lagrange polynomials on tensor Chebyshev nodes at given points.
+/*! Computes matrix `S` of size `npoints` by `p^ndim`, such that a smooth
+ * function `f` is approximated by `S*f(nodes)`, where nodes are generated by
+ * starsh_dense_dchebnodes() for the same bounding box. Each polynomial is
+ * evaluated by its expansion in Chebyshev polynomials, so no division by
+ * difference of coordinates is needed.
+ *
+ * @param[in] npoints: Number of points.
+ * @param[in] ndim: Dimensionality of space.
+ * @param[in] p: Number of nodes in each dimension.
+ * @param[in] box: Lower corner of a box, followed by its upper corner.
+ * @param[in] point: Coordinates of points, stored dimension by dimension.
+ * @param[in] ldpoint: Leading dimension of `point`.
+ * @param[out] S: Values of Lagrange polynomials.
+ * @param[in] ldS: Leading dimension of `S`.
+ * */
+{
+    int r = 1, i, j, k, l;
+    double pi = acos(-1.);
+    for(i = 0; i < ndim; i++)
+        r *= p;
+    // Values of 1-dimensional Lagrange polynomials and Chebyshev polynomials
+    double s[ndim*p], T[p], t;
+    for(j = 0; j < npoints; j++)
+    {
+        for(i = 0; i < ndim; i++)
+        {
+            double radius = 0.5*(box[ndim+i]-box[i]);
+            // Scaled coordinate in [-1, 1]
+            double x = 0.;
+            if(radius > 0.)
+                x = (point[i*ldpoint+j]-0.5*(box[i]+box[ndim+i]))/radius;
+            T[0] = 1.;
+            if(p > 1)
+                T[1] = x;
+            for(l = 2; l < p; l++)
+                T[l] = 2*x*T[l-1]-T[l-2];
+            for(k = 0; k < p; k++)
+            {
+                // Value of Chebyshev polynomial T_l at k-th node is
+                // cos(l*theta_k)
+                double theta = pi*(2*k+1)/(2.*p);
+                t = 1.;
+                for(l = 1; l < p; l++)
+                    t += 2*T[l]*cos(l*theta);
+                s[i*p+k] = t/p;
+            }
+        }
+        for(k = 0; k < r; k++)
+        {
+            int m = k;
+            t = 1.;
+            for(i = 0; i < ndim; i++)
+            {
+                t *= s[i*p+m%p];
+                m /= p;
+            }
+            S[k*(size_t)ldS+j] = t;
+        }
+    }
+}
+
+void starsh_dense_dlrcheb(int nrows, int ncols, int krow, int kcol,
+        double *core, double *Qrow, double *Rrow, double *Qcol, double *Rcol,
+        double *U, int ldU, double *V, int ldV, int *rank, int maxrank,
+        double tol, double *work, int lwork, int *iwork)
+//! Recompress polynomial interpolant of a far-field block.
+/*! Far-field block is approximated by `Qrow*Rrow*core*Rcol^T*Qcol^T`, where
+ * `core` is a submatrix of the block on skeleton rows and columns. This
+ * function computes SVD of a small matrix `Rrow*core*Rcol^T` and truncates
+ * it with respect to given tolerance. If `r` is the largest of `krow` and
+ * `kcol`, then size of `work` must be at least `8*r*(r+1)` and size of
+ * `iwork` must be at least `8*r`.
+ *
+ * @param[in] nrows: Number of rows of a block.
+ * @param[in] ncols: Number of columns of a block.
+ * @param[in] krow: Number of skeleton rows.
+ * @param[in] kcol: Number of skeleton columns.
+ * @param[in] core: Submatrix on skeleton rows and columns, `krow` by `kcol`.
+ * @param[in] Qrow: Factor Q of interpolation matrix of rows.
+ * @param[in] Rrow: Factor R of interpolation matrix of rows.
+ * @param[in] Qcol: Factor Q of interpolation matrix of columns.
+ * @param[in] Rcol: Factor R of interpolation matrix of columns.
+ * @param[out] U: Pointer to low-rank factor `U`.
+ * @param[in] ldU: leading dimensions of `U`.
+ * @param[out] V: Pointer to low-rank factor `V`.
+ * @param[in] ldV: leading dimensions of `V`.
+ * @param[out] rank: Address of rank variable.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance or minus absolute one.
+ * @param[in] work: Working array.
+ * @param[in] lwork: Size of `work` array.
+ * @param[in] iwork: Temporary integer array.
+ * */
+{
+    int mn = nrows < ncols ? nrows : ncols;
+    int mn2 = krow < kcol ? krow : kcol;
+    int i;
+    double *tmp, *small, *svd_U, *svd_S, *svd_V, *svd_work;
+    tmp = work;
+    small = tmp+(size_t)krow*kcol;
+    svd_U = small+(size_t)krow*kcol;
+    svd_S = svd_U+(size_t)krow*mn2;
+    svd_V = svd_S+mn2;
+    svd_work = svd_V+(size_t)mn2*kcol;
+    int svd_lwork = lwork-(int)(svd_work-work);
+    // small = Rrow*core*Rcol^T
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, krow, kcol, krow,
+            1.0, Rrow, krow, core, krow, 0.0, tmp, krow);
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, krow, kcol, kcol,
+            1.0, tmp, krow, Rcol, kcol, 0.0, small, krow);
+    LAPACKE_dgesdd_work(LAPACK_COL_MAJOR, 'S', krow, kcol, small, krow, svd_S,
+            svd_U, krow, svd_V, mn2, svd_work, svd_lwork, iwork);
+    // Get rank, corresponding to given error tolerance
+    *rank = starsh_dense_dsvfr(mn2, svd_S, tol);
+    if(*rank < mn/2 && *rank <= maxrank)
+    // If far-field block is low-rank
+    {
+        for(i = 0; i < *rank; i++)
+            cblas_dscal(krow, svd_S[i], svd_U+i*(size_t)krow, 1);
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, *rank,
+                krow, 1.0, Qrow, nrows, svd_U, krow, 0.0, U, ldU);
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, ncols, *rank,
+                kcol, 1.0, Qcol, ncols, svd_V, mn2, 0.0, V, ldV);
+    }
+    else
+    // If far-field block is dense, although it was initially assumed
+    // to be low-rank. Let denote such a block as false far-field block
+        *rank = -1;
+}
+
+void starsh_dense_dlrcheb_check(int nrows, int ncols, STARSH_kernel *kernel,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        double *U, int ldU, double *V, int ldV, int *rank, double tol,
+        int nsample, double *work, STARSH_int *iwork)
+//! Estimate error of low-rank approximation of a block on a few columns.
+/*! Interpolation error is not known in advance, since it depends on
+ * smoothness of a kernel. This function computes up to `nsample` evenly
+ * spaced columns of a block and compares them to the same columns of
+ * `U*V^T`. If relative error on these columns exceeds `tol`, the block is
+ * marked as false far-field block by setting rank to `-1`. Negative `tol`
+ * stands for absolute error `-tol` of the whole block, which is extrapolated
+ * from error on computed columns. Size of `work`
+ * must be at least `nrows*nsample` and size of `iwork` must be at least
+ * `nsample`.
+ *
+ * @param[in] nrows: Number of rows of a block.
+ * @param[in] ncols: Number of columns of a block.
+ * @param[in] kernel: Pointer to a kernel, generating the block.
+ * @param[in] irow: Indexes of rows of the block.
+ * @param[in] icol: Indexes of columns of the block.
+ * @param[in] row_data: Pointer to physical data for rows.
+ * @param[in] col_data: Pointer to physical data for columns.
+ * @param[in] U: Pointer to low-rank factor `U`.
+ * @param[in] ldU: leading dimensions of `U`.
+ * @param[in] V: Pointer to low-rank factor `V`.
+ * @param[in] ldV: leading dimensions of `V`.
+ * @param[in,out] rank: Address of rank variable.
+ * @param[in] tol: Relative error tolerance or minus absolute one.
+ * @param[in] nsample: Number of columns to check.
+ * @param[in] work: Working array.
+ * @param[in] iwork: Temporary integer array.
+ * */
+{
+    int i;
+    if(nsample > ncols)
+        nsample = ncols;
+    if(*rank < 0 || nsample == 0)
+        return;
+    for(i = 0; i < nsample; i++)
+        iwork[i] = icol[(2*i+1)*(STARSH_int)ncols/(2*nsample)];
+    kernel(nrows, nsample, irow, iwork, row_data, col_data, work, nrows);
+    double norm = cblas_dnrm2(nrows*nsample, work, 1);
+    for(i = 0; i < nsample && *rank > 0; i++)
+        cblas_dgemv(CblasColMajor, CblasNoTrans, nrows, *rank, -1.0, U, ldU,
+                V+(2*i+1)*(STARSH_int)ncols/(2*nsample), ldV, 1.0,
+                work+i*(size_t)nrows, 1);
+    double err = cblas_dnrm2(nrows*nsample, work, 1);
+    if(tol < 0)
+    {
+        // Error of the whole block is estimated by error on its columns
+        err *= sqrt((double)ncols/nsample);
+        if(err > -tol)
+            *rank = -1;
+    }
+    else if(err > tol*norm)
+        *rank = -1;
+}
@@ -0,0 +1,92 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/backends/sequential/dense/did.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "starsh.h"
+#include "common.h"
+
+void starsh_dense_dlrid(int nrows, int ncols, double *D, int ldD, double *U,
+        int ldU, int *skel, int *rank, int maxrank, double tol, double *work,
+        int lwork, int *iwork)
+//! Row interpolative decomposition of a dense double precision matrix.
+/*! Approximates `D` by `U*D(skel,:)`, where `skel` is a set of skeleton rows
+ * of `D`, selected by rank-revealing QR of transposed `D`. Rows of
+ * interpolation matrix `U`, corresponding to skeleton rows, are rows of
+ * identity matrix. Matrix `D` is not changed, so skeleton rows can be read
+ * from it right after this call. This function calls LAPACK and BLAS
+ * routines, so integer types are int instead of @ref STARSH_int.
+ *
+ * Size of `work` must be at least `nrows*ncols+2*min(nrows,ncols)+3*nrows+1`
+ * and size of `iwork` must be at least `nrows`.
+ *
+ * @param[in] nrows: Number of rows of a matrix.
+ * @param[in] ncols: Number of columns of a matrix.
+ * @param[in] D: Pointer to dense matrix.
+ * @param[in] ldD: leading dimensions of `D`.
+ * @param[out] U: Pointer to interpolation matrix `U`.
+ * @param[in] ldU: leading dimensions of `U`.
+ * @param[out] skel: Indexes of skeleton rows, starting from 0.
+ * @param[out] rank: Address of rank variable.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance or minus absolute one.
+ * @param[in] work: Working array.
+ * @param[in] lwork: Size of `work` array.
+ * @param[in] iwork: Temporary integer array.
+ * */
+{
+    int mn = nrows < ncols ? nrows : ncols;
+    int i, j;
+    double *Dt, *tau, *diag, *qp3_work;
+    Dt = work;
+    tau = Dt+(size_t)nrows*ncols;
+    diag = tau+mn;
+    qp3_work = diag+mn;
+    int qp3_lwork = lwork-(int)(qp3_work-work);
+    // Transpose `D`, since rows are selected by pivoted QR of columns
+    for(i = 0; i < nrows; i++)
+        cblas_dcopy(ncols, D+i, ldD, Dt+i*(size_t)ncols, 1);
+    // Set pivots for GEQP3 to zeros
+    for(i = 0; i < nrows; i++)
+        iwork[i] = 0;
+    // Call GEQP3
+    LAPACKE_dgeqp3_work(LAPACK_COL_MAJOR, ncols, nrows, Dt, ncols, iwork,
+            tau, qp3_work, qp3_lwork);
+    // Error of rank-k interpolative decomposition is exactly the Frobenius
+    // norm of trailing submatrix R22 of factor R, so norms of rows of R22 are
+    // used instead of singular values to get the rank
+    for(i = 0; i < mn; i++)
+        diag[i] = cblas_dnrm2(nrows-i, Dt+i*(size_t)ncols+i, ncols);
+    // Get rank, corresponding to given error tolerance
+    *rank = starsh_dense_dsvfr(mn, diag, tol);
+    if(*rank < mn/2 && *rank <= maxrank)
+    // If far-field block is low-rank
+    {
+        int k = *rank;
+        // Get interpolation coefficients inv(R11)*R12 in place of R12
+        if(k > 0)
+            cblas_dtrsm(CblasColMajor, CblasLeft, CblasUpper, CblasNoTrans,
+                    CblasNonUnit, k, nrows-k, 1.0, Dt, ncols,
+                    Dt+k*(size_t)ncols, ncols);
+        for(i = 0; i < k; i++)
+        {
+            skel[i] = iwork[i]-1;
+            for(j = 0; j < nrows; j++)
+                U[i*(size_t)ldU+j] = 0.;
+            U[i*(size_t)ldU+skel[i]] = 1.;
+        }
+        // Rows of `U`, corresponding to redundant rows of `D`
+        for(j = k; j < nrows; j++)
+            cblas_dcopy(k, Dt+j*(size_t)ncols, 1, U+iwork[j]-1, ldU);
+    }
+    else
+    // If far-field block is dense, although it was initially assumed
+    // to be low-rank. Let denote such a block as false far-field block
+        *rank = -1;
+}
@@ -31,7 +31,7 @@ void starsh_dense_dlrqp3(int nrows, int ncols, double *D, int ldD, double *U,
  * @param[out] rank: Address of rank variable.
  * @param[in] maxrank: Maximum possible rank.
  * @param[in] oversample: 
- * @param[in] tol: Relative error for approximation.
+ * @param[in] tol: Relative error tolerance or minus absolute one.
  * @param[in] work: Working array.
  * @param[in] lwork: Size of `work` array.
  * @param[in] iwork: Temporary integer array.
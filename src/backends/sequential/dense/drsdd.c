@@ -91,3 +91,185 @@ void starsh_dense_dlrrsdd(int nrows, int ncols, double *D, int ldD, double *U,
     // to be low-rank. Let denote such a block as false far-field block
         *rank = -1;
 }
+
+static int starsh_dense__drealloc(double **buf, size_t size)
+//! Change size of a buffer, keeping it untouched if realloc() fails.
+{
+    double *tmp = realloc(*buf, sizeof(*tmp)*size);
+    if(tmp == NULL)
+    {
+        STARSH_ERROR("realloc() failed");
+        return STARSH_MALLOC_ERROR;
+    }
+    *buf = tmp;
+    return STARSH_SUCCESS;
+}
+
+int starsh_dense_dlrrsdd_grow(int nrows, int ncols, double *D, int ldD,
+        double **U, double **V, int *rank, int oversample, double tol)
+//! Randomized SVD approximation with rank, not limited by maxrank.
+/*! Number of random samples is doubled until approximation with given
+ * tolerance is found or until the rank reaches break-even point
+ * `nrows*ncols/(nrows+ncols)`, where low-rank factors take as much memory as
+ * the dense matrix itself. Sketch `D*X` is extended by new random samples on
+ * each step, so only new samples are multiplied by `D` and orthogonalized
+ * against the current basis, and only SVD of a small matrix is computed
+ * again. Factors `U` and `V` are allocated with exactly `rank` columns, user
+ * has to free them. If block is not low-rank or temporary buffers can not be
+ * allocated, `rank` is set to -1 and no memory is allocated.
+ *
+ * @param[in] nrows: Number of rows of a matrix.
+ * @param[in] ncols: Number of columns of a matrix.
+ * @param[in] D: Pointer to dense matrix.
+ * @param[in] ldD: leading dimensions of `D`.
+ * @param[out] U: Address of pointer to low-rank factor `U`.
+ * @param[out] V: Address of pointer to low-rank factor `V`.
+ * @param[out] rank: Address of rank variable.
+ * @param[in] oversample: Size of oversampling subset.
+ * @param[in] tol: Relative error tolerance or minus absolute one.
+ * @return Error code @ref STARSH_ERRNO.
+ * */
+{
+    int mn = nrows < ncols ? nrows : ncols;
+    int limit = (double)nrows*(double)ncols/(nrows+ncols);
+    if(limit > mn)
+        limit = mn;
+    int cur = oversample < limit ? oversample : limit;
+    // Number of samples in the sketch and its maximal value
+    int nsamples = 0, maxsamples = limit+oversample;
+    if(maxsamples > mn)
+        maxsamples = mn;
+    int iseed[4] = {0, 0, 0, 1};
+    int i, lwork_cur = 0, info = STARSH_SUCCESS;
+    *U = NULL;
+    *V = NULL;
+    *rank = -1;
+    if(limit <= 0)
+        return STARSH_SUCCESS;
+    // Orthonormal basis `Q` of the sketch and `Bt = D^T*Q` grow with number
+    // of samples, while SVD of `Bt` is computed in `svd_W` and `svd_Z`
+    double *Q = NULL, *Bt = NULL, *X = NULL, *C = NULL, *tau = NULL;
+    double *svd_W = NULL, *svd_S = NULL, *svd_Z = NULL, *work = NULL;
+    int *iwork = NULL;
+    while(1)
+    {
+        int total = cur+oversample < maxsamples ? cur+oversample : maxsamples;
+        int add = total-nsamples;
+        if(add > 0)
+        {
+            int lwork = ncols, lwork_sdd = (4*total+7)*total;
+            if(lwork_sdd > lwork)
+                lwork = lwork_sdd;
+            // Factors of the sketch keep their values, other buffers are
+            // temporary
+            info = starsh_dense__drealloc(&Q, (size_t)nrows*total);
+            info |= starsh_dense__drealloc(&Bt, (size_t)ncols*total);
+            info |= starsh_dense__drealloc(&X, (size_t)ncols*total);
+            info |= starsh_dense__drealloc(&C, (size_t)total*total);
+            info |= starsh_dense__drealloc(&tau, total);
+            info |= starsh_dense__drealloc(&svd_W, (size_t)ncols*total);
+            info |= starsh_dense__drealloc(&svd_S, total);
+            info |= starsh_dense__drealloc(&svd_Z, (size_t)total*total);
+            info |= starsh_dense__drealloc(&work, lwork);
+            free(iwork);
+            STARSH_PMALLOC(iwork, 8*total, info);
+            if(info != STARSH_SUCCESS)
+            {
+                info = STARSH_MALLOC_ERROR;
+                break;
+            }
+            double *Qnew = Q+(size_t)nrows*nsamples;
+            // Sketch new random samples
+            LAPACKE_dlarnv_work(3, iseed, ncols*add, X);
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, add,
+                    ncols, 1.0, D, ldD, X, ncols, 0.0, Qnew, nrows);
+            // Orthogonalize them against current basis and orthonormalize.
+            // New samples of exactly low-rank matrix may lie in the span of
+            // the basis, so their orthonormalized round-off errors are
+            // orthogonalized once again.
+            for(i = 0; i < 2; i++)
+            {
+                if(nsamples > 0)
+                {
+                    cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans,
+                            nsamples, add, nrows, 1.0, Q, nrows, Qnew, nrows,
+                            0.0, C, nsamples);
+                    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans,
+                            nrows, add, nsamples, -1.0, Q, nrows, C, nsamples,
+                            1.0, Qnew, nrows);
+                }
+                LAPACKE_dgeqrf_work(LAPACK_COL_MAJOR, nrows, add, Qnew, nrows,
+                        tau, work, lwork);
+                LAPACKE_dorgqr_work(LAPACK_COL_MAJOR, nrows, add, add, Qnew,
+                        nrows, tau, work, lwork);
+                if(nsamples == 0)
+                    break;
+            }
+            // Project the matrix onto new part of the basis
+            cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ncols, add,
+                    nrows, 1.0, D, ldD, Qnew, nrows, 0.0,
+                    Bt+(size_t)ncols*nsamples, ncols);
+            nsamples = total;
+            lwork_cur = lwork;
+        }
+        // SVD overwrites its input, so `Bt` is copied
+        memcpy(X, Bt, sizeof(*X)*(size_t)ncols*nsamples);
+        int sdd_info = LAPACKE_dgesdd_work(LAPACK_COL_MAJOR, 'S', ncols,
+                nsamples, X, ncols, svd_S, svd_W, ncols, svd_Z, nsamples,
+                work, lwork_cur, iwork);
+        if(sdd_info != 0)
+        {
+            STARSH_WARNING("LAPACKE_dgesdd_work info=%d", sdd_info);
+            *rank = -1;
+            break;
+        }
+        // Get rank, corresponding to given error tolerance
+        *rank = starsh_dense_dsvfr(nsamples, svd_S, tol);
+        if(*rank <= cur)
+            break;
+        *rank = -1;
+        if(cur == limit)
+            break;
+        // Not enough samples, so increase their number
+        cur *= 2;
+        if(cur > limit)
+            cur = limit;
+    }
+    if(info == STARSH_SUCCESS && *rank != -1)
+    {
+        // One extra element keeps malloc() from returning NULL for rank 0
+        STARSH_PMALLOC(*U, (size_t)nrows*(size_t)(*rank)+1, info);
+        STARSH_PMALLOC(*V, (size_t)ncols*(size_t)(*rank)+1, info);
+    }
+    if(info == STARSH_SUCCESS && *rank != -1)
+    {
+        // D ~ Q*Bt^T = Q*Z*S*W^T, so U = Q*Z and V = W*S
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, *rank,
+                nsamples, 1.0, Q, nrows, svd_Z, nsamples, 0.0, *U, nrows);
+        for(i = 0; i < *rank; i++)
+        {
+            cblas_dcopy(ncols, svd_W+i*(size_t)ncols, 1,
+                    *V+i*(size_t)ncols, 1);
+            cblas_dscal(ncols, svd_S[i], *V+i*(size_t)ncols, 1);
+        }
+    }
+    else
+    {
+        free(*U);
+        free(*V);
+        *U = NULL;
+        *V = NULL;
+        *rank = -1;
+    }
+    free(Q);
+    free(Bt);
+    free(X);
+    free(C);
+    free(tau);
+    free(svd_W);
+    free(svd_S);
+    free(svd_Z);
+    free(work);
+    free(iwork);
+    return info;
+}
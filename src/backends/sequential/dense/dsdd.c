@@ -30,7 +30,7 @@ void starsh_dense_dlrsdd(int nrows, int ncols, double *D, int ldD, double *U,
  * @param[in] ldV: leading dimensions of `V`.
  * @param[out] rank: Address of rank variable.
  * @param[in] maxrank: Maximum possible rank.
- * @param[in] tol: Relative error for approximation.
+ * @param[in] tol: Relative error tolerance or minus absolute one.
  * @param[in] work: Working array.
  * @param[in] lwork: Size of `work` array.
  * @param[in] iwork: Temporary integer array.
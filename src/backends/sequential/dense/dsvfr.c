@@ -17,10 +17,12 @@ int starsh_dense_dsvfr(int size, double *S, double tol)
 //! Returns rank of double precision singular values.
 /*! Tries ranks `size`, `size`-1, `size`-2 and so on. May be accelerated by
  * binary search, but it requires additional temporary memory to be allocated.
+ * Negative `tol` stands for absolute error tolerance `-tol`, so rank can be
+ * 0 if Frobenius norm is below it.
  *
  * @param[in] size: Number of singular values.
  * @param[in] S: Array of singular values.
- * @param[in] tol: Relative error tolerance.
+ * @param[in] tol: Relative error tolerance or minus absolute one.
  * @return rank in terms of relative error in Frobenius norm.
  * */
 {
@@ -32,16 +34,24 @@ int starsh_dense_dsvfr(int size, double *S, double tol)
     // If all elements of S are zeros, then rank is 0
     if(err_tol == 0)
         return 0;
+    // Set tolerance
+    int minrank = 1;
+    if(tol < 0)
+    {
+        err_tol = tol*tol;
+        minrank = 0;
+    }
+    else
+        err_tol *= tol*tol;
     // If Frobenius norm is not zero, then set rank as maximum possible value
     i = size;
-    // Set tolerance
-    err_tol *= tol*tol;
     double tmp_norm = S[size-1]*S[size-1];
     // Check each possible rank
-    while(i > 1 && err_tol >= tmp_norm)
+    while(i > minrank && err_tol >= tmp_norm)
     {
         i--;
-        tmp_norm += S[i-1]*S[i-1];
+        if(i > 0)
+            tmp_norm += S[i-1]*S[i-1];
     }
     return i;
 }
@@ -20,7 +20,6 @@ void starsh_dense_kernel_starpu(void *buffer[], void *cl_arg)
     STARSH_blrf *F;
     starpu_codelet_unpack_args(cl_arg, &F);
     STARSH_problem *P = F->problem;
-    STARSH_kernel *kernel = P->kernel;
     // Shortcuts to information about clusters
     STARSH_cluster *RC = F->row_cluster, *CC = F->col_cluster;
     void *RD = RC->data, *CD = CC->data;
@@ -30,7 +29,8 @@ void starsh_dense_kernel_starpu(void *buffer[], void *cl_arg)
     STARSH_int nrows = RC->size[i];
     STARSH_int ncols = CC->size[j];
     double *D = (double *)STARPU_VECTOR_GET_PTR(buffer[1]);
-    kernel(nrows, ncols, RC->pivot+RC->start[i], CC->pivot+CC->start[j],
-            RD, CD, D, nrows);
+    // Diagonal tiles of symmetric problems are computed by lower triangle
+    starsh_problem_kernel(P, nrows, ncols, RC->pivot+RC->start[i],
+            CC->pivot+CC->start[j], RD, CD, D, nrows);
 }
 
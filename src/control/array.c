@@ -10,8 +10,15 @@
  * @date 2017-11-07
  * */
 
+// Required for mmap() in strict C99 mode
+#define _POSIX_C_SOURCE 200809L
+
 #include "common.h"
 #include "starsh.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 int array_from_buffer(Array **A, int ndim, int *shape,
         char dtype, char order, void *data)
@@ -72,6 +79,7 @@ int array_from_buffer(Array **A, int ndim, int *shape,
         A2->nbytes = 0;
         A2->data_nbytes = sizeof(*A2);
         A2->data = data;
+        A2->mapped = 0;
         return STARSH_SUCCESS;
     }
     int i;
@@ -113,6 +121,7 @@ int array_from_buffer(Array **A, int ndim, int *shape,
     A2->nbytes = A2->data_nbytes+ndim*(sizeof(*newshape)+sizeof(*stride))+
             sizeof(*A2);
     A2->data = data;
+    A2->mapped = 0;
     return STARSH_SUCCESS;
 }
 
@@ -173,6 +182,7 @@ int array_new_like(Array **A, Array *B)
     A2->dtype_size = B->dtype_size;
     A2->nbytes = B->nbytes;
     A2->data_nbytes = B->data_nbytes;
+    A2->mapped = 0;
     STARSH_MALLOC(A2->data, B->data_nbytes);
     return STARSH_SUCCESS;
 }
@@ -245,13 +255,78 @@ int array_new_copy(Array **A, Array *B, char order)
     return STARSH_SUCCESS;
 }
 
+int array_from_file(Array **A, int ndim, int *shape, char dtype, char order,
+        const char *filename)
+//! Init @ref ::array object, mapped from a binary file.
+/*! File is mapped into memory in read-only mode, so that data is loaded by
+ * operating system only when it is accessed. This allows matrices, larger
+ * than memory, to be compressed with starsh_problem_from_array(). File must
+ * contain raw elements of array in a given order without any header. Writing
+ * into such an array leads to segmentation fault. Mapping is released by
+ * array_free().
+ *
+ * @param[out] A: Address of pointer to @ref ::array object.
+ * @param[in] ndim: Number of dimensions of array, `ndim > 1`.
+ * @param[in] shape: Size of array in each dimension.
+ * @param[in] dtype: Precision of array element.
+ * @param[in] order: Fortran (column-major) or C (row-major) order.
+ * @param[in] filename: Path to binary file.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup array
+ * */
+{
+    if(filename == NULL)
+    {
+        STARSH_ERROR("Invalid value of `filename`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    int info = array_from_buffer(A, ndim, shape, dtype, order, NULL);
+    if(info != 0)
+        return info;
+    Array *A2 = *A;
+    int fd = open(filename, O_RDONLY);
+    if(fd == -1)
+    {
+        STARSH_ERROR("Failed to open file `%s`", filename);
+        array_free(A2);
+        return STARSH_FILE_NOT_EXIST;
+    }
+    struct stat st;
+    if(fstat(fd, &st) == -1 || (size_t)st.st_size < A2->data_nbytes)
+    {
+        STARSH_ERROR("File `%s` is smaller than array", filename);
+        close(fd);
+        array_free(A2);
+        return STARSH_FILE_WRONG_INPUT;
+    }
+    if(A2->data_nbytes > 0)
+    {
+        void *data = mmap(NULL, A2->data_nbytes, PROT_READ, MAP_SHARED, fd,
+                0);
+        if(data == MAP_FAILED)
+        {
+            STARSH_ERROR("mmap() failed");
+            close(fd);
+            array_free(A2);
+            return STARSH_UNKNOWN_ERROR;
+        }
+        A2->data = data;
+        A2->mapped = 1;
+    }
+    // Mapping remains valid after file is closed
+    close(fd);
+    return STARSH_SUCCESS;
+}
+
 void array_free(Array *A)
 //! Free @ref ::array object.
 //! @ingroup array
 {
     if(A == NULL)
         return;
-    if(A->data != NULL)
+    if(A->mapped)
+        munmap(A->data, A->data_nbytes);
+    else if(A->data != NULL)
         free(A->data);
     if(A->shape != NULL)
         free(A->shape);
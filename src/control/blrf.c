@@ -288,21 +288,51 @@ int starsh_blrf_new_from_coo(STARSH_blrf **format, STARSH_problem *problem,
     return STARSH_SUCCESS;
 }
 
-int starsh_blrf_new_tlr(STARSH_blrf **format, STARSH_problem *problem,
-        char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster)
-//! TLR partitioning of problem with given plain clusters.
-/*! Uses non-hierarchical clusterization of rows and columns to generate plain
- * division of problem into admissible blocks.
- *
- * @param[out] format: Address of pointer to @ref STARSH_blrf object.
- * @param[in] problem: Pointer to @ref STARSH_problem object.
- * @param[in] symm: 'S' if format is symmetric and 'N' otherwise.
- * @param[in] row_cluster, col_cluster: pointers to @ref STARSH_cluster
- *      objects, corresponding to clusterization of rows and columns.
- * @return Error code @ref STARSH_ERRNO.
- * @sa starsh_blrf_new(), starsh_blrf_new_from_coo().
- * @ingroup blrf
+static int starsh_blrf_admissible(STARSH_cluster *R, STARSH_int i,
+        STARSH_cluster *C, STARSH_int j, double eta)
+//! Check if a block is admissible by bounding boxes of its clusters.
+/*! Block is admissible if diameter of the smaller bounding box does not
+ * exceed `eta` times distance between the boxes. Only admissible blocks
+ * are expected to be low-rank.
  * */
+{
+    int ndim = R->ndim, d;
+    double *lower_i = R->box+2*ndim*i, *upper_i = lower_i+ndim;
+    double *lower_j = C->box+2*ndim*j, *upper_j = lower_j+ndim;
+    double diam_i = 0., diam_j = 0., dist = 0.;
+    for(d = 0; d < ndim; d++)
+    {
+        double width_i = upper_i[d]-lower_i[d];
+        double width_j = upper_j[d]-lower_j[d];
+        double gap = lower_j[d]-upper_i[d];
+        if(lower_i[d]-upper_j[d] > gap)
+            gap = lower_i[d]-upper_j[d];
+        diam_i += width_i*width_i;
+        diam_j += width_j*width_j;
+        if(gap > 0.)
+            dist += gap*gap;
+    }
+    double diam = diam_i < diam_j ? diam_i : diam_j;
+    return dist > 0. && diam <= eta*eta*dist;
+}
+
+static double starsh_blrf__tlr_eta(STARSH_cluster *R, STARSH_cluster *C)
+//! Admissibility parameter of TLR partitioning without given `eta`.
+/*! If geometry of both clusters is set, only blocks with overlapping
+ * bounding boxes, including diagonal blocks, are inadmissible, which is
+ * admissibility with infinite `eta`. Otherwise, all blocks are admissible.
+ * */
+{
+    if(R == NULL || C == NULL || R->box == NULL || C->box == NULL ||
+            R->ndim != C->ndim)
+        return 0.;
+    return INFINITY;
+}
+
+static int starsh_blrf__new_tlr(STARSH_blrf **format,
+        STARSH_problem *problem, char symm, STARSH_cluster *row_cluster,
+        STARSH_cluster *col_cluster, double eta)
+//! TLR partitioning, that checks admissibility of blocks if `eta` > 0.
 {
     if(format == NULL)
     {
@@ -340,34 +370,183 @@ int starsh_blrf_new_tlr(STARSH_blrf **format, STARSH_problem *problem,
         return STARSH_WRONG_PARAMETER;
     }
     STARSH_int nbrows = row_cluster->nblocks, nbcols = col_cluster->nblocks;
-    STARSH_int i, j, *block_far;
-    STARSH_int k = 0, nblocks_far;
+    STARSH_int i, j, *block_far, *block_near = NULL;
+    STARSH_int k = 0, nblocks, nblocks_far, nblocks_near = 0;
     if(symm == 'N')
+        nblocks = nbrows*nbcols;
+    else
+        nblocks = nbrows*(nbrows+1)/2;
+    STARSH_MALLOC(block_far, 2*nblocks);
+    if(eta > 0.)
     {
-        nblocks_far = nbrows*nbcols;
-        STARSH_MALLOC(block_far, 2*nblocks_far);
-        for(i = 0; i < nbrows; i++)
-            for(j = 0; j < nbcols; j++)
-            {
-                block_far[2*k] = i;
-                block_far[2*k+1] = j;
-                k++;
-            }
+        block_near = malloc(2*nblocks*sizeof(*block_near));
+        if(block_near == NULL)
+        {
+            STARSH_ERROR("malloc() failed");
+            free(block_far);
+            return STARSH_MALLOC_ERROR;
+        }
     }
-    else
+    for(i = 0; i < nbrows; i++)
     {
-        nblocks_far = nbrows*(nbrows+1)/2;
-        STARSH_MALLOC(block_far, 2*nblocks_far);
-        for(i = 0; i < nbrows; i++)
-            for(j = 0; j <= i; j++)
+        STARSH_int jmax = symm == 'N' ? nbcols : i+1;
+        for(j = 0; j < jmax; j++)
+        {
+            if(eta > 0. && !starsh_blrf_admissible(row_cluster, i,
+                        col_cluster, j, eta))
+            {
+                block_near[2*nblocks_near] = i;
+                block_near[2*nblocks_near+1] = j;
+                nblocks_near++;
+            }
+            else
             {
                 block_far[2*k] = i;
                 block_far[2*k+1] = j;
                 k++;
             }
+        }
+    }
+    nblocks_far = k;
+    if(nblocks_far == 0)
+    {
+        free(block_far);
+        block_far = NULL;
     }
+    else if(nblocks_near > 0)
+        STARSH_REALLOC(block_far, 2*nblocks_far);
+    if(nblocks_near == 0)
+    {
+        free(block_near);
+        block_near = NULL;
+    }
+    else if(nblocks_far > 0)
+        STARSH_REALLOC(block_near, 2*nblocks_near);
     return starsh_blrf_new_from_coo(format, problem, symm, row_cluster,
-            col_cluster, nblocks_far, block_far, 0, NULL, STARSH_TLR);
+            col_cluster, nblocks_far, block_far, nblocks_near, block_near,
+            STARSH_TLR);
+}
+
+int starsh_blrf_new_tlr(STARSH_blrf **format, STARSH_problem *problem,
+        char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster)
+//! TLR partitioning of problem with given plain clusters.
+/*! Uses non-hierarchical clusterization of rows and columns to generate plain
+ * division of problem into admissible blocks. If geometry of both clusters
+ * is set by starsh_cluster_set_geometry(), diagonal blocks and blocks with
+ * overlapping bounding boxes of row and column clusters are near-field
+ * blocks, and all other blocks are far-field blocks. Otherwise, all blocks
+ * are far-field blocks.
+ *
+ * @param[out] format: Address of pointer to @ref STARSH_blrf object.
+ * @param[in] problem: Pointer to @ref STARSH_problem object.
+ * @param[in] symm: 'S' if format is symmetric and 'N' otherwise.
+ * @param[in] row_cluster, col_cluster: pointers to @ref STARSH_cluster
+ *      objects, corresponding to clusterization of rows and columns.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrf_new(), starsh_blrf_new_from_coo(),
+ *      starsh_blrf_new_tlr_eta().
+ * @ingroup blrf
+ * */
+{
+    return starsh_blrf__new_tlr(format, problem, symm, row_cluster,
+            col_cluster, starsh_blrf__tlr_eta(row_cluster, col_cluster));
+}
+
+int starsh_blrf_new_tlr_eta(STARSH_blrf **format, STARSH_problem *problem,
+        char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster,
+        double eta)
+//! TLR partitioning of problem with geometric admissibility of blocks.
+/*! Same as starsh_blrf_new_tlr(), but geometry of both clusters must be set
+ * by starsh_cluster_set_geometry(). Block is far-field only if diameter of
+ * the smaller of bounding boxes of its row and column clusters does not
+ * exceed `eta` times distance between the boxes. All other blocks, including
+ * diagonal and neighbouring ones, are near-field blocks, so they are not
+ * compressed only to be rejected by a low-rank engine. Larger `eta` gives
+ * more far-field blocks, and `eta=2` is a common choice.
+ *
+ * @param[out] format: Address of pointer to @ref STARSH_blrf object.
+ * @param[in] problem: Pointer to @ref STARSH_problem object.
+ * @param[in] symm: 'S' if format is symmetric and 'N' otherwise.
+ * @param[in] row_cluster, col_cluster: pointers to @ref STARSH_cluster
+ *      objects, corresponding to clusterization of rows and columns.
+ * @param[in] eta: Admissibility parameter.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrf_new_tlr(), starsh_cluster_set_geometry().
+ * @ingroup blrf
+ * */
+{
+    if(row_cluster == NULL || row_cluster->box == NULL)
+    {
+        STARSH_ERROR("Geometry of `row_cluster` is not set");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(col_cluster == NULL || col_cluster->box == NULL ||
+            col_cluster->ndim != row_cluster->ndim)
+    {
+        STARSH_ERROR("Geometry of `col_cluster` is not set or does not match "
+                "geometry of `row_cluster`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(eta <= 0.)
+    {
+        STARSH_ERROR("Invalid value of `eta`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    return starsh_blrf__new_tlr(format, problem, symm, row_cluster,
+            col_cluster, eta);
+}
+
+int starsh_blrf__bcol_list(STARSH_int nbcols, STARSH_int nblocks,
+        STARSH_int *block, STARSH_int **bcol_start, STARSH_int **bcol)
+//! Build lists of blocks of each block column out of list of blocks.
+/*! Lists `bcol_far` and `bcol_near` of symmetric @ref STARSH_blrf are
+ * aliases of `brow_far` and `brow_near`, since only lower triangle is stored.
+ * This function returns the actual stored blocks of each block column, so
+ * that transposed blocks of block rows can be found. Both output arrays are
+ * allocated and have to be freed by user.
+ *
+ * @param[in] nbcols: Number of block columns.
+ * @param[in] nblocks: Number of blocks.
+ * @param[in] block: Pairs of block row and block column of each block.
+ * @param[out] bcol_start: Start of list of each block column in `bcol`.
+ * @param[out] bcol: List of blocks of each block column.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrf
+ * */
+{
+    STARSH_int *start, *list, *size, bi, j;
+    STARSH_MALLOC(start, nbcols+1);
+    // Keep buffers from being of zero size
+    list = malloc(sizeof(*list)*(nblocks+1));
+    size = malloc(sizeof(*size)*(nbcols+1));
+    if(list == NULL || size == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        free(start);
+        free(list);
+        free(size);
+        return STARSH_MALLOC_ERROR;
+    }
+    for(j = 0; j < nbcols; j++)
+        size[j] = 0;
+    for(bi = 0; bi < nblocks; bi++)
+        size[block[2*bi+1]]++;
+    start[0] = 0;
+    for(j = 0; j < nbcols; j++)
+    {
+        start[j+1] = start[j]+size[j];
+        size[j] = 0;
+    }
+    for(bi = 0; bi < nblocks; bi++)
+    {
+        j = block[2*bi+1];
+        list[start[j]+size[j]] = bi;
+        size[j]++;
+    }
+    free(size);
+    *bcol_start = start;
+    *bcol = list;
+    return STARSH_SUCCESS;
 }
 
 void starsh_blrf_free(STARSH_blrf *format)
@@ -512,7 +691,8 @@ int starsh_blrf_get_block(STARSH_blrf *format, STARSH_int i, STARSH_int j,
     STARSH_problem *P = format->problem;
     if(P->ndim != 2)
     {
-        STARSH_ERROR("Only scalar kernels are supported");
+        STARSH_ERROR("Only scalar kernels are supported, use "
+                "starsh_problem_from_tensor()");
         return STARSH_WRONG_PARAMETER;
     }
     STARSH_cluster *R = format->row_cluster, *C = format->col_cluster;
@@ -520,11 +700,162 @@ int starsh_blrf_get_block(STARSH_blrf *format, STARSH_int i, STARSH_int j,
     shape[0] = nrows;
     shape[1] = ncols;
     STARSH_MALLOC(*D, P->entry_size*(size_t)nrows*(size_t)ncols);
-    P->kernel(nrows, ncols, R->pivot+R->start[i], C->pivot+C->start[j],
-            P->row_data, P->col_data, *D, nrows);
+    starsh_problem_kernel(P, nrows, ncols, R->pivot+R->start[i],
+            C->pivot+C->start[j], P->row_data, P->col_data, *D, nrows);
     return info;
 }
 
+static double starsh_blrf__dblock_sqrnorm(STARSH_blrf *F, STARSH_int i,
+        STARSH_int j, int nsamples, double *buf)
+//! Estimate squared Frobenius norm of a block by uniform sampling.
+/*! Diagonal elements are usually the largest ones, so diagonal blocks are
+ * computed exactly by a single call to the kernel. Size of `buf` must be
+ * enough for a diagonal block.
+ * */
+{
+    STARSH_problem *P = F->problem;
+    STARSH_cluster *R = F->row_cluster, *C = F->col_cluster;
+    STARSH_int nrows = R->size[i], ncols = C->size[j];
+    STARSH_int *irow = R->pivot+R->start[i], *icol = C->pivot+C->start[j];
+    STARSH_int srow[nsamples], scol[nsamples];
+    int s = nrows < nsamples ? nrows : nsamples;
+    int t = ncols < nsamples ? ncols : nsamples;
+    int k, l;
+    double norm = 0.;
+    if(R == C && i == j)
+    {
+        starsh_problem_kernel(P, nrows, ncols, irow, icol, P->row_data,
+                P->col_data, buf, nrows);
+        norm = cblas_dnrm2((size_t)nrows*ncols, buf, 1);
+        return norm*norm;
+    }
+    for(k = 0; k < s; k++)
+        srow[k] = irow[(k*nrows)/s];
+    for(l = 0; l < t; l++)
+        scol[l] = icol[((2*l+1)*ncols)/(2*t)];
+    P->kernel(s, t, srow, scol, P->row_data, P->col_data, buf, s);
+    for(l = 0; l < t; l++)
+        for(k = 0; k < s; k++)
+            norm += buf[l*s+k]*buf[l*s+k];
+    return norm*((double)nrows*(double)ncols)/((double)s*t);
+}
+
+int starsh_blrf_dnorm_estimate(STARSH_blrf *format, int nsamples,
+        double *norm)
+//! Cheap estimation of Frobenius norm of a double precision matrix.
+/*! Each admissible block is sampled on a `nsamples` by `nsamples` grid of its
+ * rows and columns. Diagonal blocks are computed exactly. Result
+ * is the same on all MPI processes, since global lists of blocks are used.
+ *
+ * @param[in] format: Pointer to @ref STARSH_blrf object.
+ * @param[in] nsamples: Number of sampled rows and columns of each block.
+ * @param[out] norm: Estimated Frobenius norm.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrf
+ * */
+{
+    if(format == NULL)
+    {
+        STARSH_ERROR("Invalid value of `format`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(nsamples <= 0)
+    {
+        STARSH_ERROR("Invalid value of `nsamples`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(norm == NULL)
+    {
+        STARSH_ERROR("Invalid value of `norm`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = format;
+    if(F->problem->dtype != 'd' || F->problem->ndim != 2)
+    {
+        STARSH_ERROR("Only scalar double precision kernels are supported");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_int bi;
+    double *buf, result = 0.;
+    size_t lbuf = (size_t)nsamples*(size_t)nsamples;
+    // Buffer must be big enough for any diagonal block
+    if(F->row_cluster == F->col_cluster)
+        for(bi = 0; bi < F->nbrows; bi++)
+        {
+            size_t size = (size_t)F->row_cluster->size[bi]*
+                (size_t)F->row_cluster->size[bi];
+            if(size > lbuf)
+                lbuf = size;
+        }
+    STARSH_MALLOC(buf, lbuf);
+    for(bi = 0; bi < F->nblocks_far; bi++)
+    {
+        STARSH_int i = F->block_far[2*bi], j = F->block_far[2*bi+1];
+        double tmp = starsh_blrf__dblock_sqrnorm(F, i, j, nsamples, buf);
+        // Symmetric matrix stores only one block of each symmetric pair
+        if(F->symm == 'S' && i != j)
+            tmp *= 2;
+        result += tmp;
+    }
+    for(bi = 0; bi < F->nblocks_near; bi++)
+    {
+        STARSH_int i = F->block_near[2*bi], j = F->block_near[2*bi+1];
+        double tmp = starsh_blrf__dblock_sqrnorm(F, i, j, nsamples, buf);
+        if(F->symm == 'S' && i != j)
+            tmp *= 2;
+        result += tmp;
+    }
+    free(buf);
+    *norm = sqrt(result);
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrf_dtol_norm(STARSH_blrf *format, double *norm)
+//! Norm of a double precision matrix, required by selected tolerance mode.
+/*! In @ref STARSH_TOLMODE_GLOBAL mode Frobenius norm of the whole matrix is
+ * estimated by starsh_blrf_dnorm_estimate() with 16 samples per block, and
+ * in other modes norm is not needed and is set to zero. Approximation
+ * routines call it before any allocation, so nothing has to be freed if it
+ * fails.
+ *
+ * @param[in] format: Pointer to @ref STARSH_blrf object.
+ * @param[out] norm: Norm to be passed to starsh_blrf_dtile_tol().
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrf
+ * */
+{
+    *norm = 0.;
+    if(starsh_params.tolmode != STARSH_TOLMODE_GLOBAL)
+        return STARSH_SUCCESS;
+    return starsh_blrf_dnorm_estimate(format, 16, norm);
+}
+
+double starsh_blrf_dtile_tol(STARSH_blrf *format, double norm, double tol,
+        STARSH_int i, STARSH_int j)
+//! Error tolerance of a tile, corresponding to selected tolerance mode.
+/*! In @ref STARSH_TOLMODE_TILE mode `tol` is returned as is. In @ref
+ * STARSH_TOLMODE_GLOBAL mode squared absolute error `tol*tol*norm*norm` is
+ * distributed among tiles proportionally to their sizes, and absolute error
+ * of a tile is returned with minus sign, as starsh_dense_dsvfr() expects.
+ *
+ * @param[in] format: Pointer to @ref STARSH_blrf object.
+ * @param[in] norm: Estimated Frobenius norm of the whole matrix.
+ * @param[in] tol: Relative error tolerance.
+ * @param[in] i, j: Indexes of row and column clusters.
+ * @return Error tolerance for starsh_dense_dsvfr().
+ * @sa starsh_blrf_dnorm_estimate().
+ * @ingroup blrf
+ * */
+{
+    if(starsh_params.tolmode != STARSH_TOLMODE_GLOBAL)
+        return tol;
+    STARSH_problem *P = format->problem;
+    double size = (double)format->row_cluster->size[i]*
+        (double)format->col_cluster->size[j];
+    double total = (double)P->shape[0]*(double)P->shape[P->ndim-1];
+    return -tol*norm*sqrt(size/total);
+}
+
 #ifdef MPI
 int starsh_blrf_new_from_coo_mpi(STARSH_blrf **format, STARSH_problem *problem,
         char symm, STARSH_cluster *row_cluster, STARSH_cluster *col_cluster,
@@ -579,7 +910,9 @@ int starsh_blrf_new_tlr_mpi(STARSH_blrf **format, STARSH_problem *problem,
 //! TLR partitioning on MPI nodes with 2D block cycling distribution.
 /*! Uses non-hierarchical clusterization of rows and columns to generate plain
  * division of problem into admissible far-field and near-field blocks, placed
- * over MPI nodes by 2D block cycling distribution.
+ * over MPI nodes by 2D block cycling distribution. Blocks are classified as
+ * in starsh_blrf_new_tlr(): if geometry of both clusters is set, diagonal
+ * blocks and blocks with overlapping bounding boxes are near-field blocks.
  *
  * @param[out] format: Address of pointer to @ref STARSH_blrf object.
  * @param[in] problem: Pointer to @ref STARSH_problem object.
@@ -627,9 +960,11 @@ int starsh_blrf_new_tlr_mpi(STARSH_blrf **format, STARSH_problem *problem,
         return STARSH_WRONG_PARAMETER;
     }
     STARSH_int nbrows = row_cluster->nblocks, nbcols = col_cluster->nblocks;
-    STARSH_int i, j, *block_far;
-    STARSH_int k = 0, nblocks_far, nblocks_far_local, li = 0;
-    STARSH_int *block_far_local;
+    STARSH_int i, j, *block_far, *block_near = NULL;
+    STARSH_int k = 0, nblocks, nblocks_far, nblocks_near = 0;
+    STARSH_int nblocks_local, nblocks_far_local = 0, nblocks_near_local = 0;
+    STARSH_int *block_far_local, *block_near_local = NULL;
+    double eta = starsh_blrf__tlr_eta(row_cluster, col_cluster);
     int mpi_rank, mpi_size;
     MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
@@ -640,67 +975,93 @@ int starsh_blrf_new_tlr_mpi(STARSH_blrf **format, STARSH_problem *problem,
     grid_x = mpi_rank % grid_nx;
     grid_y = mpi_rank / grid_nx;
     //STARSH_WARNING("MPI GRID=%d x %d, MPI RANK=%d, MPI COORD=(%d, %d)", grid_nx, grid_ny, mpi_rank, grid_x, grid_y);
+    // Number of all blocks and number of blocks, stored locally
     if(symm == 'N')
     {
-        nblocks_far = nbrows*nbcols;
-        STARSH_MALLOC(block_far, 2*nblocks_far);
-        //nblocks_far_local = (nblocks_far+mpi_size-1-mpi_rank)/mpi_size;
-        nblocks_far_local = ((nbrows+grid_nx-1-grid_x)/grid_nx)*
+        nblocks = nbrows*nbcols;
+        nblocks_local = ((nbrows+grid_nx-1-grid_x)/grid_nx)*
                 ((nbcols+grid_ny-1-grid_y)/grid_ny);
-        STARSH_MALLOC(block_far_local, nblocks_far_local);
-        for(i = 0; i < nbrows; i++)
-            for(j = 0; j < nbcols; j++)
-            {
-                block_far[2*k] = i;
-                block_far[2*k+1] = j;
-                if(i % grid_nx == grid_x && j % grid_ny == grid_y)
-                //if(k % mpi_size == mpi_rank)
-                {
-                    block_far_local[li] = k;
-                    li++;
-                }
-                k++;
-            }
-        if(li != nblocks_far_local)
-            STARSH_ERROR("WRONG COUNT FOR LOCAL BLOCKS");
     }
     else
     {
-        nblocks_far = nbrows*(nbrows+1)/2;
-        STARSH_MALLOC(block_far, 2*nblocks_far);
-        nblocks_far_local = (nbrows+grid_nx-1-grid_x)/grid_nx-1;
-        nblocks_far_local = nblocks_far_local*(nblocks_far_local+1)/2;
+        nblocks = nbrows*(nbrows+1)/2;
+        nblocks_local = (nbrows+grid_nx-1-grid_x)/grid_nx-1;
+        nblocks_local = nblocks_local*(nblocks_local+1)/2;
         if(grid_x >= grid_y)
         {
-            nblocks_far_local += nbrows/grid_nx;
+            nblocks_local += nbrows/grid_nx;
             if(nbrows % grid_nx > grid_x && nbcols % grid_ny > grid_y)
-                nblocks_far_local += 1;
+                nblocks_local += 1;
         }
-        //nblocks_far_local = (nblocks_far+mpi_size-1-mpi_rank)/mpi_size;
-        //STARSH_WARNING("(%d, %d): LOCAL BLOCKS=%zu", grid_x, grid_y, nblocks_far_local);
-        STARSH_MALLOC(block_far_local, nblocks_far_local);
-        for(i = 0; i < nbrows; i++)
-            for(j = 0; j <= i; j++)
+    }
+    //STARSH_WARNING("(%d, %d): LOCAL BLOCKS=%zu", grid_x, grid_y, nblocks_local);
+    STARSH_MALLOC(block_far, 2*nblocks);
+    STARSH_MALLOC(block_far_local, nblocks_local);
+    if(eta > 0.)
+    {
+        block_near = malloc(2*nblocks*sizeof(*block_near));
+        block_near_local = malloc(nblocks_local*sizeof(*block_near_local));
+        if(block_near == NULL || block_near_local == NULL)
+        {
+            STARSH_ERROR("malloc() failed");
+            free(block_far);
+            free(block_far_local);
+            free(block_near);
+            free(block_near_local);
+            return STARSH_MALLOC_ERROR;
+        }
+    }
+    for(i = 0; i < nbrows; i++)
+    {
+        STARSH_int jmax = symm == 'N' ? nbcols : i+1;
+        for(j = 0; j < jmax; j++)
+        {
+            int local = i % grid_nx == grid_x && j % grid_ny == grid_y;
+            if(eta > 0. && !starsh_blrf_admissible(row_cluster, i,
+                        col_cluster, j, eta))
+            {
+                block_near[2*nblocks_near] = i;
+                block_near[2*nblocks_near+1] = j;
+                if(local)
+                    block_near_local[nblocks_near_local++] = nblocks_near;
+                nblocks_near++;
+            }
+            else
             {
                 block_far[2*k] = i;
                 block_far[2*k+1] = j;
-                if(i % grid_nx == grid_x && j % grid_ny == grid_y)
-                //if(k % mpi_size == mpi_rank)
-                {
-                    block_far_local[li] = k;
-                    li++;
-                    if(li > nblocks_far_local)
-                    {
-                        STARSH_ERROR("WRONG COUNG FOR LOCAL BLOCKS 2");
-                    }
-                }
+                if(local)
+                    block_far_local[nblocks_far_local++] = k;
                 k++;
             }
-        if(li != nblocks_far_local)
-            STARSH_ERROR("WRONG COUNT FOR LOCAL BLOCKS");
+        }
+    }
+    if(nblocks_far_local+nblocks_near_local != nblocks_local)
+        STARSH_ERROR("WRONG COUNT FOR LOCAL BLOCKS");
+    nblocks_far = k;
+    if(nblocks_far == 0)
+    {
+        free(block_far);
+        block_far = NULL;
+    }
+    if(nblocks_far_local == 0)
+    {
+        free(block_far_local);
+        block_far_local = NULL;
+    }
+    if(nblocks_near == 0)
+    {
+        free(block_near);
+        block_near = NULL;
+    }
+    if(nblocks_near_local == 0)
+    {
+        free(block_near_local);
+        block_near_local = NULL;
     }
     return starsh_blrf_new_from_coo_mpi(format, problem, symm, row_cluster,
             col_cluster, nblocks_far, block_far, nblocks_far_local,
-            block_far_local, 0, NULL, 0, NULL, STARSH_TLR);
+            block_far_local, nblocks_near, block_near, nblocks_near_local,
+            block_near_local, STARSH_TLR);
 }
 #endif // MPI
@@ -30,7 +30,7 @@ int starsh_blrm_new(STARSH_blrm **matrix, STARSH_blrf *format, int *far_rank,
  * @param[in] alloc_V: Pointer to big buffer for all `far_V`.
  * @param[in] alloc_D: Pointer to big buffer for all `near_D`.
  * @param[in] alloc_type: Type of memory allocation. `1` if big buffers
- *     are used.
+ *     are used, `3` if big buffers are used only for far-field blocks.
  * @return Error code @ref STARSH_ERRNO.
  * @ingroup blrm
  * */
@@ -71,17 +71,17 @@ int starsh_blrm_new(STARSH_blrm **matrix, STARSH_blrf *format, int *far_rank,
         STARSH_ERROR("Invalid value of `near_D`");
         return STARSH_WRONG_PARAMETER;
     }
-    if(alloc_type != '1' && alloc_type != '2')
+    if(alloc_type != '1' && alloc_type != '2' && alloc_type != '3')
     {
         STARSH_ERROR("Invalid value of `alloc_type`");
         return STARSH_WRONG_PARAMETER;
     }
-    if(alloc_U == NULL && F->nblocks_far > 0 && alloc_type == '1')
+    if(alloc_U == NULL && F->nblocks_far > 0 && alloc_type != '2')
     {
         STARSH_ERROR("Invalid value of `alloc_U`");
         return STARSH_WRONG_PARAMETER;
     }
-    if(alloc_V == NULL && F->nblocks_far > 0 && alloc_type == '1')
+    if(alloc_V == NULL && F->nblocks_far > 0 && alloc_type != '2')
     {
         STARSH_ERROR("Invalid value of `alloc_V`");
         return STARSH_WRONG_PARAMETER;
@@ -99,12 +99,15 @@ int starsh_blrm_new(STARSH_blrm **matrix, STARSH_blrf *format, int *far_rank,
     M->far_rank = far_rank;
     M->far_U = far_U;
     M->far_V = far_V;
+    M->far_skel = NULL;
     M->onfly = onfly;
     M->near_D = near_D;
     M->alloc_U = alloc_U;
     M->alloc_V = alloc_V;
+    M->alloc_skel = NULL;
     M->alloc_D = alloc_D;
     M->alloc_type = alloc_type;
+    M->far_engine = NULL;
     STARSH_int bi, data_size = 0, size = 0;
     size += sizeof(*M);
     size += F->nblocks_far*(sizeof(*far_rank)+sizeof(*far_U)+sizeof(*far_V));
@@ -127,6 +130,130 @@ int starsh_blrm_new(STARSH_blrm **matrix, STARSH_blrf *format, int *far_rank,
     return STARSH_SUCCESS;
 }
 
+int starsh_blrm_new_skel(STARSH_blrm **matrix, STARSH_blrf *format,
+        int *far_rank, Array **far_U, int **far_skel, int onfly,
+        Array **near_D, void *alloc_U, void *alloc_skel, void *alloc_D,
+        char alloc_type)
+//! Init @ref STARSH_blrm object, that keeps skeleton rows instead of `far_V`.
+/*! Each far-field block is approximated by its interpolative decomposition
+ * `far_U[i]*A(far_skel[i],:)`, where `A` is the far-field block itself. Rows
+ * of `A` are computed on demand by the kernel, so only `far_rank[i]` indexes
+ * are stored instead of low-rank factor `far_V[i]`.
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
+ * @param[in] format: Pointer to @ref STARSH_blrf object.
+ * @param[in] far_rank: Array of ranks of far-field blocks.
+ * @param[in] far_U: Array of interpolation matrices `U`.
+ * @param[in] far_skel: Array of skeleton rows of far-field blocks.
+ * @param[in] onfly: Whether not to store dense blocks.
+ * @param[in] near_D: Array of dense near-field blocks.
+ * @param[in] alloc_U: Pointer to big buffer for all `far_U`.
+ * @param[in] alloc_skel: Pointer to big buffer for all `far_skel`.
+ * @param[in] alloc_D: Pointer to big buffer for all `near_D`.
+ * @param[in] alloc_type: Type of memory allocation. `1` if big buffers
+ *     are used, `3` if big buffers are used only for far-field blocks.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrm_new(), starsh_blrm__dget_far_V().
+ * @ingroup blrm
+ * */
+{
+    if(matrix == NULL)
+    {
+        STARSH_ERROR("Invalid value of `matrix`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(format == NULL)
+    {
+        STARSH_ERROR("Invalid value of `format`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = format;
+    if(far_rank == NULL && F->nblocks_far > 0)
+    {
+        STARSH_ERROR("Invalid value of `far_rank`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(far_U == NULL && F->nblocks_far > 0)
+    {
+        STARSH_ERROR("Invalid value of `far_U`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(far_skel == NULL && F->nblocks_far > 0)
+    {
+        STARSH_ERROR("Invalid value of `far_skel`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(onfly != 0 && onfly != 1)
+    {
+        STARSH_ERROR("Invalid value of `onfly`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(near_D == NULL && F->nblocks_near > 0 && onfly == 0)
+    {
+        STARSH_ERROR("Invalid value of `near_D`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(alloc_type != '1' && alloc_type != '2' && alloc_type != '3')
+    {
+        STARSH_ERROR("Invalid value of `alloc_type`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(alloc_U == NULL && F->nblocks_far > 0 && alloc_type != '2')
+    {
+        STARSH_ERROR("Invalid value of `alloc_U`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(alloc_skel == NULL && F->nblocks_far > 0 && alloc_type != '2')
+    {
+        STARSH_ERROR("Invalid value of `alloc_skel`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(alloc_D == NULL && F->nblocks_near > 0 && alloc_type == '1' &&
+            onfly == 0)
+    {
+        STARSH_ERROR("Invalid value of `alloc_D`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrm *M;
+    STARSH_MALLOC(M, 1);
+    *matrix = M;
+    M->format = F;
+    M->far_rank = far_rank;
+    M->far_U = far_U;
+    M->far_V = NULL;
+    M->far_skel = far_skel;
+    M->onfly = onfly;
+    M->near_D = near_D;
+    M->alloc_U = alloc_U;
+    M->alloc_V = NULL;
+    M->alloc_skel = alloc_skel;
+    M->alloc_D = alloc_D;
+    M->alloc_type = alloc_type;
+    M->far_engine = NULL;
+    STARSH_int bi, data_size = 0, size = 0;
+    size += sizeof(*M);
+    size += F->nblocks_far*(sizeof(*far_rank)+sizeof(*far_U)+
+            sizeof(*far_skel));
+    for(bi = 0; bi < F->nblocks_far; bi++)
+    {
+        size += far_U[bi]->nbytes+far_rank[bi]*sizeof(*far_skel[bi]);
+        data_size += far_U[bi]->data_nbytes+
+            far_rank[bi]*sizeof(*far_skel[bi]);
+    }
+    if(onfly == 0)
+    {
+        size += F->nblocks_near*sizeof(*near_D);
+        for(bi = 0; bi < F->nblocks_near; bi++)
+        {
+            size += near_D[bi]->nbytes;
+            data_size += near_D[bi]->data_nbytes;
+        }
+    }
+    M->nbytes = size;
+    M->data_nbytes = data_size;
+    return STARSH_SUCCESS;
+}
+
 void starsh_blrm_free(STARSH_blrm *matrix)
 //! Free memory of a non-nested block low-rank matrix.
 //! @ingroup blrm
@@ -139,29 +266,57 @@ void starsh_blrm_free(STARSH_blrm *matrix)
     int info;
     if(F->nblocks_far > 0)
     {
-        if(M->alloc_type == '1')
+        if(M->far_skel != NULL)
         {
-            free(M->alloc_U);
-            free(M->alloc_V);
-            for(bi = 0; bi < F->nblocks_far; bi++)
+            // Only interpolation matrices and skeleton rows are stored
+            if(M->alloc_type != '2')
+            {
+                free(M->alloc_U);
+                free(M->alloc_skel);
+                for(bi = 0; bi < F->nblocks_far; bi++)
+                {
+                    M->far_U[bi]->data = NULL;
+                    array_free(M->far_U[bi]);
+                }
+            }
+            else// M->alloc_type == '2'
             {
-                M->far_U[bi]->data = NULL;
-                array_free(M->far_U[bi]);
-                M->far_V[bi]->data = NULL;
-                array_free(M->far_V[bi]);
+                for(bi = 0; bi < F->nblocks_far; bi++)
+                {
+                    array_free(M->far_U[bi]);
+                    free(M->far_skel[bi]);
+                }
             }
+            free(M->far_rank);
+            free(M->far_U);
+            free(M->far_skel);
         }
-        else// M->alloc_type == '2'
+        else
         {
-            for(bi = 0; bi < F->nblocks_far; bi++)
+            if(M->alloc_type != '2')
             {
-                array_free(M->far_U[bi]);
-                array_free(M->far_V[bi]);
+                free(M->alloc_U);
+                free(M->alloc_V);
+                for(bi = 0; bi < F->nblocks_far; bi++)
+                {
+                    M->far_U[bi]->data = NULL;
+                    array_free(M->far_U[bi]);
+                    M->far_V[bi]->data = NULL;
+                    array_free(M->far_V[bi]);
+                }
             }
+            else// M->alloc_type == '2'
+            {
+                for(bi = 0; bi < F->nblocks_far; bi++)
+                {
+                    array_free(M->far_U[bi]);
+                    array_free(M->far_V[bi]);
+                }
+            }
+            free(M->far_rank);
+            free(M->far_U);
+            free(M->far_V);
         }
-        free(M->far_rank);
-        free(M->far_U);
-        free(M->far_V);
     }
     if(F->nblocks_near > 0 && M->onfly == 0)
     {
@@ -174,7 +329,7 @@ void starsh_blrm_free(STARSH_blrm *matrix)
                 array_free(M->near_D[bi]);
             }
         }
-        else// M->alloc_type == '2'
+        else// M->alloc_type == '2' or M->alloc_type == '3'
         {
             for(bi = 0; bi < F->nblocks_near; bi++)
             {
@@ -183,6 +338,7 @@ void starsh_blrm_free(STARSH_blrm *matrix)
         }
         free(M->near_D);
     }
+    free(M->far_engine);
     free(M);
 }
 
@@ -195,13 +351,31 @@ void starsh_blrm_info(STARSH_blrm *matrix)
         return;
     printf("<STARSH_blrm at %p, %d onfly, allocation type '%c', %f MB memory "
             "footprint>\n", M, M->onfly, M->alloc_type, M->nbytes/1024./1024.);
+    if(M->far_engine != NULL)
+    {
+        // Number of far-field blocks, approximated by each low-rank engine
+        STARSH_int bi, nsdd = 0, nrsdd = 0, naca = 0;
+        for(bi = 0; bi < M->format->nblocks_far; bi++)
+        {
+            if(M->far_engine[bi] == STARSH_LRENGINE_DCSVD)
+                nsdd++;
+            else if(M->far_engine[bi] == STARSH_LRENGINE_RSVD)
+                nrsdd++;
+            else if(M->far_engine[bi] == STARSH_LRENGINE_CROSS)
+                naca++;
+        }
+        printf("Far-field blocks approximated by DCSVD: %zd, RSVD: %zd, "
+                "CROSS: %zd\n", nsdd, nrsdd, naca);
+    }
 }
 
 int starsh_blrm_get_block(STARSH_blrm *matrix, STARSH_int i, STARSH_int j,
         int *shape, int *rank, void **U, void **V, void **D)
 //! Get shape, rank and low-rank factors or dense representation of a block.
 /*! If block is admissible and low-rank, then its low-rank factors are returned
- * and `D` is NULL (since dense block is not stored). If block is admissible
+ * and `D` is NULL (since dense block is not stored). If matrix keeps skeleton
+ * rows instead of factors `V`, then `V` is computed and user have to free it
+ * after usage. If block is admissible
  * and not low-rank, then its dense version is returned and `U` and `V` are
  * NULL. If block is NOT admissible, then it is computed and returned as dense.
  *
@@ -262,7 +436,8 @@ int starsh_blrm_get_block(STARSH_blrm *matrix, STARSH_int i, STARSH_int j,
     STARSH_problem *P = F->problem;
     if(P->ndim != 2)
     {
-        STARSH_ERROR("Only scalar kernels are supported");
+        STARSH_ERROR("Only scalar kernels are supported, use "
+                "starsh_problem_from_tensor()");
         return STARSH_WRONG_PARAMETER;
     }
     int onfly = M->onfly;
@@ -291,7 +466,15 @@ int starsh_blrm_get_block(STARSH_blrm *matrix, STARSH_int i, STARSH_int j,
         {
             *rank = M->far_rank[bi];
             *U = M->far_U[bi]->data;
-            *V = M->far_V[bi]->data;
+            if(M->far_skel == NULL)
+                *V = M->far_V[bi]->data;
+            else
+            {
+                double *tmp_V;
+                STARSH_MALLOC(tmp_V, (size_t)ncols*(size_t)(*rank));
+                info = starsh_blrm__dget_far_V(M, bi, tmp_V);
+                *V = tmp_V;
+            }
             return info;
         }
     }
@@ -321,6 +504,50 @@ int starsh_blrm_get_block(STARSH_blrm *matrix, STARSH_int i, STARSH_int j,
     return info;
 }
 
+int starsh_blrm__dget_far_V(STARSH_blrm *matrix, STARSH_int bi, double *V)
+//! Get low-rank factor `V` of a far-field block.
+/*! If factor `V` is stored, it is simply copied. Otherwise it is computed as
+ * transposed skeleton rows of a far-field block. Leading dimension of `V` is
+ * equal to number of columns of corresponding block.
+ *
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] bi: Index of far-field block.
+ * @param[out] V: Low-rank factor `V` of size `ncols` by `far_rank[bi]`.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrm_new_skel().
+ * @ingroup blrm
+ * */
+{
+    STARSH_blrm *M = matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_problem *P = F->problem;
+    STARSH_cluster *R = F->row_cluster, *C = F->col_cluster;
+    STARSH_int i = F->block_far[2*bi];
+    STARSH_int j = F->block_far[2*bi+1];
+    int ncols = C->size[j], rank = M->far_rank[bi];
+    if(M->far_skel == NULL)
+    {
+        cblas_dcopy(ncols*rank, M->far_V[bi]->data, 1, V, 1);
+        return STARSH_SUCCESS;
+    }
+    if(rank == 0)
+        return STARSH_SUCCESS;
+    STARSH_int *irow;
+    double *D;
+    STARSH_MALLOC(irow, rank);
+    STARSH_MALLOC(D, (size_t)rank*(size_t)ncols);
+    for(int k = 0; k < rank; k++)
+        irow[k] = R->pivot[R->start[i]+M->far_skel[bi][k]];
+    // Compute skeleton rows and transpose them
+    P->kernel(rank, ncols, irow, C->pivot+C->start[j], R->data, C->data, D,
+            rank);
+    for(int k = 0; k < rank; k++)
+        cblas_dcopy(ncols, D+k, rank, V+k*(size_t)ncols, 1);
+    free(D);
+    free(irow);
+    return STARSH_SUCCESS;
+}
+
 #ifdef MPI
 int starsh_blrm_new_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
         int *far_rank, Array **far_U, Array **far_V, int onfly, Array **near_D,
@@ -338,7 +565,7 @@ int starsh_blrm_new_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
  * @param[in] alloc_V: Pointer to big buffer for all `far_V`.
  * @param[in] alloc_D: Pointer to big buffer for all `near_D`.
  * @param[in] alloc_type: Type of memory allocation. `1` if big buffers
- *     are used.
+ *     are used, `3` if big buffers are used only for far-field blocks.
  * @return Error code @ref STARSH_ERRNO.
  * @ingroup blrm
  * */
@@ -379,17 +606,17 @@ int starsh_blrm_new_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
         STARSH_ERROR("Invalid value of `near_D`");
         return STARSH_WRONG_PARAMETER;
     }
-    if(alloc_type != '1' && alloc_type != '2')
+    if(alloc_type != '1' && alloc_type != '2' && alloc_type != '3')
     {
         STARSH_ERROR("Invalid value of `alloc_type`");
         return STARSH_WRONG_PARAMETER;
     }
-    if(alloc_U == NULL && F->nblocks_far_local > 0 && alloc_type == '1')
+    if(alloc_U == NULL && F->nblocks_far_local > 0 && alloc_type != '2')
     {
         STARSH_ERROR("Invalid value of `alloc_U`");
         return STARSH_WRONG_PARAMETER;
     }
-    if(alloc_V == NULL && F->nblocks_far_local > 0 && alloc_type == '1')
+    if(alloc_V == NULL && F->nblocks_far_local > 0 && alloc_type != '2')
     {
         STARSH_ERROR("Invalid value of `alloc_V`");
         return STARSH_WRONG_PARAMETER;
@@ -407,12 +634,15 @@ int starsh_blrm_new_mpi(STARSH_blrm **matrix, STARSH_blrf *format,
     M->far_rank = far_rank;
     M->far_U = far_U;
     M->far_V = far_V;
+    M->far_skel = NULL;
     M->onfly = onfly;
     M->near_D = near_D;
     M->alloc_U = alloc_U;
     M->alloc_V = alloc_V;
+    M->alloc_skel = NULL;
     M->alloc_D = alloc_D;
     M->alloc_type = alloc_type;
+    M->far_engine = NULL;
     STARSH_int lbi, bi;
     size_t data_size = 0, size = 0;
     size += sizeof(*M);
@@ -453,7 +683,7 @@ void starsh_blrm_free_mpi(STARSH_blrm *matrix)
     int info;
     if(F->nblocks_far_local > 0)
     {
-        if(M->alloc_type == '1')
+        if(M->alloc_type != '2')
         {
             free(M->alloc_U);
             free(M->alloc_V);
@@ -488,7 +718,7 @@ void starsh_blrm_free_mpi(STARSH_blrm *matrix)
                 array_free(M->near_D[lbi]);
             }
         }
-        else// M->alloc_type == '2'
+        else// M->alloc_type == '2' or M->alloc_type == '3'
         {
             for(lbi = 0; lbi < F->nblocks_near_local; lbi++)
             {
@@ -497,6 +727,7 @@ void starsh_blrm_free_mpi(STARSH_blrm *matrix)
         }
         free(M->near_D);
     }
+    free(M->far_engine);
     free(M);
 }
 
@@ -0,0 +1,137 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/control/blrm2.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_blrm2__new_empty(STARSH_blrm2 **matrix, STARSH_blrf *format,
+        int onfly)
+//! Init block low-rank matrix with shared bases without any data.
+/*! All bases and blocks are set to NULL and all ranks are set to zero, so
+ * that the matrix can be filled step by step and freed by
+ * starsh_blrm2_free() at any moment.
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm2 object.
+ * @param[in] format: Pointer to @ref STARSH_blrf object.
+ * @param[in] onfly: Equal to `1` to compute dense blocks on demand.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup blrm
+ * */
+{
+    if(matrix == NULL)
+    {
+        STARSH_ERROR("Invalid value of `matrix`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(format == NULL)
+    {
+        STARSH_ERROR("Invalid value of `format`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = format;
+    STARSH_blrm2 *M;
+    STARSH_MALLOC(M, 1);
+    M->format = F;
+    M->onfly = onfly;
+    // Keep buffers from being of zero size
+    M->row_rank = calloc(F->nbrows+1, sizeof(*M->row_rank));
+    M->row_basis = calloc(F->nbrows+1, sizeof(*M->row_basis));
+    M->col_rank = M->row_rank;
+    M->col_basis = M->row_basis;
+    if(F->symm == 'N')
+    {
+        M->col_rank = calloc(F->nbcols+1, sizeof(*M->col_rank));
+        M->col_basis = calloc(F->nbcols+1, sizeof(*M->col_basis));
+    }
+    M->far_S = calloc(F->nblocks_far+1, sizeof(*M->far_S));
+    M->far_rank = calloc(F->nblocks_far+1, sizeof(*M->far_rank));
+    M->far_U = calloc(F->nblocks_far+1, sizeof(*M->far_U));
+    M->far_V = calloc(F->nblocks_far+1, sizeof(*M->far_V));
+    M->near_D = NULL;
+    if(onfly == 0)
+        M->near_D = calloc(F->nblocks_near+1, sizeof(*M->near_D));
+    M->nbytes = 0;
+    M->data_nbytes = 0;
+    if(M->row_rank == NULL || M->row_basis == NULL || M->col_rank == NULL ||
+            M->col_basis == NULL || M->far_S == NULL || M->far_rank == NULL ||
+            M->far_U == NULL || M->far_V == NULL ||
+            (onfly == 0 && M->near_D == NULL))
+    {
+        STARSH_ERROR("malloc() failed");
+        starsh_blrm2_free(M);
+        return STARSH_MALLOC_ERROR;
+    }
+    *matrix = M;
+    return STARSH_SUCCESS;
+}
+
+void starsh_blrm2_free(STARSH_blrm2 *matrix)
+//! Free memory of a block low-rank matrix with shared bases.
+//! @ingroup blrm
+{
+    STARSH_blrm2 *M = matrix;
+    if(M == NULL)
+        return;
+    STARSH_blrf *F = M->format;
+    STARSH_int bi;
+    if(M->row_basis != NULL)
+        for(bi = 0; bi < F->nbrows; bi++)
+            free(M->row_basis[bi]);
+    free(M->row_basis);
+    free(M->row_rank);
+    if(F->symm == 'N')
+    {
+        if(M->col_basis != NULL)
+            for(bi = 0; bi < F->nbcols; bi++)
+                free(M->col_basis[bi]);
+        free(M->col_basis);
+        free(M->col_rank);
+    }
+    for(bi = 0; bi < F->nblocks_far; bi++)
+    {
+        if(M->far_S != NULL)
+            free(M->far_S[bi]);
+        if(M->far_U != NULL)
+            free(M->far_U[bi]);
+        if(M->far_V != NULL)
+            free(M->far_V[bi]);
+    }
+    free(M->far_S);
+    free(M->far_rank);
+    free(M->far_U);
+    free(M->far_V);
+    if(M->near_D != NULL)
+        for(bi = 0; bi < F->nblocks_near; bi++)
+            free(M->near_D[bi]);
+    free(M->near_D);
+    free(M);
+}
+
+void starsh_blrm2_info(STARSH_blrm2 *matrix)
+//! Print short info on block low-rank matrix with shared bases.
+//! @ingroup blrm
+{
+    STARSH_blrm2 *M = matrix;
+    if(M == NULL)
+        return;
+    STARSH_blrf *F = M->format;
+    STARSH_int bi;
+    int maxrank = 0;
+    for(bi = 0; bi < F->nbrows; bi++)
+        if(M->row_rank[bi] > maxrank)
+            maxrank = M->row_rank[bi];
+    for(bi = 0; bi < F->nbcols; bi++)
+        if(M->col_rank[bi] > maxrank)
+            maxrank = M->col_rank[bi];
+    printf("<STARSH_blrm2 at %p, %d onfly, maximal rank of bases %d, %f MB "
+            "memory footprint>\n", M, M->onfly, maxrank,
+            M->nbytes/1024./1024.);
+}
@@ -64,6 +64,9 @@ int starsh_cluster_new(STARSH_cluster **cluster, void *data, STARSH_int ndata,
     C->child_start = child_start;
     C->child = child;
     C->type = type;
+    C->ndim = 0;
+    C->point = NULL;
+    C->box = NULL;
     return STARSH_SUCCESS;
 }
 
@@ -85,6 +88,8 @@ void starsh_cluster_free(STARSH_cluster *cluster)
         free(C->child_start);
     if(C->child != NULL)
         free(C->child);
+    if(C->box != NULL)
+        free(C->box);
     free(C);
 }
 
@@ -145,3 +150,66 @@ int starsh_cluster_new_plain(STARSH_cluster **cluster, void *data,
             start, size, NULL, NULL, NULL, STARSH_PLAIN);
 }
 
+int starsh_cluster_set_geometry(STARSH_cluster *cluster, int ndim,
+        double *point)
+//! Set coordinates of discrete elements and bounding boxes of clusters.
+/*! Coordinates are not copied, so they must stay valid while the cluster is
+ * used. `d`-th coordinate of `k`-th discrete element is stored in
+ * `point[d*ndata+k]`, as it is done in @ref STARSH_particles. Bounding boxes
+ * mark diagonal blocks and blocks with overlapping boxes as near-field
+ * blocks in starsh_blrf_new_tlr() and starsh_blrf_new_tlr_mpi(), and all
+ * inadmissible blocks in starsh_blrf_new_tlr_eta(). Coordinates are used by
+ * Chebyshev interpolation engine.
+ *
+ * @param[in,out] cluster: Pointer to @ref STARSH_cluster object.
+ * @param[in] ndim: Dimensionality of space.
+ * @param[in] point: Coordinates of all discrete elements.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrf_new_tlr(), starsh_blrf_new_tlr_eta().
+ * @ingroup cluster
+ * */
+{
+    STARSH_cluster *C = cluster;
+    if(C == NULL)
+    {
+        STARSH_ERROR("Invalid value of `cluster`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(ndim < 1)
+    {
+        STARSH_ERROR("Invalid value of `ndim`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(point == NULL)
+    {
+        STARSH_ERROR("Invalid value of `point`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_int count = C->ndata, bi, k;
+    double *box;
+    STARSH_MALLOC(box, 2*ndim*C->nblocks);
+    for(bi = 0; bi < C->nblocks; bi++)
+    {
+        STARSH_int *pivot = C->pivot+C->start[bi];
+        double *lower = box+2*ndim*bi, *upper = lower+ndim;
+        for(int d = 0; d < ndim; d++)
+        {
+            double *x = point+d*count;
+            lower[d] = x[pivot[0]];
+            upper[d] = x[pivot[0]];
+            for(k = 1; k < C->size[bi]; k++)
+            {
+                if(x[pivot[k]] < lower[d])
+                    lower[d] = x[pivot[k]];
+                if(x[pivot[k]] > upper[d])
+                    upper[d] = x[pivot[k]];
+            }
+        }
+    }
+    if(C->box != NULL)
+        free(C->box);
+    C->ndim = ndim;
+    C->point = point;
+    C->box = box;
+    return STARSH_SUCCESS;
+}
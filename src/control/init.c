@@ -20,6 +20,35 @@
 // Approximation routine, chosen by starsh_init()
 STARSH_blrm_approximate *starsh_blrm_approximate = NULL;
 
+static int starsh_blrm__approximate(STARSH_blrm **matrix, STARSH_blrf *format,
+        int maxrank, double tol, int onfly)
+//! Approximate matrix by routine of selected backend and low-rank engine.
+/*! Problems with 'z' data type are approximated by complex routines, all
+ * other problems by real ones.
+ *
+ * @param[out] matrix: Address of pointer to @ref STARSH_blrm object.
+ * @param[in] format: Block low-rank format.
+ * @param[in] maxrank: Maximum possible rank.
+ * @param[in] tol: Relative error tolerance.
+ * @param[in] onfly: Whether not to store dense blocks.
+ * @return Error code @ref STARSH_ERRNO.
+ * */
+{
+    char dtype = format->problem->dtype;
+    STARSH_blrm_approximate *approximate;
+    if(dtype == 'z')
+        approximate = zlr[starsh_params.backend][starsh_params.lrengine];
+    else
+        approximate = dlr[starsh_params.backend][starsh_params.lrengine];
+    if(approximate == NULL)
+    {
+        STARSH_ERROR("Selected backend does not support '%c' data type",
+                dtype);
+        return STARSH_WRONG_PARAMETER;
+    }
+    return approximate(matrix, format, maxrank, tol, onfly);
+}
+
 int starsh_init()
 //! Initialize backend and low-rank engine to be used.
 /*! Read environment variables and sets up backend (etc. MPI) and low-rank
@@ -30,12 +59,22 @@ int starsh_init()
  *  STARSH_BACKEND: SEQUENTIAL, MPI (pure MPI), OPENMP (pure OpenMP) or
  *  MPI_OPENMP (hybrid MPI with OpenMP).
  *
- *  STARSH_LRENGINE: SVD (divide-and-conquer SVD), RRQR (LAPACK *geqp3) or
- *  RSVD (randomized SVD).
+ *  STARSH_LRENGINE: SVD (divide-and-conquer SVD), RRQR (LAPACK *geqp3),
+ *  RSVD (randomized SVD), ID (interpolative decomposition, storing skeleton
+ *  rows instead of factor `V`), CHEB (polynomial interpolation of kernel at
+ *  skeleton particles, needs geometry of clusters, set by
+ *  starsh_cluster_set_geometry()) or AUTO
+ *  (choice of SVD, RSVD or cross approximation for each tile by its shape
+ *  and measured cost of kernel).
  *
  *  STARSH_OVERSAMPLE: Number of oversampling vectors for randomized SVD and
  *  RRQR.
  *
+ *  STARSH_TOLMODE: TILE (error tolerance is relative to norm of each tile) or
+ *  GLOBAL (error tolerance is relative to estimated norm of the whole matrix
+ *  and each tile gets its share of absolute error). Tiles below their share
+ *  get rank 0.
+ *
  * @return Error code @ref STARSH_ERRNO.
  * @sa starsh_set_backend(), starsh_set_lrengine().
  * */
@@ -43,6 +82,7 @@ int starsh_init()
     const char *str_backend = "STARSH_BACKEND";
     const char *str_lrengine = "STARSH_LRENGINE";
     const char *str_oversample = "STARSH_OVERSAMPLE";
+    const char *str_tolmode = "STARSH_TOLMODE";
     //starsh_params = starsh_params_default;
     int info = 0, i;
     // Set backend by STARSH_BACKEND
@@ -60,6 +100,11 @@ int starsh_init()
     // If attempt to use user-defined value fails, then use default one
     if(info != STARSH_SUCCESS)
         starsh_set_oversample(NULL);
+    // Set error tolerance mode by STARSH_TOLMODE
+    info = starsh_set_tolmode(getenv(str_tolmode));
+    // If attempt to use user-defined value fails, then use default one
+    if(info != STARSH_SUCCESS)
+        starsh_set_tolmode(NULL);
     return STARSH_SUCCESS;
 }
 
@@ -100,8 +145,7 @@ int starsh_set_backend(const char *string)
     }
     starsh_params.backend = backend[selected].backend;
     fprintf(stderr, "Selected backend is %s\n", backend[selected].string);
-    starsh_blrm_approximate = dlr[starsh_params.backend][
-        starsh_params.lrengine];
+    starsh_blrm_approximate = starsh_blrm__approximate;
     return STARSH_SUCCESS;
 }
 
@@ -138,8 +182,7 @@ int starsh_set_lrengine(const char *string)
     starsh_params.lrengine = lrengine[selected].lrengine;
     fprintf(stderr, "Selected low-rank engine is %s\n",
             lrengine[selected].string);
-    starsh_blrm_approximate = dlr[starsh_params.backend][
-        starsh_params.lrengine];
+    starsh_blrm_approximate = starsh_blrm__approximate;
     return STARSH_SUCCESS;
 }
 
@@ -170,3 +213,37 @@ int starsh_set_oversample(const char *string)
     starsh_params.oversample = value;
     return STARSH_SUCCESS;
 }
+
+int starsh_set_tolmode(const char *string)
+//! Set the way error tolerance is applied (TILE or GLOBAL).
+/*! @param[in] string: Environment variable and value, encoded in a string.
+ *      Example: "STARSH_TOLMODE=GLOBAL".
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_init().
+ * */
+{
+    int i, selected = -1;
+    if(string == NULL)
+    {
+        selected = starsh_params_default.tolmode;
+    }
+    else
+    {
+        for(i = 0; i < TOLMODE_NUM; i++)
+        {
+            if(!strcmp(string, tolmode[i].string))
+            {
+                selected = i;
+                break;
+            }
+        }
+    }
+    if(selected == -1)
+    {
+        fprintf(stderr, "Environment variable STARSH_TOLMODE=%s is invalid\n",
+                string);
+        return STARSH_WRONG_PARAMETER;
+    }
+    starsh_params.tolmode = tolmode[selected].tolmode;
+    return STARSH_SUCCESS;
+}
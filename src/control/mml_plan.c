@@ -0,0 +1,636 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/control/mml_plan.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+#include "starsh-mpi.h"
+
+int starsh_blrm_mml_plan_create(STARSH_blrm_mml_plan **plan,
+        STARSH_blrm *matrix, int nrhs)
+//! Create plan of multiplication of H-matrix by dense matrix.
+/*! Temporary buffers for all threads are allocated once, so that
+ * starsh_blrm_mml_plan_execute() can be called many times with the same
+ * matrix and at most `nrhs` right hand sides without any allocation. Only
+ * local blocks are multiplied if any MPI backend (including MPI with
+ * StarPU) is selected.
+ *
+ * @param[out] plan: Address of pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Maximum number of right hand sides.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrm_mml_plan_execute(), starsh_blrm_mml_plan_destroy().
+ * @ingroup matmul
+ * */
+{
+    // Matrices of all MPI backends keep only local blocks
+    int mpi = starsh_params.backend == STARSH_BACKEND_MPI ||
+        starsh_params.backend == STARSH_BACKEND_MPI_OPENMP ||
+        starsh_params.backend == STARSH_BACKEND_MPI_STARPU;
+    return starsh_blrm__mml_plan_new(plan, matrix, nrhs, mpi);
+}
+
+static size_t mml_plan_panel_fill(STARSH_blrm_mml_plan *P, STARSH_int p,
+        const STARSH_int *bcol_far_start, const STARSH_int *bcol_far,
+        double *buf)
+// Set positions of factors in `p`-th panel and copy factors into `buf`, if
+// it is not NULL. Returns number of elements to be copied, which is zero if
+// factors are adjacent in memory.
+{
+    STARSH_blrm *M = P->matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_int nbrows = F->nbrows, k, start = 0, end = 0;
+    const STARSH_int *list = NULL;
+    int nrows, pos = 0, adjacent = 1;
+    double *next = NULL;
+    if(p < nbrows)
+        nrows = F->row_cluster->size[p];
+    else
+        nrows = F->col_cluster->size[p-nbrows];
+    P->panel_W[p] = NULL;
+    // Factors `V` of a block column are followed by factors `U` of
+    // transposed blocks, while panel of a block row has only factors `U`
+    for(int part = 0; part < 2; part++)
+    {
+        // Equal to 1 if factors `U` are concatenated
+        int use_U;
+        if(p >= nbrows && part == 0)
+        {
+            list = bcol_far;
+            start = bcol_far_start[p-nbrows];
+            end = bcol_far_start[p-nbrows+1];
+            use_U = 0;
+        }
+        else if(p >= nbrows && F->symm == 'S')
+        {
+            list = F->brow_far;
+            start = F->brow_far_start[p-nbrows];
+            end = F->brow_far_start[p-nbrows+1];
+            use_U = 1;
+        }
+        else if(p < nbrows && part == 0)
+        {
+            list = F->brow_far;
+            start = F->brow_far_start[p];
+            end = F->brow_far_start[p+1];
+            use_U = 1;
+        }
+        else
+            break;
+        for(k = start; k < end; k++)
+        {
+            STARSH_int bi = list[k];
+            int rank = M->far_rank[bi];
+            // Diagonal block of symmetric matrix is already in the panel
+            if(part == 1 && F->block_far[2*bi+1] == p-nbrows)
+                continue;
+            double *W = use_U ? M->far_U[bi]->data : P->far_V[bi];
+            P->far_pos[2*bi+use_U] = pos;
+            if(rank == 0)
+                continue;
+            if(buf != NULL)
+                memcpy(buf+(size_t)nrows*pos, W,
+                        sizeof(*W)*(size_t)nrows*rank);
+            else if(next == NULL)
+                P->panel_W[p] = W;
+            else if(W != next)
+                adjacent = 0;
+            next = W+(size_t)nrows*rank;
+            pos += rank;
+        }
+    }
+    if(buf != NULL)
+        P->panel_W[p] = buf;
+    return adjacent ? 0 : (size_t)nrows*pos;
+}
+
+int starsh_blrm__mml_plan_panel(STARSH_blrm_mml_plan *plan)
+//! Prepare panels of a plan.
+/*! Factors, multiplied by the same rows of right hand sides, are
+ * concatenated into panels. Panels point at factors, stored in the matrix,
+ * if they are adjacent in memory, and factors are copied otherwise. Factors
+ * `V`, which are not stored, are computed from skeleton rows. All buffers are stored in the plan as soon as they are
+ * allocated, so that they are freed by starsh_blrm_mml_plan_destroy() in
+ * case of error.
+ *
+ * @param[in,out] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup matmul
+ * */
+{
+    STARSH_blrm_mml_plan *P = plan;
+    STARSH_blrm *M = P->matrix;
+    int nrhs = P->nrhs, info;
+    STARSH_blrf *F = M->format;
+    STARSH_cluster *C = F->col_cluster;
+    STARSH_int nbrows = F->nbrows, nbcols = F->nbcols;
+    STARSH_int nblocks_far = F->nblocks_far;
+    STARSH_int i, j, k, bi;
+    char symm = F->symm;
+    int *rank;
+    STARSH_int *bcol_far_start = F->bcol_far_start, *bcol_far = F->bcol_far;
+    // Nothing to multiply by panels, far-field blocks are absent
+    if(nblocks_far == 0)
+        return STARSH_SUCCESS;
+    // Lists of block columns of symmetric format are aliases of lists of
+    // block rows, so actual lists of stored blocks of each block column are
+    // required to find transposed blocks
+    if(symm == 'S')
+    {
+        info = starsh_blrf__bcol_list(nbcols, nblocks_far, F->block_far,
+                &P->bcol_far_start, &P->bcol_far);
+        if(info != STARSH_SUCCESS)
+            return info;
+        info = starsh_blrf__bcol_list(nbcols, F->nblocks_near,
+                F->block_near, &P->bcol_near_start, &P->bcol_near);
+        if(info != STARSH_SUCCESS)
+            return info;
+        bcol_far_start = P->bcol_far_start;
+        bcol_far = P->bcol_far;
+    }
+    STARSH_MALLOC(P->panel_rank, nbrows+nbcols);
+    STARSH_MALLOC(P->far_V, nblocks_far);
+    rank = P->panel_rank;
+    // Total ranks of block rows and block columns
+    for(i = 0; i < nbrows; i++)
+    {
+        rank[i] = 0;
+        for(k = F->brow_far_start[i]; k < F->brow_far_start[i+1]; k++)
+            rank[i] += M->far_rank[F->brow_far[k]];
+        if(symm == 'S')
+            for(k = bcol_far_start[i]; k < bcol_far_start[i+1]; k++)
+                if(F->block_far[2*bcol_far[k]] != i)
+                    rank[i] += M->far_rank[bcol_far[k]];
+    }
+    for(j = 0; j < nbcols; j++)
+    {
+        rank[nbrows+j] = 0;
+        for(k = bcol_far_start[j]; k < bcol_far_start[j+1]; k++)
+            rank[nbrows+j] += M->far_rank[bcol_far[k]];
+        if(symm == 'S')
+            for(k = F->brow_far_start[j]; k < F->brow_far_start[j+1]; k++)
+                if(F->block_far[2*F->brow_far[k]+1] != j)
+                    rank[nbrows+j] += M->far_rank[F->brow_far[k]];
+    }
+    int maxrank = 0;
+    for(i = 0; i < nbrows+nbcols; i++)
+        if(rank[i] > maxrank)
+            maxrank = rank[i];
+    // Factors V are either stored or computed from skeleton rows once
+    if(M->far_skel == NULL)
+        for(bi = 0; bi < nblocks_far; bi++)
+            P->far_V[bi] = M->far_V[bi]->data;
+    else
+    {
+        size_t size_V = 0;
+        for(bi = 0; bi < nblocks_far; bi++)
+            size_V += (size_t)C->size[F->block_far[2*bi+1]]*M->far_rank[bi];
+        // Keep buffer from being of zero size
+        STARSH_MALLOC(P->skel_V, size_V+1);
+        size_V = 0;
+        for(bi = 0; bi < nblocks_far; bi++)
+        {
+            P->far_V[bi] = P->skel_V+size_V;
+            info = starsh_blrm__dget_far_V(M, bi, P->far_V[bi]);
+            if(info != STARSH_SUCCESS)
+                return info;
+            size_V += (size_t)C->size[F->block_far[2*bi+1]]*M->far_rank[bi];
+        }
+    }
+    // Panels of block columns are used by both multiplications, while
+    // panels of block rows are used only by transposed multiplication of
+    // nonsymmetric matrix
+    STARSH_MALLOC(P->panel_W, nbrows+nbcols);
+    STARSH_MALLOC(P->panel_offset, nbrows+nbcols);
+    STARSH_MALLOC(P->far_pos, 2*nblocks_far);
+    size_t size_buf = 0, size_row = 0, size_col = 0;
+    for(i = 0; i < nbrows+nbcols; i++)
+    {
+        if(i < nbrows)
+        {
+            P->panel_offset[i] = (size_t)nrhs*size_row;
+            size_row += rank[i];
+        }
+        else
+        {
+            P->panel_offset[i] = (size_t)nrhs*size_col;
+            size_col += rank[i];
+        }
+        if(i < nbrows && symm == 'S')
+            P->panel_W[i] = NULL;
+        else
+            size_buf += mml_plan_panel_fill(P, i, bcol_far_start, bcol_far,
+                    NULL);
+    }
+    if(size_buf > 0)
+    {
+        STARSH_MALLOC(P->panel_buf, size_buf);
+        size_buf = 0;
+        for(i = 0; i < nbrows+nbcols; i++)
+        {
+            if(i < nbrows && symm == 'S')
+                continue;
+            size_t size = mml_plan_panel_fill(P, i, bcol_far_start,
+                    bcol_far, NULL);
+            if(size == 0)
+                continue;
+            mml_plan_panel_fill(P, i, bcol_far_start, bcol_far,
+                    P->panel_buf+size_buf);
+            size_buf += size;
+        }
+    }
+    // Products of panels by right hand sides, keep buffer from being of zero
+    // size
+    if(size_col < size_row)
+        size_col = size_row;
+    STARSH_MALLOC(P->temp_T, (size_t)nrhs*size_col+1);
+    // Products of all far-field blocks of a block row by right hand sides
+    // are gathered in temporary buffer of a thread
+    if((size_t)nrhs*maxrank > P->size_D)
+    {
+        // Old buffer is kept in the plan if realloc() fails
+        double *temp_D = realloc(P->temp_D,
+                sizeof(*temp_D)*P->num_threads*(size_t)nrhs*maxrank);
+        if(temp_D == NULL)
+        {
+            STARSH_ERROR("realloc() failed");
+            return STARSH_MALLOC_ERROR;
+        }
+        P->temp_D = temp_D;
+        P->size_D = (size_t)nrhs*maxrank;
+    }
+    // Each block row is processed by a single thread, so private copies of
+    // result are not needed
+    free(P->temp_B);
+    P->temp_B = NULL;
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrm_mml_plan_create_panel(STARSH_blrm_mml_plan **plan,
+        STARSH_blrm *matrix, int nrhs)
+//! Create plan of multiplication with concatenated low-rank factors.
+/*! Each block row is multiplied by a single thread, so private copies of
+ * result and their final reduction are not needed. Factors `V` of all
+ * far-field blocks of a block column are concatenated, so that they are
+ * multiplied by right hand sides by a single GEMM. These products are
+ * gathered for each block row, and factors `U`, which are adjacent in
+ * memory, are multiplied by a single GEMM. Panels point at low-rank factors
+ * of the matrix if they are adjacent in memory, and factors are copied into
+ * the plan otherwise. In case of symmetric matrix, transposed blocks are
+ * also included into panels. Panels are not built for MPI backend, since
+ * block rows are distributed among nodes.
+ *
+ * @param[out] plan: Address of pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Maximum number of right hand sides.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrm_mml_plan_create().
+ * @ingroup matmul
+ * */
+{
+    int info = starsh_blrm_mml_plan_create(plan, matrix, nrhs);
+    if(info != STARSH_SUCCESS || (*plan)->mpi)
+        return info;
+    info = starsh_blrm__mml_plan_panel(*plan);
+    if(info != STARSH_SUCCESS)
+    {
+        // Plan owns all the buffers, allocated so far
+        starsh_blrm_mml_plan_destroy(*plan);
+        *plan = NULL;
+    }
+    return info;
+}
+
+int starsh_blrm_mml_plan_sparse(STARSH_blrm_mml_plan *plan, double fill)
+//! Store sparse near-field blocks of a plan in CSR format.
+/*! Near-field blocks of compactly supported kernels (i.e. Wendland kernel
+ * for mesh deformation) are filled mostly by zeros. Each near-field block
+ * with portion of nonzero elements not greater than `fill` is copied into CSR
+ * format and multiplied by a sparse loop instead of GEMM by OpenMP backend.
+ * Blocks, computed on demand, and local blocks of MPI backend are not
+ * converted.
+ *
+ * @param[in,out] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] fill: Maximal portion of nonzero elements of a sparse block.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrm_mml_plan_create().
+ * @ingroup matmul
+ * */
+{
+    if(plan == NULL)
+    {
+        STARSH_ERROR("Invalid value of `plan`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(fill < 0. || fill > 1.)
+    {
+        STARSH_ERROR("Invalid value of `fill`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrm *M = plan->matrix;
+    STARSH_blrf *F = M->format;
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    STARSH_int nblocks_near = F->nblocks_near, bi;
+    if(plan->mpi || M->onfly == 1 || nblocks_near == 0 ||
+            plan->sparse_ptr != NULL)
+        return STARSH_SUCCESS;
+    plan->sparse_ptr = malloc(sizeof(*plan->sparse_ptr)*nblocks_near);
+    plan->sparse_ind = malloc(sizeof(*plan->sparse_ind)*nblocks_near);
+    plan->sparse_val = malloc(sizeof(*plan->sparse_val)*nblocks_near);
+    if(plan->sparse_ptr == NULL || plan->sparse_ind == NULL ||
+            plan->sparse_val == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        free(plan->sparse_ptr);
+        free(plan->sparse_ind);
+        free(plan->sparse_val);
+        plan->sparse_ptr = NULL;
+        plan->sparse_ind = NULL;
+        plan->sparse_val = NULL;
+        return STARSH_MALLOC_ERROR;
+    }
+    for(bi = 0; bi < nblocks_near; bi++)
+    {
+        plan->sparse_ptr[bi] = NULL;
+        plan->sparse_ind[bi] = NULL;
+        plan->sparse_val[bi] = NULL;
+    }
+    for(bi = 0; bi < nblocks_near; bi++)
+    {
+        STARSH_int i = F->block_near[2*bi];
+        STARSH_int j = F->block_near[2*bi+1];
+        int nrows = R->size[i], ncols = C->size[j], k, l;
+        double *D = M->near_D[bi]->data;
+        size_t nnz = 0;
+        for(size_t m = 0; m < (size_t)nrows*ncols; m++)
+            if(D[m] != 0.)
+                nnz++;
+        if(nnz > fill*nrows*(double)ncols)
+            continue;
+        // Keep buffers from being of zero size
+        int *ptr = malloc(sizeof(*ptr)*(nrows+1));
+        int *ind = malloc(sizeof(*ind)*(nnz+1));
+        double *val = malloc(sizeof(*val)*(nnz+1));
+        if(ptr == NULL || ind == NULL || val == NULL)
+        {
+            // Blocks, converted so far, are kept in the plan
+            STARSH_ERROR("malloc() failed");
+            free(ptr);
+            free(ind);
+            free(val);
+            return STARSH_MALLOC_ERROR;
+        }
+        ptr[0] = 0;
+        for(k = 0; k < nrows; k++)
+        {
+            ptr[k+1] = ptr[k];
+            for(l = 0; l < ncols; l++)
+            {
+                double value = D[l*(size_t)nrows+k];
+                if(value != 0.)
+                {
+                    ind[ptr[k+1]] = l;
+                    val[ptr[k+1]] = value;
+                    ptr[k+1]++;
+                }
+            }
+        }
+        plan->sparse_ptr[bi] = ptr;
+        plan->sparse_ind[bi] = ind;
+        plan->sparse_val[bi] = val;
+    }
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrm__mml_plan_new(STARSH_blrm_mml_plan **plan,
+        STARSH_blrm *matrix, int nrhs, int mpi)
+//! Init @ref STARSH_blrm_mml_plan object.
+/*! Size of temporary buffer for blocks is defined by maximal rank of
+ * far-field blocks and, if dense blocks are computed on demand, by maximal
+ * sizes of clusters.
+ *
+ * @param[out] plan: Address of pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] matrix: Pointer to @ref STARSH_blrm object.
+ * @param[in] nrhs: Maximum number of right hand sides.
+ * @param[in] mpi: Equal to `1` if only local blocks are multiplied.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup matmul
+ * */
+{
+    if(plan == NULL)
+    {
+        STARSH_ERROR("Invalid value of `plan`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(matrix == NULL)
+    {
+        STARSH_ERROR("Invalid value of `matrix`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(nrhs <= 0)
+    {
+        STARSH_ERROR("Invalid value of `nrhs`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    STARSH_blrf *F = matrix->format;
+    STARSH_cluster *R = F->row_cluster;
+    STARSH_cluster *C = F->col_cluster;
+    STARSH_int nrows = F->problem->shape[0];
+    STARSH_int nblocks_far = mpi ? F->nblocks_far_local : F->nblocks_far;
+    STARSH_int bi;
+    // Maximal rank of far-field blocks and maximal sizes of clusters
+    int maxrank = 1, maxrow = 0, maxcol = 0;
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(matrix->far_rank[bi] > maxrank)
+            maxrank = matrix->far_rank[bi];
+    for(bi = 0; bi < R->nblocks; bi++)
+        if(R->size[bi] > maxrow)
+            maxrow = R->size[bi];
+    for(bi = 0; bi < C->nblocks; bi++)
+        if(C->size[bi] > maxcol)
+            maxcol = C->size[bi];
+    size_t size_D = (size_t)nrhs*maxrank;
+    if(matrix->onfly == 1 && (size_t)maxrow*maxcol > size_D)
+        size_D = (size_t)maxrow*maxcol;
+    int num_threads = 1;
+#ifdef OPENMP
+    #pragma omp parallel
+    #pragma omp master
+    num_threads = omp_get_num_threads();
+#endif
+    STARSH_blrm_mml_plan *P;
+    STARSH_MALLOC(P, 1);
+    P->matrix = matrix;
+    P->nrhs = nrhs;
+    P->mpi = mpi;
+    P->num_threads = num_threads;
+    P->size_D = size_D;
+    P->panel_rank = NULL;
+    P->far_V = NULL;
+    P->skel_V = NULL;
+    P->panel_W = NULL;
+    P->panel_buf = NULL;
+    P->panel_offset = NULL;
+    P->far_pos = NULL;
+    P->temp_T = NULL;
+    P->bcol_far_start = NULL;
+    P->bcol_far = NULL;
+    P->bcol_near_start = NULL;
+    P->bcol_near = NULL;
+    P->sparse_ptr = NULL;
+    P->sparse_ind = NULL;
+    P->sparse_val = NULL;
+    P->temp_D = malloc(sizeof(*P->temp_D)*num_threads*size_D);
+    P->temp_B = malloc(sizeof(*P->temp_B)*num_threads*(size_t)nrhs*nrows);
+    if(P->temp_D == NULL || P->temp_B == NULL)
+    {
+        STARSH_ERROR("malloc() failed");
+        starsh_blrm_mml_plan_destroy(P);
+        return STARSH_MALLOC_ERROR;
+    }
+    *plan = P;
+    return STARSH_SUCCESS;
+}
+
+int starsh_blrm_mml_plan_execute(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb)
+//! Multiply H-matrix by dense matrix with precomputed plan.
+/*! Performs `C=alpha*A*B+beta*C` with @ref STARSH_blrm `A` of a plan and
+ * dense matrices `B` and `C`. Uses the same backend, as
+ * starsh_blrm_mml_plan_create() for this plan.
+ *
+ * @param[in] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] nrhs: Number of right hand sides, not greater than in plan.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup matmul
+ * */
+{
+    if(plan == NULL)
+    {
+        STARSH_ERROR("Invalid value of `plan`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(nrhs <= 0 || nrhs > plan->nrhs)
+    {
+        STARSH_ERROR("Invalid value of `nrhs`");
+        return STARSH_WRONG_PARAMETER;
+    }
+#ifdef MPI
+    if(plan->mpi)
+        return starsh_blrm__dmml_plan_mpi(plan, nrhs, alpha, A, lda, beta, B,
+                ldb);
+#endif
+#ifdef OPENMP
+    if(plan->panel_rank != NULL)
+        return starsh_blrm__dmml_panel_omp(plan, nrhs, alpha, A, lda, beta,
+                B, ldb);
+    return starsh_blrm__dmml_plan_omp(plan, nrhs, alpha, A, lda, beta, B,
+            ldb);
+#else
+    return starsh_blrm__dmml(plan->matrix, nrhs, alpha, A, lda, beta, B,
+            ldb);
+#endif
+}
+
+int starsh_blrm_mml_plan_execute_trans(STARSH_blrm_mml_plan *plan, int nrhs,
+        double alpha, double *A, int lda, double beta, double *B, int ldb)
+//! Multiply transposed H-matrix by dense matrix with precomputed plan.
+/*! Performs `C=alpha*A^T*B+beta*C` with @ref STARSH_blrm `A` of a plan and
+ * dense matrices `B` and `C`. Plan must be created by
+ * starsh_blrm_mml_plan_create_panel(), since OpenMP backend multiplies each
+ * block column of nonsymmetric matrix by panels. Temporary buffers of MPI
+ * plan are not used.
+ *
+ * @param[in] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @param[in] nrhs: Number of right hand sides, not greater than in plan.
+ * @param[in] alpha: Scalar mutliplier.
+ * @param[in] A: Dense matrix, right havd side.
+ * @param[in] lda: Leading dimension of `A`.
+ * @param[in] beta: Scalar multiplier.
+ * @param[in] B: Resulting dense matrix.
+ * @param[in] ldb: Leading dimension of B.
+ * @return Error code @ref STARSH_ERRNO.
+ * @sa starsh_blrm_mml_plan_execute().
+ * @ingroup matmul
+ * */
+{
+    if(plan == NULL)
+    {
+        STARSH_ERROR("Invalid value of `plan`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(nrhs <= 0 || nrhs > plan->nrhs)
+    {
+        STARSH_ERROR("Invalid value of `nrhs`");
+        return STARSH_WRONG_PARAMETER;
+    }
+#ifdef MPI
+    if(plan->mpi)
+        return starsh_blrm__dmml_trans_mpi(plan->matrix, nrhs, alpha, A, lda,
+                beta, B, ldb);
+#endif
+#ifdef OPENMP
+    if(plan->panel_rank == NULL && plan->matrix->format->nblocks_far > 0)
+    {
+        STARSH_ERROR("Plan has no panels");
+        return STARSH_WRONG_PARAMETER;
+    }
+    return starsh_blrm__dmml_trans_panel_omp(plan, nrhs, alpha, A, lda, beta,
+            B, ldb);
+#else
+    return starsh_blrm__dmml_trans(plan->matrix, nrhs, alpha, A, lda, beta,
+            B, ldb);
+#endif
+}
+
+void starsh_blrm_mml_plan_destroy(STARSH_blrm_mml_plan *plan)
+//! Free memory of @ref STARSH_blrm_mml_plan object.
+/*! @param[in] plan: Pointer to @ref STARSH_blrm_mml_plan object.
+ * @ingroup matmul
+ * */
+{
+    if(plan == NULL)
+        return;
+    free(plan->temp_D);
+    free(plan->temp_B);
+    free(plan->panel_rank);
+    free(plan->far_V);
+    free(plan->skel_V);
+    free(plan->panel_W);
+    free(plan->panel_buf);
+    free(plan->panel_offset);
+    free(plan->far_pos);
+    free(plan->temp_T);
+    free(plan->bcol_far_start);
+    free(plan->bcol_far);
+    free(plan->bcol_near_start);
+    free(plan->bcol_near);
+    if(plan->sparse_ptr != NULL)
+    {
+        STARSH_int bi;
+        for(bi = 0; bi < plan->matrix->format->nblocks_near; bi++)
+        {
+            free(plan->sparse_ptr[bi]);
+            free(plan->sparse_ind[bi]);
+            free(plan->sparse_val[bi]);
+        }
+        free(plan->sparse_ptr);
+        free(plan->sparse_ind);
+        free(plan->sparse_val);
+    }
+    free(plan);
+}
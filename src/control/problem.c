@@ -13,6 +13,10 @@
 #include "common.h"
 #include "starsh.h"
 
+static void _tensor_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld);
+
 int starsh_problem_new(STARSH_problem **problem, int ndim, STARSH_int *shape,
         char symm, char dtype, void *row_data, void *col_data,
         STARSH_kernel *kernel, char *name)
@@ -107,6 +111,9 @@ void starsh_problem_free(STARSH_problem *problem)
 {
     if(problem == NULL)
         return;
+    // Problems from tensors own data for rows and columns
+    if(problem->kernel == _tensor_kernel)
+        free(problem->row_data);
     free(problem->shape);
     if(problem->name != NULL)
         free(problem->name);
@@ -181,54 +188,199 @@ int starsh_problem_get_block(STARSH_problem *problem, int nrows, int ncols,
     info = array_new(A, ndim, shape, problem->dtype, 'F');
     if(info != 0)
         return info;
-    problem->kernel(nrows, ncols, irow, icol, problem->row_data,
-            problem->col_data, (*A)->data, nrows);
+    starsh_problem_kernel(problem, nrows, ncols, irow, icol,
+            problem->row_data, problem->col_data, (*A)->data, nrows);
     return STARSH_SUCCESS;
 }
 
+//! Size of diagonal blocks, computed directly by starsh_problem_kernel().
+static const int symm_leaf_size = 64;
+
+static void _symm_mirror(char dtype, int nrows, int ncols, void *result,
+        int ld)
+//! Copy lower off-diagonal `nrows` by `ncols` block into upper one.
+/*! Lower block starts at `result` and upper block starts at
+ * `result+(ld-ncols)*ncols` elements, since the diagonal block of `ncols`
+ * rows precedes the lower one.
+ * */
+{
+    int i, j;
+    size_t shift = (size_t)ncols*ld-ncols;
+    if(dtype == 'd')
+    {
+        double *L = result, *U = L+shift;
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < ncols; j++)
+                U[j+i*(size_t)ld] = L[i+j*(size_t)ld];
+    }
+    else if(dtype == 'z')
+    {
+        double complex *L = result, *U = L+shift;
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < ncols; j++)
+                U[j+i*(size_t)ld] = L[i+j*(size_t)ld];
+    }
+    else if(dtype == 's')
+    {
+        float *L = result, *U = L+shift;
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < ncols; j++)
+                U[j+i*(size_t)ld] = L[i+j*(size_t)ld];
+    }
+    else
+    {
+        float complex *L = result, *U = L+shift;
+        for(i = 0; i < nrows; i++)
+            for(j = 0; j < ncols; j++)
+                U[j+i*(size_t)ld] = L[i+j*(size_t)ld];
+    }
+}
+
+static void _symm_kernel(STARSH_problem *problem, int n, STARSH_int *index,
+        void *data, char *result, int ld)
+//! Recursively compute symmetric diagonal block by its lower triangle.
+{
+    if(n <= symm_leaf_size)
+    {
+        problem->kernel(n, n, index, index, data, data, result, ld);
+        return;
+    }
+    int n1 = n/2, n2 = n-n1;
+    size_t size = problem->dtype_size;
+    _symm_kernel(problem, n1, index, data, result, ld);
+    _symm_kernel(problem, n2, index+n1, data, result+size*(n1+(size_t)n1*ld),
+            ld);
+    problem->kernel(n2, n1, index+n1, index, data, data, result+size*n1, ld);
+    _symm_mirror(problem->dtype, n2, n1, result+size*n1, ld);
+}
+
+void starsh_problem_kernel(STARSH_problem *problem, int nrows, int ncols,
+        STARSH_int *irow, STARSH_int *icol, void *row_data, void *col_data,
+        void *result, int ld)
+//! Compute submatrix, using symmetry of diagonal blocks.
+/*! Same as a call to `problem->kernel`, but if the problem is symmetric and
+ * the block is a diagonal one (same indexes and same data for rows and
+ * columns), only lower triangle is computed by the kernel. Block is halved
+ * recursively, lower off-diagonal part is computed by a single call to the
+ * kernel and then mirrored into upper part. This almost halves number of
+ * kernel evaluations for the most expensive dense blocks. Tensor kernels
+ * (`ndim` greater than 2) are always computed by a single call to the kernel.
+ *
+ * @param[in] problem: Pointer to @ref STARSH_problem object.
+ * @param[in] nrows: Number of rows.
+ * @param[in] ncols: Number of columns.
+ * @param[in] irow: Indexes of rows.
+ * @param[in] icol: Indexes of columns.
+ * @param[in] row_data: Pointer to physical data for rows.
+ * @param[in] col_data: Pointer to physical data for columns.
+ * @param[out] result: Pointer to memory of submatrix.
+ * @param[in] ld: Leading dimension of `result`.
+ * @ingroup problem
+ * */
+{
+    if(problem->symm == 'S' && problem->ndim == 2 && irow == icol &&
+            nrows == ncols && row_data == col_data)
+        _symm_kernel(problem, nrows, irow, row_data, result, ld);
+    else
+        problem->kernel(nrows, ncols, irow, icol, row_data, col_data, result,
+                ld);
+}
+
 static void _matrix_kernel(int nrows, int ncols, STARSH_int *irow,
         STARSH_int *icol, void *row_data, void *col_data, void *result,
         int ld)
 //! Kernel for problems, defined by dense matrices.
-//! @ingroup problem
+/*! If array is in Fortran order and rows of a block are a contiguous range,
+ * each column of a block is copied by a single memcpy(). If array is in C
+ * order, block is filled row by row, so that reading from array is
+ * contiguous, and if columns of a block are a contiguous range, each row is
+ * read from a single contiguous chunk.
+ * @ingroup problem
+ * */
 {
     Array *A = row_data;
     size_t esize = A->dtype_size;
     STARSH_int i, j;
     size_t dest, src, lda;
+    char *buffer = result, *data = A->data;
     for(int i = 1; i < A->ndim-1; i++)
         esize *= A->shape[i];
     if(A->order == 'C')
     {
         lda = A->shape[A->ndim-1];
+        // Check if columns are contiguous
+        int contiguous = 1;
+        for(j = 1; j < ncols; j++)
+            if(icol[j] != icol[0]+j)
+            {
+                contiguous = 0;
+                break;
+            }
         //#pragma omp parallel for private(dest, src, i, j)
         for(i = 0; i < nrows; i++)
+        {
+            if(contiguous)
+            {
+                // Transposed copy of a contiguous chunk of a row
+                char *row = data+(irow[i]*lda+icol[0])*esize;
+                if(esize == sizeof(double))
+                    for(j = 0; j < ncols; j++)
+                        ((double *)buffer)[j*(size_t)ld+i] =
+                            ((double *)row)[j];
+                else
+                    for(j = 0; j < ncols; j++)
+                        memcpy(buffer+(j*(size_t)ld+i)*esize, row+j*esize,
+                                esize);
+                continue;
+            }
             for(j = 0; j < ncols; j++)
             {
                 dest = j*(size_t)ld+i;
                 src = irow[i]*lda+icol[j];
-                memcpy(result+dest*esize, A->data+src*esize, esize);
+                memcpy(buffer+dest*esize, data+src*esize, esize);
             }
+        }
     }
     else
     {
         lda = A->shape[0];
+        // Check if rows are contiguous
+        int contiguous = 1;
+        for(i = 1; i < nrows; i++)
+            if(irow[i] != irow[0]+i)
+            {
+                contiguous = 0;
+                break;
+            }
         //#pragma omp parallel for private(dest, src, i, j)
-        for(i = 0; i < nrows; i++)
-            for(j = 0; j < ncols; j++)
+        for(j = 0; j < ncols; j++)
+        {
+            dest = j*(size_t)ld;
+            if(contiguous)
+            {
+                // Copy a contiguous chunk of a column at once
+                src = icol[j]*lda+irow[0];
+                memcpy(buffer+dest*esize, data+src*esize, nrows*esize);
+                continue;
+            }
+            for(i = 0; i < nrows; i++)
             {
-                dest = j*(size_t)ld+i;
                 src = icol[j]*lda+irow[i];
-                memcpy(result+dest*esize, A->data+src*esize, esize);
+                memcpy(buffer+(dest+i)*esize, data+src*esize, esize);
             }
+        }
     }
 }
 
 int starsh_problem_from_array(STARSH_problem **problem, Array *A, char symm)
 //! Create STARSH_problem instance, based on dense array.
-/*! If @ref array `A` is sorted in C order, then temporary @ref array object
- * will be created as a copy of input `A`, but in Fortran order. There will be
- * no way to free that temporary @ref array object.
+/*! Matrix `A` is used inplace both in C and in Fortran order, so it must
+ * not be freed before the problem. It can be mapped from a file by
+ * array_from_file(), so that large matrices are not loaded into memory. If
+ * @ref array `A` has more than two dimensions and is sorted in C order, then
+ * temporary @ref array object will be created as a copy of input `A`, but in
+ * Fortran order. There will be no way to free that temporary @ref array
+ * object.
  *
  * @param[out] problem: Address of pointer to @ref STARSH_problem object.
  * @param[in] A: Array.
@@ -259,9 +411,9 @@ int starsh_problem_from_array(STARSH_problem **problem, Array *A, char symm)
     }
     Array *A2 = A;
     int info;
-    if(A->order == 'C')
+    if(A->order == 'C' && A->ndim > 2)
     {
-        STARSH_WARNING("A->order is 'C', creating "
+        STARSH_WARNING("A->order is 'C' and A->ndim > 2, creating "
                 "copy of array with layout in Fortran style ('F'-order). It "
                 "makes corresponding matrix non-freeable");
         info = array_new_copy(&A2, A, 'F');
@@ -314,3 +466,162 @@ int starsh_problem_to_array(STARSH_problem *problem, Array **A)
     free(icol);
     return info;
 }
+
+typedef struct
+//! Data for rows or columns of a problem, produced from a tensor problem.
+{
+    STARSH_problem *tensor;
+    //!< Tensor problem.
+    void *data;
+    //!< Physical data of tensor problem for rows or columns.
+    int ncomp;
+    //!< Number of components of a kernel per row or per column.
+} _tensor_data;
+
+static void _tensor_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+//! Kernel for problems, produced by starsh_problem_from_tensor().
+/*! Row `r` corresponds to component `r%p` of `r/p`-th row of tensor problem
+ * and column `c` corresponds to component `c%q` of `c/q`-th column. Rows and
+ * columns of tensor problem are gathered, skipping repeated neighbours, so
+ * that tensor kernel is called only once, computing all the components for
+ * each pair of points at once. Computed entries are then scattered into
+ * `result`.
+ * @ingroup problem
+ * */
+{
+    _tensor_data *rdata = row_data, *cdata = col_data;
+    STARSH_problem *T = rdata->tensor;
+    int p = rdata->ncomp, q = cdata->ncomp;
+    size_t esize = T->dtype_size;
+    char *buffer = result;
+    int i, j, npr = 0, npc = 0;
+    if(nrows <= 0 || ncols <= 0)
+        return;
+    STARSH_int *point = malloc(sizeof(*point)*(size_t)(nrows+ncols));
+    int *pos = malloc(sizeof(*pos)*(size_t)(nrows+ncols));
+    char *work = NULL;
+    if(point != NULL && pos != NULL)
+    {
+        STARSH_int *rpoint = point, *cpoint = point+nrows;
+        int *rpos = pos, *cpos = pos+nrows;
+        for(i = 0; i < nrows; i++)
+        {
+            STARSH_int k = irow[i]/p;
+            if(npr == 0 || rpoint[npr-1] != k)
+                rpoint[npr++] = k;
+            rpos[i] = npr-1;
+        }
+        for(j = 0; j < ncols; j++)
+        {
+            STARSH_int k = icol[j]/q;
+            if(npc == 0 || cpoint[npc-1] != k)
+                cpoint[npc++] = k;
+            cpos[j] = npc-1;
+        }
+        work = malloc(esize*(size_t)npr*p*q*npc);
+    }
+    if(work == NULL)
+    {
+        // Not enough memory, so compute entries one by one
+        char entry[T->entry_size];
+        for(j = 0; j < ncols; j++)
+        {
+            STARSH_int k = icol[j]/q;
+            for(i = 0; i < nrows; i++)
+            {
+                STARSH_int l = irow[i]/p;
+                T->kernel(1, 1, &l, &k, rdata->data, cdata->data, entry, 1);
+                memcpy(buffer+(j*(size_t)ld+i)*esize,
+                        entry+(irow[i]%p+p*(icol[j]%q))*esize, esize);
+            }
+        }
+        free(point);
+        free(pos);
+        return;
+    }
+    T->kernel(npr, npc, point, point+nrows, rdata->data, cdata->data, work,
+            npr);
+    for(j = 0; j < ncols; j++)
+    {
+        size_t shift = (icol[j]%q+q*(size_t)pos[nrows+j])*p*npr;
+        if(esize == sizeof(double))
+        {
+            double *src = (double *)work+shift;
+            double *dest = (double *)buffer+j*(size_t)ld;
+            for(i = 0; i < nrows; i++)
+                dest[i] = src[pos[i]+npr*(size_t)(irow[i]%p)];
+        }
+        else
+            for(i = 0; i < nrows; i++)
+                memcpy(buffer+(j*(size_t)ld+i)*esize,
+                        work+(shift+pos[i]+npr*(size_t)(irow[i]%p))*esize,
+                        esize);
+    }
+    free(work);
+    free(point);
+    free(pos);
+}
+
+int starsh_problem_from_tensor(STARSH_problem **problem,
+        STARSH_problem *tensor)
+//! Create scalar problem from a problem with tensor-valued kernel.
+/*! Tensor problem of shape `(N, p, M)` or `(N, p, q, M)` is represented by
+ * a matrix of shape `(N*p, M)` or `(N*p, M*q)`, where all the components of
+ * the same row (column) of the tensor problem are consecutive rows
+ * (columns). Since rows and columns of the tensor problem are usually
+ * spatial points, this keeps all the outputs of a kernel for a pair of
+ * points in the same tile, so the whole system (e.g. bivariate
+ * geostatistics or a vector-valued RBF system) is compressed as a single
+ * structured matrix by usual approximation, storage and matvec routines.
+ * Kernel of the tensor problem is called once per tile and is expected to
+ * compute geometry once for all of its outputs.
+ *
+ * Clusters for the new problem must be created with `problem->row_data`
+ * and `problem->col_data` as their data, and their block sizes should be
+ * multiples of `p` and `q` respectively. Tensor problem must not be freed
+ * before the new problem. The new problem is symmetric if the tensor
+ * problem is symmetric and `p` is equal to `q`.
+ *
+ * @param[out] problem: Address of pointer to @ref STARSH_problem object.
+ * @param[in] tensor: Problem with 3 or 4 dimensions.
+ * @return Error code @ref STARSH_ERRNO.
+ * @ingroup problem
+ * */
+{
+    if(problem == NULL)
+    {
+        STARSH_ERROR("Invalid value of `problem`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(tensor == NULL)
+    {
+        STARSH_ERROR("Invalid value of `tensor`");
+        return STARSH_WRONG_PARAMETER;
+    }
+    if(tensor->ndim != 3 && tensor->ndim != 4)
+    {
+        STARSH_ERROR("`tensor` should be three- or four-dimensional");
+        return STARSH_WRONG_PARAMETER;
+    }
+    int ndim = tensor->ndim, info;
+    int p = tensor->shape[1], q = ndim == 4 ? tensor->shape[2] : 1;
+    char symm = 'N';
+    if(tensor->symm == 'S' && p == q && tensor->row_data == tensor->col_data)
+        symm = 'S';
+    STARSH_int shape[2] = {tensor->shape[0]*p, tensor->shape[ndim-1]*q};
+    _tensor_data *data;
+    STARSH_MALLOC(data, 2);
+    data[0].tensor = tensor;
+    data[0].data = tensor->row_data;
+    data[0].ncomp = p;
+    data[1].tensor = tensor;
+    data[1].data = tensor->col_data;
+    data[1].ncomp = q;
+    info = starsh_problem_new(problem, 2, shape, symm, tensor->dtype, data,
+            symm == 'S' ? data : data+1, _tensor_kernel, tensor->name);
+    if(info != STARSH_SUCCESS)
+        free(data);
+    return info;
+}
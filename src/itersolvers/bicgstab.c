@@ -0,0 +1,181 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/itersolvers/bicgstab.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+int starsh_itersolvers__dbicgstab_omp(STARSH_blrm *matrix, int nrhs,
+        double *B, int ldb, double *X, int ldx, double tol, double *work)
+//! BiCGStab method for @ref STARSH_blrm object.
+/*! Suits nonsymmetric matrices. Each right hand side is solved separately,
+ * but matrix is applied to a block of all `nrhs` vectors by a single
+ * execution of a plan, created once by starsh_blrm_mml_plan_create(). If
+ * method breaks down for a right hand side, its
+ * solution is not updated any more, while other right hand sides are solved
+ * further.
+ *
+ * @param[in] matrix: Block-wise low-rank matrix.
+ * @param[in] nrhs: Number of right havd sides.
+ * @param[in] B: Right hand side.
+ * @param[in] ldb: Leading dimension of `B`.
+ * @param[in,out] X: Initial solution as input, total solution as output.
+ * @param[in] ldx: Leading dimension of `X`.
+ * @param[in] tol: Relative error threshold for residual.
+ * @param[out] work: Temporary array of size `6*n*nrhs+4*nrhs`.
+ * @return Number of iterations or -1 if not converged, broken down for any
+ *      right hand side or matrix could not be prepared for multiplication.
+ * @ingroup solvers
+ * */
+{
+    STARSH_blrm *M = matrix;
+    int n = M->format->problem->shape[0];
+    size_t size = (size_t)n*nrhs;
+    double *R = work;
+    double *R0 = R+size;
+    double *P = R0+size;
+    double *AP = P+size;
+    double *S = AP+size;
+    double *AS = S+size;
+    double *rscheck = AS+size;
+    double *rho = rscheck+nrhs;
+    double *alpha = rho+nrhs;
+    double *omega = alpha+nrhs;
+    int i, j;
+    size_t k;
+    // Right hand sides, that are solved or broken down, are marked by
+    // negative values of `rscheck`
+    int finished = 0, failed = 0, iter = -1;
+    // Plan of multiplication is shared by all iterations
+    STARSH_blrm_mml_plan *plan;
+    if(starsh_blrm_mml_plan_create(&plan, M, nrhs) != STARSH_SUCCESS)
+        return -1;
+    starsh_blrm_mml_plan_execute(plan, nrhs, -1.0, X, ldx, 0.0, R, n);
+    for(j = 0; j < nrhs; j++)
+    {
+        double *r = R+(size_t)n*j;
+        cblas_daxpy(n, 1., B+(size_t)ldb*j, 1, r, 1);
+        double resid = cblas_dnrm2(n, r, 1);
+        rscheck[j] = resid*tol;
+        rho[j] = 1.;
+        alpha[j] = 1.;
+        omega[j] = 1.;
+        if(resid <= rscheck[j])
+        {
+            finished++;
+            rscheck[j] = -1.;
+        }
+    }
+    if(finished == nrhs)
+    {
+        starsh_blrm_mml_plan_destroy(plan);
+        return 0;
+    }
+    cblas_dcopy(size, R, 1, R0, 1);
+    for(k = 0; k < size; k++)
+    {
+        P[k] = 0.;
+        AP[k] = 0.;
+    }
+    for(i = 0; i < n; i++)
+    {
+        // Update search directions
+        for(j = 0; j < nrhs; j++)
+        {
+            if(rscheck[j] < 0)
+                continue;
+            double *r = R+(size_t)n*j, *r0 = R0+(size_t)n*j;
+            double *p = P+(size_t)n*j, *ap = AP+(size_t)n*j;
+            double rho_new = cblas_ddot(n, r0, 1, r, 1);
+            if(rho_new == 0. || omega[j] == 0.)
+            {
+                // Method broke down for this right hand side
+                finished++;
+                failed++;
+                rscheck[j] = -2.;
+                continue;
+            }
+            double beta = rho_new/rho[j]*alpha[j]/omega[j];
+            rho[j] = rho_new;
+            // p = r+beta*(p-omega*ap)
+            cblas_daxpy(n, -omega[j], ap, 1, p, 1);
+            cblas_dscal(n, beta, p, 1);
+            cblas_daxpy(n, 1., r, 1, p, 1);
+        }
+        if(finished == nrhs)
+            break;
+        starsh_blrm_mml_plan_execute(plan, nrhs, 1.0, P, n, 0.0, AP, n);
+        // Half step of BiCG
+        for(j = 0; j < nrhs; j++)
+        {
+            double *s = S+(size_t)n*j;
+            if(rscheck[j] < 0)
+            {
+                cblas_dscal(n, 0., s, 1);
+                continue;
+            }
+            double *r = R+(size_t)n*j, *r0 = R0+(size_t)n*j;
+            double *p = P+(size_t)n*j, *ap = AP+(size_t)n*j;
+            double *x = X+(size_t)ldx*j;
+            double r0ap = cblas_ddot(n, r0, 1, ap, 1);
+            if(r0ap == 0.)
+            {
+                // Method broke down for this right hand side
+                finished++;
+                failed++;
+                rscheck[j] = -2.;
+                cblas_dscal(n, 0., s, 1);
+                continue;
+            }
+            alpha[j] = rho[j]/r0ap;
+            cblas_dcopy(n, r, 1, s, 1);
+            cblas_daxpy(n, -alpha[j], ap, 1, s, 1);
+            cblas_daxpy(n, alpha[j], p, 1, x, 1);
+            if(cblas_dnrm2(n, s, 1) <= rscheck[j])
+            {
+                finished++;
+                rscheck[j] = -1.;
+                cblas_dscal(n, 0., s, 1);
+            }
+        }
+        if(finished == nrhs)
+        {
+            iter = failed > 0 ? -1 : i+1;
+            break;
+        }
+        starsh_blrm_mml_plan_execute(plan, nrhs, 1.0, S, n, 0.0, AS, n);
+        // Stabilizing step
+        for(j = 0; j < nrhs; j++)
+        {
+            if(rscheck[j] < 0)
+                continue;
+            double *r = R+(size_t)n*j, *s = S+(size_t)n*j;
+            double *as = AS+(size_t)n*j;
+            double *x = X+(size_t)ldx*j;
+            double tt = cblas_ddot(n, as, 1, as, 1);
+            omega[j] = tt > 0. ? cblas_ddot(n, as, 1, s, 1)/tt : 0.;
+            cblas_daxpy(n, omega[j], s, 1, x, 1);
+            cblas_dcopy(n, s, 1, r, 1);
+            cblas_daxpy(n, -omega[j], as, 1, r, 1);
+            if(cblas_dnrm2(n, r, 1) <= rscheck[j])
+            {
+                finished++;
+                rscheck[j] = -1.;
+            }
+        }
+        if(finished == nrhs)
+        {
+            iter = failed > 0 ? -1 : i+1;
+            break;
+        }
+    }
+    starsh_blrm_mml_plan_destroy(plan);
+    return iter;
+}
@@ -32,7 +32,8 @@ int starsh_itersolvers__dcg_omp(STARSH_blrm *matrix, int nrhs, double *B,
  * @param[in] ldx: Leading dimension of `X`.
  * @param[in] tol: Relative error threshold for residual.
  * @param[out] work: Temporary array of size `3*n`.
- * @return Number of iterations or -1 if not converged.
+ * @return Number of iterations or -1 if not converged or matrix could not
+ *      be prepared for multiplication.
  * @ingroup solvers
  * */
 {
@@ -44,9 +45,13 @@ int starsh_itersolvers__dcg_omp(STARSH_blrm *matrix, int nrhs, double *B,
     double *rscheck = next_P+n*nrhs;
     double *rsold = rscheck+nrhs;
     double *rsnew = rsold+nrhs;
-    int i;
+    int i, iter = -1;
     int finished = 0;
-    starsh_blrm__dmml_omp(M, nrhs, -1.0, X, ldx, 0.0, R, n);
+    // Plan of multiplication is shared by all iterations
+    STARSH_blrm_mml_plan *plan;
+    if(starsh_blrm_mml_plan_create(&plan, M, nrhs) != STARSH_SUCCESS)
+        return -1;
+    starsh_blrm_mml_plan_execute(plan, nrhs, -1.0, X, ldx, 0.0, R, n);
     for(i = 0; i < nrhs; i++)
         cblas_daxpy(n, 1., B+ldb*i, 1, R+n*i, 1);
     cblas_dcopy(n*nrhs, R, 1, P, 1);
@@ -60,7 +65,7 @@ int starsh_itersolvers__dcg_omp(STARSH_blrm *matrix, int nrhs, double *B,
     //printf("rsold=%e\n", rsold);
     for(i = 0; i < n; i++)
     {
-        starsh_blrm__dmml_omp(M, nrhs, 1.0, P, n, 0.0, next_P, n);
+        starsh_blrm_mml_plan_execute(plan, nrhs, 1.0, P, n, 0.0, next_P, n);
         for(int j = 0; j < nrhs; j++)
         {
             if(rscheck[j] < 0)
@@ -87,9 +92,152 @@ int starsh_itersolvers__dcg_omp(STARSH_blrm *matrix, int nrhs, double *B,
             rsold[j] = rsnew[j];
         }
         if(finished == nrhs)
-            return i;
+        {
+            iter = i;
+            break;
+        }
     }
-    return -1;
+    starsh_blrm_mml_plan_destroy(plan);
+    return iter;
+}
+
+int starsh_itersolvers__dbcg_omp(STARSH_blrm *matrix, int nrhs, double *B,
+        int ldb, double *X, int ldx, double tol, double *work)
+//! Block conjugate gradient method for @ref STARSH_blrm object.
+/*! Unlike starsh_itersolvers__dcg_omp(), all right hand sides share the same
+ * Krylov subspace, so search directions of one right hand side improve
+ * solutions of others. Converged columns are deflated: only residuals of
+ * active columns are kept and only current search directions are multiplied
+ * by matrix. Small projected systems are solved by pivoted Cholesky
+ * factorization, which also drops linearly dependent search directions.
+ *
+ * @param[in] matrix: Block-wise low-rank matrix.
+ * @param[in] nrhs: Number of right havd sides.
+ * @param[in] B: Right hand side.
+ * @param[in] ldb: Leading dimension of `B`.
+ * @param[in,out] X: Initial solution as input, total solution as output.
+ * @param[in] ldx: Leading dimension of `X`.
+ * @param[in] tol: Relative error threshold for residual.
+ * @param[out] work: Temporary array of size `3*n*nrhs+2*nrhs*nrhs+3*nrhs`.
+ * @return Number of iterations or -1 if not converged or matrix could not
+ *      be prepared for multiplication.
+ * @ingroup solvers
+ * */
+{
+    STARSH_blrm *M = matrix;
+    int n = M->format->problem->shape[0];
+    double *R = work;
+    double *P = R+(size_t)n*nrhs;
+    double *Q = P+(size_t)n*nrhs;
+    double *G = Q+(size_t)n*nrhs;
+    double *S = G+(size_t)nrhs*nrhs;
+    double *rscheck = S+(size_t)nrhs*nrhs;
+    double *pstrf_work = rscheck+nrhs;
+    // Indexes of active (not yet converged) right hand sides
+    int active[nrhs];
+    // Pivots of Cholesky factorization, current position of each search
+    // direction and search direction at each position
+    int piv[nrhs], pos[nrhs], dir[nrhs];
+    int i, j, k, info, rank;
+    // Number of active right hand sides and number of search directions
+    int nact = 0, ndir, iter = -1;
+    // Plan of multiplication is shared by all iterations
+    STARSH_blrm_mml_plan *plan;
+    if(starsh_blrm_mml_plan_create(&plan, M, nrhs) != STARSH_SUCCESS)
+        return -1;
+    starsh_blrm_mml_plan_execute(plan, nrhs, -1.0, X, ldx, 0.0, R, n);
+    for(j = 0; j < nrhs; j++)
+    {
+        double *r = R+(size_t)n*j;
+        cblas_daxpy(n, 1., B+(size_t)ldb*j, 1, r, 1);
+        double resid = cblas_dnrm2(n, r, 1);
+        rscheck[j] = resid*tol;
+        if(resid <= rscheck[j])
+            continue;
+        // Pack residuals of active columns
+        if(nact != j)
+            cblas_dcopy(n, r, 1, R+(size_t)n*nact, 1);
+        active[nact++] = j;
+    }
+    if(nact == 0)
+        iter = 0;
+    ndir = nact;
+    cblas_dcopy(n*nact, R, 1, P, 1);
+    for(i = 0; i < n && nact > 0; i++)
+    {
+        // Only current search directions are multiplied by matrix
+        starsh_blrm_mml_plan_execute(plan, ndir, 1.0, P, n, 0.0, Q, n);
+        // G = P^T*A*P is SPD for linearly independent search directions
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ndir, ndir, n,
+                1.0, P, n, Q, n, 0.0, G, ndir);
+        int ldg = ndir;
+        info = LAPACKE_dpstrf_work(LAPACK_COL_MAJOR, 'L', ndir, G, ldg, piv,
+                &rank, -1., pstrf_work);
+        if(info < 0 || rank == 0)
+            break;
+        // Move independent search directions to the beginning in order of
+        // pivoting, rest of directions are dropped
+        for(k = 0; k < ndir; k++)
+        {
+            pos[k] = k;
+            dir[k] = k;
+        }
+        for(k = 0; k < rank; k++)
+        {
+            int d = piv[k]-1, p = pos[d];
+            if(p == k)
+                continue;
+            cblas_dswap(n, P+(size_t)n*k, 1, P+(size_t)n*p, 1);
+            cblas_dswap(n, Q+(size_t)n*k, 1, Q+(size_t)n*p, 1);
+            dir[p] = dir[k];
+            pos[dir[p]] = p;
+            dir[k] = d;
+            pos[d] = k;
+        }
+        ndir = rank;
+        // Step sizes S = G^{-1}*P^T*R
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ndir, nact, n,
+                1.0, P, n, R, n, 0.0, S, ndir);
+        LAPACKE_dpotrs_work(LAPACK_COL_MAJOR, 'L', ndir, nact, G, ldg, S,
+                ndir);
+        for(k = 0; k < nact; k++)
+            cblas_dgemv(CblasColMajor, CblasNoTrans, n, ndir, 1.0, P, n,
+                    S+(size_t)ndir*k, 1, 1.0, X+(size_t)ldx*active[k], 1);
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, nact, ndir,
+                -1.0, Q, n, S, ndir, 1.0, R, n);
+        // Deflate converged columns
+        j = 0;
+        for(k = 0; k < nact; k++)
+        {
+            double *r = R+(size_t)n*k;
+            if(cblas_dnrm2(n, r, 1) <= rscheck[active[k]])
+                continue;
+            if(j != k)
+                cblas_dcopy(n, r, 1, R+(size_t)n*j, 1);
+            active[j++] = active[k];
+        }
+        nact = j;
+        if(nact == 0)
+        {
+            iter = i+1;
+            break;
+        }
+        // New search directions R+P*S are A-orthogonal to previous ones
+        // with S = -G^{-1}*Q^T*R
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, ndir, nact, n,
+                -1.0, Q, n, R, n, 0.0, S, ndir);
+        LAPACKE_dpotrs_work(LAPACK_COL_MAJOR, 'L', ndir, nact, G, ldg, S,
+                ndir);
+        cblas_dcopy(n*nact, R, 1, Q, 1);
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, nact, ndir,
+                1.0, P, n, S, ndir, 1.0, Q, n);
+        double *tmp = P;
+        P = Q;
+        Q = tmp;
+        ndir = nact;
+    }
+    starsh_blrm_mml_plan_destroy(plan);
+    return iter;
 }
 
 #ifdef MPI
@@ -0,0 +1,300 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file src/itersolvers/gmres.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include "common.h"
+#include "starsh.h"
+
+static void dgivens(double a, double b, double *c, double *s)
+//! Givens rotation, that annihilates `b` in vector `(a, b)`.
+{
+    double t = sqrt(a*a+b*b);
+    if(t == 0.)
+    {
+        *c = 1.;
+        *s = 0.;
+    }
+    else
+    {
+        *c = a/t;
+        *s = b/t;
+    }
+}
+
+int starsh_itersolvers__dgmres_omp(STARSH_blrm *matrix, int nrhs, double *B,
+        int ldb, double *X, int ldx, double tol, int restart, double *work)
+//! Restarted GMRES method for @ref STARSH_blrm object.
+/*! Each right hand side has its own Krylov subspace, but all of them are
+ * built simultaneously, so matrix is applied to a block of `nrhs` vectors by
+ * a single execution of a plan, created once by
+ * starsh_blrm_mml_plan_create(). `k`-th basis vectors of all
+ * right hand sides are stored as contiguous `n` by `nrhs` matrix. Total
+ * number of iterations is limited by size of matrix.
+ *
+ * @param[in] matrix: Block-wise low-rank matrix.
+ * @param[in] nrhs: Number of right havd sides.
+ * @param[in] B: Right hand side.
+ * @param[in] ldb: Leading dimension of `B`.
+ * @param[in,out] X: Initial solution as input, total solution as output.
+ * @param[in] ldx: Leading dimension of `X`.
+ * @param[in] tol: Relative error threshold for residual.
+ * @param[in] restart: Size of Krylov subspace before restart.
+ * @param[out] work: Temporary array of size
+ *      `nrhs*((n+restart+1)*(restart+1)+2*restart+1)`.
+ * @return Number of iterations or -1 if not converged or matrix could not
+ *      be prepared for multiplication.
+ * @ingroup solvers
+ * */
+{
+    STARSH_blrm *M = matrix;
+    int n = M->format->problem->shape[0];
+    int ldh = restart+1;
+    size_t ldv = (size_t)n*nrhs;
+    double *V = work;
+    double *H = V+ldv*ldh;
+    double *g = H+(size_t)ldh*restart*nrhs;
+    double *cs = g+(size_t)ldh*nrhs;
+    double *sn = cs+(size_t)restart*nrhs;
+    double *rscheck = sn+(size_t)restart*nrhs;
+    // Length of Arnoldi process of each right hand side in current cycle
+    int length[nrhs], active[nrhs];
+    int iter = 0, result = -1, i, j, k, l;
+    // Plan of multiplication is shared by all iterations
+    STARSH_blrm_mml_plan *plan;
+    if(starsh_blrm_mml_plan_create(&plan, M, nrhs) != STARSH_SUCCESS)
+        return -1;
+    while(1)
+    {
+        // Residuals of current solutions are the first vectors of bases
+        starsh_blrm_mml_plan_execute(plan, nrhs, -1.0, X, ldx, 0.0, V, n);
+        int finished = 0;
+        for(j = 0; j < nrhs; j++)
+        {
+            double *v = V+(size_t)n*j;
+            cblas_daxpy(n, 1., B+(size_t)ldb*j, 1, v, 1);
+            double resid = cblas_dnrm2(n, v, 1);
+            if(iter == 0)
+                rscheck[j] = resid*tol;
+            length[j] = 0;
+            active[j] = resid > rscheck[j];
+            if(active[j] == 0)
+            {
+                finished++;
+                // Zero vector is cheap to be multiplied by matrix
+                for(i = 0; i < n; i++)
+                    v[i] = 0.;
+                continue;
+            }
+            cblas_dscal(n, 1./resid, v, 1);
+            g[(size_t)ldh*j] = resid;
+            for(k = 1; k < ldh; k++)
+                g[(size_t)ldh*j+k] = 0.;
+        }
+        if(finished == nrhs)
+        {
+            result = iter;
+            break;
+        }
+        if(iter >= n)
+            break;
+        // Arnoldi process with modified Gram-Schmidt orthogonalization
+        for(k = 0; k < restart && iter < n && finished < nrhs; k++)
+        {
+            starsh_blrm_mml_plan_execute(plan, nrhs, 1.0, V+ldv*k, n, 0.0,
+                    V+ldv*(k+1), n);
+            iter++;
+            for(j = 0; j < nrhs; j++)
+            {
+                double *w = V+ldv*(k+1)+(size_t)n*j;
+                if(active[j] == 0)
+                {
+                    for(i = 0; i < n; i++)
+                        w[i] = 0.;
+                    continue;
+                }
+                double *h = H+((size_t)restart*j+k)*ldh;
+                double *c = cs+(size_t)restart*j, *s = sn+(size_t)restart*j;
+                double *gj = g+(size_t)ldh*j;
+                for(l = 0; l <= k; l++)
+                {
+                    double *v = V+ldv*l+(size_t)n*j;
+                    h[l] = cblas_ddot(n, v, 1, w, 1);
+                    cblas_daxpy(n, -h[l], v, 1, w, 1);
+                }
+                h[k+1] = cblas_dnrm2(n, w, 1);
+                if(h[k+1] > 0.)
+                    cblas_dscal(n, 1./h[k+1], w, 1);
+                // Apply previous rotations to new column of Hessenberg matrix
+                for(l = 0; l < k; l++)
+                {
+                    double tmp = c[l]*h[l]+s[l]*h[l+1];
+                    h[l+1] = -s[l]*h[l]+c[l]*h[l+1];
+                    h[l] = tmp;
+                }
+                // Annihilate subdiagonal element and update residual
+                dgivens(h[k], h[k+1], c+k, s+k);
+                h[k] = c[k]*h[k]+s[k]*h[k+1];
+                h[k+1] = 0.;
+                gj[k+1] = -s[k]*gj[k];
+                gj[k] = c[k]*gj[k];
+                length[j] = k+1;
+                if(fabs(gj[k+1]) <= rscheck[j])
+                {
+                    active[j] = 0;
+                    finished++;
+                }
+            }
+        }
+        // Update solutions with least squares solutions of small systems
+        for(j = 0; j < nrhs; j++)
+        {
+            if(length[j] == 0)
+                continue;
+            cblas_dtrsv(CblasColMajor, CblasUpper, CblasNoTrans,
+                    CblasNonUnit, length[j], H+(size_t)restart*ldh*j, ldh,
+                    g+(size_t)ldh*j, 1);
+            cblas_dgemv(CblasColMajor, CblasNoTrans, n, length[j], 1.,
+                    V+(size_t)n*j, ldv, g+(size_t)ldh*j, 1, 1.,
+                    X+(size_t)ldx*j, 1);
+        }
+    }
+    starsh_blrm_mml_plan_destroy(plan);
+    return result;
+}
+
+static void zgivens(double _Complex a, double _Complex b, double *c,
+        double _Complex *s)
+//! Complex Givens rotation, that annihilates `b` in vector `(a, b)`.
+{
+    double abs_a = cabs(a), abs_b = cabs(b);
+    double t = sqrt(abs_a*abs_a+abs_b*abs_b);
+    if(t == 0.)
+    {
+        *c = 1.;
+        *s = 0.;
+    }
+    else if(abs_a == 0.)
+    {
+        *c = 0.;
+        *s = conj(b)/abs_b;
+    }
+    else
+    {
+        *c = abs_a/t;
+        *s = a/abs_a*conj(b)/t;
+    }
+}
+
+int starsh_itersolvers__zgmres_omp(STARSH_blrm *matrix, int nrhs,
+        double _Complex *B, int ldb, double _Complex *X, int ldx, double tol,
+        int restart, double _Complex *work)
+//! Restarted GMRES method for complex @ref STARSH_blrm object.
+/*! Right hand sides are solved one by one, each with its own Krylov
+ * subspace. Matrix is applied by starsh_blrm__zmml_omp(). Total number of
+ * iterations for each right hand side is limited by size of matrix.
+ *
+ * @param[in] matrix: Block-wise low-rank matrix.
+ * @param[in] nrhs: Number of right havd sides.
+ * @param[in] B: Right hand side.
+ * @param[in] ldb: Leading dimension of `B`.
+ * @param[in,out] X: Initial solution as input, total solution as output.
+ * @param[in] ldx: Leading dimension of `X`.
+ * @param[in] tol: Relative error threshold for residual.
+ * @param[in] restart: Size of Krylov subspace before restart.
+ * @param[out] work: Temporary array of size
+ *      `n*(restart+1)+(restart+1)*(restart+1)+2*restart`.
+ * @return Maximal number of iterations or -1 if not converged.
+ * @ingroup solvers
+ * */
+{
+    STARSH_blrm *M = matrix;
+    int n = M->format->problem->shape[0];
+    int ldh = restart+1;
+    double _Complex *V = work;
+    double _Complex *H = V+(size_t)n*ldh;
+    double _Complex *g = H+(size_t)ldh*restart;
+    double _Complex *sn = g+ldh;
+    double *cs = (double *)(sn+restart);
+    double _Complex one = 1.0;
+    int i, k, l;
+    int maxiter = 0;
+    for(i = 0; i < nrhs; i++)
+    {
+        double _Complex *b = B+(size_t)ldb*i;
+        double _Complex *x = X+(size_t)ldx*i;
+        double rscheck = -1., resid = 0.;
+        int iter = 0, converged = 0;
+        while(iter < n && converged == 0)
+        {
+            // Residual of current solution is the first vector of basis
+            starsh_blrm__zmml_omp(M, 1, -1.0, x, ldx, 0.0, V, n);
+            cblas_zaxpy(n, &one, b, 1, V, 1);
+            resid = cblas_dznrm2(n, V, 1);
+            if(rscheck < 0)
+                rscheck = resid*tol;
+            if(resid <= rscheck)
+            {
+                converged = 1;
+                break;
+            }
+            cblas_zdscal(n, 1./resid, V, 1);
+            g[0] = resid;
+            for(k = 1; k < ldh; k++)
+                g[k] = 0.;
+            // Arnoldi process with modified Gram-Schmidt orthogonalization
+            for(k = 0; k < restart && iter < n && converged == 0; k++)
+            {
+                double _Complex *h = H+(size_t)ldh*k;
+                double _Complex *w = V+(size_t)n*(k+1);
+                starsh_blrm__zmml_omp(M, 1, 1.0, V+(size_t)n*k, n, 0.0, w,
+                        n);
+                for(l = 0; l <= k; l++)
+                {
+                    double _Complex tmp;
+                    cblas_zdotc_sub(n, V+(size_t)n*l, 1, w, 1, &tmp);
+                    h[l] = tmp;
+                    tmp = -tmp;
+                    cblas_zaxpy(n, &tmp, V+(size_t)n*l, 1, w, 1);
+                }
+                double hnorm = cblas_dznrm2(n, w, 1);
+                h[k+1] = hnorm;
+                if(hnorm > 0.)
+                    cblas_zdscal(n, 1./hnorm, w, 1);
+                // Apply previous rotations to new column of Hessenberg matrix
+                for(l = 0; l < k; l++)
+                {
+                    double _Complex tmp = cs[l]*h[l]+sn[l]*h[l+1];
+                    h[l+1] = -conj(sn[l])*h[l]+cs[l]*h[l+1];
+                    h[l] = tmp;
+                }
+                // Annihilate subdiagonal element and update residual
+                zgivens(h[k], h[k+1], cs+k, sn+k);
+                h[k] = cs[k]*h[k]+sn[k]*h[k+1];
+                h[k+1] = 0.;
+                g[k+1] = -conj(sn[k])*g[k];
+                g[k] = cs[k]*g[k];
+                resid = cabs(g[k+1]);
+                iter++;
+                if(resid <= rscheck)
+                    converged = 1;
+            }
+            // Update solution with least squares solution of small system
+            cblas_ztrsv(CblasColMajor, CblasUpper, CblasNoTrans, CblasNonUnit,
+                    k, H, ldh, g, 1);
+            cblas_zgemv(CblasColMajor, CblasNoTrans, n, k, &one, V, n, g, 1,
+                    &one, x, 1);
+        }
+        if(converged == 0)
+            return -1;
+        if(maxiter < iter)
+            maxiter = iter;
+    }
+    return maxiter;
+}
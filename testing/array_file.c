@@ -0,0 +1,183 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/array_file.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("array_file N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm = 'N', order[2] = {'F', 'C'};
+    int nrhs = 3;
+    int info;
+    int shape[2] = {N, N};
+    STARSH_int shape2[2] = {N, N};
+    const char *filename = "array_file.bin";
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_EXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NU, 0.5,
+            STARSH_SPATIAL_NOISE, 0., STARSH_SPATIAL_PLACE,
+            STARSH_PARTICLES_UNIFORM, 0);
+    if(info != 0)
+        return info;
+    // Dense matrix of spatial statistics problem
+    STARSH_problem *P0;
+    info = starsh_problem_new(&P0, 2, shape2, symm, dtype, data, data,
+            kernel, "Spatial Statistics example");
+    if(info != 0)
+        return info;
+    Array *A;
+    info = starsh_problem_to_array(P0, &A);
+    if(info != 0)
+        return info;
+    starsh_problem_free(P0);
+    // Rows are scaled, so that C and Fortran orders of matrix differ
+    double *A_data = A->data;
+    for(int j = 0; j < N; j++)
+        for(int i = 0; i < N; i++)
+            A_data[j*(size_t)N+i] *= 1.+(double)i/N;
+    // Dense right hand sides and results
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs, N, 1.0,
+            A_data, N, x, N, 0.0, y_ref, N);
+    // Rows and columns of a block, that are contiguous or not
+    int nrows = N/2, ncols = N/3, ld = N/2+3;
+    STARSH_int *irow = malloc(nrows*sizeof(*irow));
+    STARSH_int *icol = malloc(ncols*sizeof(*icol));
+    double *B = malloc(ld*(size_t)ncols*sizeof(*B));
+    for(int o = 0; o < 2; o++)
+    {
+        // Write matrix into a file in a given order and map it back
+        FILE *fp = fopen(filename, "wb");
+        if(fp == NULL)
+        {
+            printf("Failed to create file\n");
+            return 1;
+        }
+        if(order[o] == 'F')
+            fwrite(A_data, sizeof(*A_data), N*(size_t)N, fp);
+        else
+            for(int i = 0; i < N; i++)
+                for(int j = 0; j < N; j++)
+                    fwrite(A_data+j*(size_t)N+i, sizeof(*A_data), 1, fp);
+        fclose(fp);
+        Array *A_file;
+        info = array_from_file(&A_file, 2, shape, dtype, order[o], filename);
+        if(info != 0)
+            return info;
+        if(!A_file->mapped)
+        {
+            printf("Array is not mapped from file\n");
+            return 1;
+        }
+        STARSH_problem *P;
+        info = starsh_problem_from_array(&P, A_file, symm);
+        if(info != 0)
+            return info;
+        starsh_problem_info(P);
+        // Blocks are compared with dense matrix entry by entry
+        for(int contiguous = 0; contiguous < 4; contiguous++)
+        {
+            for(int i = 0; i < nrows; i++)
+                irow[i] = contiguous & 1 ? N/4+i : N-1-2*i;
+            for(int j = 0; j < ncols; j++)
+                icol[j] = contiguous & 2 ? N/5+j : (3*j) % N;
+            P->kernel(nrows, ncols, irow, icol, P->row_data, P->col_data, B,
+                    ld);
+            for(int j = 0; j < ncols; j++)
+                for(int i = 0; i < nrows; i++)
+                    if(B[j*(size_t)ld+i] != A_data[icol[j]*(size_t)N+irow[i]])
+                    {
+                        printf("ORDER=%c CONTIGUOUS=%d: wrong block\n",
+                                order[o], contiguous);
+                        return 1;
+                    }
+        }
+        // Init plain clusterization, tlr division into admissible blocks
+        // and approximate them
+        STARSH_cluster *C;
+        info = starsh_cluster_new_plain(&C, A_file, N, block_size);
+        if(info != 0)
+            return info;
+        STARSH_blrf *F;
+        STARSH_blrm *M;
+        info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+        if(info != 0)
+            return info;
+        info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        starsh_blrm_info(M);
+        info = starsh_blrm__dmml_omp(M, nrhs, 1.0, x, N, 0.0, y, N);
+        if(info != 0)
+            return info;
+        double rel_err = rel_diff(N*nrhs, y, y_ref);
+        printf("ORDER=%c RELATIVE ERROR OF MATVEC: %e\n", order[o], rel_err);
+        if(rel_err/tol > 10.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        starsh_blrm_free(M);
+        starsh_blrf_free(F);
+        starsh_cluster_free(C);
+        starsh_problem_free(P);
+        array_free(A_file);
+    }
+    remove(filename);
+    array_free(A);
+    free(x);
+    free(y);
+    free(y_ref);
+    free(irow);
+    free(icol);
+    free(B);
+    return 0;
+}
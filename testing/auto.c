@@ -0,0 +1,156 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/auto.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+static int check_select(int nrows, int maxrank, double rank,
+        double kernel_cost, int engine)
+// Check engine, chosen for a square tile with given costs
+{
+    int chosen = starsh_blrm__dauto_select(nrows, nrows, maxrank, 10, rank,
+            kernel_cost, 1e-9);
+    printf("TILE=%d KERNEL_COST=%e ENGINE=%d (EXPECTED %d)\n", nrows,
+            kernel_cost, chosen, engine);
+    return chosen != engine;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("auto N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm = 'N';
+    int ndim = 2, nrhs = 3;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    // Small tiles are compressed by SVD, large ones by randomized SVD and
+    // tiles with expensive kernel by cross approximation
+    if(check_select(20, 10, 5., 1e-9, STARSH_LRENGINE_DCSVD)
+            || check_select(1000, 10, 5., 1e-9, STARSH_LRENGINE_RSVD)
+            || check_select(1000, 10, 5., 1e-3, STARSH_LRENGINE_CROSS))
+    {
+        printf("Wrong low-rank engine is chosen\n");
+        return 1;
+    }
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_EXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NU, 0.5,
+            STARSH_SPATIAL_NOISE, 0., STARSH_SPATIAL_PLACE,
+            STARSH_PARTICLES_UNIFORM, 0);
+    if(info != 0)
+        return info;
+    // Dense right hand sides and results
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+    // Init problem with given data and kernel and print short info
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Spatial Statistics example");
+    if(info != 0)
+        return info;
+    starsh_problem_info(P);
+    // Reference result is computed with dense matrix
+    Array *A;
+    info = starsh_problem_to_array(P, &A);
+    if(info != 0)
+        return info;
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs, N, 1.0,
+            A->data, N, x, N, 0.0, y_ref, N);
+    array_free(A);
+    // Init plain clusterization and tlr division into admissible blocks
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    // Approximate with sequential and OpenMP backends
+    for(int backend = 0; backend < 2; backend++)
+    {
+        STARSH_blrm *M;
+        if(backend)
+            info = starsh_blrm__dauto_omp(&M, F, maxrank, tol, onfly);
+        else
+            info = starsh_blrm__dauto(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        starsh_blrm_info(M);
+        // Tiles are small, so at least some of them shall not be compressed
+        // by randomized SVD
+        STARSH_int nother = 0;
+        for(STARSH_int bi = 0; bi < F->nblocks_far; bi++)
+            if(M->far_engine[bi] != STARSH_LRENGINE_RSVD)
+                nother++;
+        printf("BACKEND=%d TILES NOT COMPRESSED BY RSVD: %zu\n", backend,
+                (size_t)nother);
+        if(nother == 0)
+        {
+            printf("Only randomized SVD was chosen\n");
+            return 1;
+        }
+        info = starsh_blrm__dmml_omp(M, nrhs, 1.0, x, N, 0.0, y, N);
+        if(info != 0)
+            return info;
+        double rel_err = rel_diff(N*nrhs, y, y_ref);
+        printf("BACKEND=%d RELATIVE ERROR OF MATVEC: %e\n", backend, rel_err);
+        if(rel_err/tol > 10.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        starsh_blrm_free(M);
+    }
+    starsh_blrf_free(F);
+    starsh_problem_free(P);
+    free(x);
+    free(y);
+    free(y_ref);
+    return 0;
+}
@@ -0,0 +1,242 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/blrm2.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+// Columns of the first block column are scaled by the following kernel, so
+// that far-field blocks of each block row have very different norms
+static STARSH_kernel *base_kernel;
+static STARSH_int scaled_ncols;
+
+static void scaled_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+{
+    double *A = result;
+    base_kernel(nrows, ncols, irow, icol, row_data, col_data, result, ld);
+    for(int j = 0; j < ncols; j++)
+        if(icol[j] < scaled_ncols)
+            cblas_dscal(nrows, 1e6, A+j*(size_t)ld, 1);
+}
+
+static double max_block_err(STARSH_blrm2 *M2, STARSH_kernel *kernel,
+        void *data)
+// Maximal relative error of far-field blocks of a matrix with shared bases
+{
+    STARSH_blrf *F = M2->format;
+    STARSH_cluster *R = F->row_cluster, *C = F->col_cluster;
+    double max_err = 0.;
+    for(STARSH_int bi = 0; bi < F->nblocks_far; bi++)
+    {
+        STARSH_int i = F->block_far[2*bi];
+        STARSH_int j = F->block_far[2*bi+1];
+        int nrows = R->size[i], ncols = C->size[j];
+        int krow = M2->row_rank[i], kcol = M2->col_rank[j];
+        double *D = malloc(sizeof(*D)*nrows*ncols);
+        kernel(nrows, ncols, R->pivot+R->start[i], C->pivot+C->start[j],
+                data, data, D, nrows);
+        double norm = cblas_dnrm2(nrows*ncols, D, 1);
+        if(M2->far_S[bi] != NULL)
+        {
+            double *tmp = malloc(sizeof(*tmp)*nrows*kcol);
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows,
+                    kcol, krow, 1.0, M2->row_basis[i], nrows, M2->far_S[bi],
+                    krow, 0.0, tmp, nrows);
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, ncols,
+                    kcol, -1.0, tmp, nrows, M2->col_basis[j], ncols, 1.0, D,
+                    nrows);
+            free(tmp);
+        }
+        else if(M2->far_U[bi] != NULL)
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, ncols,
+                    M2->far_rank[bi], -1.0, M2->far_U[bi], nrows,
+                    M2->far_V[bi], ncols, 1.0, D, nrows);
+        double err = cblas_dnrm2(nrows*ncols, D, 1)/norm;
+        if(err > max_err)
+            max_err = err;
+        free(D);
+    }
+    return max_err;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("blrm2 N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm[2] = {'N', 'S'};
+    int ndim = 2, nrhs = 3;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_EXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NU, 0.5,
+            STARSH_SPATIAL_NOISE, 0., STARSH_SPATIAL_PLACE,
+            STARSH_PARTICLES_UNIFORM, 0);
+    if(info != 0)
+        return info;
+    // Dense right hand sides and results
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+    // Init plain clusterization
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    // Multiply nonsymmetric and symmetric matrices by the same plans
+    for(int s = 0; s < 2; s++)
+    {
+        // Init problem with given data and kernel and print short info
+        STARSH_problem *P;
+        info = starsh_problem_new(&P, ndim, shape, symm[s], dtype, data, data,
+                kernel, "Spatial Statistics example");
+        if(info != 0)
+            return info;
+        starsh_problem_info(P);
+        // Reference result is computed with dense matrix
+        Array *A;
+        info = starsh_problem_to_array(P, &A);
+        if(info != 0)
+            return info;
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs, N,
+                1.0, A->data, N, x, N, 0.0, y_ref, N);
+        array_free(A);
+        // Init tlr division into admissible blocks and approximate them
+        STARSH_blrf *F;
+        STARSH_blrm *M;
+        info = starsh_blrf_new_tlr(&F, P, symm[s], C, C);
+        if(info != 0)
+            return info;
+        info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        starsh_blrm_info(M);
+        // Recompress into shared bases
+        STARSH_blrm2 *M2;
+        info = starsh_blrm__dshared(&M2, M, tol);
+        if(info != 0)
+            return info;
+        starsh_blrm2_info(M2);
+        // Memory of low-rank factors and dense blocks of initial matrix
+        size_t nbytes = 0;
+        for(STARSH_int bi = 0; bi < F->nblocks_far; bi++)
+            nbytes += (size_t)M->far_rank[bi]*
+                (C->size[F->block_far[2*bi]]+C->size[F->block_far[2*bi+1]]);
+        for(STARSH_int bi = 0; bi < F->nblocks_near; bi++)
+            nbytes += (size_t)C->size[F->block_near[2*bi]]*
+                C->size[F->block_near[2*bi+1]];
+        nbytes *= sizeof(double);
+        printf("SYMM=%c MEMORY OF FACTORS: %f MB, SHARED BASES: %f MB\n",
+                symm[s], nbytes/1024./1024., M2->data_nbytes/1024./1024.);
+        if(M2->data_nbytes > nbytes)
+        {
+            printf("Shared bases take more memory than initial matrix\n");
+            return 1;
+        }
+        // Sequential and OpenMP multiplication
+        for(int omp = 0; omp < 2; omp++)
+        {
+            cblas_dscal(N*nrhs, 0.0, y, 1);
+            if(omp)
+                info = starsh_blrm2__dmml_omp(M2, nrhs, 1.0, x, N, 0.0, y, N);
+            else
+                info = starsh_blrm2__dmml(M2, nrhs, 1.0, x, N, 0.0, y, N);
+            if(info != 0)
+                return info;
+            double rel_err = rel_diff(N*nrhs, y, y_ref);
+            printf("SYMM=%c OMP=%d RELATIVE ERROR OF MATVEC: %e\n", symm[s],
+                    omp, rel_err);
+            if(rel_err/tol > 10.)
+            {
+                printf("Resulting relative error is too big\n");
+                return 1;
+            }
+        }
+        starsh_blrm2_free(M2);
+        starsh_blrm_free(M);
+        starsh_blrf_free(F);
+        starsh_problem_free(P);
+    }
+    // Bases must keep relative accuracy of each far-field block, even if
+    // norms of blocks of the same block row are very different
+    base_kernel = kernel;
+    scaled_ncols = C->size[0];
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, 'N', dtype, data, data,
+            scaled_kernel, "Spatial Statistics example with scaled columns");
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    STARSH_blrm2 *M2;
+    info = starsh_blrf_new_tlr(&F, P, 'N', C, C);
+    if(info != 0)
+        return info;
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+        return info;
+    info = starsh_blrm__dshared(&M2, M, tol);
+    if(info != 0)
+        return info;
+    starsh_blrm2_info(M2);
+    double max_err = max_block_err(M2, scaled_kernel, data);
+    printf("MAXIMAL RELATIVE ERROR OF SCALED BLOCKS: %e\n", max_err);
+    if(max_err/tol > 10.)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    starsh_blrm2_free(M2);
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    starsh_problem_free(P);
+    free(x);
+    free(y);
+    free(y_ref);
+    return 0;
+}
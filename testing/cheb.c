@@ -0,0 +1,115 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/cheb.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+int main(int argc, char **argv)
+{
+    if(argc != 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("cheb N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char symm = 'N', dtype = 'd';
+    int ndim = 2;
+    STARSH_int shape[2] = {N, N};
+    STARSH_int bi, nblocks_far;
+    int info, max_rank = 0;
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    info = starsh_set_lrengine("CHEB");
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem with smooth kernel
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_SQREXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NOISE, 0.,
+            STARSH_SPATIAL_PLACE, STARSH_PARTICLES_RAND, 0);
+    if(info != 0)
+        return info;
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Spatial Statistics example");
+    if(info != 0)
+        return info;
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    // Interpolation is impossible without geometry of clusters
+    if(starsh_blrm_approximate(&M, F, maxrank, tol, onfly) == 0)
+    {
+        printf("Matrix was approximated without geometry of clusters\n");
+        return 1;
+    }
+    info = starsh_cluster_set_geometry(C, data->particles.ndim,
+            data->particles.point);
+    if(info != 0)
+        return info;
+    nblocks_far = F->nblocks_far;
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+        return info;
+    starsh_blrf_info(F);
+    starsh_blrm_info(M);
+    // Tolerance is loose enough for far-field blocks to be low-rank
+    if(F->nblocks_far < nblocks_far/2)
+    {
+        printf("Too many far-field blocks are stored as dense blocks\n");
+        return 1;
+    }
+    for(bi = 0; bi < F->nblocks_far; bi++)
+        if(M->far_rank[bi] > max_rank)
+            max_rank = M->far_rank[bi];
+    printf("MAXIMUM RANK: %d\n", max_rank);
+    if(max_rank > maxrank || 2*max_rank > block_size)
+    {
+        printf("Ranks of far-field blocks are too big\n");
+        return 1;
+    }
+    double rel_err = starsh_blrm__dfe_omp(M);
+    printf("RELATIVE ERROR: %e\n", rel_err);
+    if(rel_err/tol > 10.)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    starsh_cluster_free(C);
+    starsh_problem_free(P);
+    return 0;
+}
@@ -0,0 +1,167 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/complex.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <complex.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-particles.h>
+
+// Parameters of complex kernel
+static const double beta = 0.1, wave = 20., shift = 10.;
+
+static void helmholtz_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+// Damped Helmholtz kernel exp(-r/beta)*exp(i*wave*r) on particles in 2D
+// with shift of diagonal
+{
+    STARSH_particles *data1 = row_data, *data2 = col_data;
+    double *x1 = data1->point, *y1 = x1+data1->count;
+    double *x2 = data2->point, *y2 = x2+data2->count;
+    double _Complex *buffer = result;
+    for(int j = 0; j < ncols; j++)
+        for(int i = 0; i < nrows; i++)
+        {
+            double dx = x1[irow[i]]-x2[icol[j]];
+            double dy = y1[irow[i]]-y2[icol[j]];
+            double dist = sqrt(dx*dx+dy*dy);
+            buffer[j*(size_t)ld+i] = exp(-dist/beta)*cexp(I*wave*dist);
+            if(dist == 0.)
+                buffer[j*(size_t)ld+i] += shift;
+        }
+}
+
+static double rel_diff(int n, double _Complex *y, double _Complex *y_ref)
+// Relative difference of two vectors
+{
+    double _Complex minus_one = -1.0;
+    double norm = cblas_dznrm2(n, y_ref, 1);
+    cblas_zaxpy(n, &minus_one, y_ref, 1, y, 1);
+    return cblas_dznrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("complex N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'z', symm[2] = {'N', 'S'};
+    int ndim = 2, nrhs = 2, restart = 50;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    double _Complex one = 1.0, zero = 0.0;
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate particles in 2D
+    STARSH_particles *data;
+    info = starsh_particles_generate(&data, N, 2, STARSH_PARTICLES_UNIFORM);
+    if(info != 0)
+        return info;
+    // Dense right hand sides, results and solutions
+    double _Complex *x = malloc(N*nrhs*sizeof(*x));
+    double _Complex *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    double _Complex *y = malloc(N*nrhs*sizeof(*y));
+    double _Complex *work = malloc((N*(restart+1)+(restart+1)*(restart+1)
+                +2*restart)*sizeof(*work));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_zlarnv_work(2, iseed, N*nrhs, x);
+    // Init plain clusterization
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    for(int s = 0; s < 2; s++)
+    {
+        // Init problem with given data and kernel and print short info
+        STARSH_problem *P;
+        info = starsh_problem_new(&P, ndim, shape, symm[s], dtype, data, data,
+                helmholtz_kernel, "Damped Helmholtz example");
+        if(info != 0)
+            return info;
+        starsh_problem_info(P);
+        // Reference result is computed with dense matrix
+        Array *A;
+        info = starsh_problem_to_array(P, &A);
+        if(info != 0)
+            return info;
+        cblas_zgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs, N,
+                &one, A->data, N, x, N, &zero, y_ref, N);
+        // Init tlr division into admissible blocks and approximate them
+        STARSH_blrf *F;
+        STARSH_blrm *M;
+        info = starsh_blrf_new_tlr(&F, P, symm[s], C, C);
+        if(info != 0)
+            return info;
+        info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        starsh_blrm_info(M);
+        // Check matrix-vector product
+        info = starsh_blrm__zmml_omp(M, nrhs, 1.0, x, N, 0.0, y, N);
+        if(info != 0)
+            return info;
+        double rel_err = rel_diff(N*nrhs, y, y_ref);
+        printf("SYMM=%c RELATIVE ERROR OF MATVEC: %e\n", symm[s], rel_err);
+        if(rel_err/tol > 10.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        // Solve system with results of dense product as right hand sides
+        // and check residual with dense matrix
+        for(int i = 0; i < N*nrhs; i++)
+            y[i] = 0.;
+        int iter = starsh_itersolvers__zgmres_omp(M, nrhs, y_ref, N, y, N,
+                tol, restart, work);
+        printf("SYMM=%c GMRES ITERATIONS: %d\n", symm[s], iter);
+        if(iter < 0)
+        {
+            printf("GMRES did not converge\n");
+            return 1;
+        }
+        rel_err = rel_diff(N*nrhs, y, x);
+        printf("SYMM=%c RELATIVE ERROR OF SOLUTION: %e\n", symm[s], rel_err);
+        if(rel_err/tol > 100.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        array_free(A);
+        starsh_blrm_free(M);
+        starsh_blrf_free(F);
+        starsh_problem_free(P);
+    }
+    free(x);
+    free(y);
+    free(y_ref);
+    free(work);
+    return 0;
+}
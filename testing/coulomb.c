@@ -0,0 +1,157 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/coulomb.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <starsh.h>
+#include <starsh-electrostatics.h>
+
+// SIMD kernels for static dimensionalities 1, 2, 3 and 4
+static STARSH_kernel *kernel_simd[4] =
+{
+    starsh_esdata_block_coulomb_potential_kernel_1d_simd,
+    starsh_esdata_block_coulomb_potential_kernel_2d_simd,
+    starsh_esdata_block_coulomb_potential_kernel_3d_simd,
+    starsh_esdata_block_coulomb_potential_kernel_4d_simd
+};
+
+static double max_rel_diff(int nrows, int ncols, double *A, double *A_ref,
+        int ld)
+// Maximum relative difference of entries of two matrices. Zero entries
+// must be exact zeros in both matrices
+{
+    double max_err = 0.;
+    for(int j = 0; j < ncols; j++)
+        for(int i = 0; i < nrows; i++)
+        {
+            double a = A[j*(size_t)ld+i], a_ref = A_ref[j*(size_t)ld+i];
+            if(a_ref == 0. || a == 0.)
+            {
+                if(a != a_ref)
+                    return INFINITY;
+                continue;
+            }
+            double err = fabs(a-a_ref)/fabs(a_ref);
+            if(err > max_err)
+                max_err = err;
+        }
+    return max_err;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 3)
+    {
+        printf("%d arguments provided, but 2 are needed\n", argc-1);
+        printf("coulomb N tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]);
+    double tol = atof(argv[2]);
+    int info;
+    // Rows are taken in reversed order and columns contain repeated indexes,
+    // so that rows are gathered by several chunks and zero distances appear
+    // not only on the diagonal
+    int nrows = N, ncols = N/2, ld = N+3;
+    STARSH_int *irow = malloc(nrows*sizeof(*irow));
+    STARSH_int *icol = malloc(ncols*sizeof(*icol));
+    double *A = malloc(ld*(size_t)ncols*sizeof(*A));
+    double *A_ref = malloc(ld*(size_t)ncols*sizeof(*A_ref));
+    for(int i = 0; i < nrows; i++)
+        irow[i] = N-1-i;
+    for(int j = 0; j < ncols; j++)
+        icol[j] = (3*j) % N;
+    srand(0);
+    // Reciprocal square root of SIMD kernels is checked on a wide range of
+    // magnitudes by distances in 1d from a point at origin to points from
+    // 1e-150 to 1e150, including the origin itself
+    double *point = malloc(N*sizeof(*point));
+    point[0] = 0.;
+    for(int i = 1; i < N; i++)
+        point[i] = (1.+(double)rand()/RAND_MAX)*pow(10., rand()%301-150);
+    STARSH_esdata *data1;
+    info = starsh_particles_init(&data1, N, 1, point);
+    if(info != 0)
+        return info;
+    for(int i = 0; i < N; i++)
+        A_ref[i] = point[i] == 0. ? 0. : 1./sqrt(point[i]*point[i]);
+    for(int nd = 0; nd < 2; nd++)
+    {
+        STARSH_int origin = 0;
+        if(nd)
+            starsh_esdata_block_coulomb_potential_kernel_nd_simd(N, 1, irow,
+                    &origin, data1, data1, A, N);
+        else
+            starsh_esdata_block_coulomb_potential_kernel_1d_simd(N, 1, irow,
+                    &origin, data1, data1, A, N);
+        // Rows are in reversed order
+        for(int i = 0; i < N/2; i++)
+        {
+            double tmp = A[i];
+            A[i] = A[N-1-i];
+            A[N-1-i] = tmp;
+        }
+        double err = max_rel_diff(N, 1, A, A_ref, N);
+        printf("ND=%d MAXIMUM RELATIVE ERROR OF RSQRT: %e\n", nd, err);
+        if(err > tol)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+    }
+    starsh_esdata_free(data1);
+    for(int ndim = 1; ndim <= 4; ndim++)
+    {
+        STARSH_esdata *data;
+        info = starsh_esdata_generate(&data, N, ndim,
+                STARSH_PARTICLES_UNIFORM);
+        if(info != 0)
+            return info;
+        // Reference values are computed directly and compared with SIMD
+        // kernels for static and dynamic dimensionality
+        for(int j = 0; j < ncols; j++)
+            for(int i = 0; i < nrows; i++)
+            {
+                double dist = 0.;
+                for(int k = 0; k < ndim; k++)
+                {
+                    double tmp = data->point[k*N+irow[i]]-
+                        data->point[k*N+icol[j]];
+                    dist += tmp*tmp;
+                }
+                A_ref[j*(size_t)ld+i] = dist == 0. ? 0. : 1./sqrt(dist);
+            }
+        for(int nd = 0; nd < 2; nd++)
+        {
+            if(nd)
+                starsh_esdata_block_coulomb_potential_kernel_nd_simd(nrows,
+                        ncols, irow, icol, data, data, A, ld);
+            else
+                kernel_simd[ndim-1](nrows, ncols, irow, icol, data, data, A,
+                        ld);
+            double err = max_rel_diff(nrows, ncols, A, A_ref, ld);
+            printf("NDIM=%d ND=%d MAXIMUM RELATIVE ERROR: %e\n", ndim, nd,
+                    err);
+            if(err > tol)
+            {
+                printf("Resulting relative error is too big\n");
+                return 1;
+            }
+        }
+        starsh_esdata_free(data);
+    }
+    free(irow);
+    free(icol);
+    free(A);
+    free(A_ref);
+    return 0;
+}
@@ -0,0 +1,122 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/false_far.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+int main(int argc, char **argv)
+{
+    if(argc != 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("false_far N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char symm = 'N', dtype = 'd';
+    int ndim = 2;
+    STARSH_int shape[2] = {N, N};
+    STARSH_int bi, nblocks_near;
+    int info;
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_EXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NOISE, 0.,
+            STARSH_SPATIAL_PLACE, STARSH_PARTICLES_UNIFORM, 0);
+    if(info != 0)
+        return info;
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Spatial Statistics example");
+    if(info != 0)
+        return info;
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    nblocks_near = F->nblocks_near;
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+        return info;
+    starsh_blrf_info(F);
+    starsh_blrm_info(M);
+    // Small maximum rank makes some far-field blocks dense
+    if(F->nblocks_near == nblocks_near || F->nblocks_far == 0)
+    {
+        printf("Expected both far-field and false far-field blocks\n");
+        return 1;
+    }
+    // Dense blocks, computed during approximation, are kept as they are
+    if(M->alloc_type != '3' || M->alloc_D != NULL)
+    {
+        printf("Dense blocks are not kept in separate buffers\n");
+        return 1;
+    }
+    // Each dense block must be equal to the corresponding block of matrix
+    double *D = malloc(sizeof(*D)*block_size*block_size);
+    for(bi = 0; bi < F->nblocks_near; bi++)
+    {
+        STARSH_int i = F->block_near[2*bi];
+        STARSH_int j = F->block_near[2*bi+1];
+        int nrows = C->size[i], ncols = C->size[j];
+        if(M->near_D[bi]->shape[0] != nrows ||
+                M->near_D[bi]->shape[1] != ncols)
+        {
+            printf("Wrong shape of near-field block %zd\n", bi);
+            return 1;
+        }
+        kernel(nrows, ncols, C->pivot+C->start[i], C->pivot+C->start[j],
+                data, data, D, nrows);
+        if(memcmp(D, M->near_D[bi]->data, M->near_D[bi]->data_nbytes) != 0)
+        {
+            printf("Near-field block %zd is wrong\n", bi);
+            return 1;
+        }
+    }
+    free(D);
+    double rel_err = starsh_blrm__dfe_omp(M);
+    printf("RELATIVE ERROR: %e\n", rel_err);
+    if(rel_err/tol > 10.)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    starsh_cluster_free(C);
+    starsh_problem_free(P);
+    return 0;
+}
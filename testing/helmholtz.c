@@ -0,0 +1,154 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/helmholtz.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <starsh.h>
+#include <starsh-electrodynamics.h>
+
+// Complex kernels for static and dynamic dimensionality
+static STARSH_kernel *kernel_exp[2][2] =
+{
+    {
+        starsh_eddata_block_exp_kernel_3d,
+        starsh_eddata_block_exp_kernel_nd
+    },
+    {
+        starsh_eddata_block_exp_kernel_3d_simd,
+        starsh_eddata_block_exp_kernel_nd_simd
+    }
+};
+
+// Kernels with sin and cos outputs for static and dynamic dimensionality
+static STARSH_kernel *kernel_sincos[2] =
+{
+    starsh_eddata_block_sincos_kernel_3d_simd,
+    starsh_eddata_block_sincos_kernel_nd_simd
+};
+
+int main(int argc, char **argv)
+{
+    if(argc < 3)
+    {
+        printf("%d arguments provided, but 2 are needed\n", argc-1);
+        printf("helmholtz N tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]);
+    double tol = atof(argv[2]);
+    int ndim = 3, info;
+    // Wave numbers for plain and slow path of range reduction
+    double wave_k[3] = {20., 1e5, 1e8};
+    // All the particles are columns and rows are taken in reversed order
+    STARSH_int *irow = malloc(N*sizeof(*irow));
+    STARSH_int *icol = malloc(N*sizeof(*icol));
+    double *A_sin = malloc(N*(size_t)N*sizeof(*A_sin));
+    double *A_cos = malloc(N*(size_t)N*sizeof(*A_cos));
+    double *A = malloc(2*N*(size_t)N*sizeof(*A));
+    // Rows of scalar problem, made of sin and cos outputs of the same points
+    STARSH_int *irow2 = malloc(2*N*sizeof(*irow2));
+    for(int i = 0; i < N; i++)
+    {
+        irow[i] = N-1-i;
+        icol[i] = i;
+        irow2[2*i] = 2*irow[i];
+        irow2[2*i+1] = 2*irow[i]+1;
+    }
+    srand(0);
+    STARSH_eddata *data;
+    info = starsh_eddata_generate(&data, N, ndim, wave_k[0], N,
+            STARSH_PARTICLES_UNIFORM);
+    if(info != 0)
+        return info;
+    for(int w = 0; w < 3; w++)
+    {
+        data->k = wave_k[w];
+        // Real and imaginary parts of exp(ikr)/r are cos(kr)/r and sin(kr)/r
+        starsh_eddata_block_sin_kernel_3d(N, N, irow, icol, data, data, A_sin,
+                N);
+        starsh_eddata_block_cos_kernel_3d(N, N, irow, icol, data, data, A_cos,
+                N);
+        for(int simd = 0; simd < 2; simd++)
+            for(int nd = 0; nd < 2; nd++)
+            {
+                kernel_exp[simd][nd](N, N, irow, icol, data, data, A, N);
+                double diff = 0., norm = 0.;
+                int wrong_diag = 0;
+                for(size_t l = 0; l < N*(size_t)N; l++)
+                {
+                    // Limit of sin(kr)/r for zero distance is k, so entries
+                    // with zero distance are checked separately
+                    if(irow[l%N] == icol[l/N])
+                    {
+                        if(A[2*l] != data->diag || A[2*l+1] != wave_k[w])
+                            wrong_diag = 1;
+                        continue;
+                    }
+                    double re = A[2*l]-A_cos[l], im = A[2*l+1]-A_sin[l];
+                    diff += re*re+im*im;
+                    norm += A_cos[l]*A_cos[l]+A_sin[l]*A_sin[l];
+                }
+                double rel_err = sqrt(diff/norm);
+                if(wrong_diag)
+                {
+                    printf("Wrong entries for zero distance\n");
+                    return 1;
+                }
+                printf("K=%e SIMD=%d ND=%d RELATIVE ERROR: %e\n", wave_k[w],
+                        simd, nd, rel_err);
+                if(rel_err > tol)
+                {
+                    printf("Resulting relative error is too big\n");
+                    return 1;
+                }
+            }
+        // Kernels with two outputs are used through a tensor problem
+        STARSH_int shape[3] = {N, 2, N};
+        for(int nd = 0; nd < 2; nd++)
+        {
+            STARSH_problem *T, *P;
+            info = starsh_problem_new(&T, 3, shape, 'N', 'd', data, data,
+                    kernel_sincos[nd], "Helmholtz sin and cos");
+            if(info != 0)
+                return info;
+            info = starsh_problem_from_tensor(&P, T);
+            if(info != 0)
+                return info;
+            P->kernel(2*N, N, irow2, icol, P->row_data, P->col_data, A, 2*N);
+            double diff = 0., norm = 0.;
+            for(size_t l = 0; l < N*(size_t)N; l++)
+            {
+                double ds = A[2*l]-A_sin[l], dc = A[2*l+1]-A_cos[l];
+                diff += ds*ds+dc*dc;
+                norm += A_sin[l]*A_sin[l]+A_cos[l]*A_cos[l];
+            }
+            double rel_err = sqrt(diff/norm);
+            printf("K=%e SINCOS ND=%d RELATIVE ERROR: %e\n", wave_k[w], nd,
+                    rel_err);
+            if(rel_err > tol)
+            {
+                printf("Resulting relative error is too big\n");
+                return 1;
+            }
+            starsh_problem_free(P);
+            starsh_problem_free(T);
+        }
+    }
+    starsh_eddata_free(data);
+    free(irow);
+    free(icol);
+    free(irow2);
+    free(A_sin);
+    free(A_cos);
+    free(A);
+    return 0;
+}
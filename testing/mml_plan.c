@@ -0,0 +1,168 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/mml_plan.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("mml_plan N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm[2] = {'N', 'S'};
+    int ndim = 2, nrhs = 3;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_EXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NU, 0.5,
+            STARSH_SPATIAL_NOISE, 0., STARSH_SPATIAL_PLACE,
+            STARSH_PARTICLES_UNIFORM, 0);
+    if(info != 0)
+        return info;
+    // Dense right hand sides and results
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+    // Init plain clusterization
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    // Multiply nonsymmetric and symmetric matrices by the same plans
+    for(int s = 0; s < 2; s++)
+    {
+        // Init problem with given data and kernel and print short info
+        STARSH_problem *P;
+        info = starsh_problem_new(&P, ndim, shape, symm[s], dtype, data, data,
+                kernel, "Spatial Statistics example");
+        if(info != 0)
+            return info;
+        starsh_problem_info(P);
+        // Reference result is computed with dense matrix
+        Array *A;
+        info = starsh_problem_to_array(P, &A);
+        if(info != 0)
+            return info;
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs, N,
+                1.0, A->data, N, x, N, 0.0, y_ref, N);
+        array_free(A);
+        // Init tlr division into admissible blocks and approximate them
+        STARSH_blrf *F;
+        STARSH_blrm *M;
+        info = starsh_blrf_new_tlr(&F, P, symm[s], C, C);
+        if(info != 0)
+            return info;
+        info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        starsh_blrm_info(M);
+        // Plain plan and plan with panels of low-rank factors
+        for(int panel = 0; panel < 2; panel++)
+        {
+            STARSH_blrm_mml_plan *plan;
+            if(panel)
+                info = starsh_blrm_mml_plan_create_panel(&plan, M, nrhs);
+            else
+                info = starsh_blrm_mml_plan_create(&plan, M, nrhs);
+            if(info != 0)
+                return info;
+            // Panels point at low-rank factors of the matrix
+            if(panel && M->far_skel == NULL)
+                for(STARSH_int bi = 0; bi < M->format->nblocks_far; bi++)
+                    if(plan->far_V[bi] != M->far_V[bi]->data)
+                    {
+                        printf("Low-rank factors are copied into panels\n");
+                        return 1;
+                    }
+            // Plan is executed twice to check it is reusable
+            for(int iter = 0; iter < 2; iter++)
+            {
+                cblas_dscal(N*nrhs, 0.0, y, 1);
+                info = starsh_blrm_mml_plan_execute(plan, nrhs, 1.0, x, N,
+                        0.0, y, N);
+                if(info != 0)
+                    return info;
+                double rel_err = rel_diff(N*nrhs, y, y_ref);
+                printf("SYMM=%c PANEL=%d RELATIVE ERROR OF MATVEC: %e\n",
+                        symm[s], panel, rel_err);
+                if(rel_err/tol > 10.)
+                {
+                    printf("Resulting relative error is too big\n");
+                    return 1;
+                }
+            }
+            starsh_blrm_mml_plan_destroy(plan);
+        }
+        // Concurrent calls of starsh_blrm__dmml_omp() with the same matrix
+        // use their own temporary buffers
+        double *y2 = malloc(N*nrhs*sizeof(*y2));
+        int info2[2];
+        #pragma omp parallel for num_threads(2)
+        for(int t = 0; t < 2; t++)
+            info2[t] = starsh_blrm__dmml_omp(M, t ? nrhs : 1, 1.0, x, N, 0.0,
+                    t ? y2 : y, N);
+        if(info2[0] != 0 || info2[1] != 0)
+            return 1;
+        double rel_err = rel_diff(N, y, y_ref);
+        double rel_err2 = rel_diff(N*nrhs, y2, y_ref);
+        printf("SYMM=%c CONCURRENT RELATIVE ERRORS OF MATVEC: %e %e\n",
+                symm[s], rel_err, rel_err2);
+        if(rel_err/tol > 10. || rel_err2/tol > 10.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        free(y2);
+        starsh_blrm_free(M);
+        starsh_blrf_free(F);
+        starsh_problem_free(P);
+    }
+    free(x);
+    free(y);
+    free(y_ref);
+    return 0;
+}
@@ -0,0 +1,150 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/mpi_trans.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpi.h>
+#include <starsh.h>
+#include <starsh-mpi.h>
+#include <starsh-cauchy.h>
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+    int mpi_size, mpi_rank;
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    if(argc < 5)
+    {
+        if(mpi_rank == 0)
+        {
+            printf("%d arguments provided, but 4 are needed\n", argc-1);
+            printf("mpi_trans N block_size maxrank tol\n");
+        }
+        MPI_Finalize();
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm = 'N';
+    int ndim = 2, nrhs = 3;
+    STARSH_int shape[2] = {N, N};
+    double alpha = 2.0, beta = -1.0;
+    int info;
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+    // Generate data for nonsymmetric Cauchy matrix
+    STARSH_cauchy *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype, STARSH_CAUCHY,
+            STARSH_CAUCHY_KERNEL1, 0);
+    if(info != 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+    // Init problem with given data and kernel and print short info
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Cauchy example");
+    if(info != 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+    if(mpi_rank == 0)
+        starsh_problem_info(P);
+    // Init plain clusterization, tlr division into admissible blocks and
+    // approximate them
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    info = starsh_blrf_new_tlr_mpi(&F, P, symm, C, C);
+    if(info != 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+    if(mpi_rank == 0)
+        starsh_blrm_info(M);
+    // Right hand sides and initial values of results are generated on root
+    // node, where result is gathered
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    double *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    if(mpi_rank == 0)
+    {
+        int iseed[4] = {0, 0, 0, 1};
+        LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+        LAPACKE_dlarnv_work(3, iseed, N*nrhs, y);
+        cblas_dcopy(N*nrhs, y, 1, y_ref, 1);
+    }
+    info = starsh_blrm__dmml_trans_mpi(M, nrhs, alpha, x, N, beta, y, N);
+    if(info != 0)
+    {
+        MPI_Finalize();
+        return 1;
+    }
+    // Reference result is computed with transposed dense matrix on root node
+    double rel_err = 0.;
+    if(mpi_rank == 0)
+    {
+        Array *A;
+        info = starsh_problem_to_array(P, &A);
+        if(info != 0)
+        {
+            MPI_Finalize();
+            return 1;
+        }
+        cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, N, nrhs, N,
+                alpha, A->data, N, x, N, beta, y_ref, N);
+        array_free(A);
+        cblas_daxpy(N*nrhs, -1.0, y_ref, 1, y, 1);
+        rel_err = cblas_dnrm2(N*nrhs, y, 1)/cblas_dnrm2(N*nrhs, y_ref, 1);
+        printf("RELATIVE ERROR OF TRANSPOSED MATVEC: %e\n", rel_err);
+        if(rel_err/tol > 10.)
+            printf("Resulting relative error is too big\n");
+    }
+    MPI_Bcast(&rel_err, 1, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    free(x);
+    free(y);
+    free(y_ref);
+    MPI_Finalize();
+    if(rel_err/tol > 10.)
+        return 1;
+    return 0;
+}
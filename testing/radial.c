@@ -0,0 +1,237 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/radial.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-radial.h>
+
+static double exp_phi(double r, void *param)
+// Exponential radial function exp(-r/beta)
+{
+    double beta = *(double *)param;
+    return exp(-r/beta);
+}
+
+static void exp_phi_batch(int count, double *r, void *param)
+// Exponential radial function, applied inplace to a number of distances
+{
+    double beta = *(double *)param;
+    for(int i = 0; i < count; i++)
+        r[i] = exp(-r[i]/beta);
+}
+
+static double dist_phi(double r, void *param)
+// Scaled distance to check distances themselves
+{
+    double scale = *(double *)param;
+    return scale*r;
+}
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("radial N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm = 'S';
+    int ndim = 2, nrhs = 3;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    double beta = 0.1, nugget = 1e-2;
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate particles in 2D and init radial kernel on them
+    STARSH_particles *particles;
+    info = starsh_particles_generate(&particles, N, ndim,
+            STARSH_PARTICLES_UNIFORM);
+    if(info != 0)
+        return info;
+    STARSH_raddata *data;
+    info = starsh_raddata_init(&data, N, ndim, particles->point, exp_phi,
+            NULL, &beta, nugget);
+    if(info != 0)
+        return info;
+    // Init problem with given data and kernel and print short info
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            starsh_raddata_block_kernel, "Radial kernel example");
+    if(info != 0)
+        return info;
+    starsh_problem_info(P);
+    // Dense matrix is computed by plain loops and by GEMM and compared with
+    // reference values
+    Array *A;
+    double *x = particles->point, *y = x+N;
+    for(int gemm = 0; gemm < 2; gemm++)
+    {
+        data->gemm_ndim = gemm ? 1 : STARSH_RADIAL_GEMM_NDIM;
+        info = starsh_problem_to_array(P, &A);
+        if(info != 0)
+            return info;
+        double *D = A->data, max_err = 0.;
+        for(STARSH_int j = 0; j < N; j++)
+            for(STARSH_int i = 0; i < N; i++)
+            {
+                double dx = x[i]-x[j], dy = y[i]-y[j];
+                double ref = exp(-sqrt(dx*dx+dy*dy)/beta);
+                if(i == j)
+                    ref += nugget;
+                double err = fabs(D[j*(size_t)N+i]-ref);
+                if(err > max_err)
+                    max_err = err;
+            }
+        printf("GEMM=%d MAXIMUM ERROR OF MATRIX: %e\n", gemm, max_err);
+        if(max_err > 1e-6)
+        {
+            printf("Resulting error is too big\n");
+            return 1;
+        }
+        array_free(A);
+    }
+    // Nugget is not added if rows and columns correspond to different sets
+    // of points, even if indexes coincide
+    STARSH_raddata other = *data;
+    STARSH_int index[2] = {0, 1};
+    double block[4];
+    starsh_raddata_block_kernel(2, 2, index, index, data, &other, block, 2);
+    printf("DIAGONAL OF BLOCK ON DIFFERENT DATA: %f %f\n", block[0],
+            block[3]);
+    if(block[0] != 1. || block[3] != 1.)
+    {
+        printf("Nugget is added to a block on different data\n");
+        return 1;
+    }
+    // Distances between close points far from origin do not lose accuracy,
+    // when computed by GEMM
+    int ndim2 = 10, N2 = 64;
+    double *point2 = malloc(sizeof(*point2)*ndim2*N2);
+    double *block2 = malloc(sizeof(*block2)*N2*N2);
+    STARSH_int *index2 = malloc(sizeof(*index2)*N2);
+    for(int k = 0; k < ndim2; k++)
+        for(int i = 0; i < N2; i += 2)
+        {
+            point2[k*N2+i] = 1e4+(double)rand()/RAND_MAX;
+            point2[k*N2+i+1] = point2[k*N2+i]+(k == 0 ? 1e-6 : 0.);
+        }
+    for(int i = 0; i < N2; i++)
+        index2[i] = i;
+    STARSH_raddata *data2;
+    double scale = 1.;
+    info = starsh_raddata_init(&data2, N2, ndim2, point2, dist_phi, NULL,
+            &scale, 0.);
+    if(info != 0)
+        return info;
+    data2->gemm_ndim = 1;
+    starsh_raddata_block_kernel(N2, N2, index2, index2, data2, data2, block2,
+            N2);
+    double max_err = 0.;
+    for(int j = 0; j < N2; j++)
+        for(int i = 0; i < N2; i++)
+        {
+            double dist = 0.;
+            for(int k = 0; k < ndim2; k++)
+            {
+                double tmp = point2[k*N2+i]-point2[k*N2+j];
+                dist += tmp*tmp;
+            }
+            dist = sqrt(dist);
+            double err = fabs(block2[j*N2+i]-dist);
+            if(dist > 0.)
+                err /= dist;
+            if(err > max_err)
+                max_err = err;
+        }
+    printf("MAXIMUM RELATIVE ERROR OF SHIFTED DISTANCES: %e\n", max_err);
+    if(max_err > 1e-10)
+    {
+        printf("Resulting error is too big\n");
+        return 1;
+    }
+    starsh_raddata_free(data2);
+    free(point2);
+    free(block2);
+    free(index2);
+    // Dense right hand sides and results
+    data->gemm_ndim = STARSH_RADIAL_GEMM_NDIM;
+    data->phi_batch = exp_phi_batch;
+    double *b = malloc(N*nrhs*sizeof(*b));
+    double *c_ref = malloc(N*nrhs*sizeof(*c_ref));
+    double *c = malloc(N*nrhs*sizeof(*c));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, b);
+    info = starsh_problem_to_array(P, &A);
+    if(info != 0)
+        return info;
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs, N, 1.0,
+            A->data, N, b, N, 0.0, c_ref, N);
+    array_free(A);
+    // Init plain clusterization, tlr division into admissible blocks and
+    // approximate them
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+        return info;
+    starsh_blrm_info(M);
+    // Check matrix-vector product
+    info = starsh_blrm__dmml_omp(M, nrhs, 1.0, b, N, 0.0, c, N);
+    if(info != 0)
+        return info;
+    double rel_err = rel_diff(N*nrhs, c, c_ref);
+    printf("RELATIVE ERROR OF MATVEC: %e\n", rel_err);
+    if(rel_err/tol > 10.)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    starsh_problem_free(P);
+    starsh_raddata_free(data);
+    free(b);
+    free(c);
+    free(c_ref);
+    return 0;
+}
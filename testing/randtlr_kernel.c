@@ -0,0 +1,92 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/randtlr_kernel.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <starsh.h>
+#include <starsh-randtlr.h>
+
+static void randtlr_ref(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, STARSH_randtlr *data, double *A, int ld)
+// Reference block of random TLR matrix, computed by dot products
+{
+    STARSH_int count = data->count;
+    for(int j = 0; j < ncols; j++)
+        for(int i = 0; i < nrows; i++)
+        {
+            double res = 0;
+            for(STARSH_int k = 0; k < data->block_size; k++)
+                res += data->U[irow[i]+k*count]*data->U[icol[j]+k*count]*
+                    data->S[k];
+            if(irow[i] == icol[j])
+                res += data->diag;
+            A[j*(size_t)ld+i] = res;
+        }
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 4)
+    {
+        printf("%d arguments provided, but 3 are needed\n", argc-1);
+        printf("randtlr_kernel N block_size tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    double tol = atof(argv[3]);
+    double decay = 0.7, diag = 1.;
+    int info;
+    int nrows = N/2, ncols = N/2, ld = N/2+3;
+    STARSH_int *irow = malloc(nrows*sizeof(*irow));
+    STARSH_int *icol = malloc(ncols*sizeof(*icol));
+    double *A = malloc(ld*(size_t)ncols*sizeof(*A));
+    double *A_ref = malloc(ld*(size_t)ncols*sizeof(*A_ref));
+    srand(0);
+    STARSH_randtlr *data;
+    info = starsh_randtlr_generate(&data, N, block_size, decay, diag);
+    if(info != 0)
+        return info;
+    // Contiguous columns are read inplace, while the other ones are
+    // gathered. Rows always start inside of a tile and cross its border,
+    // and columns with repeated indexes are checked
+    for(int contiguous = 0; contiguous < 2; contiguous++)
+    {
+        for(int i = 0; i < nrows; i++)
+            irow[i] = block_size/2+i;
+        for(int j = 0; j < ncols; j++)
+            icol[j] = contiguous ? block_size/3+j : (3*j) % N;
+        starsh_randtlr_block_kernel(nrows, ncols, irow, icol, data, data, A,
+                ld);
+        randtlr_ref(nrows, ncols, irow, icol, data, A_ref, ld);
+        double diff = 0., norm = 0.;
+        for(int j = 0; j < ncols; j++)
+            for(int i = 0; i < nrows; i++)
+            {
+                double a = A[j*(size_t)ld+i], a_ref = A_ref[j*(size_t)ld+i];
+                diff += (a-a_ref)*(a-a_ref);
+                norm += a_ref*a_ref;
+            }
+        double rel_err = sqrt(diff/norm);
+        printf("CONTIGUOUS=%d RELATIVE ERROR: %e\n", contiguous, rel_err);
+        if(rel_err > tol)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+    }
+    starsh_randtlr_free(data);
+    free(irow);
+    free(icol);
+    free(A);
+    free(A_ref);
+    return 0;
+}
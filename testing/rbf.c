@@ -0,0 +1,101 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/rbf.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <starsh.h>
+#include <starsh-rbf.h>
+
+static double rbf_ref(STARSH_mddata *data, STARSH_int i0, STARSH_int j0)
+// Reference entry of RBF matrix, computed by scalar basis functions
+{
+    double *mesh = data->particles.point;
+    double d = diff(&mesh[i0*3], &mesh[j0*3])/data->scale, value;
+    switch(data->kernel)
+    {
+        case 0: value = Gaussian(d); break;
+        case 1: value = Expon(d); break;
+        case 2: value = InvQUAD(d); break;
+        case 3: value = InvMQUAD(d); break;
+        case 4:
+        case 5: value = Maternc1(d); break;
+        case 6: value = TPS(d); break;
+        case 7: value = CTPS(d); break;
+        case 8: value = QUAD(d); break;
+        default: value = Wendland(d); break;
+    }
+    if(i0 == j0 && data->isreg)
+        value += data->reg;
+    return value;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 3)
+    {
+        printf("%d arguments provided, but 2 are needed\n", argc-1);
+        printf("rbf N tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]);
+    double tol = atof(argv[2]);
+    int ndim = 3, isreg = 1, info;
+    double reg = 1.1, rad = 1.5;
+    // Rows are taken in reversed order and columns contain repeated indexes,
+    // so that distances between all kinds of points are checked
+    int nrows = N, ncols = N/2, ld = N+3;
+    STARSH_int *irow = malloc(nrows*sizeof(*irow));
+    STARSH_int *icol = malloc(ncols*sizeof(*icol));
+    double *A = malloc(ld*(size_t)ncols*sizeof(*A));
+    for(int i = 0; i < nrows; i++)
+        irow[i] = N-1-i;
+    for(int j = 0; j < ncols; j++)
+        icol[j] = (3*j) % N;
+    // Types 4 and 5 both mean Maternc1 and any type above 8 means Wendland
+    for(int type = 0; type < 10; type++)
+    {
+        STARSH_mddata *data;
+        info = starsh_generate_3d_rbf_mesh_coordinates_cube(&data, N, ndim,
+                type, isreg, reg, rad, 0);
+        if(info != 0)
+            return info;
+        starsh_generate_3d_cube(nrows, ncols, irow, icol, data, data, A, ld);
+        double max_err = 0.;
+        for(int j = 0; j < ncols; j++)
+            for(int i = 0; i < nrows; i++)
+            {
+                double a = A[j*(size_t)ld+i];
+                double a_ref = rbf_ref(data, irow[i], icol[j]);
+                double err;
+                // Thin plate spline is NaN for zero distance and compactly
+                // supported functions are exact zeros for large distances
+                if(isnan(a_ref) || a_ref == 0.)
+                    err = (isnan(a) == isnan(a_ref) && (isnan(a) || a == 0.))
+                        ? 0. : INFINITY;
+                else
+                    err = fabs(a-a_ref)/fabs(a_ref);
+                if(err > max_err)
+                    max_err = err;
+            }
+        printf("KERNEL=%d MAXIMUM RELATIVE ERROR: %e\n", type, max_err);
+        if(max_err > tol)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        starsh_mddata_free(data);
+    }
+    free(irow);
+    free(icol);
+    free(A);
+    return 0;
+}
@@ -0,0 +1,161 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/rbf_support.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-rbf.h>
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("rbf_support N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm[2] = {'N', 'S'};
+    int ndim = 2, nrhs = 3;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    double reg = 1.1, rad = 1.5;
+    // Gaussian kernel has no compact support, CTPS and Wendland kernels do
+    int type[3] = {0, 7, 9};
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Dense right hand sides and results
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+    for(int t = 0; t < 3; t++)
+    {
+        // Consecutive mesh points of cube are neighbours, so that most of
+        // tiles are zero for compactly supported kernels
+        STARSH_mddata *data;
+        info = starsh_generate_3d_rbf_mesh_coordinates_cube(&data, N, 3,
+                type[t], 1, reg, rad, 0);
+        if(info != 0)
+            return info;
+        // Init plain clusterization
+        STARSH_cluster *C;
+        info = starsh_cluster_new_plain(&C, data, N, block_size);
+        if(info != 0)
+            return info;
+        STARSH_int nblocks = C->nblocks;
+        for(int s = 0; s < 2; s++)
+        {
+            // Init problem with given data and kernel and print short info
+            STARSH_problem *P;
+            info = starsh_problem_new(&P, ndim, shape, symm[s], dtype, data,
+                    data, starsh_generate_3d_cube, "Mesh deformation example");
+            if(info != 0)
+                return info;
+            starsh_problem_info(P);
+            // Reference result is computed with dense matrix
+            Array *A;
+            info = starsh_problem_to_array(P, &A);
+            if(info != 0)
+                return info;
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs,
+                    N, 1.0, A->data, N, x, N, 0.0, y_ref, N);
+            array_free(A);
+            // Init tlr division, that skips zero tiles, and approximate tiles
+            STARSH_blrf *F;
+            STARSH_blrm *M;
+            info = starsh_mddata_tlr_support(&F, P, symm[s], C, C);
+            if(info != 0)
+                return info;
+            STARSH_int nblocks_full = symm[s] == 'N' ? nblocks*nblocks :
+                nblocks*(nblocks+1)/2;
+            STARSH_int nblocks_kept = F->nblocks_far+F->nblocks_near;
+            printf("KERNEL=%d SYMM=%c TILES: %ld OUT OF %ld\n", type[t],
+                    symm[s], (long)nblocks_kept, (long)nblocks_full);
+            if((t == 0) != (nblocks_kept == nblocks_full))
+            {
+                printf("Wrong number of tiles\n");
+                return 1;
+            }
+            info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+            if(info != 0)
+                return info;
+            starsh_blrm_info(M);
+            // Plain multiplication and plans with sparse near-field blocks
+            for(int panel = 0; panel < 3; panel++)
+            {
+                cblas_dscal(N*nrhs, 0.0, y, 1);
+                if(panel == 0)
+                    info = starsh_blrm__dmml_omp(M, nrhs, 1.0, x, N, 0.0, y,
+                            N);
+                else
+                {
+                    STARSH_blrm_mml_plan *plan;
+                    if(panel == 2)
+                        info = starsh_blrm_mml_plan_create_panel(&plan, M,
+                                nrhs);
+                    else
+                        info = starsh_blrm_mml_plan_create(&plan, M, nrhs);
+                    if(info != 0)
+                        return info;
+                    info = starsh_blrm_mml_plan_sparse(plan, 1.0);
+                    if(info != 0)
+                        return info;
+                    info = starsh_blrm_mml_plan_execute(plan, nrhs, 1.0, x, N,
+                            0.0, y, N);
+                    starsh_blrm_mml_plan_destroy(plan);
+                }
+                if(info != 0)
+                    return info;
+                double rel_err = rel_diff(N*nrhs, y, y_ref);
+                printf("KERNEL=%d SYMM=%c PLAN=%d RELATIVE ERROR OF MATVEC: "
+                        "%e\n", type[t], symm[s], panel, rel_err);
+                if(rel_err/tol > 10.)
+                {
+                    printf("Resulting relative error is too big\n");
+                    return 1;
+                }
+            }
+            starsh_blrm_free(M);
+            starsh_blrf_free(F);
+            starsh_problem_free(P);
+        }
+        starsh_cluster_free(C);
+        starsh_mddata_free(data);
+    }
+    free(x);
+    free(y);
+    free(y_ref);
+    return 0;
+}
@@ -0,0 +1,158 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/rsdd_grow.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+static int check_grow(int n, int r, int oversample, double tol)
+//! Approximate product of random `n` by `r` and `r` by `n` matrices.
+{
+    int iseed[4] = {0, 0, 0, 1};
+    int rank, info;
+    double *A = malloc(sizeof(*A)*n*r), *B = malloc(sizeof(*B)*r*n);
+    double *D = malloc(sizeof(*D)*n*n), *U, *V;
+    LAPACKE_dlarnv_work(3, iseed, n*r, A);
+    LAPACKE_dlarnv_work(3, iseed, r*n, B);
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, n, n, r, 1.0, A, n,
+            B, r, 0.0, D, n);
+    double norm = cblas_dnrm2(n*n, D, 1);
+    info = starsh_dense_dlrrsdd_grow(n, n, D, n, &U, &V, &rank, oversample,
+            tol);
+    if(info != 0)
+        return info;
+    printf("SIZE: %d, EXACT RANK: %d, RANK: %d\n", n, r, rank);
+    // Matrix of full rank is not low-rank
+    if(2*r > n)
+    {
+        free(A);
+        free(B);
+        free(D);
+        if(rank != -1 || U != NULL || V != NULL)
+        {
+            printf("Matrix of full rank was approximated\n");
+            return 1;
+        }
+        return 0;
+    }
+    if(rank != r)
+    {
+        printf("Wrong rank\n");
+        return 1;
+    }
+    cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, n, n, rank, -1.0, U,
+            n, V, n, 1.0, D, n);
+    double rel_err = cblas_dnrm2(n*n, D, 1)/norm;
+    printf("RELATIVE ERROR: %e\n", rel_err);
+    free(A);
+    free(B);
+    free(D);
+    free(U);
+    free(V);
+    if(rel_err > tol)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc != 4)
+    {
+        printf("%d arguments provided, but 3 are needed\n", argc-1);
+        printf("rsdd_grow N block_size tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    double tol = atof(argv[3]);
+    int onfly = 0;
+    char symm = 'N', dtype = 'd';
+    int ndim = 2;
+    STARSH_int shape[2] = {N, N};
+    STARSH_int bi;
+    int info, max_rank = 0;
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    info = starsh_set_lrengine("RSVD");
+    if(info != 0)
+        return info;
+    // Rank is found after several extensions of the sketch, while matrix of
+    // full rank stays dense
+    info = check_grow(block_size, 37, starsh_params.oversample, tol);
+    if(info != 0)
+        return info;
+    info = check_grow(block_size, block_size, starsh_params.oversample, tol);
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_EXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NOISE, 0.,
+            STARSH_SPATIAL_PLACE, STARSH_PARTICLES_UNIFORM, 0);
+    if(info != 0)
+        return info;
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Spatial Statistics example");
+    if(info != 0)
+        return info;
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    // Non-positive maximal rank means rank is limited only by memory
+    info = starsh_blrm_approximate(&M, F, 0, tol, onfly);
+    if(info != 0)
+        return info;
+    starsh_blrf_info(F);
+    starsh_blrm_info(M);
+    for(bi = 0; bi < F->nblocks_far; bi++)
+        if(M->far_rank[bi] > max_rank)
+            max_rank = M->far_rank[bi];
+    printf("MAXIMUM RANK: %d\n", max_rank);
+    if(max_rank <= starsh_params.oversample || 2*max_rank > block_size)
+    {
+        printf("Ranks of far-field blocks are not grown\n");
+        return 1;
+    }
+    double rel_err = starsh_blrm__dfe_omp(M);
+    printf("RELATIVE ERROR: %e\n", rel_err);
+    if(rel_err/tol > 10.)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    starsh_cluster_free(C);
+    starsh_problem_free(P);
+    return 0;
+}
@@ -0,0 +1,260 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/solvers.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-particles.h>
+
+// Parameters of kernels
+static const double beta = 0.1, skew = 0.5, shift = 10.;
+
+static void kernel_2d(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, STARSH_particles *data1, STARSH_particles *data2,
+        double *buffer, int ld, double skew)
+// Kernel exp(-r/beta)*(1+skew*(x_i-x_j)) on particles in 2D with shift of
+// diagonal, which is symmetric positive definite for zero skew
+{
+    double *x1 = data1->point, *y1 = x1+data1->count;
+    double *x2 = data2->point, *y2 = x2+data2->count;
+    for(int j = 0; j < ncols; j++)
+        for(int i = 0; i < nrows; i++)
+        {
+            double dx = x1[irow[i]]-x2[icol[j]];
+            double dy = y1[irow[i]]-y2[icol[j]];
+            double dist = sqrt(dx*dx+dy*dy);
+            buffer[j*(size_t)ld+i] = exp(-dist/beta)*(1.+skew*dx);
+            if(dist == 0.)
+                buffer[j*(size_t)ld+i] += shift;
+        }
+}
+
+static void skew_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+// Nonsymmetric kernel
+{
+    kernel_2d(nrows, ncols, irow, icol, row_data, col_data, result, ld,
+            skew);
+}
+
+static void symm_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+// Symmetric positive definite kernel
+{
+    kernel_2d(nrows, ncols, irow, icol, row_data, col_data, result, ld, 0.);
+}
+
+static void breakdown_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+// Identity on the first half of unknowns and rotations of pairs of unknowns
+// on the second half, so that BiCGStab breaks down on the second half
+{
+    STARSH_particles *data1 = row_data, *data2 = col_data;
+    // Matrix is square, so halves of rows and columns are the same
+    STARSH_int half = (data1->count+data2->count)/4;
+    double *buffer = result;
+    for(int j = 0; j < ncols; j++)
+        for(int i = 0; i < nrows; i++)
+        {
+            STARSH_int k = irow[i], l = icol[j];
+            double value = 0.;
+            if(k < half)
+                value = k == l ? 1. : 0.;
+            else if(k%2 == 0)
+                value = l == k+1 ? 1. : 0.;
+            else
+                value = l == k-1 ? -1. : 0.;
+            buffer[j*(size_t)ld+i] = value;
+        }
+}
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("solvers N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd';
+    int ndim = 2, nrhs = 3, restart = 10;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate particles in 2D
+    STARSH_particles *data;
+    info = starsh_particles_generate(&data, N, 2, STARSH_PARTICLES_UNIFORM);
+    if(info != 0)
+        return info;
+    // Dense solutions, right hand sides and results
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *b = malloc(N*nrhs*sizeof(*b));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    size_t lwork = (size_t)nrhs*((N+restart+1)*(restart+1)+2*restart+1);
+    // Buffer is big enough for all the solvers
+    if(lwork < 6*(size_t)N*nrhs+4*nrhs)
+        lwork = 6*(size_t)N*nrhs+4*nrhs;
+    double *work = malloc(lwork*sizeof(*work));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+    // Init plain clusterization
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    // Nonsymmetric systems are solved by GMRES and BiCGStab, symmetric
+    // positive definite ones by CG and block CG
+    char symm[2] = {'N', 'S'};
+    STARSH_kernel *kernel[2] = {skew_kernel, symm_kernel};
+    const char *name[2][2] = {{"GMRES", "BICGSTAB"}, {"CG", "BCG"}};
+    for(int s = 0; s < 2; s++)
+    {
+        // Init problem with given data and kernel and print short info
+        STARSH_problem *P;
+        info = starsh_problem_new(&P, ndim, shape, symm[s], dtype, data, data,
+                kernel[s], "Solvers example");
+        if(info != 0)
+            return info;
+        starsh_problem_info(P);
+        // Right hand sides are computed with dense matrix
+        Array *A;
+        info = starsh_problem_to_array(P, &A);
+        if(info != 0)
+            return info;
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, N, nrhs, N,
+                1.0, A->data, N, x, N, 0.0, b, N);
+        array_free(A);
+        // Init tlr division into admissible blocks and approximate them
+        STARSH_blrf *F;
+        STARSH_blrm *M;
+        info = starsh_blrf_new_tlr(&F, P, symm[s], C, C);
+        if(info != 0)
+            return info;
+        info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        starsh_blrm_info(M);
+        // Solve systems and compare with known solution
+        for(int solver = 0; solver < 2; solver++)
+        {
+            for(int i = 0; i < N*nrhs; i++)
+                y[i] = 0.;
+            int iter;
+            if(s == 0 && solver == 0)
+                iter = starsh_itersolvers__dgmres_omp(M, nrhs, b, N, y, N,
+                        tol, restart, work);
+            else if(s == 0)
+                iter = starsh_itersolvers__dbicgstab_omp(M, nrhs, b, N, y, N,
+                        tol, work);
+            else if(solver == 0)
+                iter = starsh_itersolvers__dcg_omp(M, nrhs, b, N, y, N, tol,
+                        work);
+            else
+                iter = starsh_itersolvers__dbcg_omp(M, nrhs, b, N, y, N, tol,
+                        work);
+            printf("%s ITERATIONS: %d\n", name[s][solver], iter);
+            if(iter < 0)
+            {
+                printf("%s did not converge\n", name[s][solver]);
+                return 1;
+            }
+            double rel_err = rel_diff(N*nrhs, y, x);
+            printf("%s RELATIVE ERROR OF SOLUTION: %e\n", name[s][solver],
+                    rel_err);
+            if(rel_err/tol > 100.)
+            {
+                printf("Resulting relative error is too big\n");
+                return 1;
+            }
+        }
+        starsh_blrm_free(M);
+        starsh_blrf_free(F);
+        starsh_problem_free(P);
+    }
+    // BiCGStab breaks down for the second right hand side, while the first
+    // one is still solved
+    {
+        STARSH_problem *P;
+        info = starsh_problem_new(&P, ndim, shape, 'N', dtype, data, data,
+                breakdown_kernel, "BiCGStab breakdown example");
+        if(info != 0)
+            return info;
+        STARSH_blrf *F;
+        STARSH_blrm *M;
+        info = starsh_blrf_new_tlr(&F, P, 'N', C, C);
+        if(info != 0)
+            return info;
+        info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        for(int i = 0; i < 2*N; i++)
+        {
+            b[i] = 0.;
+            y[i] = 0.;
+        }
+        for(int i = 0; i < N/2; i++)
+            b[i] = x[i];
+        b[N+N-2] = 1.;
+        b[N+N-1] = 1.;
+        int iter = starsh_itersolvers__dbicgstab_omp(M, 2, b, N, y, N, tol,
+                work);
+        printf("BICGSTAB ITERATIONS WITH BREAKDOWN: %d\n", iter);
+        if(iter != -1)
+        {
+            printf("Breakdown of BiCGStab was not reported\n");
+            return 1;
+        }
+        double rel_err = rel_diff(N, y, b);
+        printf("BICGSTAB RELATIVE ERROR OF SOLUTION WITHOUT BREAKDOWN: %e\n",
+                rel_err);
+        if(rel_err/tol > 100.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        starsh_blrm_free(M);
+        starsh_blrf_free(F);
+        starsh_problem_free(P);
+    }
+    free(x);
+    free(b);
+    free(y);
+    free(work);
+    return 0;
+}
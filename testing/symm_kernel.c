@@ -0,0 +1,145 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/symm_kernel.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <complex.h>
+#include <starsh.h>
+#include <starsh-electrodynamics.h>
+
+// Kernel, wrapped by counting_kernel(), and number of computed entries
+static STARSH_kernel *base_kernel;
+static size_t nentries;
+
+static void counting_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+// Count entries, computed by a kernel
+{
+    nentries += (size_t)nrows*ncols;
+    base_kernel(nrows, ncols, irow, icol, row_data, col_data, result, ld);
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 3)
+    {
+        printf("%d arguments provided, but 2 are needed\n", argc-1);
+        printf("symm_kernel N tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]);
+    double tol = atof(argv[2]);
+    int ndim = 3, info;
+    // Sizes of diagonal blocks: single leaf, one and several levels of
+    // recursion
+    int size[4] = {1, 64, 65, N};
+    // Real symmetric, real nonsymmetric and complex symmetric problems
+    char symm[3] = {'S', 'N', 'S'}, dtype[3] = {'d', 'd', 'z'};
+    STARSH_kernel *kernel[3] =
+    {
+        starsh_eddata_block_sin_kernel_3d,
+        starsh_eddata_block_sin_kernel_3d,
+        starsh_eddata_block_exp_kernel_3d
+    };
+    // Rows are taken in reversed order and result has larger leading
+    // dimension, than number of rows
+    int ld = N+3;
+    STARSH_int *index = malloc(N*sizeof(*index));
+    double complex *A = malloc(ld*(size_t)N*sizeof(*A));
+    double complex *A_ref = malloc(ld*(size_t)N*sizeof(*A_ref));
+    for(int i = 0; i < N; i++)
+        index[i] = N-1-i;
+    srand(0);
+    STARSH_eddata *data;
+    info = starsh_eddata_generate(&data, N, ndim, 20., N,
+            STARSH_PARTICLES_UNIFORM);
+    if(info != 0)
+        return info;
+    STARSH_int shape[2] = {N, N};
+    for(int p = 0; p < 3; p++)
+    {
+        STARSH_problem *P;
+        info = starsh_problem_new(&P, 2, shape, symm[p], dtype[p], data,
+                data, counting_kernel, "Symmetric kernel example");
+        if(info != 0)
+            return info;
+        base_kernel = kernel[p];
+        size_t esize = P->entry_size;
+        for(int s = 0; s < 4; s++)
+        {
+            int n = size[s];
+            // Reference block is computed by a single call to the kernel
+            kernel[p](n, n, index, index, data, data, A_ref, ld);
+            memset(A, 0, ld*(size_t)n*esize);
+            nentries = 0;
+            starsh_problem_kernel(P, n, n, index, index, data, data, A, ld);
+            double diff = 0., norm = 0.;
+            for(int j = 0; j < n; j++)
+                for(int i = 0; i < n; i++)
+                {
+                    size_t l = j*(size_t)ld+i;
+                    double complex a, a_ref;
+                    if(dtype[p] == 'd')
+                    {
+                        a = ((double *)A)[l];
+                        a_ref = ((double *)A_ref)[l];
+                    }
+                    else
+                    {
+                        a = A[l];
+                        a_ref = A_ref[l];
+                    }
+                    diff += cabs(a-a_ref)*cabs(a-a_ref);
+                    norm += cabs(a_ref)*cabs(a_ref);
+                }
+            double rel_err = sqrt(diff/norm);
+            printf("SYMM=%c DTYPE=%c N=%d ENTRIES=%zu RELATIVE ERROR: %e\n",
+                    symm[p], dtype[p], n, nentries, rel_err);
+            if(rel_err > tol)
+            {
+                printf("Resulting relative error is too big\n");
+                return 1;
+            }
+            // Nonsymmetric problem and small blocks are computed by a single
+            // call, while symmetric blocks with several levels of recursion
+            // are computed mostly by lower triangle
+            size_t n2 = (size_t)n*n;
+            int wrong;
+            if(symm[p] == 'N' || n <= 64)
+                wrong = nentries != n2;
+            else
+                wrong = nentries >= n2 || (n >= 256 && 5*nentries >= 3*n2);
+            if(wrong)
+            {
+                printf("Wrong number of computed entries\n");
+                return 1;
+            }
+        }
+        // Off-diagonal block is computed by a single call to the kernel
+        nentries = 0;
+        starsh_problem_kernel(P, N/2, N/2, index, index+N/2, data, data, A,
+                ld);
+        if(nentries != (size_t)(N/2)*(N/2))
+        {
+            printf("Off-diagonal block is not computed by a single call\n");
+            return 1;
+        }
+        starsh_problem_free(P);
+    }
+    starsh_eddata_free(data);
+    free(index);
+    free(A);
+    free(A_ref);
+    return 0;
+}
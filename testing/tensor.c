@@ -0,0 +1,221 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/tensor.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-particles.h>
+
+// Parameter of kernels
+static const double beta = 0.1;
+
+static double entry_2d(STARSH_particles *data1, STARSH_particles *data2,
+        STARSH_int i, STARSH_int j, int a, int b, double skew)
+// Component (a, b) of kernel exp(-r/beta)*(1+a+b+skew*(a*dx+b*dy)) on
+// particles in 2D, which is symmetric for zero skew
+{
+    double *x1 = data1->point, *y1 = x1+data1->count;
+    double *x2 = data2->point, *y2 = x2+data2->count;
+    double dx = x1[i]-x2[j], dy = y1[i]-y2[j];
+    double dist = sqrt(dx*dx+dy*dy);
+    return exp(-dist/beta)*(1.+a+b+skew*(a*dx+b*dy));
+}
+
+static void kernel_2d(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, STARSH_particles *data1, STARSH_particles *data2,
+        double *buffer, int ld, int p, int q, double skew)
+// Tensor kernel of shape (nrows, p, q, ncols)
+{
+    for(int j = 0; j < ncols; j++)
+        for(int b = 0; b < q; b++)
+            for(int a = 0; a < p; a++)
+                for(int i = 0; i < nrows; i++)
+                    buffer[i+ld*(a+p*(b+q*(size_t)j))] = entry_2d(data1,
+                            data2, irow[i], icol[j], a, b, skew);
+}
+
+static void skew_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+// Nonsymmetric kernel with 2-by-3 tensor output
+{
+    kernel_2d(nrows, ncols, irow, icol, row_data, col_data, result, ld, 2, 3,
+            0.5);
+}
+
+static void symm_kernel(int nrows, int ncols, STARSH_int *irow,
+        STARSH_int *icol, void *row_data, void *col_data, void *result,
+        int ld)
+// Symmetric kernel with 2-by-2 tensor output
+{
+    kernel_2d(nrows, ncols, irow, icol, row_data, col_data, result, ld, 2, 2,
+            0.);
+}
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("tensor N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm[2] = {'N', 'S'};
+    int nrhs = 3;
+    int info;
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate particles in 2D
+    STARSH_particles *data;
+    info = starsh_particles_generate(&data, N, 2, STARSH_PARTICLES_UNIFORM);
+    if(info != 0)
+        return info;
+    // Nonsymmetric kernel has 2-by-3 components, symmetric kernel has 2-by-2
+    int ncomp[2][2] = {{2, 3}, {2, 2}};
+    double skew[2] = {0.5, 0.};
+    STARSH_kernel *kernel[2] = {skew_kernel, symm_kernel};
+    for(int s = 0; s < 2; s++)
+    {
+        int p = ncomp[s][0], q = ncomp[s][1];
+        int nrows = N*p, ncols = N*q;
+        // Init tensor problem and flattened problem
+        STARSH_int shape[4] = {N, p, q, N};
+        STARSH_problem *T, *P;
+        info = starsh_problem_new(&T, 4, shape, symm[s], dtype, data, data,
+                kernel[s], "Tensor example");
+        if(info != 0)
+            return info;
+        info = starsh_problem_from_tensor(&P, T);
+        if(info != 0)
+            return info;
+        starsh_problem_info(P);
+        if(P->symm != symm[s] || P->shape[0] != nrows ||
+                P->shape[1] != ncols)
+        {
+            printf("Wrong shape or symmetry of flattened problem\n");
+            return 1;
+        }
+        // Components of the same point are consecutive rows and columns
+        Array *A;
+        info = starsh_problem_to_array(P, &A);
+        if(info != 0)
+            return info;
+        double *A_data = A->data;
+        for(int j = 0; j < ncols; j++)
+            for(int i = 0; i < nrows; i++)
+                if(A_data[j*(size_t)nrows+i] != entry_2d(data, data, i/p,
+                            j/q, i%p, j%q, skew[s]))
+                {
+                    printf("Wrong entries of flattened problem\n");
+                    return 1;
+                }
+        // Rows in reversed order and columns with repeated indexes
+        int nr = nrows/2, nc = ncols/3, ld = nr+3;
+        STARSH_int *irow = malloc(nr*sizeof(*irow));
+        STARSH_int *icol = malloc(nc*sizeof(*icol));
+        double *B = malloc(ld*(size_t)nc*sizeof(*B));
+        for(int i = 0; i < nr; i++)
+            irow[i] = nrows-1-2*i;
+        for(int j = 0; j < nc; j++)
+            icol[j] = (7*j) % ncols;
+        P->kernel(nr, nc, irow, icol, P->row_data, P->col_data, B, ld);
+        for(int j = 0; j < nc; j++)
+            for(int i = 0; i < nr; i++)
+                if(B[j*(size_t)ld+i] != A_data[icol[j]*(size_t)nrows+irow[i]])
+                {
+                    printf("Wrong block of flattened problem\n");
+                    return 1;
+                }
+        free(irow);
+        free(icol);
+        free(B);
+        // Reference result is computed with dense matrix
+        double *x = malloc(ncols*nrhs*sizeof(*x));
+        double *y_ref = malloc(nrows*nrhs*sizeof(*y_ref));
+        double *y = malloc(nrows*nrhs*sizeof(*y));
+        int iseed[4] = {0, 0, 0, 1};
+        LAPACKE_dlarnv_work(3, iseed, ncols*nrhs, x);
+        cblas_dgemm(CblasColMajor, CblasNoTrans, CblasNoTrans, nrows, nrhs,
+                ncols, 1.0, A_data, nrows, x, ncols, 0.0, y_ref, nrows);
+        array_free(A);
+        // Init plain clusterization with block sizes, multiple of number of
+        // components, tlr division into admissible blocks and approximate
+        STARSH_cluster *R, *C;
+        info = starsh_cluster_new_plain(&R, P->row_data, nrows,
+                block_size*p);
+        if(info != 0)
+            return info;
+        if(symm[s] == 'S')
+            C = R;
+        else
+        {
+            info = starsh_cluster_new_plain(&C, P->col_data, ncols,
+                    block_size*q);
+            if(info != 0)
+                return info;
+        }
+        STARSH_blrf *F;
+        STARSH_blrm *M;
+        info = starsh_blrf_new_tlr(&F, P, symm[s], R, C);
+        if(info != 0)
+            return info;
+        info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+        if(info != 0)
+            return info;
+        starsh_blrm_info(M);
+        info = starsh_blrm__dmml_omp(M, nrhs, 1.0, x, ncols, 0.0, y, nrows);
+        if(info != 0)
+            return info;
+        double rel_err = rel_diff(nrows*nrhs, y, y_ref);
+        printf("SYMM=%c RELATIVE ERROR OF MATVEC: %e\n", symm[s], rel_err);
+        if(rel_err/tol > 10.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+        starsh_blrm_free(M);
+        starsh_blrf_free(F);
+        if(C != R)
+            starsh_cluster_free(C);
+        starsh_cluster_free(R);
+        starsh_problem_free(P);
+        starsh_problem_free(T);
+        free(x);
+        free(y);
+        free(y_ref);
+    }
+    starsh_particles_free(data);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/tlr_eta.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+int main(int argc, char **argv)
+{
+    if(argc != 6)
+    {
+        printf("%d arguments provided, but 5 are needed\n", argc-1);
+        printf("tlr_eta N block_size maxrank tol eta\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]), eta = atof(argv[5]);
+    int onfly = 0;
+    char symm = 'N', dtype = 'd';
+    int ndim = 2;
+    STARSH_int shape[2] = {N, N};
+    STARSH_int bi, nblocks_far, nblocks_near;
+    int info;
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_SQREXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NOISE, 0.,
+            STARSH_SPATIAL_PLACE, STARSH_PARTICLES_RAND, 0);
+    if(info != 0)
+        return info;
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Spatial Statistics example");
+    if(info != 0)
+        return info;
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    // Admissibility can not be checked without geometry
+    if(starsh_blrf_new_tlr_eta(&F, P, symm, C, C, eta) == 0)
+    {
+        printf("Format was created without geometry of clusters\n");
+        return 1;
+    }
+    info = starsh_cluster_set_geometry(C, data->particles.ndim,
+            data->particles.point);
+    if(info != 0)
+        return info;
+    info = starsh_blrf_new_tlr_eta(&F, P, symm, C, C, eta);
+    if(info != 0)
+        return info;
+    starsh_blrf_info(F);
+    nblocks_far = F->nblocks_far;
+    nblocks_near = F->nblocks_near;
+    if(nblocks_far == 0 || nblocks_near == 0)
+    {
+        printf("Expected both far-field and near-field blocks\n");
+        return 1;
+    }
+    // Diagonal blocks must be near-field blocks
+    for(bi = 0; bi < nblocks_far; bi++)
+        if(F->block_far[2*bi] == F->block_far[2*bi+1])
+        {
+            printf("Diagonal block %zd is a far-field block\n",
+                    F->block_far[2*bi]);
+            return 1;
+        }
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+        return info;
+    starsh_blrf_info(F);
+    // Admissible blocks must not turn out to be false far-field blocks
+    if(F->nblocks_far != nblocks_far || F->nblocks_near != nblocks_near)
+    {
+        printf("Format was rebuilt due to false far-field blocks\n");
+        return 1;
+    }
+    double rel_err = starsh_blrm__dfe_omp(M);
+    printf("RELATIVE ERROR: %e\n", rel_err);
+    if(rel_err/tol > 10.)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    // Plain TLR partitioning keeps only blocks with overlapping bounding
+    // boxes, including diagonal ones, as near-field blocks
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    starsh_blrf_info(F);
+    if(F->nblocks_near == 0 || F->nblocks_near > nblocks_near)
+    {
+        printf("Wrong number of near-field blocks of TLR format\n");
+        return 1;
+    }
+    for(bi = 0; bi < F->nblocks_far; bi++)
+        if(F->block_far[2*bi] == F->block_far[2*bi+1])
+        {
+            printf("Diagonal block %zd is a far-field block of TLR format\n",
+                    F->block_far[2*bi]);
+            return 1;
+        }
+    starsh_blrf_free(F);
+    starsh_cluster_free(C);
+    starsh_problem_free(P);
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/tolmode.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-spatial.h>
+
+int main(int argc, char **argv)
+{
+    if(argc != 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("tolmode N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char symm = 'N', dtype = 'd';
+    int ndim = 2;
+    STARSH_int shape[2] = {N, N};
+    int info;
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Tolerance is set for the whole matrix and not for each tile
+    info = starsh_set_tolmode("GLOBAL");
+    if(info != 0)
+        return info;
+    // Generate data for spatial statistics problem with smooth kernel
+    STARSH_ssdata *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype,
+            STARSH_SPATIAL, STARSH_SPATIAL_SQREXP_SIMD, STARSH_SPATIAL_NDIM, 2,
+            STARSH_SPATIAL_BETA, 0.1, STARSH_SPATIAL_NOISE, 0.,
+            STARSH_SPATIAL_PLACE, STARSH_PARTICLES_RAND, 0);
+    if(info != 0)
+        return info;
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Spatial Statistics example");
+    if(info != 0)
+        return info;
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    // Geometry of clusters is required by Chebyshev interpolation
+    info = starsh_cluster_set_geometry(C, data->particles.ndim,
+            data->particles.point);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+        return info;
+    starsh_blrf_info(F);
+    starsh_blrm_info(M);
+    if(F->nblocks_far == 0)
+    {
+        printf("All far-field blocks are stored as dense blocks\n");
+        return 1;
+    }
+    // Error of the whole matrix is bounded by given tolerance
+    double rel_err = starsh_blrm__dfe_omp(M);
+    printf("RELATIVE ERROR: %e\n", rel_err);
+    if(rel_err > tol)
+    {
+        printf("Resulting relative error is too big\n");
+        return 1;
+    }
+    // Engine AUTO chooses cross approximation by timings, so cross
+    // approximation is checked for all far-field blocks separately
+    if(starsh_params.lrengine == STARSH_LRENGINE_AUTO)
+    {
+        double norm, err2 = 0.;
+        info = starsh_blrf_dnorm_estimate(F, 16, &norm);
+        if(info != 0)
+            return info;
+        double *U = malloc(sizeof(*U)*block_size*maxrank);
+        double *V = malloc(sizeof(*V)*block_size*maxrank);
+        double *D = malloc(sizeof(*D)*block_size*block_size);
+        int *iwork = malloc(sizeof(*iwork)*block_size);
+        for(STARSH_int bi = 0; bi < F->nblocks_far; bi++)
+        {
+            STARSH_int i = F->block_far[2*bi];
+            STARSH_int j = F->block_far[2*bi+1];
+            int nrows = C->size[i], ncols = C->size[j], rank;
+            starsh_dense_dlraca(nrows, ncols, kernel, C->pivot+C->start[i],
+                    C->pivot+C->start[j], data, data, U, nrows, V, ncols,
+                    &rank, maxrank, starsh_blrf_dtile_tol(F, norm, tol, i, j),
+                    iwork);
+            // Dense blocks are stored without error
+            if(rank == -1)
+                continue;
+            kernel(nrows, ncols, C->pivot+C->start[i], C->pivot+C->start[j],
+                    data, data, D, nrows);
+            cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nrows, ncols,
+                    rank, -1.0, U, nrows, V, ncols, 1.0, D, nrows);
+            double err = cblas_dnrm2(nrows*ncols, D, 1);
+            err2 += err*err;
+        }
+        free(U);
+        free(V);
+        free(D);
+        free(iwork);
+        printf("RELATIVE ERROR OF CROSS APPROXIMATION: %e\n",
+                sqrt(err2)/norm);
+        if(sqrt(err2) > tol*norm)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+    }
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    starsh_cluster_free(C);
+    starsh_problem_free(P);
+    return 0;
+}
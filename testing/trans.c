@@ -0,0 +1,169 @@
+/*! @copyright (c) 2017 King Abdullah University of Science and
+ *                      Technology (KAUST). All rights reserved.
+ *
+ * STARS-H is a software package, provided by King Abdullah
+ *             University of Science and Technology (KAUST)
+ *
+ * @file testing/trans.c
+ * @version 0.1.1
+ * @date 2026-10-18
+ * */
+
+#ifdef MKL
+    #include <mkl.h>
+#else
+    #include <cblas.h>
+    #include <lapacke.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <starsh.h>
+#include <starsh-cauchy.h>
+
+static double rel_diff(int n, double *y, double *y_ref)
+// Relative difference of two vectors
+{
+    double norm = cblas_dnrm2(n, y_ref, 1);
+    cblas_daxpy(n, -1.0, y_ref, 1, y, 1);
+    return cblas_dnrm2(n, y, 1)/norm;
+}
+
+int main(int argc, char **argv)
+{
+    if(argc < 5)
+    {
+        printf("%d arguments provided, but 4 are needed\n", argc-1);
+        printf("trans N block_size maxrank tol\n");
+        return 1;
+    }
+    int N = atoi(argv[1]), block_size = atoi(argv[2]);
+    int maxrank = atoi(argv[3]);
+    double tol = atof(argv[4]);
+    int onfly = 0;
+    char dtype = 'd', symm = 'N';
+    int ndim = 2, nrhs = 3;
+    int info;
+    STARSH_int shape[2] = {N, N};
+    double alpha = 2.0, beta = -1.0;
+    printf("PARAMS: N=%d NB=%d TOL=%e\n", N, block_size, tol);
+    srand(0);
+    // Init STARS-H
+    info = starsh_init();
+    if(info != 0)
+        return info;
+    // Generate data for nonsymmetric Cauchy matrix
+    STARSH_cauchy *data;
+    STARSH_kernel *kernel;
+    info = starsh_application((void **)&data, &kernel, N, dtype, STARSH_CAUCHY,
+            STARSH_CAUCHY_KERNEL1, 0);
+    if(info != 0)
+        return info;
+    // Init problem with given data and kernel and print short info
+    STARSH_problem *P;
+    info = starsh_problem_new(&P, ndim, shape, symm, dtype, data, data,
+            kernel, "Cauchy example");
+    if(info != 0)
+        return info;
+    starsh_problem_info(P);
+    // Dense right hand sides, initial values of results and reference
+    // results, computed with transposed dense matrix
+    double *x = malloc(N*nrhs*sizeof(*x));
+    double *y0 = malloc(N*nrhs*sizeof(*y0));
+    double *y_ref = malloc(N*nrhs*sizeof(*y_ref));
+    double *y = malloc(N*nrhs*sizeof(*y));
+    int iseed[4] = {0, 0, 0, 1};
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, x);
+    LAPACKE_dlarnv_work(3, iseed, N*nrhs, y0);
+    Array *A;
+    info = starsh_problem_to_array(P, &A);
+    if(info != 0)
+        return info;
+    cblas_dcopy(N*nrhs, y0, 1, y_ref, 1);
+    cblas_dgemm(CblasColMajor, CblasTrans, CblasNoTrans, N, nrhs, N, alpha,
+            A->data, N, x, N, beta, y_ref, N);
+    array_free(A);
+    // Init plain clusterization, tlr division into admissible blocks and
+    // approximate them
+    STARSH_cluster *C;
+    info = starsh_cluster_new_plain(&C, data, N, block_size);
+    if(info != 0)
+        return info;
+    STARSH_blrf *F;
+    STARSH_blrm *M;
+    info = starsh_blrf_new_tlr(&F, P, symm, C, C);
+    if(info != 0)
+        return info;
+    info = starsh_blrm_approximate(&M, F, maxrank, tol, onfly);
+    if(info != 0)
+        return info;
+    starsh_blrm_info(M);
+    // Check transposed product with sequential and OpenMP backends
+    for(int backend = 0; backend < 2; backend++)
+    {
+        cblas_dcopy(N*nrhs, y0, 1, y, 1);
+        if(backend)
+            info = starsh_blrm__dmml_trans_omp(M, nrhs, alpha, x, N, beta, y,
+                    N);
+        else
+            info = starsh_blrm__dmml_trans(M, nrhs, alpha, x, N, beta, y, N);
+        if(info != 0)
+            return info;
+        double rel_err = rel_diff(N*nrhs, y, y_ref);
+        printf("BACKEND=%d RELATIVE ERROR OF TRANSPOSED MATVEC: %e\n",
+                backend, rel_err);
+        if(rel_err/tol > 10.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+    }
+    // Check transposed product with plan of multiplication, with dense and
+    // CSR near-field blocks
+    STARSH_blrm_mml_plan *plan;
+    info = starsh_blrm_mml_plan_create(&plan, M, nrhs);
+    if(info != 0)
+        return info;
+    if(F->nblocks_far > 0 && starsh_blrm_mml_plan_execute_trans(plan, nrhs,
+                alpha, x, N, beta, y, N) == 0)
+    {
+        printf("Transposed product is computed without panels\n");
+        return 1;
+    }
+    starsh_blrm_mml_plan_destroy(plan);
+    info = starsh_blrm_mml_plan_create_panel(&plan, M, nrhs);
+    if(info != 0)
+        return info;
+    for(int sparse = 0; sparse < 2; sparse++)
+    {
+        // All near-field blocks are converted into CSR format
+        if(sparse)
+        {
+            info = starsh_blrm_mml_plan_sparse(plan, 1.0);
+            if(info != 0)
+                return info;
+        }
+        cblas_dcopy(N*nrhs, y0, 1, y, 1);
+        info = starsh_blrm_mml_plan_execute_trans(plan, nrhs, alpha, x, N,
+                beta, y, N);
+        if(info != 0)
+            return info;
+        double rel_err = rel_diff(N*nrhs, y, y_ref);
+        printf("SPARSE=%d RELATIVE ERROR OF TRANSPOSED MATVEC WITH PLAN: %e\n",
+                sparse, rel_err);
+        if(rel_err/tol > 10.)
+        {
+            printf("Resulting relative error is too big\n");
+            return 1;
+        }
+    }
+    starsh_blrm_mml_plan_destroy(plan);
+    starsh_blrm_free(M);
+    starsh_blrf_free(F);
+    starsh_problem_free(P);
+    free(x);
+    free(y0);
+    free(y);
+    free(y_ref);
+    return 0;
+}